@@ -32,6 +32,8 @@ public enum DebugEventType {
   EVT_DROPPED(0x03000000L),
   /// <summary>Event(s) filtered.</summary>
   EVT_FILTERED(0x03000001L),
+  /// <summary>Event(s) sampled out on the client.</summary>
+  EVT_SAMPLED(0x03000002L),
 
   /// <summary>Event(s) sent.</summary>
   EVT_SENT(0x04000000L),
@@ -0,0 +1,55 @@
+//
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// SPDX-License-Identifier: Apache-2.0
+//
+#include "AggregatedMetric.hpp"
+
+#include "stats/MetricsAggregator.hpp"
+
+namespace MAT_NS_BEGIN
+{
+
+    namespace Models {
+
+        AggregatedMetric::AggregatedMetric(std::string const& name,
+            std::string const& units,
+            unsigned const intervalInSec,
+            EventProperties const& eventProperties,
+            ILogger* pLogger) :
+            AggregatedMetric(name, units, intervalInSec, "", "", "", eventProperties, pLogger)
+        {
+        }
+
+        AggregatedMetric::AggregatedMetric(std::string const& name,
+            std::string const& units,
+            unsigned const intervalInSec,
+            std::string const& instanceName,
+            std::string const& objectClass,
+            std::string const& objectId,
+            EventProperties const& eventProperties,
+            ILogger* pLogger)
+        {
+            AggregatedMetricData metricData(name, 0, 0);
+            metricData.units = units;
+            metricData.instanceName = instanceName;
+            metricData.objectClass = objectClass;
+            metricData.objectId = objectId;
+            // An interval of 0 seconds would never be emitted before destruction
+            m_pAggregatedMetricImpl = new AggregatedMetricSeries(metricData, eventProperties, pLogger, (intervalInSec > 0) ? intervalInSec : 1);
+        }
+
+        AggregatedMetric::~AggregatedMetric()
+        {
+            auto series = static_cast<AggregatedMetricSeries*>(m_pAggregatedMetricImpl);
+            series->Flush();
+            delete series;
+        }
+
+        void AggregatedMetric::PushMetric(double value)
+        {
+            static_cast<AggregatedMetricSeries*>(m_pAggregatedMetricImpl)->Record(value);
+        }
+
+    } // Models
+
+} MAT_NS_END
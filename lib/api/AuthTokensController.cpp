@@ -12,7 +12,8 @@ namespace MAT_NS_BEGIN {
     MATSDK_LOG_INST_COMPONENT_CLASS(AuthTokensController, "EventsSDK.AuthTokensController", "Events telemetry client - AuthTokensController class");
 
     AuthTokensController::AuthTokensController()
-        :m_IsStrictModeEnabled(false)
+        :m_IsStrictModeEnabled(false),
+        m_version(1)
     {
         LOG_TRACE("New AuthTokensController instance");
     }
@@ -38,6 +39,7 @@ namespace MAT_NS_BEGIN {
                 m_tickets.push_back(TICKETS_PREPEND_STRING + std::to_string(type));
                 m_userTokens[type] = std::string(tokenValue);
             }
+            m_version++;
             return STATUS_SUCCESS;
         }
         return STATUS_EFAIL;
@@ -48,12 +50,14 @@ namespace MAT_NS_BEGIN {
         m_deviceTokens.clear();
         m_userTokens.clear();
         m_tickets.clear();
+        m_version++;
         return STATUS_SUCCESS;
     }
 
     status_t  AuthTokensController::SetStrictMode(bool value)
     {
         m_IsStrictModeEnabled = value;
+        m_version++;
         return STATUS_EFAIL;
     }
 
@@ -67,15 +71,20 @@ namespace MAT_NS_BEGIN {
         return m_tickets;
     }
 
-    std::map<TicketType, std::string>&  AuthTokensController::GetDeviceTokens()
+    std::map<TicketType, std::string> const&  AuthTokensController::GetDeviceTokens()
     {
         return m_deviceTokens;
     }
 
-    std::map<TicketType, std::string>&  AuthTokensController::GetUserTokens()
+    std::map<TicketType, std::string> const&  AuthTokensController::GetUserTokens()
     {
         return m_userTokens;
     }
 
+    uint64_t  AuthTokensController::GetTokensVersion()
+    {
+        return m_version;
+    }
+
 } MAT_NS_END
 
@@ -10,6 +10,7 @@
 #include "pal/PAL.hpp"
 #include "IAuthTokensController.hpp"
 
+#include <atomic>
 #include <map>
 #include <vector>
 
@@ -59,18 +60,21 @@ namespace MAT_NS_BEGIN
         virtual std::vector<std::string>&  GetTickets() override;
 
         /// <summary>
-        /// Set the Auth ticket.
+        /// Gets the device tokens. They are changed through SetTicketToken() and Clear() only,
+        /// which update GetTokensVersion().
         /// </summary>
-        /// <param name="type">Ticket type</param>
-        /// <param name="ticketValue">Ticketvalue</param>
-        virtual std::map<TicketType, std::string>&  GetDeviceTokens() override;
+        virtual std::map<TicketType, std::string> const&  GetDeviceTokens() override;
 
         /// <summary>
-        /// Set the Auth ticket.
+        /// Gets the user tokens. They are changed through SetTicketToken() and Clear() only,
+        /// which update GetTokensVersion().
         /// </summary>
-        /// <param name="type">Ticket type</param>
-        /// <param name="ticketValue">Ticketvalue</param>
-        virtual std::map<TicketType, std::string>&  GetUserTokens() override;
+        virtual std::map<TicketType, std::string> const&  GetUserTokens() override;
+
+        /// <summary>
+        /// Gets the number of changes made through this controller, starting at 1.
+        /// </summary>
+        virtual uint64_t  GetTokensVersion() override;
 
     private:
         MATSDK_LOG_DECL_COMPONENT_CLASS();
@@ -78,6 +82,7 @@ namespace MAT_NS_BEGIN
         std::map<TicketType, std::string> m_userTokens;
         std::vector<std::string> m_tickets;
         bool m_IsStrictModeEnabled;
+        std::atomic<uint64_t> m_version;
     };
 
 
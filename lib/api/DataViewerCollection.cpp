@@ -4,24 +4,151 @@
 //
 #include "DataViewerCollection.hpp"
 #include <algorithm>
+#include <iterator>
 #include <mutex>
 
 namespace MAT_NS_BEGIN {
 
     MATSDK_LOG_INST_COMPONENT_CLASS(DataViewerCollection, "EventsSDK.DataViewerCollection", "Microsoft Telemetry Client - DataViewerCollection class");
 
+    DataViewerCollection::DataViewerCollection(size_t maxQueuedPackets) noexcept :
+        m_maxQueuedPackets(std::max<size_t>(1, maxQueuedPackets))
+    {
+    }
+
+    DataViewerCollection::~DataViewerCollection() noexcept
+    {
+        {
+            // Only the packet a viewer is receiving right now is waited for; the
+            // queued ones must not hold up teardown behind a slow viewer.
+            std::lock_guard<std::mutex> lock(m_pendingLock);
+            m_stopDelivery = true;
+            m_pending.clear();
+        }
+        m_pendingChanged.notify_all();
+        if (m_deliveryThread.joinable())
+        {
+            m_deliveryThread.join();
+        }
+    }
+
     void DataViewerCollection::DispatchDataViewerEvent(const std::vector<uint8_t>& packetData) const noexcept
     {
         if (IsViewerEnabled() == false)
             return;
 
-        LOCKGUARD(m_dataViewerMapLock);
-        for(const auto& viewer : m_dataViewerCollection)
+        DataViewerPacket packet;
+        try
+        {
+            packet = std::make_shared<const std::vector<uint8_t>>(packetData);
+        }
+        catch (const std::bad_alloc&)
+        {
+            LOG_ERROR("Failed to copy data viewer packet of %zu bytes", packetData.size());
+            return;
+        }
+        DispatchDataViewerPacket(packet);
+    }
+
+    void DataViewerCollection::DispatchDataViewerPacket(const DataViewerPacket& packet) const noexcept
+    {
+        if (packet == nullptr || IsViewerEnabled() == false)
+            return;
+
         {
-            // Task 3568800: Integrate ThreadPool to IDataViewerCollection
-            viewer->ReceiveData(packetData);
+            LOCKGUARD(m_dataViewerMapLock);
+            std::lock_guard<std::mutex> lock(m_pendingLock);
+            if (m_stopDelivery)
+                return;
+
+            try
+            {
+                for (const auto& viewer : m_dataViewerCollection)
+                {
+                    auto& pending = m_pending[viewer.get()];
+                    pending.viewer = viewer;
+                    if (pending.packets.size() >= m_maxQueuedPackets)
+                    {
+                        pending.packets.pop_front();
+                        m_droppedPacketCount++;
+                        LOG_WARN("Data viewer '%s' is lagging behind, dropped the oldest packet", viewer->GetName());
+                    }
+                    pending.packets.push_back(packet);
+                }
+
+                if (!m_deliveryThread.joinable())
+                {
+                    m_deliveryThread = std::thread([this]() { deliverPackets(); });
+                }
+            }
+            catch (const std::exception& ex)
+            {
+                LOG_ERROR("Failed to queue data viewer packet: %s", ex.what());
+                return;
+            }
         }
-    };
+        m_pendingChanged.notify_all();
+    }
+
+    void DataViewerCollection::deliverPackets() const
+    {
+        std::unique_lock<std::mutex> lock(m_pendingLock);
+        for (;;)
+        {
+            m_pendingChanged.wait(lock, [this]() { return m_stopDelivery || !m_pending.empty(); });
+            if (m_stopDelivery)
+            {
+                // Pending packets were dropped on destruction
+                return;
+            }
+
+            // One packet per viewer per round, so that a slow viewer only delays itself
+            std::vector<std::pair<std::shared_ptr<IDataViewer>, DataViewerPacket>> batch;
+            for (auto it = m_pending.begin(); it != m_pending.end();)
+            {
+                batch.emplace_back(it->second.viewer, std::move(it->second.packets.front()));
+                it->second.packets.pop_front();
+                it = it->second.packets.empty() ? m_pending.erase(it) : std::next(it);
+            }
+
+            m_deliveringCount = batch.size();
+            lock.unlock();
+            for (auto const& item : batch)
+            {
+                item.first->ReceivePacket(item.second);
+            }
+            batch.clear();
+            lock.lock();
+            m_deliveringCount = 0;
+            m_pendingChanged.notify_all();
+        }
+    }
+
+    void DataViewerCollection::dropPendingPackets(const IDataViewer* viewer) const
+    {
+        std::lock_guard<std::mutex> lock(m_pendingLock);
+        if (viewer == nullptr)
+        {
+            m_pending.clear();
+        }
+        else
+        {
+            m_pending.erase(viewer);
+        }
+        m_pendingChanged.notify_all();
+    }
+
+    void DataViewerCollection::WaitForPendingPackets() const
+    {
+        std::unique_lock<std::mutex> lock(m_pendingLock);
+        m_pendingChanged.wait(lock, [this]() { return m_pending.empty() && m_deliveringCount == 0; });
+    }
+
+    size_t DataViewerCollection::GetDroppedPacketCount() const noexcept
+    {
+        std::lock_guard<std::mutex> lock(m_pendingLock);
+        return m_droppedPacketCount;
+    }
 
     void DataViewerCollection::RegisterViewer(const std::shared_ptr<IDataViewer>& dataViewer)
     {
@@ -62,12 +189,14 @@ namespace MAT_NS_BEGIN {
             MATSDK_THROW(std::invalid_argument(errorMessage.str()));
         }
 
+        dropPendingPackets(toErase->get());
         m_dataViewerCollection.erase(toErase);
     }
 
     void DataViewerCollection::UnregisterAllViewers()
     {
         LOCKGUARD(m_dataViewerMapLock);
+        dropPendingPackets(nullptr);
         m_dataViewerCollection.clear();
     }
 
@@ -9,16 +9,43 @@
 #include "IDataViewerCollection.hpp"
 #include "pal/PAL.hpp"
 
+#include <condition_variable>
+#include <deque>
+#include <map>
 #include <mutex>
+#include <thread>
 #include <vector>
 
 namespace MAT_NS_BEGIN {
 
+    /// <summary>
+    /// Default number of packets queued per viewer before the oldest ones are dropped.
+    /// </summary>
+    constexpr size_t DefaultMaxQueuedViewerPackets = 16;
+
+    /// <summary>
+    /// Data viewer registry. Packets are handed to the viewers on a dedicated
+    /// delivery thread through a bounded per-viewer queue, so that a slow
+    /// viewer never stalls uploads. When a viewer lags behind, its oldest
+    /// queued packets are dropped and counted. Packets still queued when the
+    /// collection is destroyed are dropped.
+    /// </summary>
     class DataViewerCollection : public IDataViewerCollection
     {
     public:
+        DataViewerCollection(size_t maxQueuedPackets = DefaultMaxQueuedViewerPackets) noexcept;
+
         virtual void DispatchDataViewerEvent(const std::vector<uint8_t>& packetData) const noexcept override;
 
+        virtual void DispatchDataViewerPacket(const DataViewerPacket& packet) const noexcept override;
+
+        virtual size_t GetDroppedPacketCount() const noexcept override;
+
+        /// <summary>
+        /// Blocks until all queued packets have been delivered.
+        /// </summary>
+        void WaitForPendingPackets() const;
+
         virtual void RegisterViewer(const std::shared_ptr<IDataViewer>& dataViewer) override;
 
         virtual void UnregisterViewer(const char* viewerName) override;
@@ -31,12 +58,30 @@ namespace MAT_NS_BEGIN {
 
         virtual bool IsViewerRegistered(const char* viewerName) const override;
 
-        virtual ~DataViewerCollection() noexcept {};
+        virtual ~DataViewerCollection() noexcept;
     private:
         MATSDK_LOG_DECL_COMPONENT_CLASS();
 
         mutable std::recursive_mutex m_dataViewerMapLock;
 
+        struct PendingPackets
+        {
+            std::shared_ptr<IDataViewer> viewer;
+            std::deque<DataViewerPacket> packets;
+        };
+
+        void deliverPackets() const;
+        void dropPendingPackets(const IDataViewer* viewer) const;
+
+        const size_t                                   m_maxQueuedPackets;
+        mutable std::mutex                             m_pendingLock;
+        mutable std::condition_variable                m_pendingChanged;
+        mutable std::map<const IDataViewer*, PendingPackets> m_pending;
+        mutable size_t                                 m_deliveringCount { 0 };
+        mutable size_t                                 m_droppedPacketCount { 0 };
+        mutable bool                                   m_stopDelivery { false };
+        mutable std::thread                            m_deliveryThread;
+
     protected:
         std::shared_ptr<IDataViewer> GetViewerFromCollection(const char* viewerName) const;
         std::vector<std::shared_ptr<IDataViewer>> m_dataViewerCollection;
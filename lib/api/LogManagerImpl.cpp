@@ -16,7 +16,10 @@
 
 #include "EventProperty.hpp"
 #include "TransmitProfiles.hpp"
+#include "bwcontrol/TokenBucketBandwidthController.hpp"
 #include "http/HttpClientFactory.hpp"
+#include "http/HttpClient_LocalAgent.hpp"
+#include "pal/PipelineTrace.hpp"
 #include "pal/TaskDispatcher.hpp"
 #include "utils/Utils.hpp"
 
@@ -117,6 +120,11 @@ namespace MAT_NS_BEGIN
 
     MATSDK_LOG_INST_COMPONENT_CLASS(LogManagerImpl, "EventsSDK.LogManager", "Microsoft Telemetry Client - LogManager class");
 
+#ifdef HAVE_MAT_CURL_DEFAULT_HTTP_CLIENT
+    /// Offline storage setting with the TLS sessions of the default HTTP client
+    static const char* tlsSessionsName = "tlssessions";
+#endif
+
 #if 1
     // TODO: integrate Tracing API from v1
     // Meanwhile we'd set the g_logLevel using ILogConfiguration settings
@@ -170,9 +178,10 @@ namespace MAT_NS_BEGIN
         m_config = std::unique_ptr<IRuntimeConfig>(new RuntimeConfig_Default(m_logConfiguration));
         setLogLevel(configuration);
         LOG_TRACE("New LogManager instance");
-
-        PAL::initialize(*m_config);
-        PAL::registerSemanticContext(&m_context);
+        if ((*m_config)[CFG_BOOL_ENABLE_PIPELINE_TRACE])
+        {
+            PAL::PipelineTrace::Enable(true);
+        }
 
         std::string cacheFilePath = MAT::GetAppLocalTempDirectory();
         if (!m_logConfiguration.HasConfig(CFG_STR_CACHE_FILE_PATH) ||
@@ -206,6 +215,12 @@ namespace MAT_NS_BEGIN
             }
         }
 
+        // PAL may keep system information next to the cache file
+        PAL::initialize(*m_config);
+        PAL::registerSemanticContext(&m_context);
+        m_eventSampler.reset(new EventSampler(m_logConfiguration));
+        m_metricsAggregator.reset(new MetricsAggregator(m_logConfiguration));
+
         if (m_logConfiguration.HasConfig(CFG_STR_TRANSMIT_PROFILES))
         {
             std::string transmitProfiles = m_logConfiguration[CFG_STR_TRANSMIT_PROFILES];
@@ -241,6 +256,7 @@ namespace MAT_NS_BEGIN
         {
             LOG_TRACE("TaskDispatcher: External %p", m_taskDispatcher.get());
         }
+        m_metricsAggregator->Start(*m_taskDispatcher);
 
         int32_t sdkMode = configuration[CFG_INT_SDK_MODE];
         (void)sdkMode; // variable may be unused when SDK is compiled without private modules
@@ -261,6 +277,7 @@ namespace MAT_NS_BEGIN
             configuration[CFG_STR_UTC][CFG_BOOL_UTC_ACTIVE] = true;
             LOG_TRACE("Initializing UTC physical layer...");
             m_system.reset(new UtcTelemetrySystem(*this, *m_config, *m_taskDispatcher));
+            m_system->setEventSampler(m_eventSampler.get());
             if (!deferSystemStart)
             {
                 m_system->start();
@@ -272,10 +289,22 @@ namespace MAT_NS_BEGIN
         }
 #endif
 
+#ifdef HAVE_MAT_LOCAL_AGENT
+        if (m_httpClient == nullptr)
+        {
+            std::string localAgentSocket = m_logConfiguration[CFG_MAP_HTTP][CFG_STR_HTTP_LOCAL_AGENT_SOCKET];
+            if (!localAgentSocket.empty())
+            {
+                m_httpClient = std::make_shared<HttpClient_LocalAgent>(localAgentSocket);
+            }
+        }
+#endif
+
 #ifdef HAVE_MAT_DEFAULT_HTTP_CLIENT
         if (m_httpClient == nullptr)
         {
             m_httpClient = HttpClientFactory::Create();
+            m_isDefaultHttpClient = true;
 #ifdef HAVE_MAT_WININET_HTTP_CLIENT
             HttpClient_WinInet* client = static_cast<HttpClient_WinInet*>(m_httpClient.get());
             if (client != nullptr)
@@ -298,6 +327,7 @@ namespace MAT_NS_BEGIN
 
         if (m_bandwidthController == nullptr)
         {
+            m_ownBandwidthController = TokenBucketBandwidthController::createFromConfig(*m_config);
             m_bandwidthController = m_ownBandwidthController.get();
         }
         else
@@ -330,6 +360,7 @@ namespace MAT_NS_BEGIN
             m_system.reset(new TelemetrySystem(*this, *m_config, *m_offlineStorage, *m_httpClient,
                                                *m_taskDispatcher, m_bandwidthController, *m_logSessionDataProvider));
         }
+        m_system->setEventSampler(m_eventSampler.get());
         LOG_TRACE("Telemetry system created, starting up...");
         if (m_system && !deferSystemStart)
         {
@@ -337,6 +368,23 @@ namespace MAT_NS_BEGIN
             m_isSystemStarted = true;
         }
 
+#ifdef HAVE_MAT_CURL_DEFAULT_HTTP_CLIENT
+        if (m_isDefaultHttpClient)
+        {
+            HttpClient_Curl* client = static_cast<HttpClient_Curl*>(m_httpClient.get());
+            // Sessions go in first, so that the pre-connect can resume one of them
+            if (m_isSystemStarted && m_logConfiguration[CFG_MAP_HTTP][CFG_BOOL_HTTP_PERSIST_TLS_SESSIONS])
+            {
+                size_t imported = client->ImportTlsSessions(m_offlineStorage->GetSetting(tlsSessionsName));
+                LOG_TRACE("Imported %u TLS sessions", static_cast<unsigned>(imported));
+            }
+            if (m_logConfiguration[CFG_MAP_HTTP][CFG_BOOL_HTTP_PREWARM])
+            {
+                client->Prewarm(m_config->GetCollectorUrl());
+            }
+        }
+#endif
+
 #ifdef HAVE_MAT_DEFAULT_FILTER
         m_modules.push_back(std::unique_ptr<CompliantByDefaultEventFilterModule>(new CompliantByDefaultEventFilterModule()));
 #endif  // HAVE_MAT_DEFAULT_FILTER
@@ -377,6 +425,8 @@ namespace MAT_NS_BEGIN
 
     void LogManagerImpl::FlushAndTeardown()
     {
+        // Pending metric aggregates are logged while the loggers are still alive
+        m_metricsAggregator->Shutdown();
         PauseActivity();
         WaitPause();
         LOG_INFO("Shutting down...");
@@ -411,6 +461,17 @@ namespace MAT_NS_BEGIN
             LOG_INFO("Tearing down modules");
             TeardownModules();
 
+#ifdef HAVE_MAT_CURL_DEFAULT_HTTP_CLIENT
+            if (m_isDefaultHttpClient && m_isSystemStarted && m_logConfiguration[CFG_MAP_HTTP][CFG_BOOL_HTTP_PERSIST_TLS_SESSIONS])
+            {
+                std::string sessions = static_cast<HttpClient_Curl*>(m_httpClient.get())->ExportTlsSessions();
+                if (!sessions.empty())
+                {
+                    m_offlineStorage->StoreSetting(tlsSessionsName, sessions);
+                }
+            }
+#endif
+
             if (m_isSystemStarted && m_system)
             {
                 m_system->stop();
@@ -790,6 +851,32 @@ namespace MAT_NS_BEGIN
         return m_diagLevelFilter;
     }
 
+    const EventSampler& LogManagerImpl::GetEventSampler()
+    {
+        return *m_eventSampler;
+    }
+
+    std::vector<DeliveryLatencyStats> LogManagerImpl::GetDeliveryLatency()
+    {
+        // Querying must not start the telemetry system
+        LOCKGUARD(m_lock);
+        if (m_system)
+        {
+            return m_system->getDeliveryLatency();
+        }
+        return {};
+    }
+
+    std::string LogManagerImpl::GetPipelineTrace()
+    {
+        return PAL::PipelineTrace::GetJson();
+    }
+
+    MetricsAggregator& LogManagerImpl::GetMetricsAggregator()
+    {
+        return *m_metricsAggregator;
+    }
+
     std::unique_ptr<ITelemetrySystem>& LogManagerImpl::GetSystem()
     {
         if (m_system == nullptr || m_isSystemStarted)
@@ -26,6 +26,8 @@
 #include "api/AuthTokensController.hpp"
 #include "api/DataViewerCollection.hpp"
 #include "filter/EventFilterCollection.hpp"
+#include "filter/EventSampler.hpp"
+#include "stats/MetricsAggregator.hpp"
 
 #include "AllowedLevelsCollection.hpp"
 
@@ -125,6 +127,8 @@ namespace MAT_NS_BEGIN
         virtual void sendEvent(IncomingEventContextPtr const& event) = 0;
         virtual const ContextFieldsProvider& GetContext() = 0;
         virtual const DiagLevelFilter& GetLevelFilter() = 0;
+        virtual const EventSampler& GetEventSampler() = 0;
+        virtual MetricsAggregator& GetMetricsAggregator() = 0;
     };
 
     class Logger;
@@ -286,6 +290,16 @@ namespace MAT_NS_BEGIN
         /// </summary>
         virtual const DiagLevelFilter& GetLevelFilter() override;
 
+        /// <summary>
+        /// Get a reference to this log manager client-side event sampler
+        /// </summary>
+        virtual const EventSampler& GetEventSampler() override;
+
+        /// <summary>
+        /// Get a reference to this log manager sampled metrics aggregator
+        /// </summary>
+        virtual MetricsAggregator& GetMetricsAggregator() override;
+
         /// <summary>
         /// Get a reference to this log manager instance ContextFieldsProvider
         /// </summary>
@@ -308,6 +322,10 @@ namespace MAT_NS_BEGIN
         virtual bool StartActivity() override;
         virtual void EndActivity() override;
 
+        virtual std::vector<DeliveryLatencyStats> GetDeliveryLatency() override;
+
+        virtual std::string GetPipelineTrace() override;
+
        protected:
         std::unique_ptr<ITelemetrySystem>& GetSystem();
         void InitializeModules() noexcept;
@@ -321,6 +339,7 @@ namespace MAT_NS_BEGIN
         ContextFieldsProvider m_context;
 
         std::shared_ptr<IHttpClient> m_httpClient;
+        bool m_isDefaultHttpClient{};
         std::shared_ptr<ITaskDispatcher> m_taskDispatcher;
         std::shared_ptr<IDataViewer> m_dataViewer;
 
@@ -341,6 +360,8 @@ namespace MAT_NS_BEGIN
 
         DebugEventSource m_debugEventSource;
         DiagLevelFilter m_diagLevelFilter;
+        std::unique_ptr<EventSampler> m_eventSampler;
+        std::unique_ptr<MetricsAggregator> m_metricsAggregator;
 
         EventFilterCollection m_filters;
         std::vector<std::unique_ptr<IModule>> m_modules;
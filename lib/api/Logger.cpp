@@ -94,6 +94,7 @@ namespace MAT_NS_BEGIN
         m_scope(scope),
         m_level(DIAG_LEVEL_DEFAULT),
         m_logManager(logManager),
+        m_sampledOut(logManager.GetEventSampler().GetSampledOutCounter(tenantToken)),
         m_context(&parentContext),
         m_config(runtimeConfig),
 
@@ -251,14 +252,15 @@ namespace MAT_NS_BEGIN
         LOG_TRACE("%p: LogAppLifecycle(state=%u, properties.name=\"%s\", ...)",
                   this, state, properties.GetName().empty() ? "<unnamed>" : properties.GetName().c_str());
 
-        if (!CanEventPropertiesBeSent(properties))
+        double sampleRate = EventSampler::FullRate;
+        if (!CanEventBeLogged(properties, sampleRate))
         {
-            DispatchEvent(DebugEventType::EVT_FILTERED);
             return;
         }
 
         EventLatency latency = EventLatency_Normal;
-        ::CsProtocol::Record record;
+        ContextPool<::CsProtocol::Record>::Lease pooledRecord(m_recordPool);
+        ::CsProtocol::Record& record = *pooledRecord;
 
         const bool decorated =
             applyCommonDecorators(record, properties, latency) &&
@@ -270,6 +272,7 @@ namespace MAT_NS_BEGIN
             return;
         }
 
+        record.popSample = sampleRate;
         submit(record, properties);
         DispatchEvent(DebugEvent(DebugEventType::EVT_LOG_LIFECYCLE, size_t(latency), size_t(0), static_cast<void*>(&record), sizeof(record)));
     }
@@ -307,9 +310,9 @@ namespace MAT_NS_BEGIN
         LOG_TRACE("%p: LogEvent(properties.name=\"%s\", ...)",
                   this, properties.GetName().empty() ? "<unnamed>" : properties.GetName().c_str());
 
-        if (!CanEventPropertiesBeSent(properties))
+        double sampleRate = EventSampler::FullRate;
+        if (!CanEventBeLogged(properties, sampleRate))
         {
-            DispatchEvent(DebugEventType::EVT_FILTERED);
             return;
         }
 
@@ -319,7 +322,8 @@ namespace MAT_NS_BEGIN
             latency = properties.GetLatency();
         }
 
-        ::CsProtocol::Record record;
+        ContextPool<::CsProtocol::Record>::Lease pooledRecord(m_recordPool);
+        ::CsProtocol::Record& record = *pooledRecord;
 
         if (!applyCommonDecorators(record, properties, latency))
         {
@@ -330,6 +334,7 @@ namespace MAT_NS_BEGIN
             return;
         }
 
+        record.popSample = sampleRate;
         submit(record, properties);
         DispatchEvent(DebugEvent(DebugEventType::EVT_LOG_EVENT, size_t(latency), size_t(0), static_cast<void*>(&record), sizeof(record)));
     }
@@ -359,14 +364,15 @@ namespace MAT_NS_BEGIN
         LOG_TRACE("%p: LogFailure(signature=\"%s\", properties.name=\"%s\", ...)",
                   this, signature.c_str(), properties.GetName().empty() ? "<unnamed>" : properties.GetName().c_str());
 
-        if (!CanEventPropertiesBeSent(properties))
+        double sampleRate = EventSampler::FullRate;
+        if (!CanEventBeLogged(properties, sampleRate))
         {
-            DispatchEvent(DebugEventType::EVT_FILTERED);
             return;
         }
 
         EventLatency latency = EventLatency_Normal;
-        ::CsProtocol::Record record;
+        ContextPool<::CsProtocol::Record>::Lease pooledRecord(m_recordPool);
+        ::CsProtocol::Record& record = *pooledRecord;
 
         const bool decorated =
             applyCommonDecorators(record, properties, latency) &&
@@ -380,6 +386,7 @@ namespace MAT_NS_BEGIN
             return;
         }
 
+        record.popSample = sampleRate;
         submit(record, properties);
         DispatchEvent(DebugEvent(DebugEventType::EVT_LOG_FAILURE, size_t(latency), size_t(0), static_cast<void*>(&record), sizeof(record)));
     }
@@ -410,14 +417,15 @@ namespace MAT_NS_BEGIN
         LOG_TRACE("%p: LogPageView(id=\"%s\", properties.name=\"%s\", ...)",
                   this, id.c_str(), properties.GetName().empty() ? "<unnamed>" : properties.GetName().c_str());
 
-        if (!CanEventPropertiesBeSent(properties))
+        double sampleRate = EventSampler::FullRate;
+        if (!CanEventBeLogged(properties, sampleRate))
         {
-            DispatchEvent(DebugEventType::EVT_FILTERED);
             return;
         }
 
         EventLatency latency = EventLatency_Normal;
-        ::CsProtocol::Record record;
+        ContextPool<::CsProtocol::Record>::Lease pooledRecord(m_recordPool);
+        ::CsProtocol::Record& record = *pooledRecord;
 
         const bool decorated =
             applyCommonDecorators(record, properties, latency) &&
@@ -430,6 +438,7 @@ namespace MAT_NS_BEGIN
             return;
         }
 
+        record.popSample = sampleRate;
         submit(record, properties);
         DispatchEvent(DebugEvent(DebugEventType::EVT_LOG_PAGEVIEW, size_t(latency), size_t(0), (void*)(&record), sizeof(record)));
     }
@@ -464,14 +473,15 @@ namespace MAT_NS_BEGIN
         LOG_TRACE("%p: LogPageAction(pageActionData.actionType=%u, properties.name=\"%s\", ...)",
                   this, pageActionData.actionType, properties.GetName().empty() ? "<unnamed>" : properties.GetName().c_str());
 
-        if (!CanEventPropertiesBeSent(properties))
+        double sampleRate = EventSampler::FullRate;
+        if (!CanEventBeLogged(properties, sampleRate))
         {
-            DispatchEvent(DebugEventType::EVT_FILTERED);
             return;
         }
 
         EventLatency latency = EventLatency_Normal;
-        ::CsProtocol::Record record;
+        ContextPool<::CsProtocol::Record>::Lease pooledRecord(m_recordPool);
+        ::CsProtocol::Record& record = *pooledRecord;
 
         const bool decorated =
             applyCommonDecorators(record, properties, latency) &&
@@ -483,6 +493,7 @@ namespace MAT_NS_BEGIN
             return;
         }
 
+        record.popSample = sampleRate;
         submit(record, properties);
         DispatchEvent(DebugEvent(DebugEventType::EVT_LOG_PAGEACTION, size_t(latency), size_t(0), (void*)(&record), sizeof(record)));
     }
@@ -582,10 +593,11 @@ namespace MAT_NS_BEGIN
         }
 
         // TODO: [MG] - check if optimization is possible in generateUuidString
-        IncomingEventContext event(PAL::generateUuidString(), m_tenantToken, latency, persistence, &record);
-        event.policyBitFlags = policyBitFlags;
+        ContextPool<IncomingEventContext>::Lease event(m_eventContextPool);
+        event->set(PAL::generateUuidString(), m_tenantToken, latency, persistence, &record);
+        event->policyBitFlags = policyBitFlags;
 
-        m_logManager.sendEvent(&event);
+        m_logManager.sendEvent(event.get());
     }
 
     void Logger::onSubmitted()
@@ -617,14 +629,22 @@ namespace MAT_NS_BEGIN
         LOG_TRACE("%p: LogSampledMetric(name=\"%s\", properties.name=\"%s\", ...)",
                   this, name.c_str(), properties.GetName().empty() ? "<unnamed>" : properties.GetName().c_str());
 
-        if (!CanEventPropertiesBeSent(properties))
+        double sampleRate = EventSampler::FullRate;
+        if (!CanEventBeLogged(properties, sampleRate))
+        {
+            return;
+        }
+
+        // Aggregated observations are logged later as one AggregatedMetric event per series
+        MetricsAggregator& metrics = m_logManager.GetMetricsAggregator();
+        if (metrics.IsEnabled() && metrics.RecordSampledMetric(*this, name, value, units, instanceName, objectClass, objectId, properties))
         {
-            DispatchEvent(DebugEventType::EVT_FILTERED);
             return;
         }
 
         EventLatency latency = EventLatency_Normal;
-        ::CsProtocol::Record record;
+        ContextPool<::CsProtocol::Record>::Lease pooledRecord(m_recordPool);
+        ::CsProtocol::Record& record = *pooledRecord;
 
         const bool decorated =
             applyCommonDecorators(record, properties, latency) &&
@@ -637,6 +657,7 @@ namespace MAT_NS_BEGIN
             return;
         }
 
+        record.popSample = sampleRate;
         submit(record, properties);
         DispatchEvent(DebugEvent(DebugEventType::EVT_LOG_SAMPLEMETR, size_t(latency), size_t(0), (void*)(&record), sizeof(record)));
     }
@@ -673,14 +694,15 @@ namespace MAT_NS_BEGIN
         LOG_TRACE("%p: LogAggregatedMetric(name=\"%s\", properties.name=\"%s\", ...)",
                   this, metricData.name.c_str(), properties.GetName().empty() ? "<unnamed>" : properties.GetName().c_str());
 
-        if (!CanEventPropertiesBeSent(properties))
+        double sampleRate = EventSampler::FullRate;
+        if (!CanEventBeLogged(properties, sampleRate))
         {
-            DispatchEvent(DebugEventType::EVT_FILTERED);
             return;
         }
 
         EventLatency latency = EventLatency_Normal;
-        ::CsProtocol::Record record;
+        ContextPool<::CsProtocol::Record>::Lease pooledRecord(m_recordPool);
+        ::CsProtocol::Record& record = *pooledRecord;
 
         const bool decorated =
             applyCommonDecorators(record, properties, latency) &&
@@ -693,6 +715,7 @@ namespace MAT_NS_BEGIN
             return;
         }
 
+        record.popSample = sampleRate;
         submit(record, properties);
         DispatchEvent(DebugEvent(DebugEventType::EVT_LOG_AGGRMETR, size_t(latency), size_t(0), (void*)(&record), sizeof(record)));
     }
@@ -711,14 +734,15 @@ namespace MAT_NS_BEGIN
         LOG_TRACE("%p: LogTrace(level=%u, properties.name=\"%s\", ...)",
                   this, level, properties.GetName().empty() ? "<unnamed>" : properties.GetName().c_str());
 
-        if (!CanEventPropertiesBeSent(properties))
+        double sampleRate = EventSampler::FullRate;
+        if (!CanEventBeLogged(properties, sampleRate))
         {
-            DispatchEvent(DebugEventType::EVT_FILTERED);
             return;
         }
 
         EventLatency latency = EventLatency_Normal;
-        ::CsProtocol::Record record;
+        ContextPool<::CsProtocol::Record>::Lease pooledRecord(m_recordPool);
+        ::CsProtocol::Record& record = *pooledRecord;
 
         bool decorated =
             applyCommonDecorators(record, properties, latency) &&
@@ -731,6 +755,7 @@ namespace MAT_NS_BEGIN
             return;
         }
 
+        record.popSample = sampleRate;
         submit(record, properties);
         DispatchEvent(DebugEvent(DebugEventType::EVT_LOG_TRACE, size_t(latency), size_t(0), (void*)(&record), sizeof(record)));
     }
@@ -749,14 +774,15 @@ namespace MAT_NS_BEGIN
         LOG_TRACE("%p: LogUserState(state=%u, properties.name=\"%s\", ...)",
                   this, state, properties.GetName().empty() ? "<unnamed>" : properties.GetName().c_str());
 
-        if (!CanEventPropertiesBeSent(properties))
+        double sampleRate = EventSampler::FullRate;
+        if (!CanEventBeLogged(properties, sampleRate))
         {
-            DispatchEvent(DebugEventType::EVT_FILTERED);
             return;
         }
 
         EventLatency latency = EventLatency_Normal;
-        ::CsProtocol::Record record;
+        ContextPool<::CsProtocol::Record>::Lease pooledRecord(m_recordPool);
+        ::CsProtocol::Record& record = *pooledRecord;
 
         bool decorated =
             applyCommonDecorators(record, properties, latency) &&
@@ -769,6 +795,7 @@ namespace MAT_NS_BEGIN
             return;
         }
 
+        record.popSample = sampleRate;
         submit(record, properties);
         DispatchEvent(DebugEvent(DebugEventType::EVT_LOG_USERSTATE, size_t(latency), size_t(0), (void*)(&record), sizeof(record)));
     }
@@ -859,7 +886,8 @@ namespace MAT_NS_BEGIN
         }
 
         EventLatency latency = EventLatency_RealTime;
-        ::CsProtocol::Record record;
+        ContextPool<::CsProtocol::Record>::Lease pooledRecord(m_recordPool);
+        ::CsProtocol::Record& record = *pooledRecord;
 
         bool decorated = applyCommonDecorators(record, props, latency) &&
                          m_semanticApiDecorators.decorateSessionMessage(record, state, m_sessionId, PAL::formatUtcTimestampMsAsISO8601(sessionFirstTime), sessionSDKUid, sessionDuration);
@@ -950,6 +978,41 @@ namespace MAT_NS_BEGIN
         return m_filters.CanEventPropertiesBeSent(properties) && m_logManager.GetEventFilters().CanEventPropertiesBeSent(properties);
     }
 
+    /// <summary>
+    /// Applies the event filters, then client-side sampling, before the event is decorated.
+    /// Sampled out events are only counted: the stats report them on their next send.
+    /// </summary>
+    /// <param name="properties">The event properties.</param>
+    /// <param name="sampleRate">Receives the effective popSample of a kept event.</param>
+    /// <returns>false if the event has been filtered or sampled out.</returns>
+    bool Logger::CanEventBeLogged(EventProperties const& properties, double& sampleRate)
+    {
+        if (!CanEventPropertiesBeSent(properties))
+        {
+            DispatchEvent(DebugEventType::EVT_FILTERED);
+            return false;
+        }
+
+        sampleRate = properties.GetPopSample();
+        const EventSampler& sampler = m_logManager.GetEventSampler();
+        if (!sampler.IsEnabled())
+        {
+            return true;
+        }
+
+        bool hasLevel = false;
+        uint8_t level = m_level;
+        std::tie(hasLevel, level) = properties.TryGetLevel();
+        const double rate = sampler.GetSampleRate(m_tenantToken, properties.GetName(), hasLevel ? level : m_level);
+        if (!sampler.IsSampledIn(rate))
+        {
+            m_sampledOut.fetch_add(1, std::memory_order_relaxed);
+            return false;
+        }
+        sampleRate = sampleRate * rate / EventSampler::FullRate;
+        return true;
+    }
+
     void Logger::RecordShutdown()
     {
         std::unique_lock<std::mutex> shutdownLock(m_shutdown_mutex);
@@ -23,6 +23,10 @@
 #include "decorators/SemanticContextDecorator.hpp"
 
 #include "filter/EventFilterCollection.hpp"
+#include "filter/EventSampler.hpp"
+
+#include "system/ContextPool.hpp"
+#include "system/Contexts.hpp"
 
 namespace MAT_NS_BEGIN
 {
@@ -237,6 +241,9 @@ namespace MAT_NS_BEGIN
         bool
         CanEventPropertiesBeSent(EventProperties const& properties) const noexcept;
 
+        bool
+        CanEventBeLogged(EventProperties const& properties, double& sampleRate);
+
         std::mutex m_lock;
 
         std::string m_tenantToken;
@@ -251,6 +258,8 @@ namespace MAT_NS_BEGIN
         uint8_t m_level;
 
         ILogManagerInternal& m_logManager;
+        // Events of this tenant sampled out since the last stats send (see EventSampler)
+        std::atomic<unsigned>& m_sampledOut;
         ContextFieldsProvider m_context;
         IRuntimeConfig& m_config;
 
@@ -268,6 +277,12 @@ namespace MAT_NS_BEGIN
         bool m_resetSessionOnEnd;
         EventFilterCollection m_filters;
 
+        /// Records and incoming event contexts are reused by later calls, so
+        /// that their vectors and strings keep the capacity they grew to.
+        /// Enough are kept for a few threads logging through this logger at once.
+        ContextPool<::CsProtocol::Record> m_recordPool{8};
+        ContextPool<IncomingEventContext> m_eventContextPool{8};
+
         /// m_shutdown_mutex protects shut-down state
         mutable std::mutex m_shutdown_mutex;
 
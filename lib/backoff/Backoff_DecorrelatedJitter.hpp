@@ -0,0 +1,82 @@
+//
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// SPDX-License-Identifier: Apache-2.0
+//
+#ifndef BACKOFF_DECORRELATEDJITTER_HPP
+#define BACKOFF_DECORRELATEDJITTER_HPP
+
+#include "backoff/IBackoff.hpp"
+#include "pal/PseudoRandomGenerator.hpp"
+
+#include <algorithm>
+#include <math.h>
+
+namespace MAT_NS_BEGIN {
+
+
+/// <summary>
+/// Backoff implementation with decorrelated jitter: each step is drawn
+/// uniformly from <c>[baseValue, previous * 3]</c> and clipped to
+/// <c>maximumValue</c>. Unlike plain exponential backoff, clients that
+/// failed at the same moment do not retry in lock-step afterwards.
+/// </summary>
+class Backoff_DecorrelatedJitter : public IBackoff {
+  public:
+    /// <summary>
+    /// Initializes the decorrelated jitter backoff calculator.
+    /// The first value is already randomized in <c>[baseValue, baseValue * 3]</c>.
+    /// </summary>
+    /// <param name="baseValue">Minimum backoff value</param>
+    /// <param name="maximumValue">Maximum possible backoff value</param>
+    Backoff_DecorrelatedJitter(int baseValue, int maximumValue)
+      : m_baseValue(baseValue),
+        m_maximumValue(maximumValue)
+    {
+        reset_private();
+    }
+
+    bool good() const
+    {
+        return (m_baseValue > 0) && (m_baseValue <= m_maximumValue);
+    }
+
+    virtual void reset() override
+    {
+        reset_private();
+    }
+
+    virtual void increase() override
+    {
+        increase_private();
+    }
+
+    virtual int getValue() override
+    {
+        return static_cast<int>(floor(m_currentValue));
+    }
+
+  protected:
+    double m_baseValue {}, m_maximumValue {};
+    double m_currentValue {};
+    PAL::PseudoRandomGenerator m_rand;
+
+private:
+    // Private implementation of reset--exists to avoid calling virtual methods in ctor
+    void reset_private()
+    {
+        m_currentValue = m_baseValue;
+        increase_private();
+    }
+
+    // Private implementation of increase--exists to avoid calling virtual methods in ctor
+    void increase_private()
+    {
+        double upper = std::min(m_maximumValue, m_currentValue * 3);
+        double value = m_baseValue + m_rand.getRandomDouble() * std::max(0.0, upper - m_baseValue);
+        m_currentValue = floor(std::min(m_maximumValue, std::max(m_baseValue, value)));
+    }
+};
+
+
+} MAT_NS_END
+#endif
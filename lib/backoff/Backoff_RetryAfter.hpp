@@ -0,0 +1,80 @@
+//
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// SPDX-License-Identifier: Apache-2.0
+//
+#ifndef BACKOFF_RETRYAFTER_HPP
+#define BACKOFF_RETRYAFTER_HPP
+
+#include "backoff/IBackoff.hpp"
+#include "pal/PseudoRandomGenerator.hpp"
+
+#include <algorithm>
+#include <math.h>
+
+namespace MAT_NS_BEGIN {
+
+
+/// <summary>
+/// Backoff decorator honoring server hints (<c>Retry-After</c>). While a hint
+/// is pending, the value is never shorter than the hint plus a random spread,
+/// so that clients told to come back at the same time do not all return in
+/// the same second. Otherwise the wrapped backoff is used unchanged.
+/// </summary>
+class Backoff_RetryAfter : public IBackoff {
+  public:
+    /// <summary>
+    /// Initializes the decorator.
+    /// </summary>
+    /// <param name="inner">Backoff used when the server gave no hint</param>
+    /// <param name="spread">Random spread added to the hint, as a fraction of it</param>
+    Backoff_RetryAfter(std::unique_ptr<IBackoff>&& inner, double spread)
+      : m_inner(std::move(inner)),
+        m_spread(spread)
+    {
+    }
+
+    bool good() const
+    {
+        return m_inner && (m_spread >= 0.0);
+    }
+
+    virtual void reset() override
+    {
+        m_inner->reset();
+        m_retryAfterMs = 0;
+    }
+
+    /// <summary>
+    /// Consumes the pending hint (if any) and steps the wrapped backoff.
+    /// </summary>
+    virtual void increase() override
+    {
+        m_inner->increase();
+        m_retryAfterMs = 0;
+    }
+
+    virtual int getValue() override
+    {
+        int value = m_inner->getValue();
+        if (m_retryAfterMs > 0) {
+            double hinted = m_retryAfterMs + m_rand.getRandomDouble() * m_retryAfterMs * m_spread;
+            value = std::max(value, static_cast<int>(floor(hinted)));
+        }
+        return value;
+    }
+
+    virtual void setRetryAfter(int delayMs) override
+    {
+        m_retryAfterMs = std::max(0, delayMs);
+    }
+
+  protected:
+    std::unique_ptr<IBackoff> m_inner;
+    double m_spread {};
+    int m_retryAfterMs {};
+    PAL::PseudoRandomGenerator m_rand;
+};
+
+
+} MAT_NS_END
+#endif
@@ -5,6 +5,9 @@
 
 #include "IBackoff.hpp"
 #include "Backoff_ExponentialWithJitter.hpp"
+#include "Backoff_DecorrelatedJitter.hpp"
+#include "Backoff_RetryAfter.hpp"
+#include <iterator>
 #include <sstream>
 
 namespace MAT_NS_BEGIN {
@@ -36,6 +39,30 @@ std::unique_ptr<IBackoff> IBackoff::createFromConfig(std::string const& config)
             }
         }
     }
+    else if (kind == 'D') {
+        // "D,baseDelayMs,maximumDelayMs"
+        char sep = {};
+        int baseDelayMs, maximumDelayMs;
+        is >> baseDelayMs >> sep >> maximumDelayMs;
+        if (!is.fail() && is.get() == EOF && sep == ',') {
+            result.reset(new Backoff_DecorrelatedJitter(baseDelayMs, maximumDelayMs));
+            if (!static_cast<Backoff_DecorrelatedJitter*>(result.get())->good()) {
+                result.reset();
+            }
+        }
+    }
+    else if (kind == 'R') {
+        // "R,spread,<inner backoff config>"
+        double spread;
+        is >> spread;
+        if (!is.fail() && is.get() == ',') {
+            std::string inner((std::istreambuf_iterator<char>(is)), std::istreambuf_iterator<char>());
+            result.reset(new Backoff_RetryAfter(createFromConfig(inner), spread));
+            if (!static_cast<Backoff_RetryAfter*>(result.get())->good()) {
+                result.reset();
+            }
+        }
+    }
 
     return result;
 }
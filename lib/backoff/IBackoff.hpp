@@ -37,6 +37,16 @@ class IBackoff {
     /// <returns>Current backoff value</returns>
     virtual int getValue() = 0;
 
+    /// <summary>
+    /// Passes a server requested retry delay (e.g. <c>Retry-After</c>) for the
+    /// next step. Strategies not honoring server hints ignore it.
+    /// </summary>
+    /// <param name="delayMs">Requested delay in milliseconds</param>
+    virtual void setRetryAfter(int delayMs)
+    {
+        UNREFERENCED_PARAMETER(delayMs);
+    }
+
     /// <summary>
     /// Factory for creating new backoff objects.
     /// </summary>
@@ -15,7 +15,7 @@ class BondSerializer {
     bool handleSerialize(IncomingEventContextPtr const& ctx);
 
   public:
-    RoutePassThrough<BondSerializer, IncomingEventContextPtr const&> serialize{this, &BondSerializer::handleSerialize};
+    MAT_BOUND_ROUTE(BondSerializer, handleSerialize) serialize{this, "serialize"};
 };
 
 
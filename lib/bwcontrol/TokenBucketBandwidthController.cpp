@@ -0,0 +1,140 @@
+//
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// SPDX-License-Identifier: Apache-2.0
+//
+
+#include "TokenBucketBandwidthController.hpp"
+#include "utils/StringUtils.hpp"
+
+#include <algorithm>
+#include <climits>
+#include <cmath>
+
+namespace MAT_NS_BEGIN {
+
+    MATSDK_LOG_INST_COMPONENT_CLASS(TokenBucketBandwidthController, "EventsSDK.BandwidthController", "Events telemetry client - TokenBucketBandwidthController class");
+
+    TokenBucketBandwidthController::TokenBucketBandwidthController(unsigned rateBps, unsigned burstBytes) :
+        m_rateBps(rateBps),
+        m_burstBytes(burstBytes)
+    {
+        for (auto& bucket : m_buckets)
+        {
+            bucket.rateBps = rateBps;
+            bucket.tokens = burstBytes;
+        }
+    }
+
+    std::unique_ptr<TokenBucketBandwidthController> TokenBucketBandwidthController::createFromConfig(IRuntimeConfig& config)
+    {
+        std::unique_ptr<TokenBucketBandwidthController> result;
+
+        VariantMap& tpmConfig = config[CFG_MAP_TPM];
+        auto it = tpmConfig.find(CFG_INT_TPM_BANDWIDTH_BPS);
+        if (it == tpmConfig.end() || it->second.type != Variant::TYPE_INT)
+        {
+            return result;
+        }
+        int64_t rateBps = it->second;
+        if (rateBps <= 0)
+        {
+            return result;
+        }
+
+        // Default burst lets one full-size request go out without waiting
+        int64_t burstBytes = config.GetMaximumUploadSizeBytes();
+        it = tpmConfig.find(CFG_INT_TPM_BANDWIDTH_BURST);
+        if (it != tpmConfig.end() && it->second.type == Variant::TYPE_INT)
+        {
+            int64_t burst = it->second;
+            burstBytes = burst;
+        }
+
+        result.reset(new TokenBucketBandwidthController(
+            static_cast<unsigned>(std::min<int64_t>(rateBps, UINT_MAX)),
+            static_cast<unsigned>(std::max<int64_t>(0, std::min<int64_t>(burstBytes, UINT_MAX)))));
+
+        it = tpmConfig.find(CFG_MAP_TPM_BANDWIDTH_LATENCY_BPS);
+        if (it != tpmConfig.end() && it->second.type == Variant::TYPE_OBJ)
+        {
+            VariantMap& rates = it->second;
+            for (int latency = EventLatency_Off; latency <= EventLatency_Max; latency++)
+            {
+                auto rate = rates.find(latencyToStr(static_cast<EventLatency>(latency)));
+                if (rate != rates.end() && rate->second.type == Variant::TYPE_INT)
+                {
+                    int64_t latencyRateBps = rate->second;
+                    result->setLatencyRate(static_cast<EventLatency>(latency),
+                        static_cast<unsigned>(std::max<int64_t>(0, std::min<int64_t>(latencyRateBps, UINT_MAX))));
+                }
+            }
+        }
+        return result;
+    }
+
+    void TokenBucketBandwidthController::setLatencyRate(EventLatency latency, unsigned rateBps)
+    {
+        LOCKGUARD(m_lock);
+        getBucket(latency).rateBps = rateBps;
+    }
+
+    uint64_t TokenBucketBandwidthController::getMonotonicTimeMs() const
+    {
+        return PAL::getMonotonicTimeMs();
+    }
+
+    TokenBucketBandwidthController::Bucket& TokenBucketBandwidthController::getBucket(EventLatency latency)
+    {
+        if (latency < EventLatency_Off || latency > EventLatency_Max)
+        {
+            latency = EventLatency_Normal;
+        }
+        return m_buckets[latency];
+    }
+
+    void TokenBucketBandwidthController::refill(Bucket& bucket, uint64_t nowMs) const
+    {
+        if (nowMs > bucket.lastRefillMs)
+        {
+            double added = static_cast<double>(bucket.rateBps) * static_cast<double>(nowMs - bucket.lastRefillMs) / 1000.0;
+            bucket.tokens = std::min(static_cast<double>(m_burstBytes), bucket.tokens + added);
+        }
+        bucket.lastRefillMs = nowMs;
+    }
+
+    unsigned TokenBucketBandwidthController::GetProposedBandwidthBps()
+    {
+        return m_rateBps;
+    }
+
+    void TokenBucketBandwidthController::OnBytesSent(EventLatency latency, size_t bytes)
+    {
+        LOCKGUARD(m_lock);
+        Bucket& bucket = getBucket(latency);
+        if (bucket.rateBps == 0)
+        {
+            return;
+        }
+        refill(bucket, getMonotonicTimeMs());
+        bucket.tokens -= static_cast<double>(bytes);
+        LOG_TRACE("Sent %u bytes of lat=%d, %.0f bytes of budget left",
+            static_cast<unsigned>(bytes), latency, bucket.tokens);
+    }
+
+    unsigned TokenBucketBandwidthController::GetSendDelayMs(EventLatency latency)
+    {
+        LOCKGUARD(m_lock);
+        Bucket& bucket = getBucket(latency);
+        if (bucket.rateBps == 0)
+        {
+            return 0;
+        }
+        refill(bucket, getMonotonicTimeMs());
+        if (bucket.tokens >= 0)
+        {
+            return 0;
+        }
+        return static_cast<unsigned>(std::ceil(-bucket.tokens * 1000.0 / bucket.rateBps));
+    }
+
+} MAT_NS_END
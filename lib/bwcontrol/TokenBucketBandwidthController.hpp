@@ -0,0 +1,65 @@
+//
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// SPDX-License-Identifier: Apache-2.0
+//
+#ifndef TOKENBUCKETBANDWIDTHCONTROLLER_HPP
+#define TOKENBUCKETBANDWIDTHCONTROLLER_HPP
+
+#include "IBandwidthController.hpp"
+#include "api/IRuntimeConfig.hpp"
+#include "pal/PAL.hpp"
+
+#include <memory>
+#include <mutex>
+
+namespace MAT_NS_BEGIN {
+
+    /// <summary>
+    /// Portable bandwidth shaping with one token bucket per event latency.
+    /// Each bucket refills at its rate up to the burst size. Bytes are charged
+    /// when a request is sent, so a large request may put the bucket in debt;
+    /// further uploads of that latency are delayed until the debt is paid off.
+    /// </summary>
+    class TokenBucketBandwidthController : public IBandwidthController
+    {
+    public:
+        TokenBucketBandwidthController(unsigned rateBps, unsigned burstBytes);
+
+        /// <summary>
+        /// Creates the controller from CFG_MAP_TPM bandwidth settings.
+        /// </summary>
+        /// <returns>nullptr if bandwidth shaping is not configured</returns>
+        static std::unique_ptr<TokenBucketBandwidthController> createFromConfig(IRuntimeConfig& config);
+
+        /// <summary>
+        /// Overrides the rate of one latency bucket (0 = unlimited).
+        /// </summary>
+        void setLatencyRate(EventLatency latency, unsigned rateBps);
+
+        virtual unsigned GetProposedBandwidthBps() override;
+        virtual void OnBytesSent(EventLatency latency, size_t bytes) override;
+        virtual unsigned GetSendDelayMs(EventLatency latency) override;
+
+    protected:
+        struct Bucket
+        {
+            unsigned rateBps { 0 };
+            double   tokens { 0.0 };
+            uint64_t lastRefillMs { 0 };
+        };
+
+        virtual uint64_t getMonotonicTimeMs() const;
+        Bucket& getBucket(EventLatency latency);
+        void refill(Bucket& bucket, uint64_t nowMs) const;
+
+        std::mutex  m_lock;
+        unsigned    m_rateBps;
+        unsigned    m_burstBytes;
+        Bucket      m_buckets[EventLatency_Max + 1];
+
+        MATSDK_LOG_DECL_COMPONENT_CLASS();
+    };
+
+} MAT_NS_END
+
+#endif // TOKENBUCKETBANDWIDTHCONTROLLER_HPP
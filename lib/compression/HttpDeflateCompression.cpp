@@ -35,6 +35,7 @@ namespace MAT_NS_BEGIN {
         if (!m_config.IsHttpRequestCompressionEnabled()) {
             return true;
         }
+        const int64_t startMs = static_cast<int64_t>(PAL::getMonotonicTimeMs());
 
         // Using a slightly adapted in-place compression technique as suggested
         // by Mark Adler himself: http://stackoverflow.com/a/12412863/3543211
@@ -87,6 +88,7 @@ namespace MAT_NS_BEGIN {
 
         ctx->body.resize(stream.total_out);
         ctx->compressed = true;
+        ctx->compressionMs = static_cast<int>(static_cast<int64_t>(PAL::getMonotonicTimeMs()) - startMs);
 #endif
         return true;
     }
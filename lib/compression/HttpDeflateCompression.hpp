@@ -26,7 +26,7 @@ namespace MAT_NS_BEGIN {
 
     public:
         RouteSource<EventsUploadContextPtr const&>                              compressionFailed;
-        RoutePassThrough<HttpDeflateCompression, EventsUploadContextPtr const&> compress{ this, &HttpDeflateCompression::handleCompress };
+        RoutePassThrough<HttpDeflateCompression, EventsUploadContextPtr const&> compress{ this, &HttpDeflateCompression::handleCompress, "compress" };
     };
 
 } MAT_NS_END
@@ -16,14 +16,24 @@ namespace MAT_NS_BEGIN
         {CFG_BOOL_ENABLE_ANALYTICS, false},
         {CFG_INT_CACHE_FILE_SIZE, 3145728},
         {CFG_INT_RAM_QUEUE_SIZE, 524288},
+        {CFG_BOOL_ASYNC_STORAGE_OPEN, false},
+        {CFG_BOOL_CACHE_SYSTEM_INFO, false},
         {CFG_BOOL_ENABLE_MULTITENANT, true},
         {CFG_BOOL_ENABLE_DB_DROP_IF_FULL, false},
         {CFG_INT_MAX_TEARDOWN_TIME, 1},
         {CFG_INT_MAX_PENDING_REQ, 4},
         {CFG_INT_RAM_QUEUE_BUFFERS, 3},
+        {CFG_STR_SHARED_QUEUE_PATH, ""},
+        {CFG_INT_SHARED_QUEUE_SIZE, 8388608},
+        {CFG_BOOL_SHARED_QUEUE_UPLOAD, true},
         {CFG_INT_TRACE_LEVEL_MASK, 0},
         {CFG_BOOL_ENABLE_TRACE, true},
+        {CFG_INT_TRACE_FILE_SIZE, 16000000},
+        {CFG_BOOL_ENABLE_PIPELINE_TRACE, false},
         {CFG_STR_COLLECTOR_URL, COLLECTOR_URL_PROD},
+        {CFG_STR_COLLECTOR_ALTERNATE_URLS, ""},
+        {CFG_STR_COLLECTOR_SELECTION, "primary"},
+        {CFG_INT_COLLECTOR_BREAKER_COOLDOWN, 30000},
         {CFG_INT_STORAGE_FULL_PCT, 75},
         {CFG_INT_STORAGE_FULL_CHECK_TIME, 5000},
         {CFG_INT_RAMCACHE_FULL_PCT, 75},
@@ -32,6 +42,7 @@ namespace MAT_NS_BEGIN
         {CFG_MAP_METASTATS_CONFIG,
          {/* Parameter that allows to split stats events by tenant */
           {"split", false},
+          {CFG_BOOL_METASTATS_DELIVERY_LATENCY, false},
           {"interval", 1800},
           {"tokenProd", STATS_TOKEN_PROD},
           {"tokenInt", STATS_TOKEN_INT}}},
@@ -57,21 +68,40 @@ namespace MAT_NS_BEGIN
              ,
              {"contentEncoding", "deflate"},
              /* Optional parameter to require Microsoft Root CA */
-             {CFG_BOOL_HTTP_MS_ROOT_CHECK, false}}},
+             {CFG_BOOL_HTTP_MS_ROOT_CHECK, false},
+             /* Optional Unix domain socket of a local forwarder */
+             {CFG_STR_HTTP_LOCAL_AGENT_SOCKET, ""},
+             /* Optional pre-connect to the collector at startup */
+             {CFG_BOOL_HTTP_PREWARM, false},
+             /* Optional TLS session cache kept across restarts */
+             {CFG_BOOL_HTTP_PERSIST_TLS_SESSIONS, false}}},
         {CFG_MAP_TPM,
          {
              {CFG_INT_TPM_MAX_BLOB_BYTES, 2097152},
              {CFG_INT_TPM_MAX_RETRY, 5},
              {CFG_BOOL_TPM_CLOCK_SKEW_ENABLED, true},
              {CFG_STR_TPM_BACKOFF, "E,3000,300000,2,1"},
+             {CFG_BOOL_TPM_FAIR_UPLOAD, false},
+             {CFG_BOOL_TPM_EVENT_TRIGGERS, false},
+             {CFG_INT_TPM_WATERMARK_COUNT, 100},
+             {CFG_INT_TPM_WATERMARK_BYTES, 262144},
+             {CFG_INT_TPM_BANDWIDTH_BPS, 0},
          }},
         {CFG_MAP_COMPAT,
          {
              {CFG_BOOL_COMPAT_DOTS, true}, // false: v1 backwards-compat: event.SetType("My.Custom.Type") => custom.my_custom_type
              {CFG_STR_COMPAT_PREFIX, EVENTRECORD_TYPE_CUSTOM_EVENT} // custom type prefix for Interchange / Geneva / Cosmos flow
          }},
-        {"sample",
-         {{"rate", 0}}}};
+        {CFG_MAP_SAMPLE,
+         {{CFG_INT_SAMPLE_RATE, 0},
+          {CFG_STR_SAMPLE_KEY, "device"}}},
+        {CFG_MAP_METRICS,
+         {{CFG_BOOL_METRICS_AGGREGATE_SAMPLED, false},
+          {CFG_INT_METRICS_INTERVAL, 60},
+          {CFG_INT_METRICS_MAX_SERIES, 1000}}},
+        {CFG_MAP_COALESCE,
+         {{CFG_INT_COALESCE_WINDOW_MS, 0},
+          {CFG_INT_COALESCE_MAX_ENTRIES, 256}}}};
 
     /// <summary>
     /// This class overlays a custom configuration provided by the customer
@@ -3,6 +3,10 @@
 // SPDX-License-Identifier: Apache-2.0
 //
 #include <algorithm>
+#include <array>
+#include <functional>
+#include <string>
+#include <tuple>
 #include "EventFilterCollection.hpp"
 #include "ctmacros.hpp"
 
@@ -13,6 +17,138 @@
 
 namespace MAT_NS_BEGIN
 {
+    /// <summary>
+    /// Immutable set of filters with a lock-free decision cache for the
+    /// cacheable ones. Entries are only ever added, never replaced, and are
+    /// released together with the snapshot.
+    /// </summary>
+    class EventFilterCollection::FilterSnapshot
+    {
+    public:
+        FilterSnapshot(std::vector<std::shared_ptr<IEventFilter>> const& filters)
+        {
+            for (auto const& filter : filters)
+            {
+                (filter->IsDecisionCacheable() ? m_cacheable : m_uncached).push_back(filter);
+            }
+            for (auto& slot : m_slots)
+            {
+                slot.store(nullptr, std::memory_order_relaxed);
+            }
+        }
+
+        ~FilterSnapshot()
+        {
+            for (auto& slot : m_slots)
+            {
+                delete slot.load(std::memory_order_relaxed);
+            }
+        }
+
+        bool CanEventPropertiesBeSent(const EventProperties& properties) const noexcept
+        {
+            return CanBeSentByCacheable(properties) &&
+                std::all_of(m_uncached.cbegin(), m_uncached.cend(),
+                    [&properties](const std::shared_ptr<IEventFilter>& filter)
+                    {
+                        return filter->CanEventPropertiesBeSent(properties);
+                    });
+        }
+
+    private:
+        struct Decision
+        {
+            std::string name;
+            std::tuple<bool, uint8_t> level;
+            bool canBeSent;
+        };
+
+        static constexpr size_t CacheSlots = 256;
+        static constexpr size_t MaxProbes = 8;
+
+        bool CanBeSentByCacheable(const EventProperties& properties) const noexcept
+        {
+            if (m_cacheable.empty())
+            {
+                return true;
+            }
+
+            std::string const& name = properties.GetName();
+            std::tuple<bool, uint8_t> level = properties.TryGetLevel();
+            size_t hash = std::hash<std::string>()(name) ^ (static_cast<size_t>(std::get<1>(level)) * 0x9E3779B1u);
+
+            size_t probe = 0;
+            for (; probe < MaxProbes; probe++)
+            {
+                const Decision* decision = m_slots[(hash + probe) % CacheSlots].load(std::memory_order_acquire);
+                if (decision == nullptr)
+                {
+                    break;
+                }
+                if (decision->level == level && decision->name == name)
+                {
+                    return decision->canBeSent;
+                }
+            }
+
+            bool canBeSent = std::all_of(m_cacheable.cbegin(), m_cacheable.cend(),
+                [&properties](const std::shared_ptr<IEventFilter>& filter)
+                {
+                    return filter->CanEventPropertiesBeSent(properties);
+                });
+            if (probe < MaxProbes)
+            {
+                remember(hash, probe, name, level, canBeSent);
+            }
+            return canBeSent;
+        }
+
+        // Best effort: called only with a free slot at firstProbe, so a full cache costs no
+        // allocation; when other threads take the remaining slots first, the decision is not cached
+        void remember(size_t hash, size_t firstProbe, std::string const& name, std::tuple<bool, uint8_t> level, bool canBeSent) const noexcept
+        {
+            Decision* decision = nullptr;
+            try
+            {
+                decision = new Decision { name, level, canBeSent };
+            }
+            catch (...)
+            {
+                return;
+            }
+
+            for (size_t probe = firstProbe; probe < MaxProbes; probe++)
+            {
+                const Decision* expected = nullptr;
+                if (m_slots[(hash + probe) % CacheSlots].compare_exchange_strong(expected, decision, std::memory_order_acq_rel))
+                {
+                    return;
+                }
+                if (expected->level == level && expected->name == name)
+                {
+                    // Another thread cached the same decision meanwhile
+                    break;
+                }
+            }
+            delete decision;
+        }
+
+        std::vector<std::shared_ptr<IEventFilter>> m_cacheable;
+        std::vector<std::shared_ptr<IEventFilter>> m_uncached;
+        mutable std::array<std::atomic<const Decision*>, CacheSlots> m_slots;
+    };
+
+    void EventFilterCollection::publishSnapshot()
+    {
+        std::shared_ptr<const FilterSnapshot> snapshot;
+        if (!m_filters.empty())
+        {
+            snapshot = std::make_shared<const FilterSnapshot>(m_filters);
+        }
+        std::atomic_store(&m_snapshot, snapshot);
+        m_size = m_filters.size();
+    }
+
     void EventFilterCollection::RegisterEventFilter(std::unique_ptr<IEventFilter>&& filter)
     {
         if (filter == nullptr)
@@ -20,7 +156,7 @@ namespace MAT_NS_BEGIN
 
         std::lock_guard<std::mutex> lock(m_filterLock);
         m_filters.emplace_back(std::move(filter));
-        m_size = m_filters.size();
+        publishSnapshot();
     }
 
     void EventFilterCollection::UnregisterEventFilter(const char* filterName)
@@ -31,19 +167,19 @@ namespace MAT_NS_BEGIN
         std::lock_guard<std::mutex> lock(m_filterLock);
         m_filters.erase(
             std::remove_if(m_filters.begin(), m_filters.end(), 
-                [filterName](const std::unique_ptr<IEventFilter>& filter) noexcept
+                [filterName](const std::shared_ptr<IEventFilter>& filter) noexcept
                 {
                     return strcmp(filter->GetName(), filterName) == 0;
                 }),
             m_filters.end());
-        m_size = m_filters.size();
+        publishSnapshot();
     }
 
     void EventFilterCollection::UnregisterAllFilters() noexcept
     {
         std::lock_guard<std::mutex> lock(m_filterLock);
-        std::vector<std::unique_ptr<IEventFilter>>{}.swap(m_filters);
-        m_size = 0;
+        std::vector<std::shared_ptr<IEventFilter>>{}.swap(m_filters);
+        publishSnapshot();
     }
 
     bool EventFilterCollection::CanEventPropertiesBeSent(const EventProperties& properties) const noexcept
@@ -52,12 +188,9 @@ namespace MAT_NS_BEGIN
         {
             return true;
         }
-        std::lock_guard<std::mutex> lock(m_filterLock);
-        return std::all_of(m_filters.cbegin(), m_filters.cend(), 
-            [&properties](const std::unique_ptr<IEventFilter>& filter)
-            {
-                return filter->CanEventPropertiesBeSent(properties);
-            });
+        // Filters unregistered meanwhile stay alive until the snapshot is released
+        std::shared_ptr<const FilterSnapshot> snapshot = std::atomic_load(&m_snapshot);
+        return (snapshot == nullptr) || snapshot->CanEventPropertiesBeSent(properties);
     }
 
     size_t EventFilterCollection::Size() const noexcept
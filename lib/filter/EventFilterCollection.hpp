@@ -15,6 +15,13 @@
 
 namespace MAT_NS_BEGIN
 {
+    /// <summary>
+    /// Thread-safe collection of event filters. Readers work on an immutable
+    /// snapshot of the registered filters and never take the registration lock.
+    /// Decisions of filters declaring IsDecisionCacheable() are memoized per
+    /// (event name, level) in the snapshot, so a new snapshot (and an empty
+    /// cache) is published whenever filters are registered or unregistered.
+    /// </summary>
     class EventFilterCollection : public IEventFilterCollection
     {
     public:
@@ -26,9 +33,16 @@ namespace MAT_NS_BEGIN
         virtual bool Empty() const noexcept override;
 
     protected:
+        class FilterSnapshot;
+
+        // Must be called with m_filterLock held
+        void publishSnapshot();
+
         std::atomic<size_t> m_size { 0 };
         mutable std::mutex m_filterLock;
-        std::vector<std::unique_ptr<IEventFilter>> m_filters;
+        std::vector<std::shared_ptr<IEventFilter>> m_filters;
+        // Only accessed through std::atomic_load / std::atomic_store
+        std::shared_ptr<const FilterSnapshot> m_snapshot;
     };
 
 } MAT_NS_END
@@ -0,0 +1,218 @@
+//
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// SPDX-License-Identifier: Apache-2.0
+//
+#include "EventSampler.hpp"
+
+#include "pal/PAL.hpp"
+#include "utils/Utils.hpp"
+
+#include <algorithm>
+
+namespace MAT_NS_BEGIN
+{
+    namespace
+    {
+        bool TryGetRate(VariantMap& map, double& rate)
+        {
+            auto it = map.find(CFG_INT_SAMPLE_RATE);
+            if (it == map.end())
+            {
+                return false;
+            }
+            Variant& value = it->second;
+            if (value.type == Variant::TYPE_INT)
+            {
+                int64_t intRate = value;
+                rate = static_cast<double>(intRate);
+            }
+            else if (value.type == Variant::TYPE_DOUBLE)
+            {
+                double doubleRate = value;
+                rate = doubleRate;
+            }
+            else
+            {
+                return false;
+            }
+            rate = std::max(0.0, std::min(rate, EventSampler::FullRate));
+            return true;
+        }
+
+        std::string TryGetString(VariantMap& map, const char* key)
+        {
+            auto it = map.find(key);
+            if (it == map.end() || (it->second.type != Variant::TYPE_STRING && it->second.type != Variant::TYPE_STRING2))
+            {
+                return std::string();
+            }
+            const char* value = it->second;
+            return (value != nullptr) ? std::string(value) : std::string();
+        }
+    }
+
+    constexpr double EventSampler::FullRate;
+    constexpr uint32_t EventSampler::BucketCount;
+
+    EventSampler::EventSampler() noexcept :
+        m_defaultRate(FullRate),
+        m_bucket(0),
+        m_enabled(false)
+    {
+    }
+
+    EventSampler::EventSampler(ILogConfiguration& configuration) :
+        EventSampler()
+    {
+        if (!configuration.HasConfig(CFG_MAP_SAMPLE))
+        {
+            return;
+        }
+        Variant& sampleConfig = configuration[CFG_MAP_SAMPLE];
+        if (sampleConfig.type != Variant::TYPE_OBJ)
+        {
+            return;
+        }
+        VariantMap& config = sampleConfig;
+
+        // Legacy configurations use rate 0 for "no sampling"
+        double defaultRate = FullRate;
+        if (TryGetRate(config, defaultRate) && defaultRate > 0)
+        {
+            m_defaultRate = defaultRate;
+        }
+
+        auto rules = config.find(CFG_ARR_SAMPLE_RULES);
+        if (rules != config.end() && rules->second.type == Variant::TYPE_ARR)
+        {
+            VariantArray& ruleArray = rules->second;
+            for (auto& item : ruleArray)
+            {
+                if (item.type != Variant::TYPE_OBJ)
+                {
+                    continue;
+                }
+                VariantMap& ruleConfig = item;
+                Rule rule;
+                if (!TryGetRate(ruleConfig, rule.rate))
+                {
+                    continue;
+                }
+                rule.tenantId = TryGetString(ruleConfig, "tenant");
+                rule.eventName = TryGetString(ruleConfig, "event");
+                if (!rule.eventName.empty() && rule.eventName.back() == '*')
+                {
+                    rule.eventName.pop_back();
+                    rule.eventIsPrefix = true;
+                }
+                auto level = ruleConfig.find("level");
+                if (level != ruleConfig.end() && level->second.type == Variant::TYPE_INT)
+                {
+                    int64_t levelValue = level->second;
+                    rule.anyLevel = false;
+                    rule.level = static_cast<uint8_t>(levelValue);
+                }
+                m_rules.push_back(std::move(rule));
+            }
+        }
+
+        m_enabled = (m_defaultRate < FullRate) ||
+            std::any_of(m_rules.cbegin(), m_rules.cend(), [](Rule const& rule) { return rule.rate < FullRate; });
+        if (!m_enabled)
+        {
+            return;
+        }
+
+        std::string key = TryGetString(config, CFG_STR_SAMPLE_KEY);
+        std::string samplingId;
+        if (key.empty() || key == "device")
+        {
+            auto deviceInformation = PAL::GetDeviceInformation();
+            if (deviceInformation)
+            {
+                samplingId = deviceInformation->GetDeviceId();
+            }
+        }
+        else if (key != "session")
+        {
+            samplingId = key;
+        }
+        if (samplingId.empty())
+        {
+            // Session key, or no device ID available: decisions are stable for this instance only
+            samplingId = PAL::generateUuidString();
+        }
+        m_bucket = GetBucket(samplingId);
+    }
+
+    double EventSampler::GetSampleRate(std::string const& tenantToken, std::string const& eventName, uint8_t level) const noexcept
+    {
+        for (auto const& rule : m_rules)
+        {
+            if ((rule.anyLevel || rule.level == level) && MatchesEvent(rule, eventName) && MatchesTenant(rule, tenantToken))
+            {
+                return rule.rate;
+            }
+        }
+        return m_defaultRate;
+    }
+
+    bool EventSampler::IsSampledIn(double sampleRate) const noexcept
+    {
+        if (sampleRate >= FullRate)
+        {
+            return true;
+        }
+        return m_bucket < static_cast<uint32_t>(sampleRate * (BucketCount / FullRate));
+    }
+
+    uint32_t EventSampler::GetBucket(std::string const& samplingId) noexcept
+    {
+        return hashCode(samplingId.c_str()) % BucketCount;
+    }
+
+    std::atomic<unsigned>& EventSampler::GetSampledOutCounter(std::string const& tenantToken) const
+    {
+        LOCKGUARD(m_sampledOutLock);
+        // Map nodes are never erased, so the reference stays valid for the sampler lifetime
+        return m_sampledOut[tenantToken];
+    }
+
+    void EventSampler::TakeSampledOut(std::map<std::string, unsigned>& counts) const
+    {
+        LOCKGUARD(m_sampledOutLock);
+        for (auto& item : m_sampledOut)
+        {
+            unsigned count = item.second.exchange(0, std::memory_order_relaxed);
+            if (count > 0)
+            {
+                counts[item.first] += count;
+            }
+        }
+    }
+
+    bool EventSampler::MatchesTenant(Rule const& rule, std::string const& tenantToken) noexcept
+    {
+        // Tenant token format is "<tenantId>-<key>"
+        if (rule.tenantId.empty())
+        {
+            return true;
+        }
+        if (tenantToken.compare(0, rule.tenantId.size(), rule.tenantId) != 0)
+        {
+            return false;
+        }
+        return (tenantToken.size() == rule.tenantId.size()) || (tenantToken[rule.tenantId.size()] == '-');
+    }
+
+    bool EventSampler::MatchesEvent(Rule const& rule, std::string const& eventName) noexcept
+    {
+        if (rule.eventIsPrefix)
+        {
+            return eventName.compare(0, rule.eventName.size(), rule.eventName) == 0;
+        }
+        return rule.eventName.empty() || (rule.eventName == eventName);
+    }
+
+}
+MAT_NS_END
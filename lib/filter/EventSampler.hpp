@@ -0,0 +1,115 @@
+//
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// SPDX-License-Identifier: Apache-2.0
+//
+#ifndef EVENTSAMPLER_HPP
+#define EVENTSAMPLER_HPP
+
+#include "ctmacros.hpp"
+#include "ILogConfiguration.hpp"
+
+#include <atomic>
+#include <cstdint>
+#include <map>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace MAT_NS_BEGIN
+{
+    /// <summary>
+    /// Client-side population sampling. Rules from the CFG_MAP_SAMPLE configuration
+    /// assign a sample rate (in percent) to events selected by tenant, event name and
+    /// diagnostic level. Keep/drop decisions compare the rate against a bucket derived
+    /// from a stable sampling ID, so a device keeps or drops all events sampled at the
+    /// same rate and its decisions do not change between sessions.
+    /// </summary>
+    class EventSampler
+    {
+    public:
+        /// <summary>Rate of events that are not sampled.</summary>
+        static constexpr double FullRate = 100.0;
+
+        /// <summary>Number of buckets sampling IDs are hashed into (0.01% resolution).</summary>
+        static constexpr uint32_t BucketCount = 10000;
+
+        /// <summary>
+        /// Creates a sampler that keeps every event.
+        /// </summary>
+        EventSampler() noexcept;
+
+        /// <summary>
+        /// Creates a sampler from the CFG_MAP_SAMPLE section of the configuration.
+        /// </summary>
+        explicit EventSampler(ILogConfiguration& configuration);
+
+        /// <summary>
+        /// Returns true when at least one event can be sampled out.
+        /// </summary>
+        bool IsEnabled() const noexcept
+        {
+            return m_enabled;
+        }
+
+        /// <summary>
+        /// Returns the sample rate in percent of the first rule matching the event,
+        /// the default rate if none matches.
+        /// </summary>
+        double GetSampleRate(std::string const& tenantToken, std::string const& eventName, uint8_t level) const noexcept;
+
+        /// <summary>
+        /// Returns true if this device keeps events sampled at the given rate.
+        /// </summary>
+        bool IsSampledIn(double sampleRate) const noexcept;
+
+        /// <summary>
+        /// Bucket of this device in the [0, BucketCount) range.
+        /// </summary>
+        uint32_t GetBucket() const noexcept
+        {
+            return m_bucket;
+        }
+
+        /// <summary>
+        /// Maps a sampling ID to its bucket.
+        /// </summary>
+        static uint32_t GetBucket(std::string const& samplingId) noexcept;
+
+        /// <summary>
+        /// Returns the counter of sampled out events of a tenant. Loggers keep a reference
+        /// to it, so that dropping an event costs one atomic increment.
+        /// </summary>
+        std::atomic<unsigned>& GetSampledOutCounter(std::string const& tenantToken) const;
+
+        /// <summary>
+        /// Adds the per-tenant counts of events sampled out since the previous call to counts.
+        /// </summary>
+        void TakeSampledOut(std::map<std::string, unsigned>& counts) const;
+
+    protected:
+        struct Rule
+        {
+            std::string tenantId;
+            std::string eventName;
+            bool eventIsPrefix = false;
+            bool anyLevel = true;
+            uint8_t level = 0;
+            double rate = FullRate;
+        };
+
+        static bool MatchesTenant(Rule const& rule, std::string const& tenantToken) noexcept;
+        static bool MatchesEvent(Rule const& rule, std::string const& eventName) noexcept;
+
+        std::vector<Rule> m_rules;
+        double m_defaultRate;
+        uint32_t m_bucket;
+        bool m_enabled;
+
+        mutable std::mutex m_sampledOutLock;
+        mutable std::map<std::string, std::atomic<unsigned>> m_sampledOut;
+    };
+
+}
+MAT_NS_END
+
+#endif
@@ -0,0 +1,297 @@
+//
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// SPDX-License-Identifier: Apache-2.0
+//
+#include "CollectorEndpointPool.hpp"
+
+#include "IHttpClient.hpp"
+
+#include <algorithm>
+
+namespace MAT_NS_BEGIN {
+
+    constexpr double   CollectorEndpointPool::SmoothingFactor;
+    constexpr double   CollectorEndpointPool::ErrorPenalty;
+    constexpr unsigned CollectorEndpointPool::TripThreshold;
+
+    MATSDK_LOG_INST_COMPONENT_CLASS(CollectorEndpointPool, "EventsSDK.CollectorEndpointPool", "Events telemetry client - CollectorEndpointPool class");
+
+    // Cost of an endpoint that has been measured but never succeeded
+    static constexpr double FailedEndpointCost = 1e9;
+
+    static std::string trimmed(std::string const& value)
+    {
+        size_t first = value.find_first_not_of(" \t");
+        if (first == std::string::npos)
+        {
+            return std::string();
+        }
+        size_t last = value.find_last_not_of(" \t");
+        return value.substr(first, last - first + 1);
+    }
+
+    CollectorEndpointPool::CollectorEndpointPool(IRuntimeConfig& config) :
+        m_config(config),
+        m_selection(Selection::Primary),
+        m_cooldownMs(static_cast<uint32_t>(config[CFG_INT_COLLECTOR_BREAKER_COOLDOWN]))
+    {
+        const char* selection = config[CFG_STR_COLLECTOR_SELECTION];
+        if (selection != nullptr)
+        {
+            m_selection = ParseSelection(selection);
+        }
+
+        m_primaryUrl = config.GetCollectorUrl();
+        m_endpoints.emplace_back();
+        m_endpoints.back().url = m_primaryUrl;
+
+        const char* alternates = config[CFG_STR_COLLECTOR_ALTERNATE_URLS];
+        std::string list = (alternates != nullptr) ? alternates : "";
+        size_t start = 0;
+        while (start <= list.size())
+        {
+            size_t end = list.find(',', start);
+            if (end == std::string::npos)
+            {
+                end = list.size();
+            }
+            std::string url = trimmed(list.substr(start, end - start));
+            bool duplicate = false;
+            for (auto const& endpoint : m_endpoints)
+            {
+                duplicate |= (endpoint.url == url);
+            }
+            if (!url.empty() && !duplicate)
+            {
+                m_endpoints.emplace_back();
+                m_endpoints.back().url = url;
+            }
+            start = end + 1;
+        }
+    }
+
+    CollectorEndpointPool::Selection CollectorEndpointPool::ParseSelection(std::string const& name)
+    {
+        if (name == "leastLatency")
+        {
+            return Selection::LeastLatency;
+        }
+        if (name == "weighted")
+        {
+            return Selection::Weighted;
+        }
+        return Selection::Primary;
+    }
+
+    size_t CollectorEndpointPool::GetSize()
+    {
+        LOCKGUARD(m_lock);
+        return m_endpoints.size();
+    }
+
+    std::vector<CollectorEndpointPool::EndpointStatus> CollectorEndpointPool::GetStatus()
+    {
+        LOCKGUARD(m_lock);
+        std::vector<EndpointStatus> result;
+        for (auto const& endpoint : m_endpoints)
+        {
+            result.push_back({ endpoint.url, endpoint.latencyMs, endpoint.errorRate, endpoint.samples,
+                endpoint.consecutiveFailures, endpoint.state, endpoint.uploads });
+        }
+        return result;
+    }
+
+    /// <summary>
+    /// Restarts the primary endpoint when the collector URL has been changed.
+    /// </summary>
+    void CollectorEndpointPool::refreshEndpoints()
+    {
+        std::string primaryUrl = m_config.GetCollectorUrl();
+        if (primaryUrl != m_primaryUrl)
+        {
+            m_primaryUrl = primaryUrl;
+            m_endpoints[0] = Endpoint();
+            m_endpoints[0].url = primaryUrl;
+        }
+    }
+
+    bool CollectorEndpointPool::isAvailable(Endpoint& endpoint, int64_t now)
+    {
+        if (endpoint.state == BreakerState::Open && now >= endpoint.openUntilMs)
+        {
+            endpoint.state = BreakerState::HalfOpen;
+            endpoint.probing = false;
+        }
+        switch (endpoint.state)
+        {
+        case BreakerState::Closed:
+            return true;
+        case BreakerState::HalfOpen:
+            return !endpoint.probing;
+        default:
+            return false;
+        }
+    }
+
+    double CollectorEndpointPool::cost(Endpoint const& endpoint)
+    {
+        if (endpoint.samples == 0)
+        {
+            // Not measured yet: try it
+            return 0;
+        }
+        if (endpoint.successes == 0)
+        {
+            return FailedEndpointCost;
+        }
+        return endpoint.latencyMs * (1.0 + ErrorPenalty * endpoint.errorRate);
+    }
+
+    size_t CollectorEndpointPool::pick(std::vector<size_t> const& candidates)
+    {
+        switch (m_selection)
+        {
+        case Selection::LeastLatency:
+        {
+            size_t best = candidates[0];
+            for (size_t index : candidates)
+            {
+                if (cost(m_endpoints[index]) < cost(m_endpoints[best]))
+                {
+                    best = index;
+                }
+            }
+            return best;
+        }
+
+        case Selection::Weighted:
+        {
+            // Smooth weighted round robin: deterministic, and interleaves the endpoints
+            // instead of sending bursts to the heaviest one
+            std::vector<int64_t> weights;
+            int64_t total = 0;
+            for (size_t index : candidates)
+            {
+                weights.push_back(std::max<int64_t>(1, static_cast<int64_t>(1000000.0 / (cost(m_endpoints[index]) + 1.0))));
+                total += weights.back();
+            }
+            size_t best = candidates[0];
+            for (size_t i = 0; i < candidates.size(); i++)
+            {
+                Endpoint& endpoint = m_endpoints[candidates[i]];
+                // Weights change with every measurement: drop credit or debt beyond one round
+                endpoint.currentWeight = std::min(std::max(endpoint.currentWeight, -total), total) + weights[i];
+                if (endpoint.currentWeight > m_endpoints[best].currentWeight)
+                {
+                    best = candidates[i];
+                }
+            }
+            m_endpoints[best].currentWeight -= total;
+            return best;
+        }
+
+        default:
+            return candidates[0];
+        }
+    }
+
+    bool CollectorEndpointPool::handleSelect(EventsUploadContextPtr const& ctx)
+    {
+        LOCKGUARD(m_lock);
+        refreshEndpoints();
+        if (m_endpoints.size() < 2)
+        {
+            ctx->collectorEndpoint = -1;
+            return true;
+        }
+
+        int64_t now = getMonotonicTimeMs();
+        std::vector<size_t> candidates;
+        for (size_t index = 0; index < m_endpoints.size(); index++)
+        {
+            if (isAvailable(m_endpoints[index], now))
+            {
+                candidates.push_back(index);
+            }
+        }
+
+        // With every endpoint tripped, keep sending to the primary and let the TPM back off
+        size_t chosen = candidates.empty() ? 0 : pick(candidates);
+        Endpoint& endpoint = m_endpoints[chosen];
+        if (endpoint.state == BreakerState::HalfOpen)
+        {
+            endpoint.probing = true;
+        }
+        endpoint.uploads++;
+
+        ctx->collectorEndpoint = static_cast<int>(chosen);
+        ctx->collectorFailover = (chosen != 0) && (candidates.empty() || candidates[0] != 0);
+        if (ctx->collectorUrl != endpoint.url)
+        {
+            ctx->collectorUrl = endpoint.url;
+            ctx->httpRequest->SetUrl(endpoint.url);
+        }
+        LOG_TRACE("HTTP request %s goes to collector endpoint %u (%s)",
+            ctx->httpRequestId.c_str(), static_cast<unsigned>(chosen), endpoint.url.c_str());
+        return true;
+    }
+
+    bool CollectorEndpointPool::handleRecord(EventsUploadContextPtr const& ctx)
+    {
+        if (ctx->collectorEndpoint < 0)
+        {
+            return true;
+        }
+
+        LOCKGUARD(m_lock);
+        size_t index = static_cast<size_t>(ctx->collectorEndpoint);
+        if (index >= m_endpoints.size() || m_endpoints[index].url != ctx->collectorUrl)
+        {
+            // The primary has been replaced since the upload started
+            return true;
+        }
+        Endpoint& endpoint = m_endpoints[index];
+        endpoint.probing = false;
+
+        IHttpResponse const* response = ctx->httpResponse;
+        if (response == nullptr || response->GetResult() == HttpResult_Aborted)
+        {
+            // Cancelled uploads say nothing about the endpoint
+            return true;
+        }
+
+        unsigned status = response->GetStatusCode();
+        bool failed = (response->GetResult() != HttpResult_OK) || (status >= 500) || (status == 408) || (status == 429);
+
+        double error = failed ? 1.0 : 0.0;
+        endpoint.errorRate = (endpoint.samples == 0) ? error : endpoint.errorRate + SmoothingFactor * (error - endpoint.errorRate);
+        endpoint.samples++;
+
+        if (!failed)
+        {
+            double latency = static_cast<double>(std::max(ctx->durationMs, 0));
+            endpoint.latencyMs = (endpoint.successes == 0) ? latency : endpoint.latencyMs + SmoothingFactor * (latency - endpoint.latencyMs);
+            endpoint.successes++;
+            endpoint.consecutiveFailures = 0;
+            if (endpoint.state != BreakerState::Closed)
+            {
+                LOG_INFO("Collector endpoint %u (%s) is healthy again", static_cast<unsigned>(index), endpoint.url.c_str());
+                endpoint.state = BreakerState::Closed;
+            }
+            return true;
+        }
+
+        endpoint.consecutiveFailures++;
+        if (endpoint.state == BreakerState::HalfOpen ||
+            (endpoint.state == BreakerState::Closed && endpoint.consecutiveFailures >= TripThreshold))
+        {
+            endpoint.state = BreakerState::Open;
+            endpoint.openUntilMs = getMonotonicTimeMs() + m_cooldownMs;
+            ctx->collectorEndpointTripped = true;
+            LOG_WARN("Collector endpoint %u (%s) failed %u times in a row, not using it for %d ms",
+                static_cast<unsigned>(index), endpoint.url.c_str(), endpoint.consecutiveFailures, static_cast<int>(m_cooldownMs));
+        }
+        return true;
+    }
+
+} MAT_NS_END
@@ -0,0 +1,126 @@
+//
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// SPDX-License-Identifier: Apache-2.0
+//
+#ifndef COLLECTORENDPOINTPOOL_HPP
+#define COLLECTORENDPOINTPOOL_HPP
+
+#include "pal/PAL.hpp"
+
+#include "api/IRuntimeConfig.hpp"
+#include "system/Contexts.hpp"
+#include "system/Route.hpp"
+
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace MAT_NS_BEGIN {
+
+    /// <summary>
+    /// Collector endpoints an upload may go to: the primary collector URL plus the
+    /// alternates from CFG_STR_COLLECTOR_ALTERNATE_URLS. Every endpoint keeps an EWMA of
+    /// its round trip time and error rate, and a circuit breaker that takes it out of
+    /// rotation after consecutive failures. Uploads go to a healthy endpoint chosen by
+    /// the CFG_STR_COLLECTOR_SELECTION policy; with every endpoint tripped they go to the
+    /// primary and the TPM backoff applies as usual.
+    /// </summary>
+    class CollectorEndpointPool
+    {
+    public:
+        enum class Selection
+        {
+            /// First healthy endpoint in configuration order
+            Primary,
+            /// Healthy endpoint with the lowest cost
+            LeastLatency,
+            /// Smooth weighted round robin over healthy endpoints, weighted by 1/cost
+            Weighted
+        };
+
+        enum class BreakerState
+        {
+            Closed,
+            Open,
+            /// Cooldown is over, one probe upload is allowed through
+            HalfOpen
+        };
+
+        struct EndpointStatus
+        {
+            std::string  url;
+            double       latencyMs;
+            double       errorRate;
+            unsigned     samples;
+            unsigned     consecutiveFailures;
+            BreakerState state;
+            unsigned     uploads;
+        };
+
+        /// Weight of a new sample in the latency and error rate averages
+        static constexpr double   SmoothingFactor = 0.2;
+        /// Cost multiplier of an endpoint whose every upload fails
+        static constexpr double   ErrorPenalty = 4.0;
+        /// Consecutive failures that trip the circuit breaker
+        static constexpr unsigned TripThreshold = 3;
+
+        CollectorEndpointPool(IRuntimeConfig& config);
+        virtual ~CollectorEndpointPool() {}
+
+        /// <summary>
+        /// Parses a selection policy name, Selection::Primary when unknown.
+        /// </summary>
+        static Selection ParseSelection(std::string const& name);
+
+        /// <summary>
+        /// Number of configured endpoints, including the primary.
+        /// </summary>
+        size_t GetSize();
+
+        std::vector<EndpointStatus> GetStatus();
+
+        RoutePassThrough<CollectorEndpointPool, EventsUploadContextPtr const&> select { this, &CollectorEndpointPool::handleSelect, "selectEndpoint" };
+        RoutePassThrough<CollectorEndpointPool, EventsUploadContextPtr const&> record { this, &CollectorEndpointPool::handleRecord, "recordEndpoint" };
+
+    protected:
+        struct Endpoint
+        {
+            std::string  url;
+            double       latencyMs = 0;
+            double       errorRate = 0;
+            unsigned     samples = 0;
+            unsigned     successes = 0;
+            unsigned     consecutiveFailures = 0;
+            BreakerState state = BreakerState::Closed;
+            int64_t      openUntilMs = 0;
+            bool         probing = false;
+            int64_t      currentWeight = 0;
+            unsigned     uploads = 0;
+        };
+
+        bool handleSelect(EventsUploadContextPtr const& ctx);
+        bool handleRecord(EventsUploadContextPtr const& ctx);
+
+        void refreshEndpoints();
+        bool isAvailable(Endpoint& endpoint, int64_t now);
+        size_t pick(std::vector<size_t> const& candidates);
+        static double cost(Endpoint const& endpoint);
+
+        virtual int64_t getMonotonicTimeMs()
+        {
+            return PAL::getMonotonicTimeMs();
+        }
+
+        IRuntimeConfig&       m_config;
+        Selection             m_selection;
+        int64_t               m_cooldownMs;
+        std::string           m_primaryUrl;
+        std::vector<Endpoint> m_endpoints;
+        std::mutex            m_lock;
+
+        MATSDK_LOG_DECL_COMPONENT_CLASS();
+    };
+
+} MAT_NS_END
+
+#endif
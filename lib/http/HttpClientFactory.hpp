@@ -29,6 +29,11 @@ private:
 #include "http/HttpClient_WinInet.hpp"
 #endif
 
+#if defined(MATSDK_PAL_CPP11) && !defined(_MSC_VER) && (defined(HAVE_MAT_CURL_HTTP_CLIENT) || (!defined(__APPLE__) && !defined(ANDROID)))
+#define HAVE_MAT_CURL_DEFAULT_HTTP_CLIENT
+#include "http/HttpClient_Curl.hpp"
+#endif
+
 #endif // HAVE_MAT_DEFAULT_HTTP_CLIENT
 
 #endif // HTTPCLIENTFACTORY_HPP
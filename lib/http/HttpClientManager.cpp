@@ -77,10 +77,11 @@ namespace MAT_NS_BEGIN {
 
     //---
 
-    HttpClientManager::HttpClientManager(ILogManager& logManager, IHttpClient& httpClient, ITaskDispatcher& taskDispatcher) :
+    HttpClientManager::HttpClientManager(ILogManager& logManager, IHttpClient& httpClient, ITaskDispatcher& taskDispatcher, IBandwidthController* bandwidthController) :
         m_logManager(logManager),
         m_httpClient(httpClient),
-        m_taskDispatcher(taskDispatcher)
+        m_taskDispatcher(taskDispatcher),
+        m_bandwidthController(bandwidthController)
     {
     }
 
@@ -101,6 +102,11 @@ namespace MAT_NS_BEGIN {
             static_cast<unsigned>(ctx->recordIdsAndTenantIds.size()), ctx->latency, latencyToStr(ctx->latency), static_cast<unsigned>(ctx->packageIds.size()),
             ctx->httpRequest->GetId().c_str(), static_cast<unsigned>(ctx->httpRequest->GetSizeEstimate()));
 
+        if (m_bandwidthController)
+        {
+            // Charge the budget the upload was gated on, not the latency of the package content
+            m_bandwidthController->OnBytesSent(ctx->requestedMinLatency, ctx->httpRequest->GetSizeEstimate());
+        }
         m_httpClient.SendRequestAsync(ctx->httpRequest, callback);
     }
 
@@ -4,6 +4,7 @@
 //
 
 #pragma once
+#include "IBandwidthController.hpp"
 #include "IHttpClient.hpp"
 #include "pal/PAL.hpp"
 #include "system/Contexts.hpp"
@@ -24,7 +25,8 @@ class HttpClientManager
         HttpClientManager(
                 ILogManager& logManager,
                 IHttpClient& httpClient,
-                ITaskDispatcher& taskDispatcher);
+                ITaskDispatcher& taskDispatcher,
+                IBandwidthController* bandwidthController = nullptr);
 
         virtual ~HttpClientManager() noexcept;
 
@@ -39,7 +41,7 @@ class HttpClientManager
 
         RouteSink<HttpClientManager, EventsUploadContextPtr const&> sendRequest
         {
-            this, &HttpClientManager::handleSendRequest
+            this, &HttpClientManager::handleSendRequest, "sendRequest"
         };
 
     protected:
@@ -54,6 +56,7 @@ class HttpClientManager
         ILogManager&              m_logManager;
         IHttpClient&              m_httpClient;
         ITaskDispatcher&          m_taskDispatcher;
+        IBandwidthController*     m_bandwidthController;
         std::recursive_mutex      m_httpCallbacksMtx;
         std::list<HttpCallback*>  m_httpCallbacks;
 };
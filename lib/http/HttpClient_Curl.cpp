@@ -10,7 +10,9 @@
 
 #include "ctmacros.hpp"
 
+#include <ctime>
 #include <memory>
+#include <sstream>
 
 #include "utils/Utils.hpp"
 #include "HttpClient_Curl.hpp"
@@ -49,14 +51,185 @@ namespace MAT_NS_BEGIN {
         TRACE("Initializing HttpClient_Curl...\n");
         curl_global_init(CURL_GLOBAL_ALL);
         TRACE("libcurl version = %s\n", curl_version_info(CURLVERSION_NOW)->version);
+
+        // Connections themselves are not shared: libcurl does not support sharing them
+        // between concurrent threads, and every request runs on its own thread
+        m_share = curl_share_init();
+        if (m_share != nullptr)
+        {
+            curl_share_setopt(m_share, CURLSHOPT_LOCKFUNC, &HttpClient_Curl::LockShare);
+            curl_share_setopt(m_share, CURLSHOPT_UNLOCKFUNC, &HttpClient_Curl::UnlockShare);
+            curl_share_setopt(m_share, CURLSHOPT_SHARE, CURL_LOCK_DATA_DNS);
+            curl_share_setopt(m_share, CURLSHOPT_SHARE, CURL_LOCK_DATA_SSL_SESSION);
+        }
     }
 
     HttpClient_Curl::~HttpClient_Curl()
     {
+        if (m_prewarm.valid())
+        {
+            auto operation = m_prewarmOperation.lock();
+            if (operation)
+            {
+                operation->Abort();
+            }
+            m_prewarm.wait();
+        }
+        // Fails with CURLSHE_IN_USE while a request outlives the client: leak the share then
+        curl_share_cleanup(m_share);
         curl_global_cleanup();
         TRACE("Destroyed HttpClient_Curl.\n");
     };
 
+    static std::mutex& ShareLock(curl_lock_data data)
+    {
+        // Static, so that a share leaked by the destructor never locks a destroyed mutex
+        static std::mutex locks[CURL_LOCK_DATA_LAST];
+        return locks[(data < CURL_LOCK_DATA_LAST) ? data : CURL_LOCK_DATA_NONE];
+    }
+
+    void HttpClient_Curl::LockShare(CURL*, curl_lock_data data, curl_lock_access, void*)
+    {
+        ShareLock(data).lock();
+    }
+
+    void HttpClient_Curl::UnlockShare(CURL*, curl_lock_data data, void*)
+    {
+        ShareLock(data).unlock();
+    }
+
+    void HttpClient_Curl::Prewarm(std::string const& url)
+    {
+        std::lock_guard<std::mutex> lock(m_requestsMtx);
+        if (m_prewarm.valid())
+        {
+            return;
+        }
+        LOG_TRACE("Pre-connecting to %s", url.c_str());
+        auto operation = std::make_shared<CurlHttpOperation>("GET", url, nullptr,
+            std::map<std::string, std::string>(), std::vector<uint8_t>(), false, HTTP_CONN_TIMEOUT, m_share);
+        m_prewarmOperation = operation;
+        m_prewarm = std::async(std::launch::async, [operation]() mutable {
+            long result = operation->Connect();
+            // Later requests only need the caches of the share handle: close the connection
+            operation.reset();
+            return result;
+        }).share();
+    }
+
+#if LIBCURL_VERSION_NUM >= 0x080C00 // Version 8.12.00
+    static std::string ToHex(const unsigned char* data, size_t size)
+    {
+        static const char digits[] = "0123456789abcdef";
+        std::string result;
+        result.reserve(size * 2);
+        for (size_t i = 0; i < size; i++)
+        {
+            result += digits[data[i] >> 4];
+            result += digits[data[i] & 0x0F];
+        }
+        return result;
+    }
+
+    static bool FromHex(std::string const& text, std::vector<unsigned char>& data)
+    {
+        if (text.size() % 2 != 0)
+        {
+            return false;
+        }
+        data.clear();
+        for (size_t i = 0; i < text.size(); i += 2)
+        {
+            int value = 0;
+            for (size_t j = i; j < i + 2; j++)
+            {
+                char c = text[j];
+                int digit = (c >= '0' && c <= '9') ? c - '0' : (c >= 'a' && c <= 'f') ? c - 'a' + 10 : -1;
+                if (digit < 0)
+                {
+                    return false;
+                }
+                value = value * 16 + digit;
+            }
+            data.push_back(static_cast<unsigned char>(value));
+        }
+        return true;
+    }
+
+    static CURLcode ExportTlsSession(CURL*, void* userptr, const char* sessionKey,
+        const unsigned char* shmac, size_t shmacSize, const unsigned char* sdata, size_t sdataSize,
+        curl_off_t validUntil, int, const char*, size_t)
+    {
+        // One session per line: key, salted hash of the peer, session data, expiry
+        std::string& sessions = *static_cast<std::string*>(userptr);
+        sessions += ToHex(reinterpret_cast<const unsigned char*>(sessionKey), strlen(sessionKey));
+        sessions += ' ';
+        sessions += ToHex(shmac, shmacSize);
+        sessions += ' ';
+        sessions += ToHex(sdata, sdataSize);
+        sessions += ' ';
+        sessions += std::to_string(static_cast<long long>(validUntil));
+        sessions += '\n';
+        return CURLE_OK;
+    }
+#endif
+
+    std::string HttpClient_Curl::ExportTlsSessions()
+    {
+        std::string sessions;
+#if LIBCURL_VERSION_NUM >= 0x080C00
+        CURL* curl = curl_easy_init();
+        if (curl != nullptr && m_share != nullptr)
+        {
+            curl_easy_setopt(curl, CURLOPT_SHARE, m_share);
+            curl_easy_ssls_export(curl, &ExportTlsSession, &sessions);
+        }
+        curl_easy_cleanup(curl);
+#endif
+        return sessions;
+    }
+
+    size_t HttpClient_Curl::ImportTlsSessions(std::string const& sessions)
+    {
+        size_t imported = 0;
+#if LIBCURL_VERSION_NUM >= 0x080C00
+        CURL* curl = curl_easy_init();
+        if (curl != nullptr && m_share != nullptr)
+        {
+            curl_easy_setopt(curl, CURLOPT_SHARE, m_share);
+            std::istringstream lines(sessions);
+            std::string line;
+            while (std::getline(lines, line))
+            {
+                std::istringstream fields(line);
+                std::string key, shmac, sdata;
+                long long validUntil = 0;
+                std::vector<unsigned char> keyBytes, shmacBytes, sdataBytes;
+                if (!(fields >> key >> shmac >> sdata >> validUntil) ||
+                    !FromHex(key, keyBytes) || !FromHex(shmac, shmacBytes) || !FromHex(sdata, sdataBytes))
+                {
+                    LOG_WARN("Ignoring malformed TLS session");
+                    continue;
+                }
+                if (validUntil != 0 && validUntil <= static_cast<long long>(time(nullptr)))
+                {
+                    continue;
+                }
+                std::string sessionKey(keyBytes.begin(), keyBytes.end());
+                if (curl_easy_ssls_import(curl, sessionKey.c_str(), shmacBytes.data(), shmacBytes.size(),
+                        sdataBytes.data(), sdataBytes.size()) == CURLE_OK)
+                {
+                    imported++;
+                }
+            }
+        }
+        curl_easy_cleanup(curl);
+#else
+        UNREFERENCED_PARAMETER(sessions);
+#endif
+        return imported;
+    }
+
     IHttpRequest* HttpClient_Curl::CreateRequest()
     {
         return new CurlHttpRequest();
@@ -74,9 +247,16 @@ namespace MAT_NS_BEGIN {
             requestHeaders[header.first] = header.second;
         }
 
-        auto curlOperation = std::make_shared<CurlHttpOperation>(curlRequest->m_method, curlRequest->m_url, callback, requestHeaders, curlRequest->m_body);
+        std::shared_future<long> prewarm;
+        {
+            std::lock_guard<std::mutex> lock(m_requestsMtx);
+            prewarm = m_prewarm;
+        }
+
+        auto curlOperation = std::make_shared<CurlHttpOperation>(curlRequest->m_method, curlRequest->m_url, callback, requestHeaders, curlRequest->m_body,
+            false, HTTP_CONN_TIMEOUT, m_share);
         curlRequest->SetOperation(curlOperation);
-        
+
         // The lifetime of curlOperation is guarnteed by the call to result.wait() in the d'tor.  
         curlOperation->SendAsync([this, callback, requestId](CurlHttpOperation& operation) {
             this->EraseRequest(requestId);
@@ -98,13 +278,12 @@ namespace MAT_NS_BEGIN {
                 }
             }
 
-            auto responseHeaders = operation.GetResponseHeaders();
-            response->m_headers.insert(responseHeaders.begin(), responseHeaders.end());
+            response->m_headers.swap(operation.GetResponseHeaders());
             response->m_body = operation.GetResponseBody();
             
             // 'response' is no longer owned by IHttpClient and gets deleted in EventsUploadContext.clear()
             callback->OnHttpResponse(response.release());
-        });
+        }, prewarm);
     }
 
     void HttpClient_Curl::CancelRequestAsync(std::string const& id)
@@ -11,10 +11,8 @@
 #include <cstdlib>
 #include <cstdint>
 #include <string.h>
-#include <regex>
 
 #include <string>
-#include <sstream>
 #include <vector>
 #include <iterator>
 
@@ -28,6 +26,7 @@
 #include <unistd.h>
 
 #include "IHttpClient.hpp"
+#include "http/HttpHeaderParser.hpp"
 #include "pal/PAL.hpp"
 
 #ifdef HAVE_ONEDS_BOUNDCHECK_METHODS
@@ -35,16 +34,22 @@
 #endif
 
 #define HTTP_CONN_TIMEOUT       5L
-#define HTTP_STATUS_REGEXP		"HTTP\\/\\d\\.\\d (\\d+)\\ .*"
-#define HTTP_HEADER_REGEXP      "(.*)\\: (.*)\\n*"
+// How long a pre-connect waits for the session tickets a TLS 1.3 server sends after the handshake
+#define TLS_TICKET_WAIT_MS      200L
 
 #undef TRACE
 #define TRACE(...)	// printf
 
 namespace MAT_NS_BEGIN {
 
+class CurlHttpOperation;
+
 /**
  * Curl-based HTTP client
+ *
+ * All requests of a client share the DNS cache and the TLS session cache, so that
+ * connections after the first one resume the TLS session instead of doing a full
+ * handshake.
  */
 class HttpClient_Curl : public IHttpClient {
 public:
@@ -55,12 +60,40 @@ public:
     virtual void SendRequestAsync(IHttpRequest* request, IHttpResponseCallback* callback) override;
     virtual void CancelRequestAsync(std::string const& id) override;
 
+    /**
+     * Resolve the host of the URL and connect to it in the background, so that the
+     * first request finds the DNS entry and the TLS session cached. Requests sent
+     * meanwhile wait for the pre-connect instead of racing it with a handshake of
+     * their own. Only the first call has an effect.
+     */
+    void Prewarm(std::string const& url);
+
+    /**
+     * TLS sessions of the session cache, encoded as text for the offline storage
+     * settings. Empty if libcurl cannot export sessions: before 8.12.0, or when
+     * built without the ssls-export feature.
+     */
+    std::string ExportTlsSessions();
+
+    /**
+     * Add sessions from ExportTlsSessions() of an earlier run to the session cache.
+     * Returns the number of sessions imported.
+     */
+    size_t ImportTlsSessions(std::string const& sessions);
+
 private:
     void EraseRequest(std::string const& id);
     void AddRequest(IHttpRequest* request);
 
+    static void LockShare(CURL* handle, curl_lock_data data, curl_lock_access access, void* userptr);
+    static void UnlockShare(CURL* handle, curl_lock_data data, void* userptr);
+
     std::mutex m_requestsMtx;
     std::map<std::string, IHttpRequest*> m_requests;
+
+    CURLSH*                            m_share;
+    std::weak_ptr<CurlHttpOperation>   m_prewarmOperation;
+    std::shared_future<long>           m_prewarm;
 };
 
 class CurlHttpOperation {
@@ -80,7 +113,7 @@ public:
      * @param url
      * @param body
      * @param httpConnTimeout   HTTP connection timeout in seconds
-     * @param httpReadTimeout   HTTP read timeout in seconds
+     * @param share             Share handle for DNS and TLS session caches, optional
      */
     CurlHttpOperation(
             std::string method,
@@ -91,7 +124,8 @@ public:
             const std::vector<uint8_t>& requestBody                  = std::vector<uint8_t>(),
             // Default connectivity and response size options
             bool rawResponse                                         = false,
-            size_t httpConnTimeout                                   = HTTP_CONN_TIMEOUT) :
+            size_t httpConnTimeout                                   = HTTP_CONN_TIMEOUT,
+            CURLSH* share                                            = nullptr) :
 
             // Optional connection params
             rawResponse(rawResponse),
@@ -129,6 +163,18 @@ public:
         // Specify target URL
         curl_easy_setopt(curl, CURLOPT_URL, m_url.c_str());
 
+        if (share != nullptr)
+        {
+            curl_easy_setopt(curl, CURLOPT_SHARE, share);
+        }
+        // Requests run on their own threads: no signals for DNS timeouts
+        curl_easy_setopt(curl, CURLOPT_NOSIGNAL, 1L);
+        curl_easy_setopt(curl, CURLOPT_CONNECTTIMEOUT, static_cast<long>(httpConnTimeout));
+        // The progress callback is where an aborted request gets stopped
+        curl_easy_setopt(curl, CURLOPT_NOPROGRESS, 0L);
+        curl_easy_setopt(curl, CURLOPT_XFERINFOFUNCTION, &AbortCallback);
+        curl_easy_setopt(curl, CURLOPT_XFERINFODATA, this);
+
         // TODO: expose SSL cert verification opts via ILogConfiguration
         curl_easy_setopt(curl, CURLOPT_SSL_VERIFYPEER, 0);      // 1L
         curl_easy_setopt(curl, CURLOPT_SSL_VERIFYHOST, 0);      // 2L
@@ -190,51 +236,6 @@ public:
             goto cleanup;
         }
 
-        // TODO: should we control what local source port we use?
-        // curl_easy_setopt(curl, CURLOPT_LOCALPORT, dcf_port);
-
-        // Perform initial connect, handling the timeout if needed
-        curl_easy_setopt(curl, CURLOPT_CONNECT_ONLY, 1L);
-        DispatchEvent(OnConnecting);
-        res = curl_easy_perform(curl);
-        if(CURLE_OK != res)
-        {
-            DispatchEvent(OnConnectFailed);     // couldn't connect - stage 1
-            TRACE("Error #1: %s\n", curl_easy_strerror(res));
-            goto cleanup;
-        }
-
-        /* Extract the socket from the curl handle - we'll need it for waiting.
-         * Note that this API takes a pointer to a 'long' while we use
-         * curl_socket_t for sockets otherwise.
-         */
-
-#if LIBCURL_VERSION_NUM >= 0x072D00 // Version 7.45.00
-        res = curl_easy_getinfo(curl, CURLINFO_ACTIVESOCKET, &sockextr);
-#else
-        res = curl_easy_getinfo(curl, CURLINFO_LASTSOCKET, &sockextr);
-#endif
-
-        if(CURLE_OK != res)
-        {
-            DispatchEvent(OnConnectFailed);     // couldn't connect - stage 2
-            TRACE("Error #2: %s\n", curl_easy_strerror(res));
-            goto cleanup;
-        }
-
-        /* wait for the socket to become ready for sending */
-        sockfd = sockextr;
-        if( !WaitOnSocket(sockfd, 0, HTTP_CONN_TIMEOUT * 1000L) || isAborted)
-        {
-            TRACE("Error #3: timeout, aborted=%u\n", isAborted.load() );
-            res = CURLE_OPERATION_TIMEDOUT;
-            DispatchEvent(OnConnectFailed);     // couldn't connect - stage 3
-            goto cleanup;
-        }
-
-        // once connection is there - switch back to easy perform for HTTP post
-        curl_easy_setopt(curl, CURLOPT_CONNECT_ONLY, 0);
-
         // send all data to our callback function
         if (rawResponse)
         {
@@ -243,7 +244,8 @@ public:
             curl_easy_setopt(curl, CURLOPT_WRITEDATA,     (void *)&response);
         } else {
             curl_easy_setopt(curl, CURLOPT_WRITEFUNCTION, (void *)&WriteVectorCallback);
-            curl_easy_setopt(curl, CURLOPT_HEADERDATA,    (void *)&respHeaders);
+            curl_easy_setopt(curl, CURLOPT_HEADERFUNCTION, (void *)&WriteHeaderCallback);
+            curl_easy_setopt(curl, CURLOPT_HEADERDATA,    (void *)&respHeaderParser);
             curl_easy_setopt(curl, CURLOPT_WRITEDATA,     (void *)&respBody);
         }
 
@@ -267,11 +269,27 @@ public:
 
         curl_easy_setopt(curl, CURLOPT_LOW_SPEED_TIME, 30L);
         curl_easy_setopt(curl, CURLOPT_LOW_SPEED_LIMIT, 4096);
+
+        // Connect and send in one transfer: a connection made with CURLOPT_CONNECT_ONLY
+        // is never reused for a request, so connecting first costs a second handshake
+        isConnected = false;
+#if LIBCURL_VERSION_NUM >= 0x075000 // Version 7.80.00
+        curl_easy_setopt(curl, CURLOPT_PREREQFUNCTION, &ConnectedCallback);
+        curl_easy_setopt(curl, CURLOPT_PREREQDATA, this);
+        DispatchEvent(OnConnecting);
+#else
+        DispatchEvent(OnConnecting);
         DispatchEvent(OnSending);
+#endif
         res = curl_easy_perform(curl);
         if(CURLE_OK != res)
         {
-            DispatchEvent(OnSendFailed);
+#if LIBCURL_VERSION_NUM < 0x075000
+            double connectTime = 0;
+            curl_easy_getinfo(curl, CURLINFO_CONNECT_TIME, &connectTime);
+            isConnected = (connectTime > 0);
+#endif
+            DispatchEvent(isConnected ? OnSendFailed : OnConnectFailed);
             TRACE("Error: %s\n", curl_easy_strerror(res));
             goto cleanup;
         }
@@ -279,11 +297,7 @@ public:
         /* Code snippet to parse raw HTTP response. This might come in handy
          * if we ever consider to handle the raw upload instead of curl_easy_perform
        ...
-       std::string resp((const char *)response);
-       std::regex http_status_regex(HTTP_STATUS_REGEXP);
-       std::smatch match;
-       if(std::regex_search(resp, match, http_status_regex))
-         http_code = std::stol(match[1]);
+       HttpHeaderParser::ParseStatusLine((const char *)response.memory, response.size, http_code);
        ...
          */
 
@@ -302,8 +316,55 @@ cleanup:
         return res;
     }
 
-    std::future<long> & SendAsync(std::function<void(CurlHttpOperation &)> callback = nullptr) {
-        result = std::async(std::launch::async, [this, callback] {
+    /**
+     * Connect to the host of the URL without sending a request. The DNS entry and
+     * the TLS session end up in the caches of the share handle.
+     */
+    long Connect()
+    {
+        if(!curl)
+        {
+            res = CURLE_FAILED_INIT;
+            DispatchEvent(OnConnectFailed);
+            return res;
+        }
+
+        curl_easy_setopt(curl, CURLOPT_CONNECT_ONLY, 1L);
+        DispatchEvent(OnConnecting);
+        res = curl_easy_perform(curl);
+        if(CURLE_OK != res)
+        {
+            DispatchEvent(OnConnectFailed);
+            TRACE("Error: %s\n", curl_easy_strerror(res));
+            return res;
+        }
+
+        // TLS 1.3 servers send the session tickets after the handshake: read them
+#if LIBCURL_VERSION_NUM >= 0x072D00 // Version 7.45.00
+        curl_easy_getinfo(curl, CURLINFO_ACTIVESOCKET, &sockextr);
+#else
+        curl_easy_getinfo(curl, CURLINFO_LASTSOCKET, &sockextr);
+#endif
+        if ((sockextr > 0) && (WaitOnSocket(static_cast<curl_socket_t>(sockextr), 1, TLS_TICKET_WAIT_MS) > 0))
+        {
+            char buffer[256];
+            size_t received = 0;
+            curl_easy_recv(curl, buffer, sizeof(buffer), &received);
+        }
+        DispatchEvent(OnConnected);
+        return res;
+    }
+
+    /**
+     * Send request on a worker thread
+     *
+     * @param callback  Called on the worker thread when the request is done
+     * @param after     Send once this completes, optional
+     */
+    std::future<long> & SendAsync(std::function<void(CurlHttpOperation &)> callback = nullptr, std::shared_future<long> after = std::shared_future<long>()) {
+        result = std::async(std::launch::async, [this, callback, after] {
+            if (after.valid())
+                after.wait();
             long result = Send();
             if (callback!=nullptr)
                 callback(*this);
@@ -329,28 +390,14 @@ cleanup:
     }
 
     /**
-     * Return a copy of resposne headers
+     * Return response headers, parsed from the header callback as they arrived.
+     * The caller may take them over with swap().
      *
      * @return
      */
-    std::map<std::string, std::string> GetResponseHeaders()
+    HttpHeaders& GetResponseHeaders()
     {
-        std::map<std::string, std::string> result;
-        if (respHeaders.size() == 0)
-            return result;
-
-        std::stringstream ss;
-        std::string headers((const char *)&respHeaders[0], respHeaders.size());
-        ss.str(headers);
-
-        std::string header;
-        while (std::getline(ss, header, '\n')) {
-            std::smatch match;
-            std::regex http_headers_regex(HTTP_HEADER_REGEXP);
-            if (std::regex_search(header, match, http_headers_regex))
-                result[match[1]] = match[2];    // Key: value
-        }
-        return result;
+        return respHeaders;
     }
 
     /**
@@ -386,7 +433,7 @@ cleanup:
             response.memory = nullptr;
             response.size = 0;
         }
-        respHeaders.clear();
+        respHeaderParser.Reset();
         respBody.clear();
     }
 
@@ -395,15 +442,8 @@ cleanup:
      */
     void Abort()
     {
+        // Picked up by AbortCallback, which libcurl calls at least once per second
         isAborted = true;
-        if (curl!=nullptr)
-        {
-            // Simply close the socket - connection reset by peer.. Ha-ha-ha-ha-ha!
-            if (sockfd) {
-                ::close(sockfd);
-                sockfd = 0;
-            }
-        }
     }
 
     CURL *GetHandle()
@@ -428,13 +468,13 @@ protected:
     struct curl_slist *m_headersChunk = nullptr;
 
     // Processed response headers and body
-    std::vector<uint8_t>        respHeaders;
+    HttpHeaders                 respHeaders;
+    HttpHeaderParser            respHeaderParser { respHeaders };
     std::vector<uint8_t>        respBody;
 
     // Socket parameters
-    curl_socket_t sockfd = 0;
-
     long sockextr   = 0;
+    bool isConnected = false;
 
     curl_off_t nread = 0;
     size_t sendlen   = 0;        // # bytes sent by client
@@ -476,6 +516,23 @@ protected:
         return res;
     }
 
+    static int AbortCallback(void *clientp, curl_off_t, curl_off_t, curl_off_t, curl_off_t)
+    {
+        // Non-zero fails the transfer with CURLE_ABORTED_BY_CALLBACK
+        return static_cast<CurlHttpOperation*>(clientp)->isAborted ? 1 : 0;
+    }
+
+#if LIBCURL_VERSION_NUM >= 0x075000
+    static int ConnectedCallback(void *clientp, char *, char *, int, int)
+    {
+        CurlHttpOperation* operation = static_cast<CurlHttpOperation*>(clientp);
+        operation->isConnected = true;
+        operation->DispatchEvent(OnConnected);
+        operation->DispatchEvent(OnSending);
+        return CURL_PREREQFUNC_OK;
+    }
+#endif
+
     // Raw response buffer
     struct MemoryStruct {
       char *memory;
@@ -522,6 +579,14 @@ protected:
      * @param data
      * @return
      */
+    static size_t WriteHeaderCallback(char *buffer, size_t size, size_t nitems, HttpHeaderParser* parser)
+    {
+        if (parser!=nullptr) {
+            parser->Feed(buffer, size * nitems);
+        }
+        return size * nitems;
+    }
+
     static size_t WriteVectorCallback(void *ptr, size_t size, size_t nmemb, std::vector<uint8_t>* data)
     {
         if (data!=nullptr) {
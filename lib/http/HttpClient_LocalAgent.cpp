@@ -0,0 +1,208 @@
+//
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// SPDX-License-Identifier: Apache-2.0
+//
+#include "HttpClient_LocalAgent.hpp"
+
+#ifdef HAVE_MAT_LOCAL_AGENT
+
+#include "LocalAgentProtocol.hpp"
+
+#include <cerrno>
+#include <cstring>
+
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+namespace MAT_NS_BEGIN {
+
+    MATSDK_LOG_INST_COMPONENT_CLASS(HttpClient_LocalAgent, "EventsSDK.HttpClient_LocalAgent", "Events telemetry client - HttpClient_LocalAgent class");
+
+    HttpClient_LocalAgent::HttpClient_LocalAgent(std::string const& socketPath) :
+        m_socketPath(socketPath),
+        m_nextId(0)
+    {
+        LOG_TRACE("Uploading through local agent at %s", m_socketPath.c_str());
+    }
+
+    HttpClient_LocalAgent::~HttpClient_LocalAgent()
+    {
+        std::list<std::future<void>> workers;
+        {
+            LOCKGUARD(m_lock);
+            for (auto& item : m_operations)
+            {
+                cancel(*item.second);
+            }
+            workers.swap(m_workers);
+        }
+        for (auto& worker : workers)
+        {
+            worker.wait();
+        }
+    }
+
+    IHttpRequest* HttpClient_LocalAgent::CreateRequest()
+    {
+        return new SimpleHttpRequest("LA-" + std::to_string(m_nextId.fetch_add(1)));
+    }
+
+    void HttpClient_LocalAgent::SendRequestAsync(IHttpRequest* request, IHttpResponseCallback* callback)
+    {
+        // Note: 'request' is never owned by IHttpClient and gets deleted in EventsUploadContext.clear()
+        auto simpleRequest = static_cast<SimpleHttpRequest*>(request);
+        auto operation = std::make_shared<Operation>();
+
+        LOCKGUARD(m_lock);
+        // Forget the workers that have already delivered their response
+        for (auto it = m_workers.begin(); it != m_workers.end();)
+        {
+            if (it->wait_for(std::chrono::seconds(0)) == std::future_status::ready)
+            {
+                it = m_workers.erase(it);
+            }
+            else
+            {
+                ++it;
+            }
+        }
+        m_operations[simpleRequest->GetId()] = operation;
+        m_workers.push_back(std::async(std::launch::async, &HttpClient_LocalAgent::run, this, simpleRequest, callback, operation));
+    }
+
+    void HttpClient_LocalAgent::CancelRequestAsync(std::string const& id)
+    {
+        LOCKGUARD(m_lock);
+        auto it = m_operations.find(id);
+        if (it != m_operations.end())
+        {
+            LOG_TRACE("HTTP request id=%s being aborted...", id.c_str());
+            cancel(*it->second);
+        }
+    }
+
+    void HttpClient_LocalAgent::cancel(Operation& operation)
+    {
+        LOCKGUARD(operation.lock);
+        operation.aborted = true;
+        if (operation.socket >= 0)
+        {
+            // Wakes up the worker blocked in connect(), send() or recv()
+            ::shutdown(operation.socket, SHUT_RDWR);
+        }
+    }
+
+    void HttpClient_LocalAgent::run(SimpleHttpRequest* request, IHttpResponseCallback* callback, std::shared_ptr<Operation> operation)
+    {
+        std::string requestId = request->GetId();
+        std::unique_ptr<SimpleHttpResponse> response(new SimpleHttpResponse(requestId));
+        response->m_result = exchange(*request, *operation, *response);
+        {
+            LOCKGUARD(m_lock);
+            m_operations.erase(requestId);
+        }
+        // 'response' is no longer owned by IHttpClient and gets deleted in EventsUploadContext.clear()
+        callback->OnHttpResponse(response.release());
+    }
+
+    HttpResult HttpClient_LocalAgent::exchange(SimpleHttpRequest const& request, Operation& operation, SimpleHttpResponse& response)
+    {
+        struct sockaddr_un address;
+        memset(&address, 0, sizeof(address));
+        address.sun_family = AF_UNIX;
+        if (m_socketPath.size() >= sizeof(address.sun_path))
+        {
+            LOG_ERROR("Local agent socket path is too long: %s", m_socketPath.c_str());
+            return HttpResult_LocalFailure;
+        }
+        memcpy(address.sun_path, m_socketPath.c_str(), m_socketPath.size());
+
+        int fd = ::socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+        if (fd < 0)
+        {
+            return HttpResult_LocalFailure;
+        }
+        {
+            LOCKGUARD(operation.lock);
+            if (operation.aborted)
+            {
+                ::close(fd);
+                return HttpResult_Aborted;
+            }
+            operation.socket = fd;
+        }
+
+        HttpResult result = HttpResult_NetworkFailure;
+        if (::connect(fd, reinterpret_cast<struct sockaddr*>(&address), sizeof(address)) == 0)
+        {
+            LocalAgentProtocol::Request message;
+            message.id = request.m_id;
+            message.method = request.m_method;
+            message.url = request.m_url;
+            message.headers = request.m_headers;
+            message.latency = request.m_latency;
+
+            // Large bodies are passed as a memory file instead of being copied through the socket
+            int bodyFd = -1;
+            if (request.m_body.size() >= LocalAgentProtocol::FdBodyThreshold)
+            {
+                bodyFd = LocalAgentProtocol::CreateBodyFd(request.m_body);
+            }
+            if (bodyFd < 0)
+            {
+                message.body = request.m_body;
+            }
+
+            std::vector<uint8_t> payload;
+            LocalAgentProtocol::EncodeRequest(message, bodyFd >= 0, payload);
+            bool sent = LocalAgentProtocol::WriteFrame(fd, LocalAgentProtocol::MessageRequest,
+                (bodyFd >= 0) ? LocalAgentProtocol::FlagBodyInFd : 0, payload, bodyFd);
+            if (bodyFd >= 0)
+            {
+                ::close(bodyFd);
+            }
+
+            uint8_t type = 0;
+            uint8_t flags = 0;
+            int unexpectedFd = -1;
+            LocalAgentProtocol::Response reply;
+            if (sent &&
+                LocalAgentProtocol::ReadFrame(fd, type, flags, payload, unexpectedFd) &&
+                type == LocalAgentProtocol::MessageResponse &&
+                LocalAgentProtocol::DecodeResponse(payload, reply))
+            {
+                result = reply.result;
+                response.m_statusCode = reply.statusCode;
+                response.m_headers.swap(reply.headers);
+                response.m_body.swap(reply.body);
+            }
+            else
+            {
+                LOG_WARN("HTTP request id=%s: no response from local agent", request.m_id.c_str());
+            }
+            if (unexpectedFd >= 0)
+            {
+                ::close(unexpectedFd);
+            }
+        }
+        else
+        {
+            LOG_WARN("Cannot connect to local agent at %s: errno=%d", m_socketPath.c_str(), errno);
+        }
+
+        {
+            LOCKGUARD(operation.lock);
+            operation.socket = -1;
+            if (operation.aborted)
+            {
+                result = HttpResult_Aborted;
+            }
+        }
+        ::close(fd);
+        return result;
+    }
+
+} MAT_NS_END
+
+#endif // HAVE_MAT_LOCAL_AGENT
@@ -0,0 +1,73 @@
+//
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// SPDX-License-Identifier: Apache-2.0
+//
+#ifndef HTTPCLIENT_LOCALAGENT_HPP
+#define HTTPCLIENT_LOCALAGENT_HPP
+
+#include "mat/config.h"
+
+#ifdef HAVE_MAT_LOCAL_AGENT
+
+#include "IHttpClient.hpp"
+#include "pal/PAL.hpp"
+
+#include <atomic>
+#include <future>
+#include <list>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+
+namespace MAT_NS_BEGIN {
+
+    /// <summary>
+    /// HTTP client that hands every request to a forwarder process listening on a
+    /// Unix domain socket (see LocalAgentServer) instead of opening its own TLS
+    /// connection to the collector. The forwarder performs the upload and returns
+    /// the collector's response, so retries, storage and response handling in this
+    /// process are unchanged. When the forwarder cannot be reached the request fails
+    /// with HttpResult_NetworkFailure and is retried like any other network error.
+    /// </summary>
+    class HttpClient_LocalAgent : public IHttpClient
+    {
+    public:
+        explicit HttpClient_LocalAgent(std::string const& socketPath);
+        virtual ~HttpClient_LocalAgent();
+
+        virtual IHttpRequest* CreateRequest() override;
+        virtual void SendRequestAsync(IHttpRequest* request, IHttpResponseCallback* callback) override;
+        virtual void CancelRequestAsync(std::string const& id) override;
+
+    protected:
+        /// <summary>
+        /// Connection of one request; shut down to cancel the request.
+        /// </summary>
+        struct Operation
+        {
+            std::mutex lock;
+            int socket = -1;
+            bool aborted = false;
+        };
+
+        void run(SimpleHttpRequest* request, IHttpResponseCallback* callback, std::shared_ptr<Operation> operation);
+        HttpResult exchange(SimpleHttpRequest const& request, Operation& operation, SimpleHttpResponse& response);
+        void cancel(Operation& operation);
+
+        const std::string m_socketPath;
+        std::atomic<uint64_t> m_nextId;
+
+        std::mutex m_lock;
+        std::map<std::string, std::shared_ptr<Operation>> m_operations;
+        std::list<std::future<void>> m_workers;
+
+    private:
+        MATSDK_LOG_DECL_COMPONENT_CLASS();
+    };
+
+} MAT_NS_END
+
+#endif // HAVE_MAT_LOCAL_AGENT
+
+#endif
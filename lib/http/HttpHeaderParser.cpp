@@ -0,0 +1,177 @@
+//
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// SPDX-License-Identifier: Apache-2.0
+//
+#include "HttpHeaderParser.hpp"
+
+#include <cstring>
+
+namespace MAT_NS_BEGIN {
+
+    namespace
+    {
+        bool IsSpace(char c) noexcept
+        {
+            return c == ' ' || c == '\t' || c == '\r' || c == '\n';
+        }
+
+        void Trim(const char*& begin, const char*& end) noexcept
+        {
+            while (begin < end && IsSpace(*begin))
+            {
+                begin++;
+            }
+            while (end > begin && IsSpace(*(end - 1)))
+            {
+                end--;
+            }
+        }
+    }
+
+    HttpHeaderParser::HttpHeaderParser(HttpHeaders& headers) :
+        m_headers(headers),
+        m_lastHeader(headers.end()),
+        m_hasLastHeader(false),
+        m_statusCode(0)
+    {
+    }
+
+    void HttpHeaderParser::Feed(const char* data, size_t length)
+    {
+        const char* end = data + length;
+        while (data < end)
+        {
+            const char* newline = static_cast<const char*>(memchr(data, '\n', static_cast<size_t>(end - data)));
+            if (newline == nullptr)
+            {
+                m_partial.append(data, end);
+                return;
+            }
+            if (m_partial.empty())
+            {
+                parseLine(data, static_cast<size_t>(newline - data));
+            }
+            else
+            {
+                m_partial.append(data, newline);
+                parseLine(m_partial.data(), m_partial.size());
+                m_partial.clear();
+            }
+            data = newline + 1;
+        }
+    }
+
+    void HttpHeaderParser::Finish()
+    {
+        if (!m_partial.empty())
+        {
+            parseLine(m_partial.data(), m_partial.size());
+            m_partial.clear();
+        }
+    }
+
+    void HttpHeaderParser::Reset()
+    {
+        m_headers.clear();
+        m_lastHeader = m_headers.end();
+        m_hasLastHeader = false;
+        m_statusCode = 0;
+        m_partial.clear();
+    }
+
+    bool HttpHeaderParser::ParseStatusLine(const char* line, size_t length, long& statusCode)
+    {
+        static const char prefix[] = "HTTP/";
+        const size_t prefixLength = sizeof(prefix) - 1;
+        if (length < prefixLength || memcmp(line, prefix, prefixLength) != 0)
+        {
+            return false;
+        }
+
+        // Skip the protocol version up to the space before the status code
+        const char* end = line + length;
+        const char* c = line + prefixLength;
+        while (c < end && *c != ' ')
+        {
+            c++;
+        }
+        while (c < end && *c == ' ')
+        {
+            c++;
+        }
+
+        long code = 0;
+        int digits = 0;
+        while (c < end && *c >= '0' && *c <= '9' && digits < 3)
+        {
+            code = code * 10 + (*c - '0');
+            c++;
+            digits++;
+        }
+        if (digits != 3 || (c < end && !IsSpace(*c)))
+        {
+            return false;
+        }
+        statusCode = code;
+        return true;
+    }
+
+    void HttpHeaderParser::parseLine(const char* line, size_t length)
+    {
+        const char* begin = line;
+        const char* end = line + length;
+        if (end > begin && *(end - 1) == '\r')
+        {
+            end--;
+        }
+
+        if (begin == end)
+        {
+            // Blank line ending the header block
+            m_hasLastHeader = false;
+            return;
+        }
+
+        long statusCode = 0;
+        if (ParseStatusLine(begin, static_cast<size_t>(end - begin), statusCode))
+        {
+            m_headers.clear();
+            m_hasLastHeader = false;
+            m_statusCode = statusCode;
+            return;
+        }
+
+        if (*begin == ' ' || *begin == '\t')
+        {
+            // Obsolete line folding continues the previous value
+            Trim(begin, end);
+            if (m_hasLastHeader && begin < end)
+            {
+                std::string& value = m_lastHeader->second;
+                if (!value.empty())
+                {
+                    value.push_back(' ');
+                }
+                value.append(begin, end);
+            }
+            return;
+        }
+
+        const char* colon = static_cast<const char*>(memchr(begin, ':', static_cast<size_t>(end - begin)));
+        if (colon == nullptr || colon == begin)
+        {
+            return;
+        }
+        const char* nameEnd = colon;
+        while (nameEnd > begin && IsSpace(*(nameEnd - 1)))
+        {
+            nameEnd--;
+        }
+        const char* valueBegin = colon + 1;
+        Trim(valueBegin, end);
+
+        m_lastHeader = m_headers.emplace(std::string(begin, nameEnd), std::string(valueBegin, end));
+        m_hasLastHeader = true;
+    }
+
+} MAT_NS_END
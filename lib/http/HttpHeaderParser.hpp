@@ -0,0 +1,69 @@
+//
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// SPDX-License-Identifier: Apache-2.0
+//
+#ifndef HTTPHEADERPARSER_HPP
+#define HTTPHEADERPARSER_HPP
+
+#include "IHttpClient.hpp"
+
+#include <cstddef>
+#include <string>
+
+namespace MAT_NS_BEGIN {
+
+    /// <summary>
+    /// Incremental parser for the status and header lines of an HTTP response.
+    /// Data may be fed in arbitrary pieces; every complete line is parsed as soon
+    /// as it arrives and its header is added straight to the target HttpHeaders.
+    /// A new status line (e.g. the final response after "100 Continue") starts a
+    /// new response, dropping the headers of the previous one.
+    /// </summary>
+    class HttpHeaderParser
+    {
+    public:
+        explicit HttpHeaderParser(HttpHeaders& headers);
+
+        /// <summary>
+        /// Parses the complete lines in the data and keeps a trailing partial line for the next call.
+        /// </summary>
+        void Feed(const char* data, size_t length);
+
+        /// <summary>
+        /// Parses a trailing line which was not terminated by a line feed.
+        /// </summary>
+        void Finish();
+
+        /// <summary>
+        /// Clears the parser state and the target headers.
+        /// </summary>
+        void Reset();
+
+        /// <summary>
+        /// Status code from the last status line, 0 before the first one.
+        /// </summary>
+        long GetStatusCode() const noexcept
+        {
+            return m_statusCode;
+        }
+
+        /// <summary>
+        /// Parses "HTTP/1.1 200 OK", "HTTP/2 204" and the like.
+        /// </summary>
+        /// <returns>false when the line is not a status line.</returns>
+        static bool ParseStatusLine(const char* line, size_t length, long& statusCode);
+
+    protected:
+        void parseLine(const char* line, size_t length);
+
+        HttpHeaders&          m_headers;
+        HttpHeaders::iterator m_lastHeader;
+        bool                  m_hasLastHeader;
+        long                  m_statusCode;
+        // Partial line carried over between Feed() calls
+        std::string           m_partial;
+    };
+
+} MAT_NS_END
+
+#endif
@@ -22,7 +22,10 @@ namespace MAT_NS_BEGIN {
         :
         m_system(system),
         m_httpClient(httpClient),
-        m_config(system.getConfig())
+        m_config(system.getConfig()),
+        m_headerBlockValid(false),
+        m_headerAuthTokensController(nullptr),
+        m_headerTokensVersion(0)
     {
     }
 
@@ -35,74 +38,96 @@ namespace MAT_NS_BEGIN {
         m_system.getLogManager().GetDataViewerCollection().DispatchDataViewerEvent(dataPacket);
     }
 
-    bool HttpRequestEncoder::handleEncode(EventsUploadContextPtr const& ctx)
+    bool HttpRequestEncoder::isHeaderBlockCurrent(EventsUploadContextPtr const& ctx, IAuthTokensController* authTokensController)
     {
-        ctx->httpRequest = m_httpClient.CreateRequest();
-        ctx->httpRequestId = ctx->httpRequest->GetId();
-
-        ctx->httpRequest->SetMethod("POST");
-
-        ctx->httpRequest->SetUrl(m_config.GetCollectorUrl());
-
-        ctx->httpRequest->GetHeaders().set("Expect", "100-continue");
-        
-#ifdef HAVE_MAT_EVT_TRACEID 
-        ctx->httpRequest->GetHeaders().set("Trace-Id", ctx->traceId);
-#endif //HAVE_MAT_EVT_TRACEID 
-
-        ctx->httpRequest->GetHeaders().set("SDK-Version", PAL::getSdkVersion());
-        ctx->httpRequest->GetHeaders().set("Client-Id", "NO_AUTH");
-        ctx->httpRequest->GetHeaders().set("Content-Type", "application/bond-compact-binary");
-        ctx->httpRequest->GetHeaders().set("Upload-Time", toString(PAL::getUtcSystemTimeMs()));
-
+        if (!m_headerBlockValid || authTokensController != m_headerAuthTokensController)
+        {
+            return false;
+        }
+        if (authTokensController != nullptr &&
+            (authTokensController->GetTokensVersion() == 0 || authTokensController->GetTokensVersion() != m_headerTokensVersion))
+        {
+            return false;
+        }
+        if (ctx->packageIds.size() != m_headerTenantTokens.size())
+        {
+            return false;
+        }
+        auto tenantToken = m_headerTenantTokens.cbegin();
+        for (auto const& item : ctx->packageIds)
+        {
+            if (item.first != *tenantToken++)
+            {
+                return false;
+            }
+        }
+        return true;
+    }
 
-        if (GetAuthTokensController() != nullptr && GetAuthTokensController()->GetDeviceTokens().size() > 0)
+    void HttpRequestEncoder::buildHeaderBlock(EventsUploadContextPtr const& ctx, IAuthTokensController* authTokensController)
+    {
+        // Read before the tokens, so that tokens set meanwhile invalidate the block on the next upload
+        m_headerTokensVersion = (authTokensController != nullptr) ? authTokensController->GetTokensVersion() : 0;
+        m_headerBlock.clear();
+        m_headerBlock.set("Expect", "100-continue");
+        m_headerBlock.set("SDK-Version", PAL::getSdkVersion());
+        m_headerBlock.set("Client-Id", "NO_AUTH");
+        m_headerBlock.set("Content-Type", "application/bond-compact-binary");
+
+        if (authTokensController != nullptr && authTokensController->GetDeviceTokens().size() > 0)
         {
-            std::map<TicketType, std::string>& map = GetAuthTokensController()->GetDeviceTokens();
-            if (map.end() != map.find(TicketType::TicketType_MSA_Device))
+            std::map<TicketType, std::string> const& map = authTokensController->GetDeviceTokens();
+            auto it = map.find(TicketType::TicketType_MSA_Device);
+            if (it != map.end())
             {
-                ctx->httpRequest->GetHeaders().set("AuthMsaDeviceTicket", map[TicketType::TicketType_MSA_Device]);
+                m_headerBlock.set("AuthMsaDeviceTicket", it->second);
             }
 
-            if (map.end() != map.find(TicketType::TicketType_XAuth_Device))
+            it = map.find(TicketType::TicketType_XAuth_Device);
+            if (it != map.end())
             {
-                ctx->httpRequest->GetHeaders().set("AuthXToken", map[TicketType::TicketType_XAuth_Device]);
+                m_headerBlock.set("AuthXToken", it->second);
             }
 
-            if (map.end() != map.find(TicketType::TicketType_AAD))
+            it = map.find(TicketType::TicketType_AAD);
+            if (it != map.end())
             {
-                ctx->httpRequest->GetHeaders().set("Aad-Token", map[TicketType::TicketType_AAD]);
+                m_headerBlock.set("Aad-Token", it->second);
             }
 
-            if (map.end() != map.find(TicketType::TicketType_AAD_JWT))
+            it = map.find(TicketType::TicketType_AAD_JWT);
+            if (it != map.end())
             {
-                ctx->httpRequest->GetHeaders().set("Aad-Jwt-Token", map[TicketType::TicketType_AAD_JWT]);
+                m_headerBlock.set("Aad-Jwt-Token", it->second);
             }
 
-            if (map.end() != map.find(TicketType::TicketType_AAD_Device))
+            it = map.find(TicketType::TicketType_AAD_Device);
+            if (it != map.end())
             {
-                ctx->httpRequest->GetHeaders().set("AadDeviceToken", map[TicketType::TicketType_AAD_Device]);
+                m_headerBlock.set("AadDeviceToken", it->second);
             }
         }
 
-        if (GetAuthTokensController() != nullptr && GetAuthTokensController()->GetUserTokens().size() > 0)
+        if (authTokensController != nullptr && authTokensController->GetUserTokens().size() > 0)
         {  //create Ticket header
-            std::map<TicketType, std::string>& map = GetAuthTokensController()->GetUserTokens();
+            std::map<TicketType, std::string> const& map = authTokensController->GetUserTokens();
 
             std::string ticketHeader;
             // We know that each ticket is about 1kb in size, so pre-reserve space for the appends
-            ticketHeader.reserve(GetAuthTokensController()->GetUserTokens().size() * 1024);//
+            ticketHeader.reserve(map.size() * 1024);
 
-            if (map.end() != map.find(TicketType::TicketType_MSA_User))
+            auto it = map.find(TicketType::TicketType_MSA_User);
+            if (it != map.end())
             {
                 ticketHeader.append("\"");
                 ticketHeader.append(TICKETS_PREPEND_STRING + std::to_string(TicketType::TicketType_MSA_User));
                 ticketHeader.append("\"=\"");
                 ticketHeader.append("p:");
-                ticketHeader.append(map[TicketType::TicketType_MSA_User]);
+                ticketHeader.append(it->second);
                 ticketHeader.append("\"");
             }
-            if (map.end() != map.find(TicketType::TicketType_XAuth_User))
+            it = map.find(TicketType::TicketType_XAuth_User);
+            if (it != map.end())
             {
                 if (!ticketHeader.empty())
                 {
@@ -112,10 +137,11 @@ namespace MAT_NS_BEGIN {
                 ticketHeader.append(TICKETS_PREPEND_STRING + std::to_string(TicketType::TicketType_XAuth_User));
                 ticketHeader.append("\"=\"");
                 ticketHeader.append("x:XBL3.0 x=");
-                ticketHeader.append(map[TicketType::TicketType_XAuth_User]);
+                ticketHeader.append(it->second);
                 ticketHeader.append("\"");
             }
-            if (map.end() != map.find(TicketType::TicketType_AAD_User))
+            it = map.find(TicketType::TicketType_AAD_User);
+            if (it != map.end())
             {
                 if (!ticketHeader.empty())
                 {
@@ -125,33 +151,74 @@ namespace MAT_NS_BEGIN {
                 ticketHeader.append(TICKETS_PREPEND_STRING + std::to_string(TicketType::TicketType_AAD_User));
                 ticketHeader.append("\"=\"");
                 ticketHeader.append("at:");
-                ticketHeader.append(map[TicketType::TicketType_AAD_User]);
+                ticketHeader.append(it->second);
                 ticketHeader.append("\"");
             }
 
             if (!ticketHeader.empty())
             {
-                ctx->httpRequest->GetHeaders().set("Tickets", ticketHeader);
+                m_headerBlock.set("Tickets", ticketHeader);
             }
         }
         //strict mode
-        if (GetAuthTokensController() != nullptr && true == GetAuthTokensController()->GetStrictMode())
+        if (authTokensController != nullptr && true == authTokensController->GetStrictMode())
         {
-            ctx->httpRequest->GetHeaders().set("Strict", "true");
+            m_headerBlock.set("Strict", "true");
         }
 
         std::string tenantTokens;
         tenantTokens.reserve(ctx->packageIds.size() * 75); // Tenants tokens are usually 74 chars long.
+        m_headerTenantTokens.clear();
         for (auto const& item : ctx->packageIds) {
             if (!tenantTokens.empty()) {
                 tenantTokens.push_back(',');
             }
             tenantTokens.append(item.first);
+            m_headerTenantTokens.push_back(item.first);
         }
-        ctx->httpRequest->GetHeaders().set("APIKey", tenantTokens);
+        m_headerBlock.set("APIKey", tenantTokens);
+
+        m_headerAuthTokensController = authTokensController;
+        m_headerBlockValid = true;
+    }
+
+    bool HttpRequestEncoder::handleEncode(EventsUploadContextPtr const& ctx)
+    {
+        ctx->httpRequest = m_httpClient.CreateRequest();
+        ctx->httpRequestId = ctx->httpRequest->GetId();
+
+        ctx->httpRequest->SetMethod("POST");
+
+        ctx->collectorUrl = m_config.GetCollectorUrl();
+        ctx->httpRequest->SetUrl(ctx->collectorUrl);
+
+        // Headers which only depend on the auth tokens and the tenants are rendered once and reused
+        IAuthTokensController* authTokensController = GetAuthTokensController();
+        if (!isHeaderBlockCurrent(ctx, authTokensController))
+        {
+            buildHeaderBlock(ctx, authTokensController);
+        }
+        HttpHeaders& headers = ctx->httpRequest->GetHeaders();
+        if (headers.empty())
+        {
+            headers.insert(m_headerBlock.cbegin(), m_headerBlock.cend());
+        }
+        else
+        {
+            for (auto const& header : m_headerBlock)
+            {
+                headers.set(header.first, header.second);
+            }
+        }
+
+#ifdef HAVE_MAT_EVT_TRACEID 
+        headers.set("Trace-Id", ctx->traceId);
+#endif //HAVE_MAT_EVT_TRACEID 
+
+        headers.set("Upload-Time", toString(PAL::getUtcSystemTimeMs()));
 
         if (ctx->compressed) {
-            ctx->httpRequest->GetHeaders().add("Content-Encoding", "deflate");
+            headers.add("Content-Encoding", "deflate");
         }
 
 
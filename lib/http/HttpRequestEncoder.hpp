@@ -21,16 +21,25 @@ namespace MAT_NS_BEGIN {
         HttpRequestEncoder(ITelemetrySystem& system, IHttpClient& httpClient);
         ~HttpRequestEncoder();
 
-        RoutePassThrough<HttpRequestEncoder, EventsUploadContextPtr const&> encode { this, &HttpRequestEncoder::handleEncode };
+        RoutePassThrough<HttpRequestEncoder, EventsUploadContextPtr const&> encode { this, &HttpRequestEncoder::handleEncode, "encode" };
 
     protected:
         bool handleEncode(EventsUploadContextPtr const& ctx);
+        bool isHeaderBlockCurrent(EventsUploadContextPtr const& ctx, IAuthTokensController* authTokensController);
+        void buildHeaderBlock(EventsUploadContextPtr const& ctx, IAuthTokensController* authTokensController);
 
         ITelemetrySystem &      m_system;
         IHttpClient &           m_httpClient;
         IRuntimeConfig&         m_config;
 
-        IAuthTokensController* GetAuthTokensController()
+        // Headers shared by all uploads with the same tenants and auth tokens version
+        HttpHeaders              m_headerBlock;
+        bool                     m_headerBlockValid;
+        IAuthTokensController*   m_headerAuthTokensController;
+        uint64_t                 m_headerTokensVersion;
+        std::vector<std::string> m_headerTenantTokens;
+
+        virtual IAuthTokensController* GetAuthTokensController()
         {
             return m_system.getLogManager().GetAuthTokensController();
         }
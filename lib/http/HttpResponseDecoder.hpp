@@ -34,7 +34,7 @@ namespace MAT_NS_BEGIN {
         void handleDecode(EventsUploadContextPtr const& ctx);
 
     public:
-        RouteSink<HttpResponseDecoder, EventsUploadContextPtr const&> decode{ this, &HttpResponseDecoder::handleDecode };
+        RouteSink<HttpResponseDecoder, EventsUploadContextPtr const&> decode{ this, &HttpResponseDecoder::handleDecode, "decode" };
         RouteSource<EventsUploadContextPtr const&>                    eventsAccepted;
         RouteSource<EventsUploadContextPtr const&>                    eventsRejected;
         RouteSource<EventsUploadContextPtr const&>                    temporaryNetworkFailure;
@@ -0,0 +1,429 @@
+//
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// SPDX-License-Identifier: Apache-2.0
+//
+#include "LocalAgentProtocol.hpp"
+
+#ifdef HAVE_MAT_LOCAL_AGENT
+
+#include <cerrno>
+#include <cstring>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/types.h>
+#include <unistd.h>
+
+namespace MAT_NS_BEGIN {
+
+    constexpr uint8_t  LocalAgentProtocol::MessageRequest;
+    constexpr uint8_t  LocalAgentProtocol::MessageResponse;
+    constexpr uint8_t  LocalAgentProtocol::FlagBodyInFd;
+    constexpr size_t   LocalAgentProtocol::HeaderSize;
+    constexpr uint32_t LocalAgentProtocol::MaxPayloadSize;
+    constexpr size_t   LocalAgentProtocol::FdBodyThreshold;
+
+    namespace
+    {
+        const char Magic[4] = { 'M', 'A', 'T', 'A' };
+
+        void PutUint32(std::vector<uint8_t>& out, uint32_t value)
+        {
+            out.push_back(static_cast<uint8_t>(value));
+            out.push_back(static_cast<uint8_t>(value >> 8));
+            out.push_back(static_cast<uint8_t>(value >> 16));
+            out.push_back(static_cast<uint8_t>(value >> 24));
+        }
+
+        void PutBytes(std::vector<uint8_t>& out, const void* data, size_t length)
+        {
+            PutUint32(out, static_cast<uint32_t>(length));
+            const uint8_t* bytes = static_cast<const uint8_t*>(data);
+            out.insert(out.end(), bytes, bytes + length);
+        }
+
+        void PutString(std::vector<uint8_t>& out, std::string const& value)
+        {
+            PutBytes(out, value.data(), value.size());
+        }
+
+        void PutHeaders(std::vector<uint8_t>& out, HttpHeaders const& headers)
+        {
+            PutUint32(out, static_cast<uint32_t>(headers.size()));
+            for (auto const& header : headers)
+            {
+                PutString(out, header.first);
+                PutString(out, header.second);
+            }
+        }
+
+        /// Bounds-checked reader over a payload
+        class PayloadReader
+        {
+        public:
+            explicit PayloadReader(std::vector<uint8_t> const& payload) :
+                m_data(payload.data()),
+                m_end(payload.data() + payload.size())
+            {
+            }
+
+            bool Uint32(uint32_t& value)
+            {
+                if (m_end - m_data < 4)
+                {
+                    return false;
+                }
+                value = static_cast<uint32_t>(m_data[0]) | (static_cast<uint32_t>(m_data[1]) << 8) |
+                    (static_cast<uint32_t>(m_data[2]) << 16) | (static_cast<uint32_t>(m_data[3]) << 24);
+                m_data += 4;
+                return true;
+            }
+
+            bool String(std::string& value)
+            {
+                uint32_t length;
+                if (!Uint32(length) || static_cast<size_t>(m_end - m_data) < length)
+                {
+                    return false;
+                }
+                value.assign(reinterpret_cast<const char*>(m_data), length);
+                m_data += length;
+                return true;
+            }
+
+            bool Bytes(std::vector<uint8_t>& value)
+            {
+                uint32_t length;
+                if (!Uint32(length) || static_cast<size_t>(m_end - m_data) < length)
+                {
+                    return false;
+                }
+                value.assign(m_data, m_data + length);
+                m_data += length;
+                return true;
+            }
+
+            bool Headers(HttpHeaders& headers)
+            {
+                uint32_t count;
+                if (!Uint32(count))
+                {
+                    return false;
+                }
+                for (uint32_t i = 0; i < count; i++)
+                {
+                    std::string name;
+                    std::string value;
+                    if (!String(name) || !String(value))
+                    {
+                        return false;
+                    }
+                    headers.add(name, value);
+                }
+                return true;
+            }
+
+            bool AtEnd() const
+            {
+                return m_data == m_end;
+            }
+
+        protected:
+            const uint8_t* m_data;
+            const uint8_t* m_end;
+        };
+
+        bool WriteAll(int socket, const uint8_t* data, size_t length)
+        {
+            while (length > 0)
+            {
+                ssize_t written = ::send(socket, data, length, MSG_NOSIGNAL);
+                if (written < 0)
+                {
+                    if (errno == EINTR)
+                    {
+                        continue;
+                    }
+                    return false;
+                }
+                data += written;
+                length -= static_cast<size_t>(written);
+            }
+            return true;
+        }
+
+        bool ReadAll(int socket, uint8_t* data, size_t length)
+        {
+            while (length > 0)
+            {
+                ssize_t received = ::recv(socket, data, length, 0);
+                if (received < 0 && errno == EINTR)
+                {
+                    continue;
+                }
+                if (received <= 0)
+                {
+                    return false;
+                }
+                data += received;
+                length -= static_cast<size_t>(received);
+            }
+            return true;
+        }
+    }
+
+    void LocalAgentProtocol::EncodeRequest(Request const& request, bool bodyInFd, std::vector<uint8_t>& payload)
+    {
+        payload.clear();
+        payload.reserve(256 + (bodyInFd ? 0 : request.body.size()));
+        PutString(payload, request.id);
+        PutString(payload, request.method);
+        PutString(payload, request.url);
+        PutHeaders(payload, request.headers);
+        PutUint32(payload, static_cast<uint32_t>(request.latency));
+        if (bodyInFd)
+        {
+            PutUint32(payload, 0);
+        }
+        else
+        {
+            PutBytes(payload, request.body.data(), request.body.size());
+        }
+    }
+
+    bool LocalAgentProtocol::DecodeRequest(std::vector<uint8_t> const& payload, bool bodyInFd, Request& request)
+    {
+        PayloadReader reader(payload);
+        uint32_t latency;
+        std::vector<uint8_t> body;
+        if (!reader.String(request.id) || !reader.String(request.method) || !reader.String(request.url) ||
+            !reader.Headers(request.headers) || !reader.Uint32(latency) || !reader.Bytes(body) || !reader.AtEnd())
+        {
+            return false;
+        }
+        request.latency = static_cast<EventLatency>(static_cast<int32_t>(latency));
+        if (!bodyInFd)
+        {
+            request.body.swap(body);
+        }
+        return true;
+    }
+
+    void LocalAgentProtocol::EncodeResponse(Response const& response, std::vector<uint8_t>& payload)
+    {
+        payload.clear();
+        payload.reserve(128 + response.body.size());
+        PutString(payload, response.id);
+        PutUint32(payload, static_cast<uint32_t>(response.result));
+        PutUint32(payload, response.statusCode);
+        PutHeaders(payload, response.headers);
+        PutBytes(payload, response.body.data(), response.body.size());
+    }
+
+    bool LocalAgentProtocol::DecodeResponse(std::vector<uint8_t> const& payload, Response& response)
+    {
+        PayloadReader reader(payload);
+        uint32_t result;
+        uint32_t statusCode;
+        if (!reader.String(response.id) || !reader.Uint32(result) || !reader.Uint32(statusCode) ||
+            !reader.Headers(response.headers) || !reader.Bytes(response.body) || !reader.AtEnd())
+        {
+            return false;
+        }
+        response.result = static_cast<HttpResult>(result);
+        response.statusCode = statusCode;
+        return true;
+    }
+
+    bool LocalAgentProtocol::WriteFrame(int socket, uint8_t type, uint8_t flags, std::vector<uint8_t> const& payload, int bodyFd)
+    {
+        if (payload.size() > MaxPayloadSize)
+        {
+            return false;
+        }
+
+        uint8_t header[HeaderSize];
+        memcpy(header, Magic, sizeof(Magic));
+        header[4] = type;
+        header[5] = flags;
+        header[6] = 0;
+        header[7] = 0;
+        const uint32_t length = static_cast<uint32_t>(payload.size());
+        for (int i = 0; i < 4; i++)
+        {
+            header[8 + i] = static_cast<uint8_t>(length >> (8 * i));
+        }
+
+        if (bodyFd < 0)
+        {
+            return WriteAll(socket, header, sizeof(header)) && WriteAll(socket, payload.data(), payload.size());
+        }
+
+        // The descriptor travels with the header bytes
+        struct iovec iov;
+        iov.iov_base = header;
+        iov.iov_len = sizeof(header);
+        union
+        {
+            char buffer[CMSG_SPACE(sizeof(int))];
+            struct cmsghdr align;
+        } control;
+        memset(&control, 0, sizeof(control));
+        struct msghdr message;
+        memset(&message, 0, sizeof(message));
+        message.msg_iov = &iov;
+        message.msg_iovlen = 1;
+        message.msg_control = control.buffer;
+        message.msg_controllen = sizeof(control.buffer);
+        struct cmsghdr* cmsg = CMSG_FIRSTHDR(&message);
+        cmsg->cmsg_level = SOL_SOCKET;
+        cmsg->cmsg_type = SCM_RIGHTS;
+        cmsg->cmsg_len = CMSG_LEN(sizeof(int));
+        memcpy(CMSG_DATA(cmsg), &bodyFd, sizeof(int));
+
+        ssize_t sent;
+        do
+        {
+            sent = ::sendmsg(socket, &message, MSG_NOSIGNAL);
+        } while (sent < 0 && errno == EINTR);
+        if (sent < 0)
+        {
+            return false;
+        }
+        return WriteAll(socket, header + sent, sizeof(header) - static_cast<size_t>(sent)) &&
+            WriteAll(socket, payload.data(), payload.size());
+    }
+
+    bool LocalAgentProtocol::ReadFrame(int socket, uint8_t& type, uint8_t& flags, std::vector<uint8_t>& payload, int& bodyFd)
+    {
+        bodyFd = -1;
+        uint8_t header[HeaderSize];
+
+        struct iovec iov;
+        iov.iov_base = header;
+        iov.iov_len = sizeof(header);
+        union
+        {
+            char buffer[CMSG_SPACE(sizeof(int))];
+            struct cmsghdr align;
+        } control;
+        struct msghdr message;
+        memset(&message, 0, sizeof(message));
+        message.msg_iov = &iov;
+        message.msg_iovlen = 1;
+        message.msg_control = control.buffer;
+        message.msg_controllen = sizeof(control.buffer);
+
+        ssize_t received;
+        do
+        {
+            received = ::recvmsg(socket, &message, MSG_CMSG_CLOEXEC);
+        } while (received < 0 && errno == EINTR);
+        if (received <= 0)
+        {
+            return false;
+        }
+        for (struct cmsghdr* cmsg = CMSG_FIRSTHDR(&message); cmsg != nullptr; cmsg = CMSG_NXTHDR(&message, cmsg))
+        {
+            if (cmsg->cmsg_level == SOL_SOCKET && cmsg->cmsg_type == SCM_RIGHTS && cmsg->cmsg_len >= CMSG_LEN(sizeof(int)))
+            {
+                memcpy(&bodyFd, CMSG_DATA(cmsg), sizeof(int));
+            }
+        }
+
+        const bool valid = ReadAll(socket, header + received, sizeof(header) - static_cast<size_t>(received)) &&
+            memcmp(header, Magic, sizeof(Magic)) == 0;
+        uint32_t length = 0;
+        for (int i = 0; i < 4; i++)
+        {
+            length |= static_cast<uint32_t>(header[8 + i]) << (8 * i);
+        }
+        if (!valid || length > MaxPayloadSize)
+        {
+            if (bodyFd >= 0)
+            {
+                ::close(bodyFd);
+                bodyFd = -1;
+            }
+            return false;
+        }
+
+        type = header[4];
+        flags = header[5];
+        payload.resize(length);
+        if (!ReadAll(socket, payload.data(), payload.size()))
+        {
+            if (bodyFd >= 0)
+            {
+                ::close(bodyFd);
+                bodyFd = -1;
+            }
+            return false;
+        }
+        return true;
+    }
+
+    int LocalAgentProtocol::CreateBodyFd(std::vector<uint8_t> const& body)
+    {
+#if defined(__linux__) && !defined(__ANDROID__) && defined(MFD_CLOEXEC)
+        int fd = ::memfd_create("mat-request-body", MFD_CLOEXEC | MFD_ALLOW_SEALING);
+        if (fd < 0)
+        {
+            return -1;
+        }
+        size_t offset = 0;
+        while (offset < body.size())
+        {
+            ssize_t written = ::write(fd, body.data() + offset, body.size() - offset);
+            if (written < 0 && errno == EINTR)
+            {
+                continue;
+            }
+            if (written <= 0)
+            {
+                ::close(fd);
+                return -1;
+            }
+            offset += static_cast<size_t>(written);
+        }
+#ifdef F_ADD_SEALS
+        // The receiver can rely on the size and content staying as they are
+        ::fcntl(fd, F_ADD_SEALS, F_SEAL_SHRINK | F_SEAL_GROW | F_SEAL_WRITE | F_SEAL_SEAL);
+#endif
+        return fd;
+#else
+        (void)body;
+        return -1;
+#endif
+    }
+
+    bool LocalAgentProtocol::ReadBodyFd(int fd, std::vector<uint8_t>& body)
+    {
+        struct stat info;
+        if (::fstat(fd, &info) != 0 || info.st_size < 0 || static_cast<uint64_t>(info.st_size) > MaxPayloadSize)
+        {
+            return false;
+        }
+        body.resize(static_cast<size_t>(info.st_size));
+        size_t offset = 0;
+        while (offset < body.size())
+        {
+            ssize_t received = ::pread(fd, body.data() + offset, body.size() - offset, static_cast<off_t>(offset));
+            if (received < 0 && errno == EINTR)
+            {
+                continue;
+            }
+            if (received <= 0)
+            {
+                return false;
+            }
+            offset += static_cast<size_t>(received);
+        }
+        return true;
+    }
+
+} MAT_NS_END
+
+#endif // HAVE_MAT_LOCAL_AGENT
@@ -0,0 +1,92 @@
+//
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// SPDX-License-Identifier: Apache-2.0
+//
+#ifndef LOCALAGENTPROTOCOL_HPP
+#define LOCALAGENTPROTOCOL_HPP
+
+#include "mat/config.h"
+
+#ifdef HAVE_MAT_LOCAL_AGENT
+
+#include "IHttpClient.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace MAT_NS_BEGIN {
+
+    /// <summary>
+    /// Wire format between HttpClient_LocalAgent and LocalAgentServer over a Unix domain
+    /// stream socket. Every message is a frame: a 12 byte header ("MATA", message type,
+    /// flags, 2 reserved bytes, little-endian payload length) followed by the payload.
+    /// Payload fields are little-endian uint32 values and uint32 length-prefixed strings.
+    /// A request body above FdBodyThreshold may be passed as a sealed memfd attached to
+    /// the frame header with SCM_RIGHTS instead of being copied through the socket.
+    /// </summary>
+    class LocalAgentProtocol
+    {
+    public:
+        static constexpr uint8_t  MessageRequest = 1;
+        static constexpr uint8_t  MessageResponse = 2;
+        static constexpr uint8_t  FlagBodyInFd = 0x01;
+        static constexpr size_t   HeaderSize = 12;
+        static constexpr uint32_t MaxPayloadSize = 64 * 1024 * 1024;
+        static constexpr size_t   FdBodyThreshold = 64 * 1024;
+
+        /// <summary>
+        /// Request fields as sent by the client; the body is empty when it is passed in a file descriptor.
+        /// </summary>
+        struct Request
+        {
+            std::string          id;
+            std::string          method;
+            std::string          url;
+            HttpHeaders          headers;
+            EventLatency         latency = EventLatency_Unspecified;
+            std::vector<uint8_t> body;
+        };
+
+        struct Response
+        {
+            std::string          id;
+            HttpResult           result = HttpResult_LocalFailure;
+            unsigned             statusCode = 0;
+            HttpHeaders          headers;
+            std::vector<uint8_t> body;
+        };
+
+        static void EncodeRequest(Request const& request, bool bodyInFd, std::vector<uint8_t>& payload);
+        static bool DecodeRequest(std::vector<uint8_t> const& payload, bool bodyInFd, Request& request);
+        static void EncodeResponse(Response const& response, std::vector<uint8_t>& payload);
+        static bool DecodeResponse(std::vector<uint8_t> const& payload, Response& response);
+
+        /// <summary>
+        /// Writes a complete frame, attaching bodyFd to it when it is not -1.
+        /// </summary>
+        static bool WriteFrame(int socket, uint8_t type, uint8_t flags, std::vector<uint8_t> const& payload, int bodyFd = -1);
+
+        /// <summary>
+        /// Reads a complete frame. bodyFd receives an attached file descriptor, or -1;
+        /// the caller owns and closes it.
+        /// </summary>
+        static bool ReadFrame(int socket, uint8_t& type, uint8_t& flags, std::vector<uint8_t>& payload, int& bodyFd);
+
+        /// <summary>
+        /// Copies a body into a new sealed memory file. Returns -1 when memfd is not supported.
+        /// </summary>
+        static int CreateBodyFd(std::vector<uint8_t> const& body);
+
+        /// <summary>
+        /// Reads a whole body from a memory file created by CreateBodyFd().
+        /// </summary>
+        static bool ReadBodyFd(int fd, std::vector<uint8_t>& body);
+    };
+
+} MAT_NS_END
+
+#endif // HAVE_MAT_LOCAL_AGENT
+
+#endif
@@ -0,0 +1,393 @@
+//
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// SPDX-License-Identifier: Apache-2.0
+//
+#include "LocalAgentServer.hpp"
+
+#ifdef HAVE_MAT_LOCAL_AGENT
+
+#include <cerrno>
+#include <cstring>
+
+#include <fcntl.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+namespace MAT_NS_BEGIN {
+
+    MATSDK_LOG_INST_COMPONENT_CLASS(LocalAgentServer, "EventsSDK.LocalAgentServer", "Events telemetry client - LocalAgentServer class");
+
+    LocalAgentServer::Connection::~Connection()
+    {
+        ::close(fd);
+    }
+
+    /// <summary>
+    /// Returns the upstream response of one forwarded request to its connection.
+    /// </summary>
+    class LocalAgentServer::ForwardCallback : public IHttpResponseCallback
+    {
+    public:
+        ForwardCallback(LocalAgentServer& server, std::shared_ptr<Connection> const& connection, IHttpRequest* request, std::string const& clientId) :
+            m_server(server),
+            m_connection(connection),
+            m_request(request),
+            m_clientId(clientId)
+        {
+        }
+
+        virtual ~ForwardCallback()
+        {
+            // The request reports its destruction to this callback
+            delete m_request;
+        }
+
+        IHttpRequest* GetRequest() const
+        {
+            return m_request;
+        }
+
+        virtual void OnHttpResponse(IHttpResponse* response) override
+        {
+            LocalAgentProtocol::Response reply;
+            reply.id = m_clientId;
+            reply.result = response->GetResult();
+            reply.statusCode = response->GetStatusCode();
+            reply.headers = response->GetHeaders();
+            reply.body = response->GetBody();
+            delete response;
+
+            LocalAgentServer::respond(*m_connection, reply);
+
+            m_server.onForwarded(this);
+        }
+
+        virtual void OnHttpStateEvent(HttpStateEvent, void*, size_t) override
+        {
+        }
+
+    protected:
+        LocalAgentServer& m_server;
+        std::shared_ptr<Connection> m_connection;
+        IHttpRequest* m_request;
+        std::string m_clientId;
+    };
+
+    LocalAgentServer::LocalAgentServer(std::string const& socketPath, IHttpClient& upstream, std::set<std::string> const& collectorUrls) :
+        m_socketPath(socketPath),
+        m_upstream(upstream),
+        m_collectorUrls(collectorUrls),
+        m_listenFd(-1),
+        m_wakeFds{ -1, -1 },
+        m_stopping(false),
+        m_forwarded(0)
+    {
+    }
+
+    LocalAgentServer::~LocalAgentServer()
+    {
+        Stop();
+    }
+
+    bool LocalAgentServer::Start()
+    {
+        struct sockaddr_un address;
+        memset(&address, 0, sizeof(address));
+        address.sun_family = AF_UNIX;
+        if (m_listenFd >= 0 || m_socketPath.size() >= sizeof(address.sun_path))
+        {
+            return false;
+        }
+        memcpy(address.sun_path, m_socketPath.c_str(), m_socketPath.size());
+
+        m_listenFd = ::socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+        if (m_listenFd < 0)
+        {
+            return false;
+        }
+        // A socket file left behind by a previous instance would make bind() fail,
+        // but the socket of a forwarder still running must be left alone
+        if (!removeStaleSocket(address))
+        {
+            LOG_ERROR("Another forwarder is listening on %s", m_socketPath.c_str());
+            ::close(m_listenFd);
+            m_listenFd = -1;
+            return false;
+        }
+        // Restrict the socket to its owner and group before any client can connect
+        if (::bind(m_listenFd, reinterpret_cast<struct sockaddr*>(&address), sizeof(address)) != 0 ||
+            ::chmod(m_socketPath.c_str(), SocketMode) != 0 ||
+            ::listen(m_listenFd, SOMAXCONN) != 0 ||
+            ::pipe(m_wakeFds) != 0)
+        {
+            LOG_ERROR("Cannot listen on %s: errno=%d", m_socketPath.c_str(), errno);
+            ::close(m_listenFd);
+            m_listenFd = -1;
+            return false;
+        }
+        ::fcntl(m_wakeFds[0], F_SETFD, FD_CLOEXEC);
+        ::fcntl(m_wakeFds[1], F_SETFD, FD_CLOEXEC);
+
+        m_stopping = false;
+        m_acceptThread = std::thread(&LocalAgentServer::acceptLoop, this);
+        m_cleanupThread = std::thread(&LocalAgentServer::cleanupLoop, this);
+        LOG_INFO("Forwarding requests from %s", m_socketPath.c_str());
+        return true;
+    }
+
+    bool LocalAgentServer::removeStaleSocket(struct sockaddr_un const& address) const
+    {
+        struct stat info;
+        if (::lstat(m_socketPath.c_str(), &info) != 0 || !S_ISSOCK(info.st_mode))
+        {
+            // Nothing to remove, or not a socket: bind() reports the error
+            return true;
+        }
+        int probe = ::socket(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+        if (probe < 0)
+        {
+            return false;
+        }
+        int result = ::connect(probe, reinterpret_cast<struct sockaddr const*>(&address), sizeof(address));
+        int error = errno;
+        ::close(probe);
+        if (result != 0 && error == ECONNREFUSED)
+        {
+            ::unlink(m_socketPath.c_str());
+            return true;
+        }
+        // Connected, or a listener with a full backlog (EAGAIN)
+        return false;
+    }
+
+    void LocalAgentServer::Stop()
+    {
+        if (m_listenFd < 0)
+        {
+            return;
+        }
+
+        {
+            LOCKGUARD(m_lock);
+            m_stopping = true;
+            m_finishedChanged.notify_all();
+        }
+        char wake = 0;
+        while (::write(m_wakeFds[1], &wake, 1) < 0 && errno == EINTR)
+        {
+        }
+        m_acceptThread.join();
+
+        std::list<std::future<void>> readers;
+        std::set<std::string> pending;
+        {
+            LOCKGUARD(m_lock);
+            for (auto& weak : m_connections)
+            {
+                auto connection = weak.lock();
+                if (connection)
+                {
+                    ::shutdown(connection->fd, SHUT_RDWR);
+                }
+            }
+            m_connections.clear();
+            readers.swap(m_readers);
+        }
+        for (auto& reader : readers)
+        {
+            reader.wait();
+        }
+        {
+            LOCKGUARD(m_lock);
+            pending = m_pending;
+        }
+        for (auto const& id : pending)
+        {
+            m_upstream.CancelRequestAsync(id);
+        }
+        {
+            std::unique_lock<std::mutex> lock(m_lock);
+            m_idle.wait(lock, [this]() { return m_pending.empty(); });
+        }
+        m_cleanupThread.join();
+
+        ::close(m_listenFd);
+        ::close(m_wakeFds[0]);
+        ::close(m_wakeFds[1]);
+        m_listenFd = -1;
+        m_wakeFds[0] = m_wakeFds[1] = -1;
+        ::unlink(m_socketPath.c_str());
+    }
+
+    void LocalAgentServer::acceptLoop()
+    {
+        for (;;)
+        {
+            struct pollfd fds[2];
+            fds[0].fd = m_listenFd;
+            fds[0].events = POLLIN;
+            fds[1].fd = m_wakeFds[0];
+            fds[1].events = POLLIN;
+            if (::poll(fds, 2, -1) < 0)
+            {
+                if (errno == EINTR)
+                {
+                    continue;
+                }
+                break;
+            }
+            if (fds[1].revents != 0)
+            {
+                break;
+            }
+            if ((fds[0].revents & POLLIN) == 0)
+            {
+                continue;
+            }
+
+            int fd = ::accept(m_listenFd, nullptr, nullptr);
+            if (fd < 0)
+            {
+                continue;
+            }
+            ::fcntl(fd, F_SETFD, FD_CLOEXEC);
+            auto connection = std::make_shared<Connection>(fd);
+
+            LOCKGUARD(m_lock);
+            if (m_stopping)
+            {
+                break;
+            }
+            // Forget connections and readers that are done
+            m_connections.remove_if([](std::weak_ptr<Connection> const& weak) { return weak.expired(); });
+            m_readers.remove_if([](std::future<void> const& reader) {
+                return reader.wait_for(std::chrono::seconds(0)) == std::future_status::ready;
+            });
+            m_connections.push_back(connection);
+            m_readers.push_back(std::async(std::launch::async, &LocalAgentServer::serve, this, connection));
+        }
+    }
+
+    void LocalAgentServer::cleanupLoop()
+    {
+        std::unique_lock<std::mutex> lock(m_lock);
+        for (;;)
+        {
+            m_finishedChanged.wait(lock, [this]() { return !m_finished.empty() || (m_stopping && m_pending.empty()); });
+            if (m_finished.empty())
+            {
+                break;
+            }
+            std::list<ForwardCallback*> finished;
+            finished.swap(m_finished);
+            lock.unlock();
+            std::vector<std::string> ids;
+            for (ForwardCallback* callback : finished)
+            {
+                ids.push_back(callback->GetRequest()->GetId());
+                delete callback;
+            }
+            lock.lock();
+            for (auto const& id : ids)
+            {
+                m_pending.erase(id);
+            }
+            m_idle.notify_all();
+        }
+    }
+
+    void LocalAgentServer::serve(std::shared_ptr<Connection> connection)
+    {
+        std::vector<uint8_t> payload;
+        for (;;)
+        {
+            uint8_t type = 0;
+            uint8_t flags = 0;
+            int bodyFd = -1;
+            if (!LocalAgentProtocol::ReadFrame(connection->fd, type, flags, payload, bodyFd))
+            {
+                break;
+            }
+            bool forwarded = (type == LocalAgentProtocol::MessageRequest) && forward(connection, flags, payload, bodyFd);
+            if (bodyFd >= 0)
+            {
+                ::close(bodyFd);
+            }
+            if (!forwarded)
+            {
+                LOG_WARN("Dropping connection after an invalid message");
+                break;
+            }
+        }
+    }
+
+    bool LocalAgentServer::forward(std::shared_ptr<Connection> const& connection, uint8_t flags, std::vector<uint8_t> const& payload, int bodyFd)
+    {
+        const bool bodyInFd = (flags & LocalAgentProtocol::FlagBodyInFd) != 0;
+        LocalAgentProtocol::Request message;
+        if (!LocalAgentProtocol::DecodeRequest(payload, bodyInFd, message) ||
+            (bodyInFd && (bodyFd < 0 || !LocalAgentProtocol::ReadBodyFd(bodyFd, message.body))))
+        {
+            return false;
+        }
+
+        // Only uploads to the configured collectors are relayed
+        if (message.method != "POST" || m_collectorUrls.count(message.url) == 0)
+        {
+            LOG_WARN("Refusing request id=%s: %s %s", message.id.c_str(), message.method.c_str(), message.url.c_str());
+            LocalAgentProtocol::Response refusal;
+            refusal.id = message.id;
+            refusal.result = HttpResult_LocalFailure;
+            respond(*connection, refusal);
+            return true;
+        }
+
+        IHttpRequest* request = m_upstream.CreateRequest();
+        request->SetMethod(message.method);
+        request->SetUrl(message.url);
+        for (auto const& header : message.headers)
+        {
+            request->GetHeaders().add(header.first, header.second);
+        }
+        request->SetBody(message.body);
+        request->SetLatency(message.latency);
+
+        std::string upstreamId = request->GetId();
+        {
+            LOCKGUARD(m_lock);
+            if (m_stopping)
+            {
+                delete request;
+                return false;
+            }
+            m_pending.insert(upstreamId);
+        }
+        m_upstream.SendRequestAsync(request, new ForwardCallback(*this, connection, request, message.id));
+        return true;
+    }
+
+    void LocalAgentServer::respond(Connection& connection, LocalAgentProtocol::Response const& reply)
+    {
+        std::vector<uint8_t> payload;
+        LocalAgentProtocol::EncodeResponse(reply, payload);
+        LOCKGUARD(connection.writeLock);
+        if (!LocalAgentProtocol::WriteFrame(connection.fd, LocalAgentProtocol::MessageResponse, 0, payload))
+        {
+            LOG_WARN("Response to request id=%s could not be returned", reply.id.c_str());
+        }
+    }
+
+    void LocalAgentServer::onForwarded(ForwardCallback* callback)
+    {
+        LOCKGUARD(m_lock);
+        m_finished.push_back(callback);
+        m_forwarded++;
+        m_finishedChanged.notify_all();
+    }
+
+} MAT_NS_END
+
+#endif // HAVE_MAT_LOCAL_AGENT
@@ -0,0 +1,118 @@
+//
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// SPDX-License-Identifier: Apache-2.0
+//
+#ifndef LOCALAGENTSERVER_HPP
+#define LOCALAGENTSERVER_HPP
+
+#include "mat/config.h"
+
+#ifdef HAVE_MAT_LOCAL_AGENT
+
+#include "IHttpClient.hpp"
+#include "LocalAgentProtocol.hpp"
+#include "pal/PAL.hpp"
+
+#include <atomic>
+#include <condition_variable>
+#include <future>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <set>
+#include <string>
+#include <thread>
+
+#include <sys/types.h>
+#include <sys/un.h>
+
+namespace MAT_NS_BEGIN {
+
+    /// <summary>
+    /// Host side of the local-agent transport. Accepts connections from
+    /// HttpClient_LocalAgent instances on a Unix domain socket and replays every
+    /// request through one shared upstream IHttpClient, so all processes on the host
+    /// share its connections and TLS sessions to the collector. The upstream response
+    /// is returned to the requesting process unchanged. Only POST requests to one of
+    /// the configured collector URLs are relayed, and the socket is accessible to its
+    /// owner and group only. Records are forwarded through the shared queue instead
+    /// (see mat-forwarder --queue).
+    /// </summary>
+    class LocalAgentServer
+    {
+    public:
+        static constexpr mode_t SocketMode = 0660;
+
+        LocalAgentServer(std::string const& socketPath, IHttpClient& upstream, std::set<std::string> const& collectorUrls);
+        ~LocalAgentServer();
+
+        LocalAgentServer(LocalAgentServer const&) = delete;
+        LocalAgentServer& operator=(LocalAgentServer const&) = delete;
+
+        /// <summary>
+        /// Binds the socket and starts accepting connections. A socket file nobody listens
+        /// on any more is replaced; fails if another forwarder is listening on it.
+        /// </summary>
+        bool Start();
+
+        /// <summary>
+        /// Stops accepting, cancels the requests in flight, waits until they are
+        /// deleted and removes the socket file.
+        /// </summary>
+        void Stop();
+
+        uint64_t GetForwardedCount() const noexcept
+        {
+            return m_forwarded;
+        }
+
+    protected:
+        struct Connection
+        {
+            explicit Connection(int socket) : fd(socket) {}
+            ~Connection();
+            const int fd;
+            std::mutex writeLock;
+        };
+
+        class ForwardCallback;
+
+        bool removeStaleSocket(struct sockaddr_un const& address) const;
+        void acceptLoop();
+        void cleanupLoop();
+        void serve(std::shared_ptr<Connection> connection);
+        bool forward(std::shared_ptr<Connection> const& connection, uint8_t flags, std::vector<uint8_t> const& payload, int bodyFd);
+        static void respond(Connection& connection, LocalAgentProtocol::Response const& reply);
+        void onForwarded(ForwardCallback* callback);
+
+        const std::string m_socketPath;
+        IHttpClient& m_upstream;
+        const std::set<std::string> m_collectorUrls;
+        int m_listenFd;
+        int m_wakeFds[2];
+        std::thread m_acceptThread;
+        std::thread m_cleanupThread;
+
+        std::mutex m_lock;
+        std::condition_variable m_idle;
+        bool m_stopping;
+        std::list<std::weak_ptr<Connection>> m_connections;
+        std::list<std::future<void>> m_readers;
+        // Upstream request ids of requests not deleted yet
+        std::set<std::string> m_pending;
+        // Callbacks of answered requests, deleted with their requests on m_cleanupThread:
+        // clients like HttpClient_Curl wait for the response callback when a request is
+        // deleted and report the deletion to it
+        std::list<ForwardCallback*> m_finished;
+        std::condition_variable m_finishedChanged;
+        std::atomic<uint64_t> m_forwarded;
+
+    private:
+        MATSDK_LOG_DECL_COMPONENT_CLASS();
+    };
+
+} MAT_NS_END
+
+#endif // HAVE_MAT_LOCAL_AGENT
+
+#endif
@@ -6,6 +6,10 @@
 #define IBANDWIDTHCONTROLLER_HPP
 
 #include "ctmacros.hpp"
+#include "Enums.hpp"
+
+#include <cstddef>
+#include <tuple>
 
 namespace MAT_NS_BEGIN
 {
@@ -26,6 +30,29 @@ namespace MAT_NS_BEGIN
         /// </summary>
         /// <returns>An unsigned integer that contains the proposed bandwidth in bytes per second.</returns>
         virtual unsigned GetProposedBandwidthBps() = 0;
+
+        /// <summary>
+        /// Notifies the controller that an HTTP request carrying events of the
+        /// given latency has been handed over to the HTTP client.
+        /// </summary>
+        /// <param name="latency">Highest latency of the events in the request</param>
+        /// <param name="bytes">Request size in bytes</param>
+        virtual void OnBytesSent(EventLatency latency, size_t bytes)
+        {
+            std::ignore = latency;
+            std::ignore = bytes;
+        }
+
+        /// <summary>
+        /// Queries how long the SDK should wait before uploading events of the
+        /// given latency, so that the bytes already sent stay within the budget.
+        /// </summary>
+        /// <returns>Delay in milliseconds, 0 if the upload may start now</returns>
+        virtual unsigned GetSendDelayMs(EventLatency latency)
+        {
+            std::ignore = latency;
+            return 0;
+        }
     };
 
     /// @endcond
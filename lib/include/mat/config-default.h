@@ -26,6 +26,7 @@
 #define HAVE_MAT_JSONHPP
 #define HAVE_MAT_ZLIB
 #define HAVE_MAT_LOGGING
+#define HAVE_MAT_PIPELINE_TRACE
 /* #define HAVE_MAT_WIN_LOG     */
 /* #define HAVE_MAT_EVT_TRACEID     */
 #define HAVE_MAT_STORAGE
@@ -36,6 +37,12 @@
 #if defined(_WIN32) && !defined(_WINRT_DLL)
 #define HAVE_MAT_NETDETECT
 #endif
+#if defined(__linux__)
+#define HAVE_MAT_LOCAL_AGENT
+#endif
+#if !defined(_WIN32)
+#define HAVE_MAT_SHARED_QUEUE
+#endif
 #define HAVE_CS3
 //#define HAVE_CS4
 //#define HAVE_CS4_FULL
@@ -73,6 +73,8 @@ namespace MAT_NS_BEGIN
         EVT_DROPPED             = 0x03000000,
         /// <summary>Event(s) filtered.</summary>
         EVT_FILTERED            = 0x03000001,
+        /// <summary>Event(s) sampled out on the client, reported on each stats send (param1: count).</summary>
+        EVT_SAMPLED             = 0x03000002,
 
         /// <summary>Event(s) sent.</summary>
         EVT_SENT                = 0x04000000,
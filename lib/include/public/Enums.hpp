@@ -459,6 +459,31 @@ namespace MAT_NS_BEGIN
     };
 
 
+    /// <summary>
+    /// Stage of event delivery measured by ILogManager::GetDeliveryLatency
+    /// </summary>
+    enum DeliveryStage
+    {
+        /// Queue: from submitting the event to storing it
+        DeliveryStage_Queue = 0,
+
+        /// Storage: from storing the event to retrieving it for upload
+        DeliveryStage_Storage = 1,
+
+        /// Packaging: building the upload package the event is part of
+        DeliveryStage_Packaging = 2,
+
+        /// Compression: compressing the upload package
+        DeliveryStage_Compression = 3,
+
+        /// Network: HTTP request of the upload package
+        DeliveryStage_Network = 4,
+
+        /// Total: from storing the event to the collector accepting it
+        DeliveryStage_Total = 5,
+    };
+
+
     /// <summary>
     /// Persistence for an event
     /// </summary>
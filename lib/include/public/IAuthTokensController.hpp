@@ -53,18 +53,26 @@ namespace MAT_NS_BEGIN
         virtual std::vector<std::string>&  GetTickets() = 0;
 
         /// <summary>
-        /// Set the Auth ticket.
+        /// Gets the device tokens. They are changed through SetTicketToken() and Clear() only,
+        /// which update GetTokensVersion().
         /// </summary>
-        /// <param name="type">Ticket type</param>
-        /// <param name="ticketValue">Ticketvalue</param>
-        virtual std::map<TicketType, std::string>&  GetDeviceTokens() = 0;
+        virtual std::map<TicketType, std::string> const&  GetDeviceTokens() = 0;
 
         /// <summary>
-        /// Set the Auth ticket.
+        /// Gets the user tokens. They are changed through SetTicketToken() and Clear() only,
+        /// which update GetTokensVersion().
         /// </summary>
-        /// <param name="type">Ticket type</param>
-        /// <param name="ticketValue">Ticketvalue</param>
-        virtual std::map<TicketType, std::string>&  GetUserTokens() = 0;
+        virtual std::map<TicketType, std::string> const&  GetUserTokens() = 0;
+
+        /// <summary>
+        /// Gets a number that changes whenever tokens are set or cleared or the strict mode changes.
+        /// Uploads reuse their auth headers while it stays the same.
+        /// </summary>
+        /// <returns>0 when the implementation does not track changes.</returns>
+        virtual uint64_t  GetTokensVersion()
+        {
+            return 0;
+        }
 
     };
 
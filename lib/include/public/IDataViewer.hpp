@@ -9,11 +9,17 @@
 #include "IModule.hpp"
 
 #include <cstdint>
+#include <memory>
 #include <string>
 #include <vector>
 
 namespace MAT_NS_BEGIN
 {
+    /// <summary>
+    /// Immutable uploaded packet shared between all data viewers.
+    /// </summary>
+    using DataViewerPacket = std::shared_ptr<const std::vector<uint8_t>>;
+
     /// <summary>
     /// This interface allows SDK users to register a data viewer
     /// that will receive all packets uploaded by the SDK.
@@ -27,6 +33,17 @@ namespace MAT_NS_BEGIN
         /// <param name="packetData">HTTP Request Packet as a binary blob.</param>
         virtual void ReceiveData(const std::vector<uint8_t>& packetData) noexcept = 0;
 
+        /// <summary>
+        /// This method allows SDK to pass the uploaded packet to the data viewer
+        /// without copying it. Viewers may keep the packet for as long as needed.
+        /// Packets are delivered on a dedicated thread, never on the upload path.
+        /// </summary>
+        /// <param name="packet">HTTP Request Packet as a shared immutable binary blob.</param>
+        virtual void ReceivePacket(const DataViewerPacket& packet) noexcept
+        {
+            ReceiveData(*packet);
+        }
+
         /// <summary>
         /// Get the name of the current viewer.
         /// </summary>
@@ -25,6 +25,15 @@ namespace MAT_NS_BEGIN
         /// <param name="packetData">Data packet to be passed to all viewers.</param>
         virtual void DispatchDataViewerEvent(const std::vector<uint8_t>& packetData) const noexcept = 0;
 
+        /// <summary>
+        /// Dispatch a shared immutable Data Viewer packet to all viewers in the collection.
+        /// </summary>
+        /// <param name="packet">Data packet to be passed to all viewers.</param>
+        virtual void DispatchDataViewerPacket(const DataViewerPacket& packet) const noexcept
+        {
+            DispatchDataViewerEvent(*packet);
+        }
+
         /// <summary>
         /// Register an IDataViewer with Data Viewer Collection.
         /// </summary>
@@ -64,6 +73,14 @@ namespace MAT_NS_BEGIN
         /// Unique Name to identify the viewer being checked.
         /// </param>
         virtual bool IsViewerRegistered(const char* viewerName) const = 0;
+
+        /// <summary>
+        /// Get the number of packets dropped because a viewer lagged behind.
+        /// </summary>
+        virtual size_t GetDroppedPacketCount() const noexcept
+        {
+            return 0;
+        }
     };
 
 } MAT_NS_END
@@ -31,6 +31,17 @@ namespace MAT_NS_BEGIN
         /// <param name="properties">The full set of event properties that may be sent</param>
         /// <returns>True if the event satisfies the filter condtitions, false otherwise.</returns>
         virtual bool CanEventPropertiesBeSent(const EventProperties& properties) const noexcept = 0;
+
+        /// <summary>
+        /// Declares that CanEventPropertiesBeSent depends only on the event name and
+        /// diagnostic level and never changes over time, so that the collection may
+        /// memoize its decisions. Filters looking at anything else must return false.
+        /// </summary>
+        /// <returns>True if decisions of this filter may be cached, false otherwise.</returns>
+        virtual bool IsDecisionCacheable() const noexcept
+        {
+            return false;
+        }
     };
 
 } MAT_NS_END
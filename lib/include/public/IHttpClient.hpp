@@ -73,24 +73,25 @@ namespace MAT_NS_BEGIN
         }
 
         /// <summary>
-        /// Gets a string value given a name.
+        /// Gets a string value given a name. Names are compared case-insensitively
+        /// when there is no header with exactly the same name.
         /// </summary>
         /// <param name="name">A string that contains the name.</param>
         /// <returns>A string that contains the value associated with the name.</returns>
         std::string const& get(std::string const& name) const
         {
-            auto it = find(name);
+            auto it = findIgnoreCase(name);
             return (it != end()) ? it->second : m_empty;
         }
 
         /// <summary>
-        /// Tests whether the multimap contains the specified name.
+        /// Tests whether the multimap contains the specified name, compared as in get().
         /// </summary>
         /// <param name="name">A string that contains the name to look for.</param>
         /// <returns>A boolean that indicates success (true), or failure (false).</returns>
         bool has(std::string const& name) const
         {
-            auto it = find(name);
+            auto it = findIgnoreCase(name);
             return (it != end());
         }
 
@@ -98,6 +99,40 @@ namespace MAT_NS_BEGIN
         using std::multimap<std::string, std::string>::end;
 
     protected:
+        const_iterator findIgnoreCase(std::string const& name) const
+        {
+            auto it = find(name);
+            if (it == end())
+            {
+                for (it = begin(); it != end(); ++it)
+                {
+                    if (equalsIgnoreCase(it->first, name))
+                    {
+                        break;
+                    }
+                }
+            }
+            return it;
+        }
+
+        static bool equalsIgnoreCase(std::string const& a, std::string const& b) noexcept
+        {
+            if (a.size() != b.size())
+            {
+                return false;
+            }
+            for (size_t i = 0; i < a.size(); i++)
+            {
+                char x = a[i];
+                char y = b[i];
+                if (x != y && ((x | 0x20) != (y | 0x20) || (x | 0x20) < 'a' || (x | 0x20) > 'z'))
+                {
+                    return false;
+                }
+            }
+            return true;
+        }
+
         std::string m_empty;
     };
 
@@ -124,6 +124,23 @@ namespace MAT_NS_BEGIN
     /// </summary>
     static constexpr const char* const CFG_STR_COLLECTOR_URL = "eventCollectorUri";
 
+    /// <summary>
+    /// Comma-separated alternate collector URIs, used when the event collection URI is
+    /// unhealthy or, depending on CFG_STR_COLLECTOR_SELECTION, to spread the uploads.
+    /// </summary>
+    static constexpr const char* const CFG_STR_COLLECTOR_ALTERNATE_URLS = "alternateCollectorUris";
+
+    /// <summary>
+    /// How uploads pick a healthy collector: "primary" (the first one in configuration
+    /// order), "leastLatency" or "weighted" (by measured round trip time and errors).
+    /// </summary>
+    static constexpr const char* const CFG_STR_COLLECTOR_SELECTION = "collectorSelection";
+
+    /// <summary>
+    /// How long a collector that keeps failing is left out of rotation, in milliseconds.
+    /// </summary>
+    static constexpr const char* const CFG_INT_COLLECTOR_BREAKER_COOLDOWN = "collectorBreakerCooldownMs";
+
     /// <summary>
     /// The cache file-path.
     /// </summary>
@@ -144,11 +161,44 @@ namespace MAT_NS_BEGIN
     /// </summary>
     static constexpr const char* const CFG_INT_RAM_QUEUE_BUFFERS = "maxDBFlushQueues";
 
+    /// <summary>
+    /// Path of a memory-mapped queue shared by all processes on the host (e.g. a file
+    /// in /dev/shm). When set, records go to the shared queue instead of the RAM queue
+    /// and the cache file, and one of the processes uploads them for all, to its own
+    /// collector and with its own tickets. Processes that share the queue must use the
+    /// same collector URL and tickets.
+    /// </summary>
+    static constexpr const char* const CFG_STR_SHARED_QUEUE_PATH = "sharedQueuePath";
+
+    /// <summary>
+    /// The shared queue size in bytes, used when the queue is created.
+    /// </summary>
+    static constexpr const char* const CFG_INT_SHARED_QUEUE_SIZE = "sharedQueueSizeInBytes";
+
+    /// <summary>
+    /// Whether this process may upload the records of the shared queue. Set it to false
+    /// in every process when a host forwarder (mat-forwarder --queue) uploads for all of
+    /// them: the processes then only append their records to the queue.
+    /// </summary>
+    static constexpr const char* const CFG_BOOL_SHARED_QUEUE_UPLOAD = "sharedQueueUpload";
+
     /// <summary>
     /// SQLite DB will be checkpointed when flushing.
     /// </summary>
     static constexpr const char* const CFG_BOOL_CHECKPOINT_DB_ON_FLUSH = "checkpointDBOnFlush";
 
+    /// <summary>
+    /// Open the cache file on the worker thread instead of during LogManager startup.
+    /// Events logged meanwhile wait in the RAM queue, which has to be enabled.
+    /// </summary>
+    static constexpr const char* const CFG_BOOL_ASYNC_STORAGE_OPEN = "asyncStorageOpen";
+
+    /// <summary>
+    /// Save the system information which only changes with a reboot next to the cache file,
+    /// so that later starts during the same boot do not read and parse it again (Linux only).
+    /// </summary>
+    static constexpr const char* const CFG_BOOL_CACHE_SYSTEM_INFO = "cacheSystemInfo";
+
     /// <summary>
     /// The trace level mask.
     /// </summary>
@@ -169,6 +219,17 @@ namespace MAT_NS_BEGIN
     /// </summary>
     static constexpr const char* const CFG_STR_TRACE_FOLDER_PATH = "traceFolderPath";
 
+    /// <summary>
+    /// Size in bytes at which the trace file is rotated, 0 for no limit.
+    /// </summary>
+    static constexpr const char* const CFG_INT_TRACE_FILE_SIZE = "traceFileSizeLimit";
+
+    /// <summary>
+    /// Record the time spent in every pipeline stage and worker task, see ILogManager::GetPipelineTrace().
+    /// Requires a build with HAVE_MAT_PIPELINE_TRACE.
+    /// </summary>
+    static constexpr const char* const CFG_BOOL_ENABLE_PIPELINE_TRACE = "enablePipelineTrace";
+
     /// <summary>
     /// The SDK mode.
     /// </summary>
@@ -311,6 +372,69 @@ namespace MAT_NS_BEGIN
     /// </summary>
     static constexpr const char* const CFG_STR_CONTEXT_SCOPE = "scope";
 
+    /// <summary>
+    /// Client-side sampling configuration
+    /// </summary>
+    static constexpr const char* const CFG_MAP_SAMPLE = "sample";
+
+    /// <summary>
+    /// Sampling configuration: percentage of devices that keep events not matched
+    /// by any rule (0 or 100 disables default sampling)
+    /// </summary>
+    static constexpr const char* const CFG_INT_SAMPLE_RATE = "rate";
+
+    /// <summary>
+    /// Sampling configuration: ID that drives sampling decisions: "device" (default),
+    /// "session" or any other string used verbatim
+    /// </summary>
+    static constexpr const char* const CFG_STR_SAMPLE_KEY = "key";
+
+    /// <summary>
+    /// Sampling configuration: array of rules, each a map with optional "tenant" (tenant ID),
+    /// "event" (name, trailing '*' matches a prefix), "level" and a mandatory "rate".
+    /// The first matching rule wins.
+    /// </summary>
+    static constexpr const char* const CFG_ARR_SAMPLE_RULES = "rules";
+
+    /// <summary>
+    /// Metrics pre-aggregation configuration
+    /// </summary>
+    static constexpr const char* const CFG_MAP_METRICS = "metrics";
+
+    /// <summary>
+    /// Metrics configuration: aggregate LogSampledMetric observations into
+    /// one AggregatedMetric event per series and interval
+    /// </summary>
+    static constexpr const char* const CFG_BOOL_METRICS_AGGREGATE_SAMPLED = "aggregateSampled";
+
+    /// <summary>
+    /// Metrics configuration: aggregation interval (in seconds)
+    /// </summary>
+    static constexpr const char* const CFG_INT_METRICS_INTERVAL = "interval";
+
+    /// <summary>
+    /// Metrics configuration: maximum number of aggregated series, observations
+    /// of further series are logged as regular events
+    /// </summary>
+    static constexpr const char* const CFG_INT_METRICS_MAX_SERIES = "maxSeries";
+
+    /// <summary>
+    /// Coalescing of repeated identical events
+    /// </summary>
+    static constexpr const char* const CFG_MAP_COALESCE = "coalesce";
+
+    /// <summary>
+    /// Coalescing configuration: window (in milliseconds) in which identical events
+    /// are folded into one summary record, 0 disables coalescing
+    /// </summary>
+    static constexpr const char* const CFG_INT_COALESCE_WINDOW_MS = "windowMs";
+
+    /// <summary>
+    /// Coalescing configuration: maximum number of open windows, the oldest
+    /// window is closed early when a new one is needed
+    /// </summary>
+    static constexpr const char* const CFG_INT_COALESCE_MAX_ENTRIES = "maxEntries";
+
     /// <summary>
     /// MetaStats configuration
     /// </summary>
@@ -326,6 +450,12 @@ namespace MAT_NS_BEGIN
     /// </summary>
     static constexpr const char* const CFG_BOOL_METASTATS_SPLIT = "split";
 
+    /// <summary>
+    /// MetaStats configuration: track delivery latency histograms per tenant,
+    /// event latency and delivery stage (see ILogManager::GetDeliveryLatency)
+    /// </summary>
+    static constexpr const char* const CFG_BOOL_METASTATS_DELIVERY_LATENCY = "deliveryLatency";
+
     /// <summary>
     /// Compatibility configuration
     /// </summary>
@@ -361,6 +491,25 @@ namespace MAT_NS_BEGIN
     /// </summary>
     static constexpr const char* const CFG_BOOL_HTTP_COMPRESSION = "compress";
 
+    /// <summary>
+    /// HTTP configuration: path of the Unix domain socket of a local forwarder
+    /// that uploads on behalf of this process. Empty to upload directly. The records
+    /// stay in this process; see CFG_BOOL_SHARED_QUEUE_UPLOAD to hand them over too.
+    /// </summary>
+    static constexpr const char* const CFG_STR_HTTP_LOCAL_AGENT_SOCKET = "localAgentSocket";
+
+    /// <summary>
+    /// HTTP configuration: resolve and connect to the collector in the background
+    /// while the LogManager starts, so that the first upload finds DNS and TLS warm.
+    /// </summary>
+    static constexpr const char* const CFG_BOOL_HTTP_PREWARM = "prewarm";
+
+    /// <summary>
+    /// HTTP configuration: keep TLS sessions in the offline storage settings across
+    /// restarts, so that the first upload after a restart resumes the TLS session.
+    /// </summary>
+    static constexpr const char* const CFG_BOOL_HTTP_PERSIST_TLS_SESSIONS = "persistTlsSessions";
+
     /// <summary>
     /// TPM configuration map
     /// </summary>
@@ -372,7 +521,10 @@ namespace MAT_NS_BEGIN
     static constexpr const char* const CFG_INT_TPM_MAX_RETRY = "maxRetryCount";
 
     /// <summary>
-    /// TPM configuration map
+    /// TPM configuration: upload retry backoff. One of
+    /// "E,initialMs,maximumMs,multiplier,jitter" (exponential),
+    /// "D,baseMs,maximumMs" (decorrelated jitter) or
+    /// "R,spread,&lt;inner&gt;" (honor Retry-After on top of an inner backoff).
     /// </summary>
     static constexpr const char* const CFG_STR_TPM_BACKOFF = "backoffConfig";
 
@@ -386,6 +538,55 @@ namespace MAT_NS_BEGIN
     /// </summary>
     static constexpr const char* const CFG_BOOL_TPM_CLOCK_SKEW_ENABLED = "clockSkewEnabled";
 
+    /// <summary>
+    /// TPM configuration: build packages with weighted fair share per tenant
+    /// and upload packages of different tenants concurrently
+    /// </summary>
+    static constexpr const char* const CFG_BOOL_TPM_FAIR_UPLOAD = "fairUpload";
+
+    /// <summary>
+    /// TPM configuration: map of tenant id to integer fairness weight (default 1)
+    /// </summary>
+    static constexpr const char* const CFG_MAP_TPM_TENANT_WEIGHTS = "tenantWeights";
+
+    /// <summary>
+    /// TPM configuration: trigger uploads from queue watermarks and per-latency
+    /// max delay instead of polling on transmit profile timers
+    /// </summary>
+    static constexpr const char* const CFG_BOOL_TPM_EVENT_TRIGGERS = "eventTriggers";
+
+    /// <summary>
+    /// TPM configuration: number of events queued per latency that triggers an upload (0 disables)
+    /// </summary>
+    static constexpr const char* const CFG_INT_TPM_WATERMARK_COUNT = "watermarkCount";
+
+    /// <summary>
+    /// TPM configuration: bytes queued per latency that trigger an upload (0 disables)
+    /// </summary>
+    static constexpr const char* const CFG_INT_TPM_WATERMARK_BYTES = "watermarkBytes";
+
+    /// <summary>
+    /// TPM configuration: map of latency name ("Normal", "CostDeferred", "RealTime")
+    /// to max upload delay in milliseconds (default: transmit profile timers)
+    /// </summary>
+    static constexpr const char* const CFG_MAP_TPM_MAX_DELAY = "maxDelayMs";
+
+    /// <summary>
+    /// TPM configuration: sustained upload rate in bytes per second (0 = unlimited)
+    /// </summary>
+    static constexpr const char* const CFG_INT_TPM_BANDWIDTH_BPS = "bandwidthBps";
+
+    /// <summary>
+    /// TPM configuration: upload burst size in bytes (default: max upload size)
+    /// </summary>
+    static constexpr const char* const CFG_INT_TPM_BANDWIDTH_BURST = "bandwidthBurst";
+
+    /// <summary>
+    /// TPM configuration: map of latency name ("Normal", "CostDeferred", "RealTime",
+    /// "Immediate") to upload rate in bytes per second overriding bandwidthBps
+    /// </summary>
+    static constexpr const char* const CFG_MAP_TPM_BANDWIDTH_LATENCY_BPS = "bandwidthLatencyBps";
+
     /// <summary>
     /// When enabled, the session timer is reset after session is completed, allowing for several session events in the duration of the SDK lifecycle
     /// </summary>
@@ -11,6 +11,7 @@
 #include <cstdint>
 #include <string>
 #include <functional>
+#include <vector>
 
 #include "Enums.hpp"
 #include "IAuthTokensController.hpp"
@@ -27,6 +28,25 @@
 
 namespace MAT_NS_BEGIN
 {
+    /// <summary>
+    /// Distribution of the time events of one tenant and latency spent in one delivery stage.
+    /// Percentiles are estimated from a log-linear histogram with buckets 25% wide.
+    /// </summary>
+    struct DeliveryLatencyStats
+    {
+        std::string tenantToken;
+        EventLatency latency = EventLatency_Normal;
+        DeliveryStage stage = DeliveryStage_Total;
+        /// Number of events measured
+        uint64_t count = 0;
+        double minMs = 0;
+        double maxMs = 0;
+        double meanMs = 0;
+        double p50Ms = 0;
+        double p99Ms = 0;
+        double p999Ms = 0;
+    };
+
     class IContextProvider
     {
        public:
@@ -429,6 +449,20 @@ namespace MAT_NS_BEGIN
         /// method if StartActivity returned true.
         /// </summary>
         virtual void EndActivity() = 0;
+
+        /// <summary>
+        /// Returns the delivery latency of the events uploaded since the telemetry system started,
+        /// one entry per tenant, event latency and delivery stage with at least one measurement.
+        /// Empty unless enabled with CFG_BOOL_METASTATS_DELIVERY_LATENCY.
+        /// </summary>
+        virtual std::vector<DeliveryLatencyStats> GetDeliveryLatency() = 0;
+
+        /// <summary>
+        /// Returns the most recent pipeline stage and worker task timings as Chrome trace_event
+        /// JSON, which can be loaded in chrome://tracing. The timings are process-wide.
+        /// Empty trace unless enabled with CFG_BOOL_ENABLE_PIPELINE_TRACE.
+        /// </summary>
+        virtual std::string GetPipelineTrace() = 0;
     };
 
 }
@@ -226,6 +226,27 @@ namespace MAT_NS_BEGIN {
         virtual bool GetAndReserveRecords(std::function<bool(StorageRecord&&)> const& consumer, unsigned leaseTimeMs,
             EventLatency minLatency = EventLatency_Unspecified, unsigned maxCount = 0) = 0;
 
+        /// <summary>
+        /// Retrieve the best records of a single tenant to upload
+        /// </summary>
+        /// <remarks>
+        /// Same as <see cref="GetAndReserveRecords"/>, but only records stored
+        /// with the specified <paramref name="tenantToken"/> are considered.
+        /// Used to build per-tenant packages when fair upload is enabled.
+        /// Storage implementations that cannot filter by tenant return
+        /// <c>false</c> without calling the consumer.
+        /// </remarks>
+        virtual bool GetAndReserveTenantRecords(std::function<bool(StorageRecord&&)> const& consumer, unsigned leaseTimeMs,
+            std::string const& tenantToken, EventLatency minLatency = EventLatency_Unspecified, unsigned maxCount = 0)
+        {
+            std::ignore = consumer;
+            std::ignore = leaseTimeMs;
+            std::ignore = tenantToken;
+            std::ignore = minLatency;
+            std::ignore = maxCount;
+            return false;
+        }
+
         /// <summary>
         /// return where the last read was memory or disk
         /// </summary>
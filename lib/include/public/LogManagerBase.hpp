@@ -735,6 +735,26 @@ namespace MAT_NS_BEGIN
             LM_SAFE_CALL_VOID(EndActivity);
         }
 
+        /// <summary>
+        /// Delivery latency per tenant, event latency and delivery stage since start.
+        /// Requires CFG_BOOL_METASTATS_DELIVERY_LATENCY.
+        /// </summary>
+        static std::vector<DeliveryLatencyStats> GetDeliveryLatency()
+        {
+            LM_SAFE_CALL_RETURN(GetDeliveryLatency);
+            return {};
+        }
+
+        /// <summary>
+        /// Recent pipeline stage and worker task timings in Chrome trace_event JSON format.
+        /// Requires CFG_BOOL_ENABLE_PIPELINE_TRACE.
+        /// </summary>
+        static std::string GetPipelineTrace()
+        {
+            LM_SAFE_CALL_RETURN(GetPipelineTrace);
+            return {};
+        }
+
         /// <summary>
         /// Obtain a raw pointer to the ILogManager singleton instance.
         /// NOTE: this API should not be used concurrently with Initialize or FlushAndTeardown API calls.
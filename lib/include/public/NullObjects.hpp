@@ -393,6 +393,16 @@ namespace MAT_NS_BEGIN
         }
         virtual void EndActivity() override {}
 
+        virtual std::vector<DeliveryLatencyStats> GetDeliveryLatency() override
+        {
+            return {};
+        }
+
+        virtual std::string GetPipelineTrace() override
+        {
+            return {};
+        }
+
         private:
             NullDataViewerCollection nullDataViewerCollection;
             NullEventFilterCollection m_filters;
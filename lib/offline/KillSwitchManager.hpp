@@ -7,6 +7,7 @@
 
 #include "pal/PAL.hpp"
 
+#include <cstdlib>
 #include <map>
 #include <string>
 #include <mutex>
@@ -32,20 +33,32 @@ namespace MAT_NS_BEGIN {
         {
         }
 
+        /// <summary>
+        /// Parses the delay-seconds form of the Retry-After response header.
+        /// </summary>
+        /// <returns>Requested delay in seconds, 0 if absent or not a number</returns>
+        static int64_t getRetryAfterSecs(HttpHeaders const& headers)
+        {
+            std::string const& timeStr = headers.get("Retry-After");
+            if (timeStr.empty())
+            {
+                return 0;
+            }
+            char* end = nullptr;
+            long long timeinSecs = std::strtoll(timeStr.c_str(), &end, 10);
+            return (end != timeStr.c_str() && timeinSecs > 0) ? static_cast<int64_t>(timeinSecs) : 0;
+        }
+
         bool handleResponse(HttpHeaders& headers)
         {
             bool isNewTokenKilled = false;
 
-            std::string timeStr = headers.get("Retry-After");
-            if (!timeStr.empty())
+            int64_t timeinSecs = getRetryAfterSecs(headers);
+            if (timeinSecs > 0)
             {
-                int64_t timeinSecs = std::stoi(timeStr);
-                if (timeinSecs > 0)
-                {
-                    std::lock_guard<std::mutex> guard(m_lock);
-                    m_retryAfterExpiryTime = PAL::getUtcSystemTime() + timeinSecs;
-                    m_isRetryAfterActive = true;
-                }
+                std::lock_guard<std::mutex> guard(m_lock);
+                m_retryAfterExpiryTime = PAL::getUtcSystemTime() + timeinSecs;
+                m_isRetryAfterActive = true;
             }
 
             std::pair<std::multimap<std::string, std::string>::const_iterator, std::multimap<std::string, std::string>::const_iterator> ret;
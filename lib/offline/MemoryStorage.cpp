@@ -176,6 +176,64 @@ namespace MAT_NS_BEGIN {
         }
         return true;
     }
+
+    /// <summary>
+    /// Get records of a single tenant from MemoryStorage.
+    /// Records of other tenants stay in the queue in their original order.
+    /// </summary>
+    /// <param name="consumer">The consumer.</param>
+    /// <param name="leaseTimeMs">The lease time ms.</param>
+    /// <param name="tenantToken">The tenant token.</param>
+    /// <param name="minLatency">The minimum latency.</param>
+    /// <param name="maxCount">The maximum count.</param>
+    /// <returns></returns>
+    bool MemoryStorage::GetAndReserveTenantRecords(std::function<bool(StorageRecord&&)> const& consumer, unsigned leaseTimeMs, std::string const& tenantToken, EventLatency minLatency, unsigned maxCount)
+    {
+        LOG_TRACE("Retrieving max. %u%s events of tenant %s of latency at least %d (%s)",
+            maxCount, (maxCount > 0) ? "" : " (unlimited)", tenantTokenToId(tenantToken).c_str(),
+            minLatency, latencyToStr(static_cast<EventLatency>(minLatency)));
+
+        if (maxCount == 0)
+            maxCount = UINT_MAX;
+
+        if (minLatency == EventLatency_Unspecified)
+            minLatency = EventLatency_Off;
+
+        LOCKGUARD(m_reserved_lock);
+        LOCKGUARD(m_records_lock);
+        m_lastReadCount = 0;
+        for (int latency = static_cast<int>(EventLatency_Max); (latency >= static_cast<int>(minLatency)) && (maxCount); latency--)
+        {
+            auto& records = m_records[latency];
+            // Walk from the back, same order as GetAndReserveRecords
+            for (size_t i = records.size(); maxCount && (i > 0); i--)
+            {
+                StorageRecord& record = records[i - 1];
+                if (record.tenantToken != tenantToken)
+                    continue;
+
+                size_t recordSize = record.blob.size() + sizeof(record);
+                StorageRecord forConsumer(record);
+                if (leaseTimeMs)
+                {
+                    forConsumer.reservedUntil = PAL::getUtcSystemTimeMs() + leaseTimeMs;
+                }
+
+                if (!consumer(std::move(forConsumer))) {
+                    return true;
+                }
+
+                if (leaseTimeMs) {
+                    m_reserved_records[record.id] = std::move(record);
+                }
+                records.erase(records.begin() + static_cast<std::ptrdiff_t>(i - 1));
+                m_size -= std::min(m_size, recordSize);
+                maxCount--;
+                m_lastReadCount++;
+            }
+        }
+        return true;
+    }
     
     /// <summary>
     /// Determines whether the records were last read from memory. Always returns true.
@@ -222,32 +280,37 @@ namespace MAT_NS_BEGIN {
 
     }
 
-    void MemoryStorage::DeleteRecords(const std::map<std::string, std::string> & whereFilter)
+    bool MemoryStorage::MatchesFilter(StorageRecord const& r, const std::map<std::string, std::string> & whereFilter)
     {
-        auto matcher = [&](const StorageRecord &r, const std::map<std::string, std::string> & whereFilter)
+        bool matched = true;
+        for (const auto &kv : whereFilter)
         {
-            bool matched = true;
-            for (const auto &kv : whereFilter)
-            {
-                matched &=
-                    (kv.first == "record_id") ? (r.id == kv.second) :
-                    (kv.first == "tenant_token") ? (r.tenantToken == kv.second) :
-                    (kv.first == "latency") ? (std::to_string(r.latency) == kv.second) :
-                    (kv.first == "persistence") ? (std::to_string(r.persistence) == kv.second) :
-                    (kv.first == "retry_count") ? (std::to_string(r.retryCount) == kv.second) : false;
-                if (!matched)
-                    break;
-            }
-            return matched;
-        };
+            matched &=
+                (kv.first == "record_id") ? (r.id == kv.second) :
+                (kv.first == "tenant_token") ? (r.tenantToken == kv.second) :
+                (kv.first == "latency") ? (std::to_string(r.latency) == kv.second) :
+                (kv.first == "persistence") ? (std::to_string(r.persistence) == kv.second) :
+                (kv.first == "retry_count") ? (std::to_string(r.retryCount) == kv.second) : false;
+            if (!matched)
+                break;
+        }
+        return matched;
+    }
+
+    void MemoryStorage::DeleteRecords(const std::map<std::string, std::string> & whereFilter)
+    {
+        DeleteMatchingRecords([&whereFilter](StorageRecord const& r) { return MatchesFilter(r, whereFilter); });
+    }
 
+    void MemoryStorage::DeleteMatchingRecords(std::function<bool(StorageRecord const&)> const& matcher)
+    {
         // Delete from reserved, which is typically a shorter list
         std::vector<StorageRecordId> m_reserved_ids;
         {
             LOCKGUARD(m_reserved_lock);
             for (const auto & kv : m_reserved_records)
             {
-                if (matcher(kv.second, whereFilter))
+                if (matcher(kv.second))
                 {
                     m_reserved_ids.push_back(kv.first);
                 }
@@ -269,7 +332,7 @@ namespace MAT_NS_BEGIN {
                 // remove from records all ids that were found in the set
                 while (it != records.end()) {
                     auto &v = *it;
-                    if (matcher(v, whereFilter))
+                    if (matcher(v))
                     {
                         size_t recordSize = v.blob.size() + sizeof(v);
                         m_size -= std::min(m_size, recordSize);
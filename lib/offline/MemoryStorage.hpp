@@ -16,6 +16,7 @@
 #include "ILogManager.hpp"
 
 #include <algorithm>
+#include <functional>
 #include <memory>
 #include <mutex>
 #include <map>
@@ -43,6 +44,9 @@ namespace MAT_NS_BEGIN {
         virtual bool GetAndReserveRecords(std::function<bool(StorageRecord&&)> const& consumer, unsigned leaseTimeMs,
             EventLatency minLatency = EventLatency_Unspecified, unsigned maxCount = 0) override;
 
+        virtual bool GetAndReserveTenantRecords(std::function<bool(StorageRecord&&)> const& consumer, unsigned leaseTimeMs,
+            std::string const& tenantToken, EventLatency minLatency = EventLatency_Unspecified, unsigned maxCount = 0) override;
+
         virtual bool IsLastReadFromMemory() override;
 
         virtual unsigned LastReadRecordCount() override;
@@ -51,6 +55,16 @@ namespace MAT_NS_BEGIN {
 
         virtual void DeleteRecords(const std::map<std::string, std::string> & whereFilter = {}) override;
 
+        /// <summary>
+        /// Deletes the reserved and unreserved records the matcher returns true for.
+        /// </summary>
+        void DeleteMatchingRecords(std::function<bool(StorageRecord const&)> const& matcher);
+
+        /// <summary>
+        /// Whether a record matches a DeleteRecords() filter.
+        /// </summary>
+        static bool MatchesFilter(StorageRecord const& record, const std::map<std::string, std::string> & whereFilter);
+
         virtual void DeleteRecords(std::vector<StorageRecordId> const& ids, HttpHeaders headers, bool& fromMemory) override;
 
         virtual void ReleaseRecords(std::vector<StorageRecordId> const& ids, bool incrementRetryCount, HttpHeaders headers, bool& fromMemory) override;
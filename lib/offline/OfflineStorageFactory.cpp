@@ -13,11 +13,23 @@
 #else
 #include "offline/OfflineStorage_SQLite.hpp"
 #endif
+#include "offline/OfflineStorage_SharedMemory.hpp"
 
 #include <memory>
 
 namespace MAT_NS_BEGIN
 {
+    bool OfflineStorageFactory::IsSharedQueue(IRuntimeConfig& runtimeConfig)
+    {
+#ifdef HAVE_MAT_SHARED_QUEUE
+        const char* path = runtimeConfig[CFG_STR_SHARED_QUEUE_PATH];
+        return (path != nullptr) && (*path != '\0');
+#else
+        UNREFERENCED_PARAMETER(runtimeConfig);
+        return false;
+#endif
+    }
+
     std::shared_ptr<IOfflineStorage> OfflineStorageFactory::Create(ILogManager& logManager, IRuntimeConfig& runtimeConfig)
     {
 #ifdef HAVE_MAT_STORAGE
@@ -26,6 +38,12 @@ namespace MAT_NS_BEGIN
             LOG_TRACE("Creating OfflineStorage from module");
             return std::static_pointer_cast<IOfflineStorage>(std::static_pointer_cast<IOfflineStorageModule>(module));
         }
+#ifdef HAVE_MAT_SHARED_QUEUE
+        if (IsSharedQueue(runtimeConfig)) {
+            LOG_TRACE("Creating OfflineStorage_SharedMemory");
+            return std::make_shared<OfflineStorage_SharedMemory>(logManager, runtimeConfig);
+        }
+#endif
 #ifdef USE_ROOM
         LOG_TRACE("Creating OfflineStorage_Room");
         return std::make_shared<OfflineStorage_Room>(logManager, runtimeConfig);
@@ -14,6 +14,11 @@ namespace MAT_NS_BEGIN
     {
        public:
         static std::shared_ptr<IOfflineStorage> Create(ILogManager& logManager, IRuntimeConfig& runtimeConfig);
+
+        /// <summary>
+        /// Whether Create() makes a queue shared with the other processes of the host.
+        /// </summary>
+        static bool IsSharedQueue(IRuntimeConfig& runtimeConfig);
     };
 }
 MAT_NS_END
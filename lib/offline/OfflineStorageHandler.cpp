@@ -33,7 +33,9 @@ namespace MAT_NS_BEGIN {
         m_shutdownStarted(false),
         m_memoryDbSize(0),
         m_queryDbSize(0),
-        m_isStorageFullNotificationSend(false)
+        m_isStorageFullNotificationSend(false),
+        m_sharedQueue(false),
+        m_diskState(DiskOpenState::Opened)
     {
         // TODO: [MG] - OfflineStorage_SQLite.cpp is performing similar checks
         uint32_t percentage = m_config[CFG_INT_RAMCACHE_FULL_PCT];
@@ -70,6 +72,11 @@ namespace MAT_NS_BEGIN {
     OfflineStorageHandler::~OfflineStorageHandler()
     {
         WaitForFlush();
+        m_diskOpenHandle.Cancel();
+        if (m_diskState == DiskOpenState::Opening)
+        {
+            m_diskOpened.wait();
+        }
         if (nullptr != m_offlineStorageMemory)
         {
             m_offlineStorageMemory.reset();
@@ -85,16 +92,28 @@ namespace MAT_NS_BEGIN {
         m_observer = &observer;
         uint32_t cacheMemorySizeLimitInBytes = m_config[CFG_INT_RAM_QUEUE_SIZE];
 
-        m_offlineStorageDisk = OfflineStorageFactory::Create(m_logManager, m_config);
-        if (m_offlineStorageDisk)
+        m_sharedQueue = OfflineStorageFactory::IsSharedQueue(m_config);
+
+        // Opening the disk storage may take a while (schema checks, recovery). With a RAM
+        // queue to hold the records meanwhile, it can be left to the worker thread.
+        bool deferDiskOpen = m_config[CFG_BOOL_ASYNC_STORAGE_OPEN] && (cacheMemorySizeLimitInBytes > 0) && !m_sharedQueue;
+        m_diskOpened.Reset();
+        m_diskState = DiskOpenState::Pending;
+        if (deferDiskOpen)
         {
-            m_offlineStorageDisk->Initialize(*this);
+            LOG_TRACE("Deferring the open of the disk storage to the worker thread");
+            m_diskOpenHandle = PAL::scheduleTask(&m_taskDispatcher, 0, this, &OfflineStorageHandler::OpenDiskStorage);
+        }
+        else
+        {
+            OpenDiskStorage();
         }
 
         // TODO: [MG] - consider passing m_offlineStorageDisk to m_offlineStorageMemory,
         // so that the Flush() op on memory storage leads to saving unflushed events to
         // disk.
-        if (cacheMemorySizeLimitInBytes > 0)
+        // The shared queue is in memory already and must see every record right away
+        if (cacheMemorySizeLimitInBytes > 0 && !m_sharedQueue)
         {
             m_offlineStorageMemory.reset(new MemoryStorage(m_logManager, m_config));
             m_offlineStorageMemory->Initialize(*this);
@@ -109,16 +128,54 @@ namespace MAT_NS_BEGIN {
         LOG_TRACE("Shutting down offline storage handler");
         m_shutdownStarted = true;
         WaitForFlush();
+        // The RAM queue is saved to disk below, so a deferred open has to happen now
+        m_diskOpenHandle.Cancel();
+        IOfflineStorage* disk = GetOpenedDiskStorage();
         if (nullptr != m_offlineStorageMemory)
         {
             m_offlineStorageMemory->ReleaseAllRecords();
             Flush();
             m_offlineStorageMemory->Shutdown();
         }
-        if (nullptr != m_offlineStorageDisk)
+        if (nullptr != disk)
+        {
+            disk->Shutdown();
+        }
+    }
+
+    void OfflineStorageHandler::OpenDiskStorage()
+    {
+        DiskOpenState expected = DiskOpenState::Pending;
+        if (!m_diskState.compare_exchange_strong(expected, DiskOpenState::Opening))
+        {
+            // Opened by Shutdown() or a settings call already
+            return;
+        }
+
+        auto disk = OfflineStorageFactory::Create(m_logManager, m_config);
+        if (disk)
+        {
+            disk->Initialize(*this);
+        }
+        m_offlineStorageDisk = disk;
+        m_diskState = DiskOpenState::Opened;
+        m_diskOpened.post();
+    }
+
+    IOfflineStorage* OfflineStorageHandler::GetDiskStorage() const
+    {
+        return (m_diskState == DiskOpenState::Opened) ? m_offlineStorageDisk.get() : nullptr;
+    }
+
+    IOfflineStorage* OfflineStorageHandler::GetOpenedDiskStorage()
+    {
+        if (m_diskState != DiskOpenState::Opened)
         {
-            m_offlineStorageDisk->Shutdown();
+            // Don't wait for the worker thread to get to it
+            OpenDiskStorage();
+            m_diskOpened.wait();
         }
+        return m_offlineStorageDisk.get();
     }
 
     /// <summary>
@@ -135,8 +192,9 @@ namespace MAT_NS_BEGIN {
         size_t size = 0;
         if (m_offlineStorageMemory != nullptr)
             size += m_offlineStorageMemory->GetSize();
-        if (m_offlineStorageDisk != nullptr)
-            size += m_offlineStorageDisk->GetSize();
+        IOfflineStorage* disk = GetDiskStorage();
+        if (disk != nullptr)
+            size += disk->GetSize();
         return size;
     }
 
@@ -145,16 +203,28 @@ namespace MAT_NS_BEGIN {
         size_t count = 0;
         if (m_offlineStorageMemory != nullptr)
             count += m_offlineStorageMemory->GetRecordCount(latency);
-        if (m_offlineStorageDisk != nullptr)
-            count += m_offlineStorageDisk->GetRecordCount(latency);
+        IOfflineStorage* disk = GetDiskStorage();
+        if (disk != nullptr)
+            count += disk->GetRecordCount(latency);
         return count;
     }
 
-    void OfflineStorageHandler::Flush()
+    void OfflineStorageHandler::ScheduledFlush()
     {
-        if (!m_logManager.StartActivity()) {
+        if (!m_logManager.StartActivity())
+        {
+            // Records stay in the RAM queue until the next flush
+            LOCKGUARD(m_flushLock);
+            m_flushComplete.post();
+            m_flushPending = false;
             return;
         }
+        Flush();
+        m_logManager.EndActivity();
+    }
+
+    void OfflineStorageHandler::Flush()
+    {
         // Flush could be executed from context of worker thread, as well as from TPM and
         // after HTTP callback. Make sure it is atomic / thread-safe.
         LOCKGUARD(m_flushLock);
@@ -164,8 +234,10 @@ namespace MAT_NS_BEGIN {
         // than the handle gets replaced by nullptr in this DeferredCallbackHandle obj.
         m_flushHandle.Cancel();
 
-        size_t dbSizeBeforeFlush = m_offlineStorageMemory->GetSize();
-        if ((m_offlineStorageMemory) && (dbSizeBeforeFlush > 0) && (m_offlineStorageDisk))
+        // Until a deferred open of the disk storage is done, records stay in the RAM queue
+        IOfflineStorage* disk = GetDiskStorage();
+        size_t dbSizeBeforeFlush = m_offlineStorageMemory ? m_offlineStorageMemory->GetSize() : 0;
+        if ((m_offlineStorageMemory) && (dbSizeBeforeFlush > 0) && (disk))
         {
             // This will block on and then take a lock for the duration of this move, and
             // StoreRecord() will then block until the move completes.
@@ -176,7 +248,7 @@ namespace MAT_NS_BEGIN {
             //            if (sqlite)
             //                sqlite->Execute("BEGIN");
 
-            size_t totalSaved = m_offlineStorageDisk->StoreRecords(records);
+            size_t totalSaved = disk->StoreRecords(records);
 
             // TODO: [MG] - consider running the batch in transaction
             //            if (sqlite)
@@ -200,9 +272,9 @@ namespace MAT_NS_BEGIN {
         }
 
         // Checkpoint DB
-        if (m_config.HasConfig(CFG_BOOL_CHECKPOINT_DB_ON_FLUSH) && m_config[CFG_BOOL_CHECKPOINT_DB_ON_FLUSH]) 
+        if (disk && m_config.HasConfig(CFG_BOOL_CHECKPOINT_DB_ON_FLUSH) && m_config[CFG_BOOL_CHECKPOINT_DB_ON_FLUSH]) 
         {
-            m_offlineStorageDisk->Flush();
+            disk->Flush();
         }
 
         m_isStorageFullNotificationSend = false;
@@ -210,7 +282,6 @@ namespace MAT_NS_BEGIN {
         // Flush is done, notify the waiters
         m_flushComplete.post();
         m_flushPending = false;
-        m_logManager.EndActivity();
     }
 
     bool OfflineStorageHandler::StoreRecord(StorageRecord const& record)
@@ -246,7 +317,7 @@ namespace MAT_NS_BEGIN {
                     {
                         m_flushPending = true;
                         m_flushComplete.Reset();
-                        m_flushHandle = PAL::scheduleTask(&m_taskDispatcher, 0, this, &OfflineStorageHandler::Flush);
+                        m_flushHandle = PAL::scheduleTask(&m_taskDispatcher, 0, this, &OfflineStorageHandler::ScheduledFlush);
                         LOG_INFO("Requested Flush (%p)", m_flushHandle.m_task);
                     }
                     m_flushLock.unlock();
@@ -255,11 +326,12 @@ namespace MAT_NS_BEGIN {
         }
         else
         {
-            if (m_offlineStorageDisk != nullptr)
+            IOfflineStorage* disk = GetDiskStorage();
+            if (disk != nullptr)
             {
-                if (record.persistence != EventPersistence::EventPersistence_DoNotStoreOnDisk)
+                if (m_sharedQueue || record.persistence != EventPersistence::EventPersistence_DoNotStoreOnDisk)
                 {
-                    m_offlineStorageDisk->StoreRecord(record);
+                    disk->StoreRecord(record);
                 }
             }
         }
@@ -287,9 +359,10 @@ namespace MAT_NS_BEGIN {
             m_offlineStorageMemory->ResizeDb();
         }
 
-        if (nullptr != m_offlineStorageDisk)
+        IOfflineStorage* disk = GetDiskStorage();
+        if (nullptr != disk)
         {
-            m_offlineStorageDisk->ResizeDb();
+            disk->ResizeDb();
         }
 
         return true;
@@ -326,10 +399,11 @@ namespace MAT_NS_BEGIN {
                 return returnValue;
         }
 
-        if (m_offlineStorageDisk)
+        IOfflineStorage* disk = GetDiskStorage();
+        if (disk)
         {
-            returnValue |= m_offlineStorageDisk->GetAndReserveRecords(consumer, leaseTimeMs, minLatency, maxCount);
-            auto lastOfflineReadCount = m_offlineStorageDisk->LastReadRecordCount();
+            returnValue |= disk->GetAndReserveRecords(consumer, leaseTimeMs, minLatency, maxCount);
+            auto lastOfflineReadCount = disk->LastReadRecordCount();
             if (lastOfflineReadCount)
             {
                 m_lastReadCount += lastOfflineReadCount;
@@ -347,6 +421,45 @@ namespace MAT_NS_BEGIN {
         return returnValue;
     }
 
+    bool OfflineStorageHandler::GetAndReserveTenantRecords(std::function<bool(StorageRecord&&)> const& consumer, unsigned leaseTimeMs, std::string const& tenantToken, EventLatency minLatency, unsigned maxCount)
+    {
+        m_lastReadCount = 0;
+        m_readFromMemory = false;
+
+        // Backlog of a killed tenant is never uploaded, don't even look at it
+        if (m_killSwitchManager.isActive() && m_killSwitchManager.isTokenBlocked(tenantToken))
+        {
+            LOG_TRACE("Tenant %s is killed, skipping retrieval", tenantTokenToId(tenantToken).c_str());
+            return false;
+        }
+
+        bool returnValue = false;
+        if (m_offlineStorageMemory)
+        {
+            returnValue |= m_offlineStorageMemory->GetAndReserveTenantRecords(consumer, leaseTimeMs, tenantToken, minLatency, maxCount);
+            m_lastReadCount += m_offlineStorageMemory->LastReadRecordCount();
+            if (m_lastReadCount <= maxCount)
+                maxCount -= m_lastReadCount;
+            m_readFromMemory = true;
+            if (m_lastReadCount)
+                return returnValue;
+        }
+
+        IOfflineStorage* disk = GetDiskStorage();
+        if (disk)
+        {
+            returnValue |= disk->GetAndReserveTenantRecords(consumer, leaseTimeMs, tenantToken, minLatency, maxCount);
+            auto lastOfflineReadCount = disk->LastReadRecordCount();
+            if (lastOfflineReadCount)
+            {
+                m_lastReadCount += lastOfflineReadCount;
+                m_readFromMemory = false;
+            }
+        }
+
+        return returnValue;
+    }
+
     std::vector<StorageRecord> OfflineStorageHandler::GetRecords(bool shutdown, EventLatency minLatency, unsigned maxCount)
     {
         // This method should not be called directly because it's a no-op
@@ -379,7 +492,7 @@ namespace MAT_NS_BEGIN {
 
     void OfflineStorageHandler::DeleteAllRecords()
     {
-        for (const auto storagePtr : { m_offlineStorageMemory.get() , m_offlineStorageDisk.get() })
+        for (const auto storagePtr : { m_offlineStorageMemory.get() , GetOpenedDiskStorage() })
         {
             if (storagePtr != nullptr)
             {
@@ -402,7 +515,7 @@ namespace MAT_NS_BEGIN {
     /// </remarks>
     void OfflineStorageHandler::DeleteRecords(const std::map<std::string, std::string>& whereFilter)
     {
-        for (const auto storagePtr : {m_offlineStorageMemory.get(), m_offlineStorageDisk.get()})
+        for (const auto storagePtr : {m_offlineStorageMemory.get(), GetOpenedDiskStorage()})
         {
             if (storagePtr != nullptr)
             {
@@ -445,9 +558,10 @@ namespace MAT_NS_BEGIN {
         }
         else
         {
-            if (nullptr != m_offlineStorageDisk)
+            IOfflineStorage* disk = GetDiskStorage();
+            if (nullptr != disk)
             {
-                m_offlineStorageDisk->DeleteRecords(ids, headers, fromMemory);
+                disk->DeleteRecords(ids, headers, fromMemory);
             }
         }
     }
@@ -473,18 +587,20 @@ namespace MAT_NS_BEGIN {
         }
         else
         {
-            if (nullptr != m_offlineStorageDisk)
+            IOfflineStorage* disk = GetDiskStorage();
+            if (nullptr != disk)
             {
-                m_offlineStorageDisk->ReleaseRecords(ids, incrementRetryCount, headers, fromMemory);
+                disk->ReleaseRecords(ids, incrementRetryCount, headers, fromMemory);
             }
         }
     }
 
     bool OfflineStorageHandler::StoreSetting(std::string const& name, std::string const& value)
     {
-        if (nullptr != m_offlineStorageDisk)
+        IOfflineStorage* disk = GetOpenedDiskStorage();
+        if (nullptr != disk)
         {
-            m_offlineStorageDisk->StoreSetting(name, value);
+            disk->StoreSetting(name, value);
             return true;
         }
         return false;
@@ -492,18 +608,20 @@ namespace MAT_NS_BEGIN {
 
     std::string OfflineStorageHandler::GetSetting(std::string const& name)
     {
-        if (nullptr != m_offlineStorageDisk)
+        IOfflineStorage* disk = GetOpenedDiskStorage();
+        if (nullptr != disk)
         {
-            return m_offlineStorageDisk->GetSetting(name);
+            return disk->GetSetting(name);
         }
         return "";
     }
 
     bool OfflineStorageHandler::DeleteSetting(std::string const& name)
     {
-        if (nullptr != m_offlineStorageDisk)
+        IOfflineStorage* disk = GetOpenedDiskStorage();
+        if (nullptr != disk)
         {
-            return m_offlineStorageDisk->DeleteSetting(name);
+            return disk->DeleteSetting(name);
         }
         return false;
     }
@@ -34,6 +34,7 @@ namespace MAT_NS_BEGIN {
         virtual bool StoreRecord(StorageRecord const& record) override;
         virtual size_t StoreRecords(std::vector<StorageRecord> & records) override;
         virtual bool GetAndReserveRecords(std::function<bool(StorageRecord&&)> const& consumer, unsigned leaseTimeMs, EventLatency minLatency = EventLatency_Unspecified, unsigned maxCount = 0) override;
+        virtual bool GetAndReserveTenantRecords(std::function<bool(StorageRecord&&)> const& consumer, unsigned leaseTimeMs, std::string const& tenantToken, EventLatency minLatency = EventLatency_Unspecified, unsigned maxCount = 0) override;
 
         virtual bool IsLastReadFromMemory() override;
         virtual unsigned LastReadRecordCount() override;
@@ -91,6 +92,12 @@ namespace MAT_NS_BEGIN {
         unsigned                               m_memoryDbSizeNotificationLimit;
         unsigned                               m_queryDbSize;
         bool                                   m_isStorageFullNotificationSend;
+        bool                                   m_sharedQueue;
+
+        enum class DiskOpenState { Pending, Opening, Opened };
+        std::atomic<DiskOpenState>             m_diskState;
+        PAL::DeferredCallbackHandle            m_diskOpenHandle;
+        PAL::Event                             m_diskOpened;
 
     protected:
         MATSDK_LOG_DECL_COMPONENT_CLASS();
@@ -98,6 +105,26 @@ namespace MAT_NS_BEGIN {
     private:
         void WaitForFlush();
 
+        /// <summary>
+        /// Flush requested by StoreRecord(), skipped while the log manager is paused.
+        /// </summary>
+        void ScheduledFlush();
+
+        /// <summary>
+        /// Creates and opens the disk storage, unless that has been started already.
+        /// </summary>
+        void OpenDiskStorage();
+
+        /// <summary>
+        /// Disk storage, nullptr while its deferred open is pending.
+        /// </summary>
+        IOfflineStorage* GetDiskStorage() const;
+
+        /// <summary>
+        /// Disk storage, opened on the calling thread if the worker has not done it yet.
+        /// </summary>
+        IOfflineStorage* GetOpenedDiskStorage();
+
     };
 
 
@@ -247,6 +247,16 @@ namespace MAT_NS_BEGIN {
     /// <param name="maxCount">The maximum count.</param>
     /// <returns></returns>
     bool OfflineStorage_SQLite::GetAndReserveRecords(std::function<bool(StorageRecord&&)> const& consumer, unsigned leaseTimeMs, EventLatency minLatency, unsigned maxCount)
+    {
+        return getAndReserveRecords(consumer, leaseTimeMs, nullptr, minLatency, maxCount);
+    }
+
+    bool OfflineStorage_SQLite::GetAndReserveTenantRecords(std::function<bool(StorageRecord&&)> const& consumer, unsigned leaseTimeMs, std::string const& tenantToken, EventLatency minLatency, unsigned maxCount)
+    {
+        return getAndReserveRecords(consumer, leaseTimeMs, &tenantToken, minLatency, maxCount);
+    }
+
+    bool OfflineStorage_SQLite::getAndReserveRecords(std::function<bool(StorageRecord&&)> const& consumer, unsigned leaseTimeMs, std::string const* tenantToken, EventLatency minLatency, unsigned maxCount)
     {
         m_lastReadCount = 0;
 
@@ -279,8 +289,11 @@ namespace MAT_NS_BEGIN {
                 }
             }
 
-            SqliteStatement selectStmt(*m_db, m_stmtSelectEvents);
-            if (!selectStmt.select(static_cast<int>(minLatency), maxCount > 0 ? maxCount : -1)) {
+            SqliteStatement selectStmt(*m_db, (tenantToken != nullptr) ? m_stmtSelectEvents_tenant : m_stmtSelectEvents);
+            bool selected = (tenantToken != nullptr) ?
+                selectStmt.select(static_cast<int>(minLatency), *tenantToken, maxCount > 0 ? maxCount : -1) :
+                selectStmt.select(static_cast<int>(minLatency), maxCount > 0 ? maxCount : -1);
+            if (!selected) {
                 LOG_ERROR("Failed to retrieve events to send: Database error occurred, recreating database");
                 recreate(204);
                 return false;
@@ -822,6 +835,11 @@ namespace MAT_NS_BEGIN {
             " FROM " TABLE_NAME_EVENTS
             " WHERE latency>=? AND reserved_until=0"
             " ORDER BY latency DESC,persistence DESC, timestamp ASC LIMIT ?");
+        PREPARE_SQL(m_stmtSelectEvents_tenant,
+            "SELECT record_id,tenant_token,latency,timestamp,retry_count,reserved_until,payload"
+            " FROM " TABLE_NAME_EVENTS
+            " WHERE latency>=? AND tenant_token=? AND reserved_until=0"
+            " ORDER BY latency DESC,persistence DESC, timestamp ASC LIMIT ?");
         PREPARE_SQL(m_stmtSelectEventAtShutdown,
             "SELECT record_id,tenant_token,latency,timestamp,retry_count,reserved_until,payload"
             " FROM " TABLE_NAME_EVENTS
@@ -36,6 +36,7 @@ namespace MAT_NS_BEGIN {
         virtual bool StoreRecord(StorageRecord const& record) override;
         virtual size_t StoreRecords(std::vector<StorageRecord> & records) override;
         virtual bool GetAndReserveRecords(std::function<bool(StorageRecord&&)> const& consumer, unsigned leaseTimeMs, EventLatency minLatency = EventLatency_Normal, unsigned maxCount = 0) override;
+        virtual bool GetAndReserveTenantRecords(std::function<bool(StorageRecord&&)> const& consumer, unsigned leaseTimeMs, std::string const& tenantToken, EventLatency minLatency = EventLatency_Normal, unsigned maxCount = 0) override;
         virtual bool IsLastReadFromMemory() override;
         virtual unsigned LastReadRecordCount() override;
 
@@ -55,6 +56,7 @@ namespace MAT_NS_BEGIN {
     protected:
         bool initializeDatabase();
         bool recreate(unsigned failureCode);
+        bool getAndReserveRecords(std::function<bool(StorageRecord&&)> const& consumer, unsigned leaseTimeMs, std::string const* tenantToken, EventLatency minLatency, unsigned maxCount);
 
         std::vector<uint8_t> packageIdList(
             std::vector<std::string>::const_iterator const & begin,
@@ -98,6 +100,7 @@ namespace MAT_NS_BEGIN {
         size_t                      m_stmtReleaseExpiredEvents {};
         size_t                      m_stmtDeleteEvents_tenants {};
         size_t                      m_stmtSelectEvents {};
+        size_t                      m_stmtSelectEvents_tenant {};
         size_t                      m_stmtSelectEventAtShutdown {};
         size_t                      m_stmtSelectEventsMinlatency {};
         size_t                      m_stmtReserveEvents {};
@@ -0,0 +1,684 @@
+//
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// SPDX-License-Identifier: Apache-2.0
+//
+#include "OfflineStorage_SharedMemory.hpp"
+
+#ifdef HAVE_MAT_SHARED_QUEUE
+
+#include "MemoryStorage.hpp"
+
+#include <cerrno>
+#include <csignal>
+#include <cstring>
+#include <new>
+
+#include <fcntl.h>
+#include <sys/file.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+static_assert(ATOMIC_LLONG_LOCK_FREE == 2 && ATOMIC_INT_LOCK_FREE == 2,
+    "The shared queue needs lock-free atomics that work across processes");
+
+namespace MAT_NS_BEGIN {
+
+    MATSDK_LOG_INST_COMPONENT_CLASS(OfflineStorage_SharedMemory, "EventsSDK.SharedMemoryStorage", "Events telemetry client - OfflineStorage_SharedMemory class");
+
+    constexpr uint32_t OfflineStorage_SharedMemory::Magic;
+    constexpr uint32_t OfflineStorage_SharedMemory::Version;
+    constexpr size_t   OfflineStorage_SharedMemory::HeaderSize;
+    constexpr size_t   OfflineStorage_SharedMemory::SlotAlignment;
+    constexpr uint64_t OfflineStorage_SharedMemory::StallTimeoutMs;
+
+    /// <summary>
+    /// Start of the mapped file. Positions grow forever; the ring offset is position % capacity.
+    /// Writers advance writePos, only the uploader advances readPos.
+    /// </summary>
+    struct OfflineStorage_SharedMemory::RingHeader
+    {
+        uint32_t magic;
+        uint32_t version;
+        uint64_t capacity;
+        // Every record is uploaded to this collector, whichever process appended it
+        char     collectorUrl[1024];
+        alignas(64) std::atomic<uint64_t> writePos;
+        alignas(64) std::atomic<uint64_t> readPos;
+        alignas(64) std::atomic<uint64_t> queuedCount;
+    };
+
+    /// <summary>
+    /// Every slot starts with this header, followed by the encoded record. Slots never
+    /// wrap around the end of the ring; the space left at the end is a padding slot.
+    /// </summary>
+    struct OfflineStorage_SharedMemory::SlotHeader
+    {
+        std::atomic<uint32_t> state;
+        uint32_t size;
+        int32_t  pid;
+        uint32_t reserved;
+    };
+
+    namespace
+    {
+        enum SlotState : uint32_t
+        {
+            SlotEmpty = 0,
+            SlotWriting = 1,
+            SlotCommitted = 2,
+            SlotPadding = 3
+        };
+
+        /// Fixed part of an encoded record; id, tenant token and blob follow it
+        struct RecordFields
+        {
+            int64_t  timestamp;
+            int32_t  latency;
+            int32_t  persistence;
+            int32_t  retryCount;
+            uint32_t idLength;
+            uint32_t tenantTokenLength;
+            uint32_t blobLength;
+        };
+
+        size_t alignSlot(size_t size)
+        {
+            return (size + OfflineStorage_SharedMemory::SlotAlignment - 1) & ~(OfflineStorage_SharedMemory::SlotAlignment - 1);
+        }
+
+        bool isProcessAlive(int32_t pid)
+        {
+            return pid > 0 && (::kill(pid, 0) == 0 || errno != ESRCH);
+        }
+    }
+
+    OfflineStorage_SharedMemory::OfflineStorage_SharedMemory(ILogManager& logManager, IRuntimeConfig& runtimeConfig) :
+        m_observer(nullptr),
+        m_config(runtimeConfig),
+        m_logManager(logManager),
+        m_capacity(0),
+        m_fd(-1),
+        m_lockFd(-1),
+        m_mapping(nullptr),
+        m_mappingSize(0),
+        m_header(nullptr),
+        m_ring(nullptr),
+        m_pid(static_cast<int32_t>(::getpid())),
+        m_canUpload(true),
+        m_isUploader(false),
+        m_localSizeLimit(0),
+        m_stalledPosition(0),
+        m_stalledSince(0),
+        m_lastReadCount(0)
+    {
+        static_assert(sizeof(RingHeader) <= HeaderSize, "Ring header does not fit");
+        static_assert(sizeof(SlotHeader) == SlotAlignment, "Slot header must keep slots aligned");
+    }
+
+    OfflineStorage_SharedMemory::~OfflineStorage_SharedMemory()
+    {
+        close();
+    }
+
+    void OfflineStorage_SharedMemory::Initialize(IOfflineStorageObserver& observer)
+    {
+        m_observer = &observer;
+        m_local.reset(new MemoryStorage(m_logManager, m_config));
+        m_local->Initialize(observer);
+        m_localSizeLimit = static_cast<uint32_t>(m_config[CFG_INT_RAM_QUEUE_SIZE]);
+
+        m_path = static_cast<const char*>(m_config[CFG_STR_SHARED_QUEUE_PATH]);
+        m_collectorUrl = m_config.GetCollectorUrl();
+        m_canUpload = m_config[CFG_BOOL_SHARED_QUEUE_UPLOAD];
+        uint32_t capacity = m_config[CFG_INT_SHARED_QUEUE_SIZE];
+        m_capacity = alignSlot(capacity < 65536 ? 65536 : capacity);
+
+        if (open())
+        {
+            LOG_INFO("Opened shared queue %s, %u bytes", m_path.c_str(), static_cast<unsigned>(m_capacity));
+            m_observer->OnStorageOpened("SharedMemory/" + m_path);
+        }
+        else
+        {
+            LOG_ERROR("Cannot open shared queue %s: errno=%d", m_path.c_str(), errno);
+            close();
+            m_observer->OnStorageOpenFailed("SharedMemory/" + m_path);
+        }
+    }
+
+    bool OfflineStorage_SharedMemory::open()
+    {
+        if (m_collectorUrl.size() >= sizeof(RingHeader::collectorUrl))
+        {
+            errno = ENAMETOOLONG;
+            return false;
+        }
+        m_fd = ::open(m_path.c_str(), O_RDWR | O_CREAT | O_CLOEXEC, 0660);
+        m_lockFd = ::open((m_path + ".lock").c_str(), O_RDWR | O_CREAT | O_CLOEXEC, 0660);
+        if (m_fd < 0 || m_lockFd < 0)
+        {
+            return false;
+        }
+
+        // Whoever comes first creates the ring; everyone else waits and adopts it
+        while (::flock(m_fd, LOCK_EX) != 0)
+        {
+            if (errno != EINTR)
+            {
+                return false;
+            }
+        }
+        bool created = false;
+        struct stat info;
+        if (::fstat(m_fd, &info) != 0)
+        {
+            info.st_size = 0;
+        }
+        else if (info.st_size == 0)
+        {
+            created = (::ftruncate(m_fd, static_cast<off_t>(HeaderSize + m_capacity)) == 0);
+            info.st_size = static_cast<off_t>(HeaderSize + m_capacity);
+        }
+        m_mappingSize = static_cast<size_t>(info.st_size);
+        void* mapping = (m_mappingSize > HeaderSize) ?
+            ::mmap(nullptr, m_mappingSize, PROT_READ | PROT_WRITE, MAP_SHARED, m_fd, 0) : MAP_FAILED;
+        if (mapping != MAP_FAILED)
+        {
+            m_mapping = static_cast<uint8_t*>(mapping);
+            m_header = reinterpret_cast<RingHeader*>(m_mapping);
+            m_ring = m_mapping + HeaderSize;
+            if (created)
+            {
+                new (m_header) RingHeader();
+                m_header->writePos.store(0);
+                m_header->readPos.store(0);
+                m_header->queuedCount.store(0);
+                m_header->capacity = m_capacity;
+                memcpy(m_header->collectorUrl, m_collectorUrl.c_str(), m_collectorUrl.size() + 1);
+                m_header->version = Version;
+                m_header->magic = Magic;
+            }
+        }
+        ::flock(m_fd, LOCK_UN);
+
+        if (m_mapping == nullptr || m_header->magic != Magic || m_header->version != Version ||
+            m_header->capacity + HeaderSize != m_mappingSize || (m_header->capacity % SlotAlignment) != 0)
+        {
+            return false;
+        }
+        if (strncmp(m_header->collectorUrl, m_collectorUrl.c_str(), sizeof(m_header->collectorUrl)) != 0)
+        {
+            // The uploader would send the records of this process to another collector
+            LOG_ERROR("Shared queue %s is used for collector %.*s", m_path.c_str(),
+                static_cast<int>(sizeof(m_header->collectorUrl)), m_header->collectorUrl);
+            errno = EINVAL;
+            return false;
+        }
+        // The size of an existing ring wins over the configured one
+        m_capacity = static_cast<size_t>(m_header->capacity);
+        return true;
+    }
+
+    void OfflineStorage_SharedMemory::close()
+    {
+        if (m_mapping != nullptr)
+        {
+            ::munmap(m_mapping, m_mappingSize);
+        }
+        m_mapping = nullptr;
+        m_header = nullptr;
+        m_ring = nullptr;
+        if (m_fd >= 0)
+        {
+            ::close(m_fd);
+        }
+        if (m_lockFd >= 0)
+        {
+            // Also gives up the uploader role
+            ::close(m_lockFd);
+        }
+        m_fd = -1;
+        m_lockFd = -1;
+        m_isUploader = false;
+    }
+
+    void OfflineStorage_SharedMemory::Shutdown()
+    {
+        if (m_isUploader && m_header != nullptr)
+        {
+            // Hand what this process drained but did not upload back to the next uploader
+            LOCKGUARD(m_drainLock);
+            m_local->ReleaseAllRecords();
+            m_ownIds.clear();
+            auto records = m_local->GetRecords(true);
+            size_t returned = 0;
+            for (auto const& record : records)
+            {
+                returned += append(record) ? 1 : 0;
+            }
+            if (returned < records.size())
+            {
+                LOG_WARN("Shared queue is full, discarding %u records", static_cast<unsigned>(records.size() - returned));
+            }
+        }
+        m_local->Shutdown();
+        close();
+    }
+
+    void OfflineStorage_SharedMemory::Flush()
+    {
+    }
+
+    size_t OfflineStorage_SharedMemory::encodedSize(StorageRecord const& record)
+    {
+        return alignSlot(sizeof(SlotHeader) + sizeof(RecordFields) + record.id.size() + record.tenantToken.size() + record.blob.size());
+    }
+
+    bool OfflineStorage_SharedMemory::append(StorageRecord const& record)
+    {
+        const size_t size = encodedSize(record);
+        if (m_header == nullptr || size > m_capacity / 2)
+        {
+            return false;
+        }
+
+        // Reserve [position, position + size), preceded by padding up to the end of the ring if needed
+        uint64_t position = m_header->writePos.load(std::memory_order_relaxed);
+        size_t padding;
+        for (;;)
+        {
+            const size_t offset = static_cast<size_t>(position % m_capacity);
+            padding = (offset + size > m_capacity) ? (m_capacity - offset) : 0;
+            const uint64_t readPos = m_header->readPos.load(std::memory_order_acquire);
+            if (position + padding + size - readPos > m_capacity)
+            {
+                return false;
+            }
+            if (m_header->writePos.compare_exchange_weak(position, position + padding + size, std::memory_order_acq_rel))
+            {
+                break;
+            }
+        }
+
+        const int32_t pid = m_pid;
+        if (padding > 0)
+        {
+            SlotHeader* pad = reinterpret_cast<SlotHeader*>(m_ring + position % m_capacity);
+            pad->size = static_cast<uint32_t>(padding);
+            pad->pid = pid;
+            pad->state.store(SlotPadding, std::memory_order_release);
+            position += padding;
+        }
+
+        uint8_t* data = m_ring + position % m_capacity;
+        SlotHeader* slot = reinterpret_cast<SlotHeader*>(data);
+        slot->size = static_cast<uint32_t>(size);
+        slot->pid = pid;
+        slot->state.store(SlotWriting, std::memory_order_release);
+
+        RecordFields fields;
+        fields.timestamp = record.timestamp;
+        fields.latency = record.latency;
+        fields.persistence = record.persistence;
+        fields.retryCount = record.retryCount;
+        fields.idLength = static_cast<uint32_t>(record.id.size());
+        fields.tenantTokenLength = static_cast<uint32_t>(record.tenantToken.size());
+        fields.blobLength = static_cast<uint32_t>(record.blob.size());
+        data += sizeof(SlotHeader);
+        memcpy(data, &fields, sizeof(fields));
+        data += sizeof(fields);
+        memcpy(data, record.id.data(), record.id.size());
+        data += record.id.size();
+        memcpy(data, record.tenantToken.data(), record.tenantToken.size());
+        data += record.tenantToken.size();
+        if (!record.blob.empty())
+        {
+            memcpy(data, record.blob.data(), record.blob.size());
+        }
+
+        slot->state.store(SlotCommitted, std::memory_order_release);
+        m_header->queuedCount.fetch_add(1, std::memory_order_relaxed);
+        return true;
+    }
+
+    void OfflineStorage_SharedMemory::discard(uint64_t from, uint64_t to)
+    {
+        while (from < to)
+        {
+            const size_t offset = static_cast<size_t>(from % m_capacity);
+            const size_t length = static_cast<size_t>(std::min<uint64_t>(to - from, m_capacity - offset));
+            memset(m_ring + offset, 0, length);
+            from += length;
+        }
+    }
+
+    bool OfflineStorage_SharedMemory::decode(const uint8_t* slot, size_t size, StorageRecord& record)
+    {
+        RecordFields fields;
+        const uint8_t* data = slot + sizeof(SlotHeader);
+        memcpy(&fields, data, sizeof(fields));
+        data += sizeof(fields);
+        if (sizeof(SlotHeader) + sizeof(fields) + static_cast<size_t>(fields.idLength) + fields.tenantTokenLength + fields.blobLength > size)
+        {
+            return false;
+        }
+        record.id.assign(reinterpret_cast<const char*>(data), fields.idLength);
+        data += fields.idLength;
+        record.tenantToken.assign(reinterpret_cast<const char*>(data), fields.tenantTokenLength);
+        data += fields.tenantTokenLength;
+        record.blob.assign(data, data + fields.blobLength);
+        record.timestamp = fields.timestamp;
+        record.latency = static_cast<EventLatency>(fields.latency);
+        record.persistence = static_cast<EventPersistence>(fields.persistence);
+        record.retryCount = fields.retryCount;
+        return true;
+    }
+
+    size_t OfflineStorage_SharedMemory::drain()
+    {
+        size_t drained = 0;
+        uint64_t readPos = m_header->readPos.load(std::memory_order_relaxed);
+        for (;;)
+        {
+            const uint64_t writePos = m_header->writePos.load(std::memory_order_acquire);
+            if (readPos == writePos)
+            {
+                break;
+            }
+            // The rest stays in the ring until uploads make room in memory
+            const size_t localSize = m_local->GetSize();
+            if (localSize > 0 && localSize >= m_localSizeLimit)
+            {
+                break;
+            }
+
+            const size_t offset = static_cast<size_t>(readPos % m_capacity);
+            SlotHeader* slot = reinterpret_cast<SlotHeader*>(m_ring + offset);
+            const uint32_t state = slot->state.load(std::memory_order_acquire);
+            const size_t size = slot->size;
+            const bool validSize = size >= sizeof(SlotHeader) && (size % SlotAlignment) == 0 &&
+                offset + size <= m_capacity && readPos + size <= writePos;
+
+            if (state == SlotEmpty || (state == SlotWriting && isProcessAlive(slot->pid)))
+            {
+                // Still being written, or reserved by a writer that died before writing the slot header
+                const uint64_t now = PAL::getMonotonicTimeMs();
+                if (m_stalledPosition != readPos || m_stalledSince == 0)
+                {
+                    m_stalledPosition = readPos;
+                    m_stalledSince = now;
+                    break;
+                }
+                if (state == SlotWriting || now - m_stalledSince < StallTimeoutMs)
+                {
+                    break;
+                }
+                LOG_WARN("Shared queue slot at %llu was never written, discarding %llu bytes",
+                    static_cast<unsigned long long>(readPos), static_cast<unsigned long long>(writePos - readPos));
+                discard(readPos, writePos);
+                readPos = writePos;
+            }
+            else if (!validSize)
+            {
+                LOG_ERROR("Shared queue is corrupt at %llu, discarding %llu bytes",
+                    static_cast<unsigned long long>(readPos), static_cast<unsigned long long>(writePos - readPos));
+                discard(readPos, writePos);
+                readPos = writePos;
+            }
+            else
+            {
+                if (state == SlotCommitted)
+                {
+                    StorageRecord record;
+                    if (decode(m_ring + offset, size, record) && m_local->StoreRecord(record))
+                    {
+                        if (slot->pid == m_pid)
+                        {
+                            m_ownIds.insert(record.id);
+                        }
+                        drained++;
+                    }
+                    m_header->queuedCount.fetch_sub(1, std::memory_order_relaxed);
+                }
+                else if (state == SlotWriting)
+                {
+                    LOG_WARN("Writer %d died while writing to the shared queue", slot->pid);
+                }
+                // Freed space must read as empty slots when writers reuse it
+                discard(readPos, readPos + size);
+                readPos += size;
+            }
+            m_stalledSince = 0;
+            m_header->readPos.store(readPos, std::memory_order_release);
+        }
+        return drained;
+    }
+
+    bool OfflineStorage_SharedMemory::tryBecomeUploader()
+    {
+        if (m_isUploader)
+        {
+            return true;
+        }
+        if (m_canUpload && m_lockFd >= 0 && ::flock(m_lockFd, LOCK_EX | LOCK_NB) == 0)
+        {
+            LOG_INFO("Process %d is now the uploader of shared queue %s", static_cast<int>(::getpid()), m_path.c_str());
+            m_isUploader = true;
+        }
+        return m_isUploader;
+    }
+
+    void OfflineStorage_SharedMemory::giveUpUploader()
+    {
+        m_isUploader = false;
+        ::flock(m_lockFd, LOCK_UN);
+        LOG_INFO("Process %d is no longer the uploader of shared queue %s", static_cast<int>(::getpid()), m_path.c_str());
+    }
+
+    bool OfflineStorage_SharedMemory::StoreRecord(StorageRecord const& record)
+    {
+        if (append(record))
+        {
+            return true;
+        }
+        if (m_observer != nullptr && m_header != nullptr)
+        {
+            m_observer->OnStorageTrimmed({ { record.tenantToken, 1 } });
+        }
+        return false;
+    }
+
+    size_t OfflineStorage_SharedMemory::StoreRecords(std::vector<StorageRecord>& records)
+    {
+        size_t stored = 0;
+        for (auto const& record : records)
+        {
+            stored += StoreRecord(record) ? 1 : 0;
+        }
+        return stored;
+    }
+
+    bool OfflineStorage_SharedMemory::reserve(std::function<bool()> const& read)
+    {
+        m_lastReadCount = 0;
+        bool result = true;
+        // Records of this process are uploaded by another one while it cannot become the uploader
+        while (m_header != nullptr && tryBecomeUploader())
+        {
+            LOCKGUARD(m_drainLock);
+            const uint64_t writePos = m_header->writePos.load(std::memory_order_acquire);
+            drain();
+            result = read();
+            m_lastReadCount = m_local->LastReadRecordCount();
+            if (m_lastReadCount > 0 || m_local->GetRecordCount() > 0 || m_local->GetReservedCount() > 0)
+            {
+                break;
+            }
+
+            // Idle: whoever appends next finds the lock free and uploads. A writer that
+            // appended meanwhile may have found it taken, so take its records back.
+            m_ownIds.clear();
+            giveUpUploader();
+            if (m_header->writePos.load(std::memory_order_acquire) == writePos)
+            {
+                break;
+            }
+        }
+        return result;
+    }
+
+    bool OfflineStorage_SharedMemory::GetAndReserveRecords(std::function<bool(StorageRecord&&)> const& consumer, unsigned leaseTimeMs,
+        EventLatency minLatency, unsigned maxCount)
+    {
+        return reserve([&]() { return m_local->GetAndReserveRecords(consumer, leaseTimeMs, minLatency, maxCount); });
+    }
+
+    bool OfflineStorage_SharedMemory::GetAndReserveTenantRecords(std::function<bool(StorageRecord&&)> const& consumer, unsigned leaseTimeMs,
+        std::string const& tenantToken, EventLatency minLatency, unsigned maxCount)
+    {
+        return reserve([&]() { return m_local->GetAndReserveTenantRecords(consumer, leaseTimeMs, tenantToken, minLatency, maxCount); });
+    }
+
+    bool OfflineStorage_SharedMemory::IsLastReadFromMemory()
+    {
+        return true;
+    }
+
+    unsigned OfflineStorage_SharedMemory::LastReadRecordCount()
+    {
+        return m_lastReadCount;
+    }
+
+    void OfflineStorage_SharedMemory::deleteOwnRecords(std::function<bool(StorageRecord const&)> const& matcher)
+    {
+        if (m_header == nullptr)
+        {
+            return;
+        }
+        if (!tryBecomeUploader())
+        {
+            LOG_WARN("Records of this process queued while another process uploads are not deleted");
+            return;
+        }
+
+        // No other process drains the ring meanwhile, and writers only commit slots or append
+        LOCKGUARD(m_drainLock);
+        const uint64_t writePos = m_header->writePos.load(std::memory_order_acquire);
+        uint64_t position = m_header->readPos.load(std::memory_order_relaxed);
+        while (position < writePos)
+        {
+            const size_t offset = static_cast<size_t>(position % m_capacity);
+            SlotHeader* slot = reinterpret_cast<SlotHeader*>(m_ring + offset);
+            const uint32_t state = slot->state.load(std::memory_order_acquire);
+            const size_t size = slot->size;
+            if (state == SlotEmpty || size < sizeof(SlotHeader) || (size % SlotAlignment) != 0 ||
+                offset + size > m_capacity || position + size > writePos)
+            {
+                // The size of the slots from here on is not known yet
+                break;
+            }
+            StorageRecord record;
+            if (state == SlotCommitted && slot->pid == m_pid && decode(m_ring + offset, size, record) && matcher(record))
+            {
+                slot->state.store(SlotPadding, std::memory_order_release);
+                m_header->queuedCount.fetch_sub(1, std::memory_order_relaxed);
+            }
+            position += size;
+        }
+
+        m_local->DeleteMatchingRecords([this, &matcher](StorageRecord const& record) {
+            return m_ownIds.count(record.id) != 0 && matcher(record);
+        });
+    }
+
+    void OfflineStorage_SharedMemory::DeleteAllRecords()
+    {
+        deleteOwnRecords([](StorageRecord const&) { return true; });
+    }
+
+    void OfflineStorage_SharedMemory::DeleteRecords(const std::map<std::string, std::string>& whereFilter)
+    {
+        deleteOwnRecords([&whereFilter](StorageRecord const& record) { return MemoryStorage::MatchesFilter(record, whereFilter); });
+    }
+
+    void OfflineStorage_SharedMemory::DeleteRecords(std::vector<StorageRecordId> const& ids, HttpHeaders headers, bool& fromMemory)
+    {
+        m_local->DeleteRecords(ids, headers, fromMemory);
+        LOCKGUARD(m_drainLock);
+        for (auto const& id : ids)
+        {
+            m_ownIds.erase(id);
+        }
+    }
+
+    void OfflineStorage_SharedMemory::ReleaseRecords(std::vector<StorageRecordId> const& ids, bool incrementRetryCount, HttpHeaders headers, bool& fromMemory)
+    {
+        m_local->ReleaseRecords(ids, incrementRetryCount, headers, fromMemory);
+    }
+
+    void OfflineStorage_SharedMemory::ReleaseAllRecords()
+    {
+        m_local->ReleaseAllRecords();
+    }
+
+    bool OfflineStorage_SharedMemory::StoreSetting(std::string const& name, std::string const& value)
+    {
+        return m_local->StoreSetting(name, value);
+    }
+
+    std::string OfflineStorage_SharedMemory::GetSetting(std::string const& name)
+    {
+        return m_local->GetSetting(name);
+    }
+
+    bool OfflineStorage_SharedMemory::DeleteSetting(std::string const& name)
+    {
+        return m_local->DeleteSetting(name);
+    }
+
+    size_t OfflineStorage_SharedMemory::GetSize()
+    {
+        size_t size = m_local->GetSize();
+        if (m_header != nullptr)
+        {
+            size += static_cast<size_t>(m_header->writePos.load(std::memory_order_relaxed) - m_header->readPos.load(std::memory_order_relaxed));
+        }
+        return size;
+    }
+
+    size_t OfflineStorage_SharedMemory::GetQueuedCount() const
+    {
+        return (m_header != nullptr) ? static_cast<size_t>(m_header->queuedCount.load(std::memory_order_relaxed)) : 0;
+    }
+
+    size_t OfflineStorage_SharedMemory::GetRecordCount(EventLatency latency) const
+    {
+        // Any process can take over the upload of the queued records; the ring is not indexed by latency
+        size_t count = m_local->GetRecordCount(latency);
+        if (latency == EventLatency_Unspecified && m_canUpload)
+        {
+            count += GetQueuedCount();
+        }
+        return count;
+    }
+
+    std::vector<StorageRecord> OfflineStorage_SharedMemory::GetRecords(bool shutdown, EventLatency minLatency, unsigned maxCount)
+    {
+        if (m_header != nullptr && tryBecomeUploader())
+        {
+            LOCKGUARD(m_drainLock);
+            drain();
+            return m_local->GetRecords(shutdown, minLatency, maxCount);
+        }
+        return std::vector<StorageRecord>{};
+    }
+
+    bool OfflineStorage_SharedMemory::ResizeDb()
+    {
+        return true;
+    }
+
+} MAT_NS_END
+
+#endif // HAVE_MAT_SHARED_QUEUE
@@ -0,0 +1,155 @@
+//
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// SPDX-License-Identifier: Apache-2.0
+//
+#ifndef OFFLINESTORAGE_SHAREDMEMORY_HPP
+#define OFFLINESTORAGE_SHAREDMEMORY_HPP
+
+#include "mat/config.h"
+
+#ifdef HAVE_MAT_SHARED_QUEUE
+
+#include "pal/PAL.hpp"
+#include "IOfflineStorage.hpp"
+
+#include "api/IRuntimeConfig.hpp"
+
+#include "ILogManager.hpp"
+
+#include <atomic>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <set>
+#include <string>
+
+namespace MAT_NS_BEGIN {
+
+    class MemoryStorage;
+
+    /// <summary>
+    /// Offline storage shared by all processes on a host through a ring buffer in a
+    /// memory-mapped file (normally on tmpfs, e.g. /dev/shm). Every process appends
+    /// its records to the ring without taking a lock. The one process that holds an
+    /// exclusive flock() on "path.lock" is the uploader: it drains the ring into its
+    /// own MemoryStorage, up to CFG_INT_RAM_QUEUE_SIZE bytes at a time, and uploads
+    /// through the normal Packager/TPM pipeline. All other processes only append. The
+    /// uploader gives up the lock as soon as it has nothing left to upload, and the
+    /// kernel releases it when the uploader exits or crashes; the next process that
+    /// asks for records takes over, so every writer uploads its own records at the
+    /// latest when no other process does. With CFG_BOOL_SHARED_QUEUE_UPLOAD set to false
+    /// a process never becomes the uploader: a host forwarder uploads its records.
+    ///
+    /// The uploader sends all records to its collector and with its own tickets, so all
+    /// processes that share a queue must use the same tickets. A process configured for
+    /// another collector than the one the queue was created for cannot open it.
+    /// DeleteAllRecords() and DeleteRecords(filter) delete the records of the calling
+    /// process only, and only while it can become the uploader: records it appended
+    /// while another process uploads belong to that process until they are sent.
+    /// </summary>
+    class OfflineStorage_SharedMemory : public IOfflineStorage
+    {
+    public:
+        static constexpr uint32_t Magic = 0x5153414D; // "MASQ"
+        static constexpr uint32_t Version = 2;
+        static constexpr size_t   HeaderSize = 4096;
+        static constexpr size_t   SlotAlignment = 16;
+        // A slot that stays unwritten this long after its space was reserved belongs to a crashed writer
+        static constexpr uint64_t StallTimeoutMs = 10000;
+
+        OfflineStorage_SharedMemory(ILogManager& logManager, IRuntimeConfig& runtimeConfig);
+        virtual ~OfflineStorage_SharedMemory() override;
+
+        virtual void Initialize(IOfflineStorageObserver& observer) override;
+        virtual void Shutdown() override;
+        virtual void Flush() override;
+        virtual bool StoreRecord(StorageRecord const& record) override;
+        virtual size_t StoreRecords(std::vector<StorageRecord>& records) override;
+        virtual bool GetAndReserveRecords(std::function<bool(StorageRecord&&)> const& consumer, unsigned leaseTimeMs,
+            EventLatency minLatency = EventLatency_Unspecified, unsigned maxCount = 0) override;
+        virtual bool GetAndReserveTenantRecords(std::function<bool(StorageRecord&&)> const& consumer, unsigned leaseTimeMs,
+            std::string const& tenantToken, EventLatency minLatency = EventLatency_Unspecified, unsigned maxCount = 0) override;
+        virtual bool IsLastReadFromMemory() override;
+        virtual unsigned LastReadRecordCount() override;
+
+        virtual void DeleteAllRecords() override;
+        virtual void DeleteRecords(const std::map<std::string, std::string>& whereFilter) override;
+        virtual void DeleteRecords(std::vector<StorageRecordId> const& ids, HttpHeaders headers, bool& fromMemory) override;
+        virtual void ReleaseRecords(std::vector<StorageRecordId> const& ids, bool incrementRetryCount, HttpHeaders headers, bool& fromMemory) override;
+        virtual void ReleaseAllRecords() override;
+
+        virtual bool StoreSetting(std::string const& name, std::string const& value) override;
+        virtual std::string GetSetting(std::string const& name) override;
+        virtual bool DeleteSetting(std::string const& name) override;
+
+        virtual size_t GetSize() override;
+        virtual size_t GetRecordCount(EventLatency latency = EventLatency_Unspecified) const override;
+        virtual std::vector<StorageRecord> GetRecords(bool shutdown, EventLatency minLatency = EventLatency_Unspecified, unsigned maxCount = 0) override;
+        virtual bool ResizeDb() override;
+
+        /// <summary>
+        /// Whether this process is currently the uploader of the shared queue.
+        /// </summary>
+        bool IsUploader() const noexcept
+        {
+            return m_isUploader;
+        }
+
+        /// <summary>
+        /// Number of records waiting in the ring, appended by any process.
+        /// </summary>
+        size_t GetQueuedCount() const;
+
+    protected:
+        struct RingHeader;
+        struct SlotHeader;
+
+        bool open();
+        void close();
+        bool tryBecomeUploader();
+        void giveUpUploader();
+        bool reserve(std::function<bool()> const& read);
+        bool append(StorageRecord const& record);
+        size_t drain();
+        void discard(uint64_t from, uint64_t to);
+        void deleteOwnRecords(std::function<bool(StorageRecord const&)> const& matcher);
+        static size_t encodedSize(StorageRecord const& record);
+        static bool decode(const uint8_t* slot, size_t size, StorageRecord& record);
+
+        IOfflineStorageObserver*       m_observer;
+        IRuntimeConfig&                m_config;
+        ILogManager&                   m_logManager;
+        std::string                    m_path;
+        std::string                    m_collectorUrl;
+        size_t                         m_capacity;
+
+        int                            m_fd;
+        int                            m_lockFd;
+        uint8_t*                       m_mapping;
+        size_t                         m_mappingSize;
+        RingHeader*                    m_header;
+        uint8_t*                       m_ring;
+        // Marks the slots this process appends
+        int32_t                        m_pid;
+
+        std::mutex                     m_drainLock;
+        // False when a host forwarder uploads the queue: this process only appends
+        bool                           m_canUpload;
+        std::atomic<bool>              m_isUploader;
+        // Records drained by the uploader, and the settings of this process
+        std::unique_ptr<MemoryStorage> m_local;
+        size_t                         m_localSizeLimit;
+        // Ids of the drained records this process appended itself
+        std::set<std::string>          m_ownIds;
+        uint64_t                       m_stalledPosition;
+        uint64_t                       m_stalledSince;
+        unsigned                       m_lastReadCount;
+
+        MATSDK_LOG_DECL_COMPONENT_CLASS();
+    };
+
+} MAT_NS_END
+
+#endif // HAVE_MAT_SHARED_QUEUE
+
+#endif
@@ -30,6 +30,12 @@ namespace MAT_NS_BEGIN {
         return true;
     }
 
+    bool StorageObserver::handleFlush()
+    {
+        m_offlineStorage.Flush();
+        return true;
+    }
+
     bool StorageObserver::handleStoreRecord(IncomingEventContextPtr const& ctx)
     {
         ctx->record.timestamp = PAL::getUtcSystemTimeMs();
@@ -50,7 +56,10 @@ namespace MAT_NS_BEGIN {
         };
 
         // TODO: [MG] - expose 120000 as a configuration parameter
-        if (!m_offlineStorage.GetAndReserveRecords(consumer, 120000, ctx->requestedMinLatency, ctx->requestedMaxCount))
+        bool retrieved = ctx->requestedTenantToken.empty() ?
+            m_offlineStorage.GetAndReserveRecords(consumer, 120000, ctx->requestedMinLatency, ctx->requestedMaxCount) :
+            m_offlineStorage.GetAndReserveTenantRecords(consumer, 120000, ctx->requestedTenantToken, ctx->requestedMinLatency, ctx->requestedMaxCount);
+        if (!retrieved)
         {
             ctx->fromMemory = m_offlineStorage.IsLastReadFromMemory();
             retrievalFailed(ctx);
@@ -29,6 +29,7 @@ namespace MAT_NS_BEGIN {
     protected:
         bool handleStart();
         bool handleStop();
+        bool handleFlush();
 
         bool handleStoreRecord(IncomingEventContextPtr const& ctx);
         void handleRetrieveEvents(EventsUploadContextPtr const& ctx);
@@ -64,11 +65,12 @@ namespace MAT_NS_BEGIN {
 
         RoutePassThrough<StorageObserver>                                        start{ this, &StorageObserver::handleStart };
         RoutePassThrough<StorageObserver>                                        stop{ this, &StorageObserver::handleStop };
+        RoutePassThrough<StorageObserver>                                        flush{ this, &StorageObserver::handleFlush };
 
         RouteSource<IncomingEventContextPtr const&>                              storeRecordFailed;
-        RoutePassThrough<StorageObserver, IncomingEventContextPtr const&>        storeRecord{ this, &StorageObserver::handleStoreRecord };
+        MAT_BOUND_ROUTE(StorageObserver, handleStoreRecord)                      storeRecord{ this, "storeRecord" };
 
-        RouteSink<StorageObserver, EventsUploadContextPtr const&>                retrieveEvents{ this, &StorageObserver::handleRetrieveEvents };
+        RouteSink<StorageObserver, EventsUploadContextPtr const&>                retrieveEvents{ this, &StorageObserver::handleRetrieveEvents, "retrieveEvents" };
         RouteSource<EventsUploadContextPtr const&, StorageRecord const&, bool&>  retrievedEvent;
         RouteSource<EventsUploadContextPtr const&>                               retrievalFinished;
         RouteSource<EventsUploadContextPtr const&>                               retrievalFailed;
@@ -11,7 +11,8 @@
 namespace MAT_NS_BEGIN {
 
     Packager::Packager(IRuntimeConfig& runtimeConfig)
-        : m_config(runtimeConfig)
+        : m_config(runtimeConfig),
+          m_trackRecordOrigins(static_cast<bool>(runtimeConfig[CFG_MAP_METASTATS_CONFIG][CFG_BOOL_METASTATS_DELIVERY_LATENCY]))
     {
         const char *forcedTenantToken = runtimeConfig["forcedTenantToken"];
         if (forcedTenantToken != nullptr)
@@ -26,6 +27,9 @@ namespace MAT_NS_BEGIN {
             if (ctx->maxUploadSize == 0) {
                 ctx->maxUploadSize = m_config.GetMaximumUploadSizeBytes();
             }
+            if (ctx->packagingStartMs == 0) {
+                ctx->packagingStartMs = PAL::getUtcSystemTimeMs();
+            }
             if (ctx->splicer->getSizeEstimate() + record.blob.size() > ctx->maxUploadSize) {
                 wantMore = false;
                 if (!ctx->recordIdsAndTenantIds.empty()) {
@@ -63,6 +67,9 @@ namespace MAT_NS_BEGIN {
 
             ctx->recordIdsAndTenantIds[record.id] = record.tenantToken;
             ctx->recordTimestamps.push_back(record.timestamp);
+            if (m_trackRecordOrigins) {
+                ctx->recordOrigins.emplace_back(record.tenantToken, record.latency);
+            }
             ctx->maxRetryCountSeen = std::max<int>(ctx->maxRetryCountSeen, record.retryCount);
         }
         catch (const std::bad_alloc&) {
@@ -80,6 +87,7 @@ namespace MAT_NS_BEGIN {
 
         ctx->body = ctx->splicer->splice();
         ctx->splicer->clear();
+        ctx->packagingMs = static_cast<int>(std::max<int64_t>(0, PAL::getUtcSystemTimeMs() - ctx->packagingStartMs));
 
         packagedEvents(ctx);
     }
@@ -22,10 +22,11 @@ namespace MAT_NS_BEGIN {
     protected:
         IRuntimeConfig & m_config;
         std::string      m_forcedTenantToken;
+        bool             m_trackRecordOrigins;
 
     public:
-        RouteSink<Packager, EventsUploadContextPtr const&, StorageRecord const&, bool&> addEventToPackage{ this, &Packager::handleAddEventToPackage };
-        RouteSink<Packager, EventsUploadContextPtr const&>                              finalizePackage{ this, &Packager::handleFinalizePackage };
+        RouteSink<Packager, EventsUploadContextPtr const&, StorageRecord const&, bool&> addEventToPackage{ this, &Packager::handleAddEventToPackage, "addEventToPackage" };
+        RouteSink<Packager, EventsUploadContextPtr const&>                              finalizePackage{ this, &Packager::handleFinalizePackage, "finalizePackage" };
 
         RouteSource<EventsUploadContextPtr const&>                                      emptyPackage;
         RouteSource<EventsUploadContextPtr const&>                                      packagedEvents;
@@ -0,0 +1,178 @@
+//
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// SPDX-License-Identifier: Apache-2.0
+//
+#include "AsyncLogSink.hpp"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+
+namespace PAL_NS_BEGIN
+{
+    constexpr size_t AsyncLogSink::DefaultBufferSize;
+
+    AsyncLogSink::AsyncLogSink(std::string const& path, size_t maxFileSize, size_t bufferSize) :
+        m_path(path),
+        m_maxFileSize(maxFileSize),
+        m_capacity(std::max<size_t>(bufferSize, 1)),
+        m_isOpen(false),
+        m_buffer(new char[m_capacity]),
+        m_head(0),
+        m_size(0),
+        m_queuedBytes(0),
+        m_writtenBytes(0),
+        m_dropped(0),
+        m_droppedSinceReport(0),
+        m_stopping(false),
+        m_writerDone(true),
+        m_fileSize(0)
+    {
+        m_file.open(m_path, std::ios::out | std::ios::trunc | std::ios::binary);
+        m_isOpen = m_file.is_open();
+        m_writerDone = !m_isOpen;
+        if (m_isOpen)
+        {
+            m_thread = std::thread(&AsyncLogSink::run, this);
+        }
+    }
+
+    AsyncLogSink::~AsyncLogSink()
+    {
+        Stop();
+    }
+
+    bool AsyncLogSink::Write(const char* text, size_t length)
+    {
+        if (length == 0)
+        {
+            return true;
+        }
+
+        {
+            std::lock_guard<std::mutex> lock(m_lock);
+            if (m_stopping || !m_isOpen)
+            {
+                return false;
+            }
+            if (m_droppedSinceReport != 0)
+            {
+                char report[64];
+                int reportLength = snprintf(report, sizeof(report), "[%llu log lines dropped]\n", static_cast<unsigned long long>(m_droppedSinceReport));
+                if (reportLength > 0 && enqueue(report, static_cast<size_t>(reportLength)))
+                {
+                    m_droppedSinceReport = 0;
+                }
+            }
+            if (!enqueue(text, length))
+            {
+                m_dropped++;
+                m_droppedSinceReport++;
+                return false;
+            }
+        }
+        m_dataAvailable.notify_one();
+        return true;
+    }
+
+    bool AsyncLogSink::enqueue(const char* text, size_t length)
+    {
+        if (length > m_capacity - m_size)
+        {
+            return false;
+        }
+        size_t tail = (m_head + m_size) % m_capacity;
+        size_t first = std::min(length, m_capacity - tail);
+        memcpy(m_buffer.get() + tail, text, first);
+        memcpy(m_buffer.get(), text + first, length - first);
+        m_size += length;
+        m_queuedBytes += length;
+        return true;
+    }
+
+    void AsyncLogSink::Flush()
+    {
+        std::unique_lock<std::mutex> lock(m_lock);
+        const uint64_t target = m_queuedBytes;
+        m_drained.wait(lock, [this, target]() { return m_writtenBytes >= target || m_writerDone; });
+    }
+
+    void AsyncLogSink::Stop()
+    {
+        {
+            std::lock_guard<std::mutex> lock(m_lock);
+            m_stopping = true;
+        }
+        m_dataAvailable.notify_one();
+        if (m_thread.joinable() && m_thread.get_id() != std::this_thread::get_id())
+        {
+            m_thread.join();
+        }
+        if (m_file.is_open())
+        {
+            m_file.close();
+        }
+    }
+
+    uint64_t AsyncLogSink::GetDroppedCount()
+    {
+        std::lock_guard<std::mutex> lock(m_lock);
+        return m_dropped;
+    }
+
+    void AsyncLogSink::run()
+    {
+        std::unique_lock<std::mutex> lock(m_lock);
+        uint64_t unflushedBytes = 0;
+        for (;;)
+        {
+            m_dataAvailable.wait(lock, [this]() { return m_size != 0 || m_stopping; });
+            if (m_size == 0)
+            {
+                // Stopping with everything written
+                break;
+            }
+
+            // Writers only append after the occupied region, so the chunk can be written unlocked
+            const char* chunk = m_buffer.get() + m_head;
+            const size_t length = std::min(m_size, m_capacity - m_head);
+            lock.unlock();
+            writeToFile(chunk, length);
+            lock.lock();
+
+            m_head = (m_head + length) % m_capacity;
+            m_size -= length;
+            unflushedBytes += length;
+            if (m_size == 0)
+            {
+                lock.unlock();
+                m_file.flush();
+                lock.lock();
+                m_writtenBytes += unflushedBytes;
+                unflushedBytes = 0;
+                m_drained.notify_all();
+            }
+        }
+        m_writerDone = true;
+        m_drained.notify_all();
+    }
+
+    void AsyncLogSink::writeToFile(const char* text, size_t length)
+    {
+        if (m_maxFileSize != 0 && m_fileSize != 0 && m_fileSize + length > m_maxFileSize)
+        {
+            m_file.close();
+            const std::string rotated = m_path + ".1";
+            std::remove(rotated.c_str());
+            std::rename(m_path.c_str(), rotated.c_str());
+            m_file.open(m_path, std::ios::out | std::ios::trunc | std::ios::binary);
+            m_fileSize = 0;
+        }
+        if (m_file.good())
+        {
+            m_file.write(text, static_cast<std::streamsize>(length));
+            m_fileSize += length;
+        }
+    }
+
+} PAL_NS_END
@@ -0,0 +1,101 @@
+//
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// SPDX-License-Identifier: Apache-2.0
+//
+#ifndef ASYNCLOGSINK_HPP
+#define ASYNCLOGSINK_HPP
+
+#include "ctmacros.hpp"
+
+#include <condition_variable>
+#include <cstdint>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+
+namespace PAL_NS_BEGIN
+{
+    /// <summary>
+    /// Debug log file written by a background thread. Callers copy formatted lines
+    /// into a fixed-size ring buffer and return; the writer thread drains the ring
+    /// into the file. Lines that do not fit into the ring are dropped and counted.
+    /// When the file would grow beyond the size limit it is renamed to "path.1"
+    /// (replacing the previous one) and a new file is started.
+    /// </summary>
+    class AsyncLogSink
+    {
+    public:
+        static constexpr size_t DefaultBufferSize = 1024 * 1024;
+
+        /// <summary>
+        /// Opens (truncates) the log file and starts the writer thread.
+        /// </summary>
+        /// <param name="path">Log file path.</param>
+        /// <param name="maxFileSize">Size at which the file is rotated, 0 for no limit.</param>
+        /// <param name="bufferSize">Capacity of the ring buffer in bytes.</param>
+        AsyncLogSink(std::string const& path, size_t maxFileSize, size_t bufferSize = DefaultBufferSize);
+        ~AsyncLogSink();
+
+        AsyncLogSink(AsyncLogSink const&) = delete;
+        AsyncLogSink& operator=(AsyncLogSink const&) = delete;
+
+        bool IsOpen() const noexcept
+        {
+            return m_isOpen;
+        }
+
+        /// <summary>
+        /// Queues text for writing without waiting for the file.
+        /// </summary>
+        /// <returns>false when the text was dropped because the ring buffer is full.</returns>
+        bool Write(const char* text, size_t length);
+
+        /// <summary>
+        /// Waits until everything queued so far is written and flushed to the file.
+        /// </summary>
+        void Flush();
+
+        /// <summary>
+        /// Writes everything queued and stops the writer thread. Later writes are dropped.
+        /// </summary>
+        void Stop();
+
+        uint64_t GetDroppedCount();
+
+    protected:
+        void run();
+        bool enqueue(const char* text, size_t length);
+        void writeToFile(const char* text, size_t length);
+
+        const std::string m_path;
+        const size_t m_maxFileSize;
+        const size_t m_capacity;
+        bool m_isOpen;
+
+        std::mutex m_lock;
+        std::condition_variable m_dataAvailable;
+        std::condition_variable m_drained;
+        std::unique_ptr<char[]> m_buffer;
+        // Ring buffer state: m_size bytes starting at m_head
+        size_t m_head;
+        size_t m_size;
+        uint64_t m_queuedBytes;
+        // Written and flushed to the file
+        uint64_t m_writtenBytes;
+        uint64_t m_dropped;
+        uint64_t m_droppedSinceReport;
+        bool m_stopping;
+        bool m_writerDone;
+
+        // Owned by the writer thread
+        std::ofstream m_file;
+        size_t m_fileSize;
+
+        std::thread m_thread;
+    };
+
+} PAL_NS_END
+
+#endif
@@ -10,6 +10,8 @@
 #include "ctmacros.hpp"
 #include "typename.hpp"
 
+#include <atomic>
+
 namespace PAL_NS_BEGIN
 {
 
@@ -52,13 +54,20 @@ namespace PAL_NS_BEGIN
 
     namespace detail {
         extern LogLevel g_logLevel;
+        // Whether there is a log destination: the debug log file is open
+        extern std::atomic<bool> isLoggingInited;
         extern void log(LogLevel level, char const* component, char const* fmt, ...);
     } // namespace detail
 
 #define MATSDK_SET_LOG_LEVEL_(level_) (PAL::detail::g_logLevel = (level_))
 
-// Check if logging is enabled on a specific level
+// Check if logging is enabled on a specific level and there is a destination for the message
+#if defined(ANDROID) && !defined(ANDROID_SUPPRESS_LOGCAT)
+// Every message that passes the level check goes to logcat
 #define MATSDK_LOG_ENABLED_(level_)   (PAL::detail::g_logLevel >= (level_))
+#else
+#define MATSDK_LOG_ENABLED_(level_)   (PAL::detail::g_logLevel >= (level_) && PAL::detail::isLoggingInited.load(std::memory_order_relaxed))
+#endif
 
 #define MATSDK_LOG_ENABLED_DETAIL()   MATSDK_LOG_ENABLED_(PAL::Detail)
 #define MATSDK_LOG_ENABLED_INFO()     MATSDK_LOG_ENABLED_(PAL::Info)
@@ -3,6 +3,7 @@
 // SPDX-License-Identifier: Apache-2.0
 //
 #include "PAL.hpp"
+#include "AsyncLogSink.hpp"
 
 #include "ILogManager.hpp"
 #include "ISemanticContext.hpp"
@@ -23,6 +24,7 @@
 
 #include <stdarg.h>
 
+#include "utils/FileUtils.hpp"
 #include "utils/Utils.hpp"
 #include <sys/types.h>
 
@@ -53,6 +55,10 @@
 #include <android/log.h>
 #endif
 
+#if defined(__linux__) && !defined(ANDROID)
+#include "posix/sysinfo_sources_impl.hpp"
+#endif
+
 #include <ctime>
 
 namespace PAL_NS_BEGIN {
@@ -87,62 +93,64 @@ namespace PAL_NS_BEGIN {
 
 #define DBG_BUFFER_LEN      2048
 
-#ifndef _WIN32
-#define DEBUG_LOG_NULL      "/dev/null"
-#else
-#define DEBUG_LOG_NULL      "NUL"
-#endif
-
-        bool isLoggingInited = false;
+        std::atomic<bool> isLoggingInited(false);
 
 #ifdef HAVE_MAT_LOGGING
         std::recursive_mutex          debugLogMutex;
         std::string                   debugLogPath;
-        std::unique_ptr<std::fstream> debugLogStream;
+        // Lines are formatted by the caller and written to the file by the sink's own thread
+        std::unique_ptr<AsyncLogSink> debugLogSink;
 
-        bool log_init(bool isTraceEnabled, const std::string& traceFolderPath)
+        bool log_init(bool isTraceEnabled, const std::string& traceFolderPath, size_t maxFileSize)
         {
             if (!isTraceEnabled)
             {
                 return false;
             }
 
-            bool result = true;
-            if (debugLogStream != nullptr)
+            std::lock_guard<std::recursive_mutex> lock(debugLogMutex);
+            if (debugLogSink != nullptr)
             {
-                return result;
+                return true;
             }
 
-            debugLogMutex.lock();
             debugLogPath = traceFolderPath;
             debugLogPath += "mat-debug-";
             debugLogPath += std::to_string(MAT::GetCurrentProcessId());
             debugLogPath += ".log";
 
-            debugLogStream = std::unique_ptr<std::fstream>(new std::fstream());
-            debugLogStream->open(debugLogPath, std::fstream::out);
-            if (!debugLogStream->is_open())
+            debugLogSink.reset(new AsyncLogSink(debugLogPath, maxFileSize));
+            if (!debugLogSink->IsOpen())
             {
-                // If file cannot be created, log to /dev/null
-                debugLogStream->open(DEBUG_LOG_NULL);
-                result = false;
+                // If file cannot be created, do not log
+                debugLogSink = nullptr;
+                return false;
             }
-            debugLogMutex.unlock();
-            return result;
+            return true;
         }
 
         void log_done()
         {
-            debugLogMutex.lock();
-            if (debugLogStream)
+            std::unique_ptr<AsyncLogSink> sink;
             {
-                debugLogStream = nullptr;
+                std::lock_guard<std::recursive_mutex> lock(debugLogMutex);
                 isLoggingInited = false;
+                sink = std::move(debugLogSink);
+            }
+            // Drains the queued lines outside of the lock
+            sink.reset();
+        }
+
+        static void log_write(const char* text, size_t length)
+        {
+            std::lock_guard<std::recursive_mutex> lock(debugLogMutex);
+            if (debugLogSink)
+            {
+                debugLogSink->Write(text, length);
             }
-            debugLogMutex.unlock();
         }
 #else
-        bool log_init(bool /*isTraceEnabled*/, const std::string& /*traceFolderPath*/)
+        bool log_init(bool /*isTraceEnabled*/, const std::string& /*traceFolderPath*/, size_t /*maxFileSize*/)
         {
             return false;
         }
@@ -153,13 +161,9 @@ namespace PAL_NS_BEGIN {
 #endif
 
 #if !defined(_WIN32) && defined(__linux__)
-        static std::mutex m;
-        static std::map<std::thread::id, pid_t> threads;
         static long int gettid()
         {
-            std::lock_guard<std::mutex> l(m);
-            long int tid = syscall(SYS_gettid);
-            threads[std::this_thread::get_id()] = tid;
+            static thread_local long int tid = syscall(SYS_gettid);
             return tid;
         }
 #else
@@ -221,14 +225,7 @@ namespace PAL_NS_BEGIN {
             buffer[std::min<size_t>(len + 1, sizeof(buffer) - 1)] = '\0';
 #ifdef HAVE_MAT_WIN_LOG
             // Log to debug log file if enabled
-            debugLogMutex.lock();
-            if (debugLogStream->good())
-            {
-                (*debugLogStream) << buffer;
-                // flush is not very efficient, but needed to get realtime file updates
-                debugLogStream->flush();
-            }
-            debugLogMutex.unlock();
+            log_write(buffer, strlen(buffer));
 #else
             ::OutputDebugStringA(buffer);
 #endif //HAVE_MAT_WIN_LOG
@@ -266,14 +263,7 @@ namespace PAL_NS_BEGIN {
                 // Make sure all of our debug strings contain EOL
                 buffer[len] = '\n';
                 // Log to debug log file if enabled
-                debugLogMutex.lock();
-                if (debugLogStream->good())
-                {
-                    (*debugLogStream) << buffer;
-                    // flush is not very efficient, but needed to get realtime file updates
-                    debugLogStream->flush();
-                }
-                debugLogMutex.unlock();
+                log_write(buffer, static_cast<size_t>(len) + 1);
             }
             va_end(ap);
 #endif
@@ -562,11 +552,36 @@ namespace PAL_NS_BEGIN {
                 traceFolderPath = static_cast<std::string&>(configuration[CFG_STR_TRACE_FOLDER_PATH]);
             }
 
-            detail::isLoggingInited = detail::log_init(configuration[CFG_BOOL_ENABLE_TRACE], traceFolderPath);
+            uint32_t traceFileSizeLimit = configuration[CFG_INT_TRACE_FILE_SIZE];
+            detail::isLoggingInited = detail::log_init(configuration[CFG_BOOL_ENABLE_TRACE], traceFolderPath, traceFileSizeLimit);
             LOG_TRACE("Initializing...");
+#if defined(__linux__) && !defined(ANDROID)
+            // System information saved by an earlier start during this boot is not read again
+            std::string sysInfoPath;
+            if (configuration[CFG_BOOL_CACHE_SYSTEM_INFO] && configuration.HasConfig(CFG_STR_CACHE_FILE_PATH))
+            {
+                const char* cacheFilePath = configuration[CFG_STR_CACHE_FILE_PATH];
+                if ((cacheFilePath != nullptr) && (strcmp(cacheFilePath, ":memory:") != 0))
+                {
+                    sysInfoPath = std::string(cacheFilePath) + ".sys";
+                }
+            }
+            bool isSysInfoLoaded = !sysInfoPath.empty() && MAT::FileExists(sysInfoPath.c_str()) &&
+                sysinfo_sources_impl::GetSysInfo().load(MAT::FileGetContents(sysInfoPath.c_str()));
+#endif
             m_SystemInformation = SystemInformationImpl::Create(configuration);
             m_DeviceInformation = DeviceInformationImpl::Create(configuration);
             m_NetworkInformation = NetworkInformationImpl::Create(configuration);
+#if defined(__linux__) && !defined(ANDROID)
+            if (!sysInfoPath.empty() && !isSysInfoLoaded)
+            {
+                std::string contents = sysinfo_sources_impl::GetSysInfo().save();
+                if (!contents.empty() && !MAT::FileWrite(sysInfoPath.c_str(), contents.c_str()))
+                {
+                    LOG_WARN("Unable to save system information to %s", sysInfoPath.c_str());
+                }
+            }
+#endif
             LOG_INFO("Initialized");
         }
         else
@@ -0,0 +1,191 @@
+//
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// SPDX-License-Identifier: Apache-2.0
+//
+#include "PipelineTrace.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace PAL_NS_BEGIN
+{
+    constexpr size_t PipelineTrace::Capacity;
+    constexpr size_t PipelineTrace::MaxNameLength;
+
+    std::atomic<bool> PipelineTrace::s_enabled(false);
+
+    namespace
+    {
+        static_assert((PipelineTrace::Capacity & (PipelineTrace::Capacity - 1)) == 0, "Capacity must be a power of two");
+
+        struct Entry
+        {
+            const char* category;
+            int64_t startUs;
+            int64_t durationUs;
+            uint32_t threadId;
+            char name[PipelineTrace::MaxNameLength + 1];
+        };
+
+        // Seqlock: sequence is odd while the entry is written and 2 * (ticket + 1) once complete
+        struct Slot
+        {
+            std::atomic<uint64_t> sequence{0};
+            Entry entry;
+        };
+
+        std::mutex s_ringLock;
+        std::unique_ptr<Slot[]> s_ring;
+        std::atomic<Slot*> s_slots(nullptr);
+        std::atomic<uint64_t> s_next(0);
+        std::atomic<uint64_t> s_first(0);
+        std::atomic<uint32_t> s_nextThreadId(1);
+
+        uint32_t GetThreadId() noexcept
+        {
+            static thread_local uint32_t threadId = s_nextThreadId.fetch_add(1, std::memory_order_relaxed);
+            return threadId;
+        }
+
+        void AppendJsonString(std::string& json, const char* value)
+        {
+            json += '"';
+            for (const char* c = value; *c != '\0'; c++)
+            {
+                switch (*c)
+                {
+                case '"':
+                    json += "\\\"";
+                    break;
+                case '\\':
+                    json += "\\\\";
+                    break;
+                default:
+                    if (static_cast<unsigned char>(*c) < 0x20)
+                    {
+                        char escaped[8];
+                        snprintf(escaped, sizeof(escaped), "\\u%04x", static_cast<unsigned>(*c));
+                        json += escaped;
+                    }
+                    else
+                    {
+                        json += *c;
+                    }
+                    break;
+                }
+            }
+            json += '"';
+        }
+    }
+
+    void PipelineTrace::Enable(bool enabled)
+    {
+        if (enabled && s_slots.load(std::memory_order_acquire) == nullptr)
+        {
+            std::lock_guard<std::mutex> lock(s_ringLock);
+            if (!s_ring)
+            {
+                s_ring.reset(new Slot[Capacity]);
+                s_slots.store(s_ring.get(), std::memory_order_release);
+            }
+        }
+        s_enabled.store(enabled, std::memory_order_relaxed);
+    }
+
+    int64_t PipelineTrace::Now() noexcept
+    {
+        const auto now = std::chrono::steady_clock::now().time_since_epoch();
+        // 0 marks an inactive scope
+        return std::max<int64_t>(1, std::chrono::duration_cast<std::chrono::microseconds>(now).count());
+    }
+
+    void PipelineTrace::Record(const char* category, const char* name, int64_t startUs, int64_t endUs) noexcept
+    {
+        Slot* slots = s_slots.load(std::memory_order_acquire);
+        if (slots == nullptr)
+        {
+            return;
+        }
+
+        const uint64_t ticket = s_next.fetch_add(1, std::memory_order_relaxed);
+        Slot& slot = slots[ticket & (Capacity - 1)];
+        slot.sequence.store(2 * ticket + 1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+
+        Entry& entry = slot.entry;
+        entry.category = category;
+        entry.startUs = startUs;
+        entry.durationUs = endUs - startUs;
+        entry.threadId = GetThreadId();
+        size_t length = 0;
+        if (name != nullptr)
+        {
+            while (length < MaxNameLength && name[length] != '\0')
+            {
+                entry.name[length] = name[length];
+                length++;
+            }
+        }
+        entry.name[length] = '\0';
+
+        slot.sequence.store(2 * ticket + 2, std::memory_order_release);
+    }
+
+    std::string PipelineTrace::GetJson()
+    {
+        std::vector<Entry> entries;
+        Slot* slots = s_slots.load(std::memory_order_acquire);
+        if (slots != nullptr)
+        {
+            const uint64_t end = s_next.load(std::memory_order_acquire);
+            uint64_t begin = (end > Capacity) ? (end - Capacity) : 0;
+            begin = std::max(begin, s_first.load(std::memory_order_relaxed));
+            entries.reserve(static_cast<size_t>(end - begin));
+            for (uint64_t ticket = begin; ticket < end; ticket++)
+            {
+                Slot const& slot = slots[ticket & (Capacity - 1)];
+                const uint64_t sequence = slot.sequence.load(std::memory_order_acquire);
+                if (sequence != 2 * ticket + 2)
+                {
+                    // Still being written or already overwritten
+                    continue;
+                }
+                Entry entry;
+                memcpy(&entry, &slot.entry, sizeof(entry));
+                std::atomic_thread_fence(std::memory_order_acquire);
+                if (slot.sequence.load(std::memory_order_relaxed) == sequence)
+                {
+                    entries.push_back(entry);
+                }
+            }
+        }
+
+        std::string json("{\"traceEvents\":[");
+        char numbers[96];
+        bool first = true;
+        for (auto const& entry : entries)
+        {
+            json += first ? "{\"name\":" : ",{\"name\":";
+            first = false;
+            AppendJsonString(json, entry.name);
+            json += ",\"cat\":";
+            AppendJsonString(json, (entry.category != nullptr) ? entry.category : "");
+            snprintf(numbers, sizeof(numbers), ",\"ph\":\"X\",\"ts\":%lld,\"dur\":%lld,\"pid\":1,\"tid\":%u}",
+                static_cast<long long>(entry.startUs), static_cast<long long>(entry.durationUs), entry.threadId);
+            json += numbers;
+        }
+        json += "],\"displayTimeUnit\":\"ms\"}";
+        return json;
+    }
+
+    void PipelineTrace::Clear() noexcept
+    {
+        s_first.store(s_next.load(std::memory_order_acquire), std::memory_order_relaxed);
+    }
+
+} PAL_NS_END
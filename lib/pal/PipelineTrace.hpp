@@ -0,0 +1,123 @@
+//
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// SPDX-License-Identifier: Apache-2.0
+//
+#ifndef PIPELINETRACE_HPP
+#define PIPELINETRACE_HPP
+
+#include "mat/config.h"
+
+#include "ctmacros.hpp"
+#include "typename.hpp"
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+namespace PAL_NS_BEGIN
+{
+    /// <summary>
+    /// Process-wide timing of pipeline stages: route hops and worker thread tasks.
+    /// Each completed scope is written into a fixed-size lock-free ring (the oldest
+    /// entries are overwritten), which can be exported as Chrome trace_event JSON
+    /// and loaded in chrome://tracing or Perfetto.
+    /// Hooks are compiled in with HAVE_MAT_PIPELINE_TRACE; while tracing is disabled
+    /// at runtime each hook costs one relaxed atomic load.
+    /// </summary>
+    class PipelineTrace
+    {
+    public:
+        /// Number of entries kept, a power of two
+        static constexpr size_t Capacity = 16384;
+        /// Longer names are truncated
+        static constexpr size_t MaxNameLength = 95;
+
+        static bool IsEnabled() noexcept
+        {
+            return s_enabled.load(std::memory_order_relaxed);
+        }
+
+        /// <summary>
+        /// Starts or stops recording. The ring is allocated the first time tracing is enabled.
+        /// </summary>
+        static void Enable(bool enabled);
+
+        /// <summary>
+        /// Microseconds on the monotonic clock used for trace timestamps.
+        /// </summary>
+        static int64_t Now() noexcept;
+
+        /// <summary>
+        /// Records one completed scope. The name is copied.
+        /// </summary>
+        static void Record(const char* category, const char* name, int64_t startUs, int64_t endUs) noexcept;
+
+        /// <summary>
+        /// Recorded scopes in Chrome trace_event JSON format, oldest first.
+        /// </summary>
+        static std::string GetJson();
+
+        /// <summary>
+        /// Drops all recorded scopes.
+        /// </summary>
+        static void Clear() noexcept;
+
+        /// <summary>
+        /// Name of a type, computed once per type. Empty without RTTI.
+        /// </summary>
+        template<typename T>
+        static const char* TypeName()
+        {
+            static const std::string name(TYPENAME(T));
+            return name.c_str();
+        }
+
+    protected:
+        static std::atomic<bool> s_enabled;
+    };
+
+    /// <summary>
+    /// Times the enclosing scope when tracing is enabled at construction.
+    /// The name must stay valid until the scope ends.
+    /// </summary>
+    class PipelineTraceScope
+    {
+    public:
+        PipelineTraceScope(const char* category, const char* name = nullptr) noexcept :
+            m_category(category),
+            m_name(name),
+            m_startUs(PipelineTrace::IsEnabled() ? PipelineTrace::Now() : 0)
+        {
+        }
+
+        ~PipelineTraceScope() noexcept
+        {
+            if (m_startUs != 0)
+            {
+                PipelineTrace::Record(m_category, m_name, m_startUs, PipelineTrace::Now());
+            }
+        }
+
+        PipelineTraceScope(PipelineTraceScope const&) = delete;
+        PipelineTraceScope& operator=(PipelineTraceScope const&) = delete;
+
+        bool IsActive() const noexcept
+        {
+            return m_startUs != 0;
+        }
+
+        void SetName(const char* name) noexcept
+        {
+            m_name = name;
+        }
+
+    protected:
+        const char* m_category;
+        const char* m_name;
+        int64_t m_startUs;
+    };
+
+} PAL_NS_END
+
+#endif
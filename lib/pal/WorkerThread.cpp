@@ -5,6 +5,7 @@
 // clang-format off
 #include "pal/WorkerThread.hpp"
 #include "pal/PAL.hpp"
+#include "pal/PipelineTrace.hpp"
 
 #if defined(MATSDK_PAL_CPP11) || defined(MATSDK_PAL_WIN32)
 
@@ -238,7 +239,12 @@ namespace PAL_NS_BEGIN {
                     // Item wasn't cancelled before it could be executed
                     if (self->m_itemInProgress != nullptr) {
                         LOG_TRACE("%10llu Execute item=%p type=%s\n", wakeupCount, item.get(), item.get()->TypeName.c_str() );
-                        (*item)();
+                        {
+#ifdef HAVE_MAT_PIPELINE_TRACE
+                            PAL::PipelineTraceScope trace("task", item->TypeName.c_str());
+#endif
+                            (*item)();
+                        }
                         self->m_itemInProgress = nullptr;
                     }
 
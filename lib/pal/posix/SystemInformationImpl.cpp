@@ -13,7 +13,7 @@ namespace PAL_NS_BEGIN {
 
     SystemInformationImpl::SystemInformationImpl(IRuntimeConfig& configuration) : m_info_helper()
     {
-        auto sysInfo = sysinfo_sources_impl::GetSysInfo();
+        auto& sysInfo = sysinfo_sources_impl::GetSysInfo();
         m_user_timezone = sysInfo.get("tz");
         m_app_id = sysInfo.get("appId");
         m_os_name = sysInfo.get("osName");
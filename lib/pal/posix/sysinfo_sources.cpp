@@ -18,15 +18,11 @@
 #include <string.h>
 
 #include <sstream>
-#include <fstream>
-#include <streambuf>
 #include <list>
 
 #include <unistd.h>
 #include <sys/utsname.h>
 
-#include <regex>
-
 #include <iostream>
 #include <iomanip>
 
@@ -91,11 +87,22 @@ std::string get_app_name()
  * @param filename
  * @return
  */
-inline std::string ReadFile(const char *filename)
+static std::string ReadFile(const char *filename)
 {
-    std::ifstream t(filename);
-    std::string str((std::istreambuf_iterator<char>(t)), std::istreambuf_iterator<char>());
-    return str;
+    std::string result;
+    FILE* file = fopen(filename, "rb");
+    if (file == nullptr)
+    {
+        return result;
+    }
+    char buffer[1024];
+    size_t size;
+    while ((size = fread(buffer, 1, sizeof(buffer), file)) > 0)
+    {
+        result.append(buffer, size);
+    }
+    fclose(file);
+    return result;
 }
 
 /**
@@ -142,37 +149,153 @@ static std::string Exec(const char* cmd)
 #endif
 
 /**
- * Read node value, preprocess it using regexp and store result in cache
+ * Field of uname(2), used when the OS release files are missing
+ */
+enum class UnameField { SysName, Release, Version };
+
+static std::string Uname(UnameField field)
+{
+    struct utsname buf;
+    if (uname(&buf) != 0)
+    {
+        return std::string();
+    }
+    switch (field)
+    {
+    case UnameField::SysName:
+        return buf.sysname;
+    case UnameField::Release:
+        return buf.release;
+    default:
+        return buf.version;
+    }
+}
+
+/**
+ * Escape line breaks, so that every saved field takes one line
+ */
+static std::string Escape(const std::string& value)
+{
+    std::string result;
+    for (char c : value)
+    {
+        if (c == '\\')
+        {
+            result += "\\\\";
+        }
+        else if (c == '\n')
+        {
+            result += "\\n";
+        }
+        else
+        {
+            result += c;
+        }
+    }
+    return result;
+}
+
+static std::string Unescape(const std::string& value)
+{
+    std::string result;
+    for (size_t i = 0; i < value.size(); i++)
+    {
+        if (value[i] == '\\' && i + 1 < value.size())
+        {
+            i++;
+            result += (value[i] == 'n') ? '\n' : value[i];
+        }
+        else
+        {
+            result += value[i];
+        }
+    }
+    return result;
+}
+
+std::string sysinfo_sources::parse(const std::string& contents, sysinfo_format_t format, const char* selector)
+{
+    switch (format)
+    {
+    case SYSINFO_WHOLE_FILE:
+        return contents;
+
+    case SYSINFO_FIRST_LINE:
+        return contents.substr(0, contents.find('\n'));
+
+    case SYSINFO_FIRST_ARG:
+        return std::string(contents.c_str());
+
+    case SYSINFO_ENV_VALUE:
+    {
+        if (selector == nullptr)
+        {
+            return std::string();
+        }
+        const size_t length = strlen(selector);
+        size_t line = 0;
+        while (line < contents.size())
+        {
+            size_t end = contents.find('\n', line);
+            if (end == std::string::npos)
+            {
+                end = contents.size();
+            }
+            if ((end - line > length) && (contents.compare(line, length, selector) == 0) && (contents[line + length] == '='))
+            {
+                std::string value = contents.substr(line + length + 1, end - line - length - 1);
+                if (!value.empty() && value.back() == '\r')
+                {
+                    value.pop_back();
+                }
+                // Values may be quoted, on openSUSE for example
+                if ((value.size() >= 2) && (value.front() == '"' || value.front() == '\'') && (value.back() == value.front()))
+                {
+                    value = value.substr(1, value.size() - 2);
+                }
+                return value;
+            }
+            line = end + 1;
+        }
+        return std::string();
+    }
+
+    default:
+        return std::string();
+    }
+}
+
+/**
+ * Read node value, extract the field from it and store result in cache.
+ * Falls back to the resolvers of the field when no source has a value.
  *
  * @param key       Field name
  * @return          true if field value is found and saved in cache
  */
 bool sysinfo_sources::fetch(std::string key)
 {
-	for(auto &kv : (*this))
-	{
-		if(kv.first == key)
-		{
-			const std::string star("*");
-			const std::string empty("");
-
-			std::string contents = ReadFile(kv.second.path);
-			if((kv.second.selector == star) || (kv.second.selector == empty))
-			{
-				cache[key] = contents;
-				return true;
-			}
-			// Run regexp
-			std::regex selector_regex(kv.second.selector);
-			std::smatch match;
-			if(std::regex_search(contents, match, selector_regex))
-			{
-				cache[key] = match[1];
-				return true;
-			}
-		}
-	}
-	return false;
+    auto sources = equal_range(key);
+    for (auto it = sources.first; it != sources.second; ++it)
+    {
+        std::string value = parse(ReadFile(it->second.path), it->second.format, it->second.selector);
+        if (!value.empty())
+        {
+            cache[key] = value;
+            return true;
+        }
+    }
+
+    auto resolvers = fallbacks.equal_range(key);
+    for (auto it = resolvers.first; it != resolvers.second; ++it)
+    {
+        std::string value = it->second();
+        if (!value.empty())
+        {
+            cache[key] = value;
+            return true;
+        }
+    }
+    return false;
 }
 
 /**
@@ -186,6 +309,18 @@ void sysinfo_sources::add(const std::string& key, const sysinfo_source_t& val)
     (*this).insert(std::pair<std::string, sysinfo_source_t>(key, val));
 }
 
+/**
+ * Add a resolver used when neither the sources nor the resolvers added
+ * earlier have a value for the field.
+ *
+ * @param key
+ * @param resolver
+ */
+void sysinfo_sources::fallback(const std::string& key, std::function<std::string()> resolver)
+{
+    fallbacks.insert(std::make_pair(key, resolver));
+}
+
 /**
  * Static configuration provisioning for where to fetch the props from
  */
@@ -203,51 +338,107 @@ sysinfo_sources::sysinfo_sources() :
  */
 const std::string& sysinfo_sources::get(std::string key)
 {
+    std::lock_guard<std::mutex> guard(lock);
     if(cache.find(key) == cache.end())
         fetch(key);
     return cache[key];
 }
 
 /**
- * Obtain system hardware and application information
+ * Serialize the boot fields resolved so far: the boot ID on the first line,
+ * then one key=value line per field.
+ *
+ * @return          Empty string if the boot ID is not known
  */
-sysinfo_sources_impl::sysinfo_sources_impl() : sysinfo_sources()
+std::string sysinfo_sources::save()
 {
-    struct utsname buf;
-    uname(&buf);
-#if defined(__linux__)
-    // Obtain Linux system information from filesystem
-    add("devId", { "/etc/machine-id", "*"});
-    add("osName", {"/etc/os-release", ".*ID=(.*)[\n]+"});
-    add("osVer", {"/etc/os-release", ".*VERSION_ID=\"(.*)\".*"});
-    add("osRel", {"/etc/os-release", ".*VERSION=\"(.*)\".*"});
-    add("osBuild", {"/proc/version", "(.*)[\n]+"});
-    // add("proc_loadavg", {"/proc/loadavg", "(.*)[\n]*"});
-    // add("proc_uptime", {"/proc/uptime", "(.*)[\n]*"});
-
-    // osName may contain quotes on openSUSE
-    if (get("osName").find('"') == 0)
+    const std::string& bootId = get("bootId");
+    std::lock_guard<std::mutex> guard(lock);
+    if (bootId.empty())
     {
-        std::string contents = get("osName");
-        size_t pos_end_quote = contents.rfind('"');
-        if (pos_end_quote != std::string::npos && pos_end_quote > 0)
+        return std::string();
+    }
+    std::string result = bootId + "\n";
+    for (const auto& key : bootFields)
+    {
+        auto it = cache.find(key);
+        if (it != cache.end())
         {
-            cache["osName"] = contents.substr(1, pos_end_quote - 1);
+            result += key + "=" + Escape(it->second) + "\n";
         }
     }
+    return result;
+}
 
-    time_t t = time(NULL);
+/**
+ * Restore the boot fields written by save() during the same boot, unless
+ * they have been resolved already.
+ *
+ * @param contents
+ * @return          true if the contents were saved during this boot
+ */
+bool sysinfo_sources::load(const std::string& contents)
+{
+    const std::string& bootId = get("bootId");
+    size_t end = contents.find('\n');
+    if (bootId.empty() || end == std::string::npos || contents.compare(0, end, bootId) != 0)
+    {
+        return false;
+    }
+
+    std::lock_guard<std::mutex> guard(lock);
+    size_t line = end + 1;
+    while (line < contents.size())
+    {
+        end = contents.find('\n', line);
+        if (end == std::string::npos)
+        {
+            end = contents.size();
+        }
+        size_t separator = contents.find('=', line);
+        if (separator < end)
+        {
+            std::string key = contents.substr(line, separator - line);
+            if (bootFields.count(key) != 0 && cache.find(key) == cache.end())
+            {
+                cache[key] = Unescape(contents.substr(separator + 1, end - separator - 1));
+            }
+        }
+        line = end + 1;
+    }
+    return true;
+}
+
+/**
+ * Obtain system hardware and application information.
+ * Only registers where every field comes from: nothing is read until the field is used.
+ */
+sysinfo_sources_impl::sysinfo_sources_impl() : sysinfo_sources()
+{
+#if defined(__linux__)
+    // Obtain Linux system information from filesystem
+    add("devId", { "/etc/machine-id", SYSINFO_WHOLE_FILE, nullptr });
+    add("osName", { "/etc/os-release", SYSINFO_ENV_VALUE, "ID" });
+    add("osVer", { "/etc/os-release", SYSINFO_ENV_VALUE, "VERSION_ID" });
+    add("osRel", { "/etc/os-release", SYSINFO_ENV_VALUE, "VERSION" });
+    add("osBuild", { "/proc/version", SYSINFO_FIRST_LINE, nullptr });
+    add("bootId", { "/proc/sys/kernel/random/boot_id", SYSINFO_FIRST_LINE, nullptr });
+    bootFields = { "devId", "osName", "osVer", "osRel", "osBuild" };
+
+    fallback("tz", []()
+    {
+        time_t t = time(NULL);
 
 #if defined(__clang__)
 #pragma clang diagnostic push
-#pragma clang diagnostic ignored "-Wmissing-field-initializers"  // error: missing initializer for member �tm::tm_min� [-Werror=missing-field-initializers]
+#pragma clang diagnostic ignored "-Wmissing-field-initializers"  // error: missing initializer for member tm::tm_min [-Werror=missing-field-initializers]
 #elif defined(__GNUC__)
 #pragma GCC diagnostic push
-#pragma GCC diagnostic ignored "-Wmissing-field-initializers"  // error: missing initializer for member �tm::tm_min� [-Werror=missing-field-initializers]
+#pragma GCC diagnostic ignored "-Wmissing-field-initializers"  // error: missing initializer for member tm::tm_min [-Werror=missing-field-initializers]
 #endif
 
-    struct tm lt { 0 };
-    localtime_r(&t, &lt);
+        struct tm lt { 0 };
+        localtime_r(&t, &lt);
 
 #if defined(__clang__)
 #pragma clang diagnostic pop
@@ -255,98 +446,91 @@ sysinfo_sources_impl::sysinfo_sources_impl() : sysinfo_sources()
 #pragma GCC diagnostic pop
 #endif
 
-    int hh = lt.tm_gmtoff / 3600;
-    int mm = (lt.tm_gmtoff / 60) % 60;
-    std::ostringstream oss;
-    oss << ((hh<0)?"-":"+"); // +hh:mm or -hh:mm
-    oss << std::setw(2) << std::setfill('0') << std::abs(hh);
-    oss << std::setw(1) << ":";
-    oss << std::setw(2) << std::setfill('0') << std::abs(mm);
-    cache["tz"] = oss.str();
+        int hh = lt.tm_gmtoff / 3600;
+        int mm = (lt.tm_gmtoff / 60) % 60;
+        std::ostringstream oss;
+        oss << ((hh<0)?"-":"+"); // +hh:mm or -hh:mm
+        oss << std::setw(2) << std::setfill('0') << std::abs(hh);
+        oss << std::setw(1) << ":";
+        oss << std::setw(2) << std::setfill('0') << std::abs(mm);
+        return oss.str();
+    });
 #endif
 
 #if defined(__MINGW32__) || defined(__MSYS__)
     // Obtain MinGW Device ID from registry
-    add("devId",    { "/proc/registry/HKEY_LOCAL_MACHINE/SYSTEM/CurrentControlSet/Control/SystemInformation/ComputerHardwareId", "*"});
-    add("devMake",  { "/proc/registry/HKEY_LOCAL_MACHINE/SYSTEM/CurrentControlSet/Control/SystemInformation/SystemManufacturer", "*"});
-    add("devModel", { "/proc/registry/HKEY_LOCAL_MACHINE/SYSTEM/CurrentControlSet/Control/SystemInformation/SystemProductName",  "*"});
+    add("devId",    { "/proc/registry/HKEY_LOCAL_MACHINE/SYSTEM/CurrentControlSet/Control/SystemInformation/ComputerHardwareId", SYSINFO_WHOLE_FILE, nullptr });
+    add("devMake",  { "/proc/registry/HKEY_LOCAL_MACHINE/SYSTEM/CurrentControlSet/Control/SystemInformation/SystemManufacturer", SYSINFO_WHOLE_FILE, nullptr });
+    add("devModel", { "/proc/registry/HKEY_LOCAL_MACHINE/SYSTEM/CurrentControlSet/Control/SystemInformation/SystemProductName",  SYSINFO_WHOLE_FILE, nullptr });
 #endif
 
 #if defined(__APPLE__)
-    cache["devMake"] = "Apple";
-    cache["devModel"] = GetDeviceModel();
-    cache["osName"] = GetDeviceOsName();
-    cache["osVer"] = GetDeviceOsVersion();
-    cache["osRel"] = GetDeviceOsRelease();
-    cache["osBuild"] = GetDeviceOsBuild();
-    cache["devClass"] = GetDeviceClass();
+    fallback("devMake", []() { return std::string("Apple"); });
+    fallback("devModel", GetDeviceModel);
+    fallback("osName", GetDeviceOsName);
+    fallback("osVer", GetDeviceOsVersion);
+    fallback("osRel", GetDeviceOsRelease);
+    fallback("osBuild", GetDeviceOsBuild);
+    fallback("devClass", GetDeviceClass);
 
     // Populate user timezone as hh:mm offset from UTC timezone. Example for PST: "-08:00"
-    CFTimeZoneRef tz = CFTimeZoneCopySystem();
-    CFTimeInterval minsFromGMT = CFTimeZoneGetSecondsFromGMT(tz, CFAbsoluteTimeGetCurrent()) / 60.0;
-    CFRelease(tz);
-    std::ostringstream oss;
-    int hh = std::abs((int)minsFromGMT / 60);
-    int mm = std::abs((int)minsFromGMT % 60);
-    if (minsFromGMT<0)
+    fallback("tz", []()
     {
-        oss << "-";
-    }
-    oss << std::setw(2) << std::setfill('0') << hh;
-    oss << std::setw(1) << ":";
-    oss << std::setw(2) << std::setfill('0') << mm;
-    cache["tz"] = oss.str();
+        CFTimeZoneRef tz = CFTimeZoneCopySystem();
+        CFTimeInterval minsFromGMT = CFTimeZoneGetSecondsFromGMT(tz, CFAbsoluteTimeGetCurrent()) / 60.0;
+        CFRelease(tz);
+        std::ostringstream oss;
+        int hh = std::abs((int)minsFromGMT / 60);
+        int mm = std::abs((int)minsFromGMT % 60);
+        if (minsFromGMT<0)
+        {
+            oss << "-";
+        }
+        oss << std::setw(2) << std::setfill('0') << hh;
+        oss << std::setw(1) << ":";
+        oss << std::setw(2) << std::setfill('0') << mm;
+        return oss.str();
+    });
 #endif
 
     // Fallback to uname if above methods failed
-    if (!get("osVer").compare(""))
-    {
-        cache["osVer"]  = (const char *)(buf.version);
-    }
-
-    if (!get("osName").compare(""))
-    {
-        cache["osName"] = (const char *)(buf.sysname);
-    }
-
-    if (!get("osRel").compare(""))
-    {
-        cache["osRel"]  = (const char *)(buf.release);
-    }
+    fallback("osVer", []() { return Uname(UnameField::Version); });
+    fallback("osName", []() { return Uname(UnameField::SysName); });
+    fallback("osRel", []() { return Uname(UnameField::Release); });
 
 #ifndef __APPLE__
-    add("appId", {"/proc/self/cmdline", "(.*)[ ]*.*[\n]*"});
+    add("appId", { "/proc/self/cmdline", SYSINFO_FIRST_ARG, nullptr });
 #else
-    cache["appId"] = get_app_name();
+    fallback("appId", get_app_name);
 #endif
 
-    if (!get("devId").compare(""))
+    fallback("devId", []()
     {
 #ifdef __APPLE__
         std::string contents = GetDeviceId();
 #if TARGET_OS_IPHONE
-        cache["devId"] = "i:";
+        std::string devId = "i:";
 #else
-        cache["devId"] = "u:";
+        std::string devId = "u:";
 #endif // TARGET_OS_IPHONE
-        cache["devId"] += MAT::GUID_t(contents.c_str()).to_string();
+        devId += MAT::GUID_t(contents.c_str()).to_string();
+        return devId;
 #else
         // We were unable to obtain Device Id using standard means.
         // Try to use hash of blkid + hostname instead. Both blkid
         // and hostname would rarely change, as well as guarantee
         // at least some protection from cloned VM images.
         std::string contents = Exec("echo `blkid; hostname`");
-        if (!contents.empty())
+        if (contents.empty())
         {
-            uint8_t guid_bytes[16] = { 0 };
-            for(size_t i=0; i<contents.length(); i++)
-            {   // Simple XOR of contents to generate a UUID
-                guid_bytes[i % 16] ^= contents.at(i);
-            }
-            cache["devId"] = MAT::GUID_t(guid_bytes).to_string();
+            return std::string();
+        }
+        uint8_t guid_bytes[16] = { 0 };
+        for(size_t i=0; i<contents.length(); i++)
+        {   // Simple XOR of contents to generate a UUID
+            guid_bytes[i % 16] ^= contents.at(i);
         }
+        return MAT::GUID_t(guid_bytes).to_string();
 #endif
-    }
-
+    });
 }
-
@@ -5,14 +5,28 @@
 // SPDX-License-Identifier: Apache-2.0
 //
 
+#include <functional>
 #include <map>
+#include <mutex>
+#include <set>
 #include <string>
 
+/**
+ * How the field value is found in the contents of its source
+ */
+typedef enum {
+    SYSINFO_WHOLE_FILE,     // Entire contents
+    SYSINFO_FIRST_LINE,     // Contents up to the first line break
+    SYSINFO_FIRST_ARG,      // Contents up to the first NUL, as in /proc/self/cmdline
+    SYSINFO_ENV_VALUE       // Unquoted value of the KEY=value line named by the selector, as in os-release
+} sysinfo_format_t;
+
 /**
  * System information source path and selector
  */
 typedef struct {
     const char * path;
+    sysinfo_format_t format;
     const char * selector;
 } sysinfo_source_t;
 
@@ -20,16 +34,24 @@ typedef struct {
  * Helper class to retrieve various key-value pairs from system info sources.
  *
  * Everything is a file in POSIX / UNIX, so this file helps to retrieve and
- * cache info obtained from various files.
+ * cache info obtained from various files. Fields are resolved on first use.
  *
  */
 class sysinfo_sources : public std::multimap<std::string, sysinfo_source_t> {
 
 protected:
+    std::mutex lock;
     std::map<std::string, std::string> cache;
+    std::multimap<std::string, std::function<std::string()>> fallbacks;
+
+    /**
+     * Fields which only change with a reboot, see save() and load()
+     */
+    std::set<std::string> bootFields;
 
     /**
-     * Read node value, preprocess it using regexp and store result in cache
+     * Read node value, extract the field from it and store result in cache.
+     * Falls back to the resolvers of the field when no source has a value.
      *
      * @param key       Field name
      * @return          true if field value is found and saved in cache
@@ -46,6 +68,15 @@ public:
      */
     void add(const std::string& key, const sysinfo_source_t& val);
 
+    /**
+     * Add a resolver used when neither the sources nor the resolvers added
+     * earlier have a value for the field.
+     *
+     * @param key
+     * @param resolver
+     */
+    void fallback(const std::string& key, std::function<std::string()> resolver);
+
     sysinfo_sources();
 
     /**
@@ -57,7 +88,32 @@ public:
      */
     const std::string& get(std::string key);
 
+    /**
+     * Extract the field value from the contents of a source.
+     *
+     * @param contents
+     * @param format
+     * @param selector  Key name for SYSINFO_ENV_VALUE
+     * @return          Empty string if the field is not found
+     */
+    static std::string parse(const std::string& contents, sysinfo_format_t format, const char* selector);
+
+    /**
+     * Serialize the boot fields resolved so far, tagged with the "bootId" field.
+     *
+     * @return          Empty string if the boot ID is not known
+     */
+    std::string save();
+
+    /**
+     * Restore the boot fields written by save() during the same boot, unless
+     * they have been resolved already.
+     *
+     * @param contents
+     * @return          true if the contents were saved during this boot
+     */
+    bool load(const std::string& contents);
+
 };
 
 #endif /* LIB_PAL_POSIX_SYSINFO_SOURCES_HPP_ */
-
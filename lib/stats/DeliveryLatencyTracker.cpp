@@ -0,0 +1,148 @@
+//
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// SPDX-License-Identifier: Apache-2.0
+//
+#include "DeliveryLatencyTracker.hpp"
+
+#include "pal/PAL.hpp"
+
+#include <algorithm>
+
+namespace MAT_NS_BEGIN
+{
+    constexpr size_t DeliveryLatencyTracker::LatencySlots;
+    constexpr size_t DeliveryLatencyTracker::StageCount;
+
+    DeliveryLatencyTracker::TenantSeries::TenantSeries()
+    {
+        for (auto& stages : series)
+        {
+            for (auto& stage : stages)
+            {
+                stage.reset(new MetricSeries(MetricSeries::Kind::Distribution));
+            }
+        }
+    }
+
+    DeliveryLatencyTracker::DeliveryLatencyTracker(IRuntimeConfig& config) :
+        m_enabled(static_cast<bool>(config[CFG_MAP_METASTATS_CONFIG][CFG_BOOL_METASTATS_DELIVERY_LATENCY])),
+        m_tenants(std::make_shared<TenantMap>())
+    {
+    }
+
+    DeliveryLatencyTracker::TenantSeries& DeliveryLatencyTracker::getTenantSeries(std::string const& tenantToken)
+    {
+        {
+            auto tenants = std::atomic_load(&m_tenants);
+            auto it = tenants->find(tenantToken);
+            if (it != tenants->end())
+            {
+                return *(it->second);
+            }
+        }
+
+        LOCKGUARD(m_tenantsLock);
+        auto tenants = std::atomic_load(&m_tenants);
+        auto it = tenants->find(tenantToken);
+        if (it != tenants->end())
+        {
+            return *(it->second);
+        }
+        auto series = std::make_shared<TenantSeries>();
+        auto updated = std::make_shared<TenantMap>(*tenants);
+        (*updated)[tenantToken] = series;
+        std::atomic_store(&m_tenants, std::shared_ptr<const TenantMap>(std::move(updated)));
+        return *series;
+    }
+
+    void DeliveryLatencyTracker::Record(std::string const& tenantToken, EventLatency latency, DeliveryStage stage, int64_t durationMs)
+    {
+        if (!m_enabled || latency < 0 || static_cast<size_t>(latency) >= LatencySlots || static_cast<size_t>(stage) >= StageCount)
+        {
+            return;
+        }
+        getTenantSeries(tenantToken).series[latency][stage]->Record(static_cast<double>(std::max<int64_t>(0, durationMs)));
+    }
+
+    void DeliveryLatencyTracker::harvest()
+    {
+        // Tenants are never removed, so the current map holds every series
+        auto tenants = std::atomic_load(&m_tenants);
+        MetricSnapshot snapshot;
+        for (auto const& tenant : *tenants)
+        {
+            for (size_t latency = 0; latency < LatencySlots; latency++)
+            {
+                for (size_t stage = 0; stage < StageCount; stage++)
+                {
+                    if (tenant.second->series[latency][stage]->Harvest(snapshot))
+                    {
+                        m_totals[tenant.first][latency][stage].Merge(snapshot);
+                        m_interval[tenant.first][latency][stage].Merge(snapshot);
+                    }
+                }
+            }
+        }
+    }
+
+    std::vector<DeliveryLatencyStats> DeliveryLatencyTracker::GetStats()
+    {
+        std::vector<DeliveryLatencyStats> result;
+        if (!m_enabled)
+        {
+            return result;
+        }
+
+        LOCKGUARD(m_snapshotsLock);
+        harvest();
+        for (auto const& tenant : m_totals)
+        {
+            for (size_t latency = 0; latency < LatencySlots; latency++)
+            {
+                for (size_t stage = 0; stage < StageCount; stage++)
+                {
+                    MetricSnapshot const& snapshot = tenant.second[latency][stage];
+                    if (snapshot.count != 0)
+                    {
+                        result.push_back(Summarize(tenant.first, static_cast<EventLatency>(latency), static_cast<DeliveryStage>(stage), snapshot));
+                    }
+                }
+            }
+        }
+        return result;
+    }
+
+    void DeliveryLatencyTracker::TakeInterval(std::map<std::string, Snapshots>& snapshots)
+    {
+        snapshots.clear();
+        if (!m_enabled)
+        {
+            return;
+        }
+
+        LOCKGUARD(m_snapshotsLock);
+        harvest();
+        snapshots.swap(m_interval);
+    }
+
+    DeliveryLatencyStats DeliveryLatencyTracker::Summarize(std::string const& tenantToken, EventLatency latency, DeliveryStage stage, MetricSnapshot const& snapshot)
+    {
+        DeliveryLatencyStats stats;
+        stats.tenantToken = tenantToken;
+        stats.latency = latency;
+        stats.stage = stage;
+        stats.count = snapshot.count;
+        if (snapshot.count != 0)
+        {
+            stats.minMs = snapshot.min;
+            stats.maxMs = snapshot.max;
+            stats.meanMs = snapshot.sum / static_cast<double>(snapshot.count);
+            stats.p50Ms = snapshot.GetPercentile(50);
+            stats.p99Ms = snapshot.GetPercentile(99);
+            stats.p999Ms = snapshot.GetPercentile(99.9);
+        }
+        return stats;
+    }
+
+}
+MAT_NS_END
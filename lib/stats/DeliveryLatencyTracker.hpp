@@ -0,0 +1,92 @@
+//
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// SPDX-License-Identifier: Apache-2.0
+//
+#ifndef DELIVERYLATENCYTRACKER_HPP
+#define DELIVERYLATENCYTRACKER_HPP
+
+#include "api/IRuntimeConfig.hpp"
+#include "ILogManager.hpp"
+#include "MetricSeries.hpp"
+
+#include <array>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace MAT_NS_BEGIN
+{
+    /// <summary>
+    /// Delivery latency histograms per tenant, event latency and delivery stage, enabled
+    /// with CFG_BOOL_METASTATS_DELIVERY_LATENCY. Recording is lock-free once a tenant is
+    /// known; measurements are moved into cumulative totals, reported by GetStats(), and
+    /// into the current stats interval, taken by TakeInterval().
+    /// </summary>
+    class DeliveryLatencyTracker
+    {
+    public:
+        /// One slot per EventLatency value from EventLatency_Off to EventLatency_Max
+        static constexpr size_t LatencySlots = EventLatency_Max + 1;
+        static constexpr size_t StageCount = DeliveryStage_Total + 1;
+
+        using Snapshots = std::array<std::array<MetricSnapshot, StageCount>, LatencySlots>;
+
+        explicit DeliveryLatencyTracker(IRuntimeConfig& config);
+
+        bool IsEnabled() const noexcept
+        {
+            return m_enabled;
+        }
+
+        /// <summary>
+        /// Records the time one event spent in a delivery stage. Negative durations
+        /// (wall clock adjustments) are recorded as 0.
+        /// </summary>
+        void Record(std::string const& tenantToken, EventLatency latency, DeliveryStage stage, int64_t durationMs);
+
+        /// <summary>
+        /// Everything recorded since the tracker was created.
+        /// </summary>
+        std::vector<DeliveryLatencyStats> GetStats();
+
+        /// <summary>
+        /// Moves everything recorded since the previous call into per-tenant snapshots.
+        /// </summary>
+        void TakeInterval(std::map<std::string, Snapshots>& snapshots);
+
+        /// <summary>
+        /// Summary of one snapshot, as reported by GetStats().
+        /// </summary>
+        static DeliveryLatencyStats Summarize(std::string const& tenantToken, EventLatency latency, DeliveryStage stage, MetricSnapshot const& snapshot);
+
+    protected:
+        struct TenantSeries
+        {
+            TenantSeries();
+            std::unique_ptr<MetricSeries> series[LatencySlots][StageCount];
+        };
+
+        using TenantMap = std::unordered_map<std::string, std::shared_ptr<TenantSeries>>;
+
+        TenantSeries& getTenantSeries(std::string const& tenantToken);
+        void harvest();
+
+        const bool m_enabled;
+
+        // Copy-on-write: registering a tenant replaces the map under m_tenantsLock
+        std::mutex m_tenantsLock;
+        std::shared_ptr<const TenantMap> m_tenants;
+
+        // Guards harvesting and the snapshots below
+        std::mutex m_snapshotsLock;
+        std::map<std::string, Snapshots> m_totals;
+        std::map<std::string, Snapshots> m_interval;
+    };
+
+}
+MAT_NS_END
+
+#endif
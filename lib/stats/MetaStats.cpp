@@ -7,6 +7,8 @@
 
 #include <utils/StringUtils.hpp>
 
+#include <functional>
+
 namespace MAT_NS_BEGIN {
 
     /// <summary>
@@ -136,10 +138,116 @@ namespace MAT_NS_BEGIN {
         }
     }
 
+    static void atomicMin(std::atomic<unsigned>& target, unsigned value)
+    {
+        unsigned current = target.load(std::memory_order_relaxed);
+        while (value < current && !target.compare_exchange_weak(current, value, std::memory_order_relaxed))
+        {
+        }
+    }
+
+    static void atomicMax(std::atomic<unsigned>& target, unsigned value)
+    {
+        unsigned current = target.load(std::memory_order_relaxed);
+        while (value > current && !target.compare_exchange_weak(current, value, std::memory_order_relaxed))
+        {
+        }
+    }
+
+    static unsigned take(std::atomic<unsigned>& counter, unsigned resetValue = 0)
+    {
+        return counter.exchange(resetValue, std::memory_order_relaxed);
+    }
+
+    constexpr size_t HotStatsCounters::LatencySlots;
+    constexpr size_t HotStatsCounters::RetrySlots;
+
+    HotStatsCounters::HotStatsCounters() :
+        received(0),
+        receivedStats(0),
+        sent(0),
+        sampledOut(0),
+        totalRecordsSizeInBytes(0),
+        minOfRecordSizeInBytes(static_cast<unsigned>(~0)),
+        maxOfRecordSizeInBytes(0),
+        totalPkgsToBeAcked(0),
+        totalMetastatsOnlyPkgsToBeAcked(0),
+        totalPkgsAcked(0),
+        totalMetastatsOnlyPkgsAcked(0),
+        successPkgsAcked(0),
+        totalBandwidthConsumedInBytes(0),
+        minOfLatencyInMilliSecs(static_cast<unsigned>(~0)),
+        maxOfLatencyInMilliSecs(0)
+    {
+        for (size_t i = 0; i < LatencySlots; i++)
+        {
+            receivedPerLatency[i] = 0;
+            sentPerLatency[i] = 0;
+            bytesPerLatency[i] = 0;
+        }
+        for (auto& count : retriesCount)
+        {
+            count = 0;
+        }
+    }
+
+    void HotStatsCounters::harvest(TelemetryStats& snapshot)
+    {
+        RecordStats& recordStats = snapshot.recordStats;
+        recordStats.received += take(received);
+        recordStats.receivedStats += take(receivedStats);
+        recordStats.sent += take(sent);
+        recordStats.sampledOut += take(sampledOut);
+        recordStats.totalRecordsSizeInBytes += take(totalRecordsSizeInBytes);
+        recordStats.minOfRecordSizeInBytes = std::min(recordStats.minOfRecordSizeInBytes, take(minOfRecordSizeInBytes, static_cast<unsigned>(~0)));
+        recordStats.maxOfRecordSizeInBytes = std::max(recordStats.maxOfRecordSizeInBytes, take(maxOfRecordSizeInBytes));
+        for (size_t i = 0; i < LatencySlots; i++)
+        {
+            unsigned latencyReceived = take(receivedPerLatency[i]);
+            unsigned latencySent = take(sentPerLatency[i]);
+            unsigned latencyBytes = take(bytesPerLatency[i]);
+            if (latencyReceived != 0 || latencySent != 0 || latencyBytes != 0)
+            {
+                RecordStats& recordStatsPerPriority = snapshot.recordStatsPerLatency[static_cast<EventLatency>(i)];
+                recordStatsPerPriority.received += latencyReceived;
+                recordStatsPerPriority.sent += latencySent;
+                recordStatsPerPriority.totalRecordsSizeInBytes += latencyBytes;
+            }
+        }
+
+        PackageStats& packageStats = snapshot.packageStats;
+        packageStats.totalPkgsToBeAcked += take(totalPkgsToBeAcked);
+        packageStats.totalMetastatsOnlyPkgsToBeAcked += take(totalMetastatsOnlyPkgsToBeAcked);
+        packageStats.totalPkgsAcked += take(totalPkgsAcked);
+        packageStats.totalMetastatsOnlyPkgsAcked += take(totalMetastatsOnlyPkgsAcked);
+        packageStats.successPkgsAcked += take(successPkgsAcked);
+        packageStats.totalBandwidthConsumedInBytes += take(totalBandwidthConsumedInBytes);
+
+        LatencyStats& rttStats = snapshot.rttStats;
+        rttStats.minOfLatencyInMilliSecs = std::min(rttStats.minOfLatencyInMilliSecs, take(minOfLatencyInMilliSecs, static_cast<unsigned>(~0)));
+        rttStats.maxOfLatencyInMilliSecs = std::max(rttStats.maxOfLatencyInMilliSecs, take(maxOfLatencyInMilliSecs));
+
+        for (size_t i = 0; i < RetrySlots; i++)
+        {
+            unsigned count = take(retriesCount[i]);
+            if (count != 0)
+            {
+                snapshot.retriesCountDistribution[static_cast<unsigned>(i)] += count;
+            }
+        }
+    }
+
+    bool HotStatsCounters::hasData() const noexcept
+    {
+        return (received.load(std::memory_order_relaxed) > 0) || (sampledOut.load(std::memory_order_relaxed) > 0);
+    }
+
     MetaStats::MetaStats(IRuntimeConfig& config)
         :
         m_config(config),
-        m_enableTenantStats(false)
+        m_enableTenantStats(false),
+        m_tenantCounters(std::make_shared<TenantCountersMap>()),
+        m_deliveryLatency(config)
     {
         m_telemetryStats.statsStartTimestamp = PAL::getUtcSystemTimeMs();
         resetStats(true);
@@ -156,6 +264,37 @@ namespace MAT_NS_BEGIN {
     {
     }
 
+    std::shared_ptr<const MetaStats::TenantCountersMap> MetaStats::getTenantCountersMap() const
+    {
+        return std::atomic_load(&m_tenantCounters);
+    }
+
+    HotStatsCounters& MetaStats::getTenantCounters(std::string const& tenantToken)
+    {
+        {
+            auto tenantCounters = getTenantCountersMap();
+            auto it = tenantCounters->find(tenantToken);
+            if (it != tenantCounters->end())
+            {
+                return *(it->second);
+            }
+        }
+
+        // Copy-on-write: concurrent readers keep using the previous map until they reload it
+        LOCKGUARD(m_tenantCountersLock);
+        auto tenantCounters = getTenantCountersMap();
+        auto it = tenantCounters->find(tenantToken);
+        if (it != tenantCounters->end())
+        {
+            return *(it->second);
+        }
+        auto counters = std::make_shared<HotStatsCounters>();
+        auto updated = std::make_shared<TenantCountersMap>(*tenantCounters);
+        (*updated)[tenantToken] = counters;
+        std::atomic_store(&m_tenantCounters, std::shared_ptr<const TenantCountersMap>(std::move(updated)));
+        return *counters;
+    }
+
     /// <summary>
     /// Resets the stats.
     /// </summary>
@@ -254,6 +393,9 @@ namespace MAT_NS_BEGIN {
         insertNonZero(ext, "pkg_drp", packageStats.dropPkgsAcked);
         addCountsPerHttpReturnCodeToRecordFields(record, "pkg_drop_HTTP", packageStats.dropPkgsPerHttpReturnCode);
         addCountsPerHttpReturnCodeToRecordFields(record, "pkg_retr_HTTP", packageStats.retryPkgsPerHttpReturnCode);
+        addCountsPerHttpReturnCodeToRecordFields(record, "pkg_ep", packageStats.pkgsPerCollectorEndpoint);
+        insertNonZero(ext, "pkg_fovr", packageStats.failoverPkgs);
+        addCountsPerHttpReturnCodeToRecordFields(record, "ep_trip", packageStats.collectorEndpointTrips);
         insertNonZero(ext, "bytes", packageStats.totalBandwidthConsumedInBytes);
 
         // RTT stats
@@ -271,6 +413,7 @@ namespace MAT_NS_BEGIN {
         insertNonZero(ext, "evt_snt", recordStats.sent);
         insertNonZero(ext, "evt_rej", recordStats.rejected);
         insertNonZero(ext, "evt_drp", recordStats.dropped);
+        insertNonZero(ext, "evt_smp", recordStats.sampledOut);
 
         // Reject reason stats
         for (const auto &kv : m_reject_reasons)
@@ -305,6 +448,22 @@ namespace MAT_NS_BEGIN {
             insertNonZero(ext, pfx + "dsk", r_stats.overflown);
             insertNonZero(ext, pfx + "rej", r_stats.rejected);
             insertNonZero(ext, pfx + "bytes", r_stats.totalRecordsSizeInBytes);
+
+            // Delivery latency percentiles, rounded to milliseconds
+            for (const auto &stage : m_delivery_stage_pfx)
+            {
+                MetricSnapshot const& snapshot = telemetryStats.deliveryLatency[lat][stage.first];
+                if (snapshot.count == 0)
+                {
+                    continue;
+                }
+                const std::string name = pfx + stage.second;
+                insertNonZero(ext, name + "cnt", snapshot.count);
+                insertNonZero(ext, name + "p50", static_cast<uint64_t>(snapshot.GetPercentile(50) + 0.5));
+                insertNonZero(ext, name + "p99", static_cast<uint64_t>(snapshot.GetPercentile(99) + 0.5));
+                insertNonZero(ext, name + "p999", static_cast<uint64_t>(snapshot.GetPercentile(99.9) + 0.5));
+                insertNonZero(ext, name + "max", static_cast<uint64_t>(snapshot.max + 0.5));
+            }
         }
 
         records.push_back(record);
@@ -322,11 +481,45 @@ namespace MAT_NS_BEGIN {
         // Cumulative
         std::string statTenantToken = m_config.GetMetaStatsTenantToken();
         m_telemetryStats.tenantId = statTenantToken.substr(0, statTenantToken.find('-'));
+        m_counters.harvest(m_telemetryStats);
+
+        // Delivery latency: cumulative over all tenants, and per tenant
+        std::map<std::string, DeliveryLatencyTracker::Snapshots> deliveryLatency;
+        m_deliveryLatency.TakeInterval(deliveryLatency);
+        for (auto const& tenant : deliveryLatency)
+        {
+            for (size_t latency = 0; latency < DeliveryLatencyTracker::LatencySlots; latency++)
+            {
+                for (size_t stage = 0; stage < DeliveryLatencyTracker::StageCount; stage++)
+                {
+                    m_telemetryStats.deliveryLatency[latency][stage].Merge(tenant.second[latency][stage]);
+                }
+            }
+            if (m_enableTenantStats)
+            {
+                TelemetryStats& tenantStats = m_telemetryTenantStats[tenant.first];
+                if (tenantStats.tenantId.empty())
+                {
+                    tenantStats.tenantId = tenant.first.substr(0, tenant.first.find('-'));
+                }
+                tenantStats.deliveryLatency = tenant.second;
+            }
+        }
+
         snapStatsToRecord(records, rollupKind, m_telemetryStats);
 
         // Per-tenant
         if (m_enableTenantStats)
         {
+            for (auto const& tenantCounters : *getTenantCountersMap())
+            {
+                TelemetryStats& tenantStats = m_telemetryTenantStats[tenantCounters.first];
+                if (tenantStats.tenantId.empty())
+                {
+                    tenantStats.tenantId = tenantCounters.first.substr(0, tenantCounters.first.find('-'));
+                }
+                tenantCounters.second->harvest(tenantStats);
+            }
             for (auto &tenantStats : m_telemetryTenantStats)
             {
                 snapStatsToRecord(records, rollupKind, tenantStats.second);
@@ -376,7 +569,7 @@ namespace MAT_NS_BEGIN {
     /// </returns>
     bool MetaStats::hasStatsDataAvailable() const
     {
-        return (m_telemetryStats.recordStats.received > 0);
+        return m_counters.hasData() || (m_telemetryStats.recordStats.received > 0) || (m_telemetryStats.recordStats.sampledOut > 0);
     }
 
     /// <summary>
@@ -411,34 +604,29 @@ namespace MAT_NS_BEGIN {
     /// <param name="metastats">if set to <c>true</c> [metastats].</param>
     void MetaStats::updateOnEventIncoming(std::string const& tenanttoken, unsigned size, EventLatency latency, bool metastats)
     {
-        auto updateRecordStats = [&](RecordStats& recordStats)
+        auto updateRecordStats = [&](HotStatsCounters& counters)
         {
-            recordStats.received++;
+            counters.received.fetch_add(1, std::memory_order_relaxed);
             if (metastats)
             {
-                recordStats.receivedStats++;
+                counters.receivedStats.fetch_add(1, std::memory_order_relaxed);
             }
-            recordStats.maxOfRecordSizeInBytes = std::max<unsigned>(recordStats.maxOfRecordSizeInBytes, size);
-            recordStats.minOfRecordSizeInBytes = std::min<unsigned>(recordStats.minOfRecordSizeInBytes, size);
-            recordStats.totalRecordsSizeInBytes += size;
-            if (latency >= 0) {
-                RecordStats& recordStatsPerPriority = m_telemetryTenantStats[tenanttoken].recordStatsPerLatency[latency];
-                recordStatsPerPriority.received++;
-                recordStatsPerPriority.totalRecordsSizeInBytes += size;
+            atomicMax(counters.maxOfRecordSizeInBytes, size);
+            atomicMin(counters.minOfRecordSizeInBytes, size);
+            counters.totalRecordsSizeInBytes.fetch_add(size, std::memory_order_relaxed);
+            if (latency >= 0 && static_cast<size_t>(latency) < HotStatsCounters::LatencySlots) {
+                counters.receivedPerLatency[latency].fetch_add(1, std::memory_order_relaxed);
+                counters.bytesPerLatency[latency].fetch_add(size, std::memory_order_relaxed);
             }
         };
 
         // Cumulative
-        updateRecordStats(m_telemetryStats.recordStats);
+        updateRecordStats(m_counters);
 
         // Per-tenant
         if (m_enableTenantStats)
         {
-            if (m_telemetryTenantStats[tenanttoken].tenantId.empty())
-            {
-                m_telemetryTenantStats[tenanttoken].tenantId = tenanttoken.substr(0, tenanttoken.find('-'));
-            }
-            updateRecordStats(m_telemetryTenantStats[tenanttoken].recordStats);
+            updateRecordStats(getTenantCounters(tenanttoken));
         }
     }
 
@@ -450,10 +638,10 @@ namespace MAT_NS_BEGIN {
     void MetaStats::updateOnPostData(unsigned postDataLength, bool metastatsOnly)
     {
         // Cumulative only
-        m_telemetryStats.packageStats.totalBandwidthConsumedInBytes += postDataLength;
-        m_telemetryStats.packageStats.totalPkgsToBeAcked++;
+        m_counters.totalBandwidthConsumedInBytes.fetch_add(postDataLength, std::memory_order_relaxed);
+        m_counters.totalPkgsToBeAcked.fetch_add(1, std::memory_order_relaxed);
         if (metastatsOnly) {
-            m_telemetryStats.packageStats.totalMetastatsOnlyPkgsToBeAcked++;
+            m_counters.totalMetastatsOnlyPkgsToBeAcked.fetch_add(1, std::memory_order_relaxed);
         }
     }
 
@@ -469,43 +657,45 @@ namespace MAT_NS_BEGIN {
     void MetaStats::updateOnPackageSentSucceeded(std::map<std::string, std::string> const& recordIdsAndTenantids, EventLatency eventLatency, unsigned retryFailedTimes, unsigned durationMs, std::vector<unsigned> const& /*latencyToSendMs*/, bool metastatsOnly)
     {
         // Package summary stats
-        PackageStats& packageStats = m_telemetryStats.packageStats;
-        packageStats.totalPkgsAcked++;
-        packageStats.successPkgsAcked++;
+        m_counters.totalPkgsAcked.fetch_add(1, std::memory_order_relaxed);
+        m_counters.successPkgsAcked.fetch_add(1, std::memory_order_relaxed);
         if (metastatsOnly)
         {
-            packageStats.totalMetastatsOnlyPkgsAcked++;
+            m_counters.totalMetastatsOnlyPkgsAcked.fetch_add(1, std::memory_order_relaxed);
         }
-        m_telemetryStats.retriesCountDistribution[retryFailedTimes]++;
+        m_counters.retriesCount[std::min<size_t>(retryFailedTimes, HotStatsCounters::RetrySlots - 1)].fetch_add(1, std::memory_order_relaxed);
 
         // RTT stats: record min and max HTTP post latency
-        LatencyStats& rttStats = m_telemetryStats.rttStats;
-        rttStats.maxOfLatencyInMilliSecs = std::max<unsigned>(rttStats.maxOfLatencyInMilliSecs, durationMs);
-        rttStats.minOfLatencyInMilliSecs = std::min<unsigned>(rttStats.minOfLatencyInMilliSecs, durationMs);
+        atomicMax(m_counters.maxOfLatencyInMilliSecs, durationMs);
+        atomicMin(m_counters.minOfLatencyInMilliSecs, durationMs);
 
-        auto updatePackageSent = [&](TelemetryStats& stats)
+        const bool latencyInRange = (eventLatency >= 0 && static_cast<size_t>(eventLatency) < HotStatsCounters::LatencySlots);
+        auto updatePackageSent = [&](HotStatsCounters& counters, unsigned count)
         {
-            RecordStats& recordStats = stats.recordStats;
-            recordStats.sent++;
+            counters.sent.fetch_add(count, std::memory_order_relaxed);
             // Update per-priority record stats
-            if (eventLatency >= 0) {
-                RecordStats& recordStatsPerPriority = stats.recordStatsPerLatency[eventLatency];
-                recordStatsPerPriority.sent++;
+            if (latencyInRange) {
+                counters.sentPerLatency[eventLatency].fetch_add(count, std::memory_order_relaxed);
             }
         };
 
         // Cumulative
-        updatePackageSent(m_telemetryStats);
+        updatePackageSent(m_counters, 1);
 
-        // Per-tenant
+        // Per-tenant: records of a package mostly belong to few tenants, so count them per
+        // tenant first and look up the counters of each tenant once
         if (m_enableTenantStats)
         {
+            std::map<std::reference_wrapper<std::string const>, unsigned, std::less<std::string>> sentPerTenant;
             for (const auto& entry : recordIdsAndTenantids)
             {
-                updatePackageSent(m_telemetryTenantStats[entry.second]);
+                sentPerTenant[std::cref(entry.second)]++;
+            }
+            for (const auto& tenantSent : sentPerTenant)
+            {
+                updatePackageSent(getTenantCounters(tenantSent.first), tenantSent.second);
             }
         }
-
     }
 
     /// <summary>
@@ -536,6 +726,46 @@ namespace MAT_NS_BEGIN {
         m_telemetryStats.retriesCountDistribution[retryFailedTimes]++;
     }
 
+    /// <summary>
+    /// Update stats on the collector endpoint chosen for a package.
+    /// </summary>
+    /// <param name="endpoint">Index of the endpoint, 0 for the primary collector.</param>
+    /// <param name="failover">Whether the primary collector was unhealthy.</param>
+    void MetaStats::updateOnCollectorEndpointSelected(unsigned endpoint, bool failover)
+    {
+        PackageStats& packageStats = m_telemetryStats.packageStats;
+        packageStats.pkgsPerCollectorEndpoint[endpoint]++;
+        if (failover)
+        {
+            packageStats.failoverPkgs++;
+        }
+    }
+
+    /// <summary>
+    /// Update stats on a collector endpoint taken out of rotation.
+    /// </summary>
+    /// <param name="endpoint">Index of the endpoint, 0 for the primary collector.</param>
+    void MetaStats::updateOnCollectorEndpointTripped(unsigned endpoint)
+    {
+        m_telemetryStats.packageStats.collectorEndpointTrips[endpoint]++;
+    }
+
+    /// <summary>
+    /// Update stats on events dropped by client-side sampling.
+    /// </summary>
+    /// <param name="tenantToken">The tenant token.</param>
+    /// <param name="count">The number of events dropped.</param>
+    void MetaStats::updateOnEventSampledOut(std::string const& tenantToken, unsigned count)
+    {
+        // Per-tenant
+        if (m_enableTenantStats)
+        {
+            getTenantCounters(tenantToken).sampledOut.fetch_add(count, std::memory_order_relaxed);
+        }
+        // Cumulative
+        m_counters.sampledOut.fetch_add(count, std::memory_order_relaxed);
+    }
+
     /// <summary>
     /// Update stats on records dropped.
     /// </summary>
@@ -11,9 +11,13 @@
 
 #include "Enums.hpp"
 #include "CsProtocol_types.hpp"
+#include "DeliveryLatencyTracker.hpp"
 
 #include <memory>
 #include <algorithm>
+#include <atomic>
+#include <mutex>
+#include <unordered_map>
 
 namespace MAT_NS_BEGIN {
 
@@ -204,6 +208,9 @@ namespace MAT_NS_BEGIN {
         /// the number of overflown records
         unsigned int overflown;
 
+        /// the number of records dropped by client-side sampling
+        unsigned int sampledOut;
+
         /// distribution of records count by reason due to which record was dropped
         uint_uint_dict_t droppedByReason;
 
@@ -246,6 +253,7 @@ namespace MAT_NS_BEGIN {
             dropped = 0;
             rejected = 0;
             overflown = 0;
+            sampledOut = 0;
             sent = 0;
             inflight = 0;
 
@@ -309,6 +317,17 @@ namespace MAT_NS_BEGIN {
 
         uint_uint_dict_t retryPkgsPerHttpReturnCode;
 
+        /// key: collector endpoint index, 0 for the primary collector
+        /// value: number of packages sent to the endpoint, only counted when alternates are configured
+        uint_uint_dict_t pkgsPerCollectorEndpoint;
+
+        /// number of packages sent to an alternate collector because the primary one was unhealthy
+        unsigned int failoverPkgs;
+
+        /// key: collector endpoint index
+        /// value: number of times the endpoint was taken out of rotation after consecutive failures
+        uint_uint_dict_t collectorEndpointTrips;
+
         /// the total size of packages
         unsigned int totalBandwidthConsumedInBytes;
 
@@ -325,6 +344,9 @@ namespace MAT_NS_BEGIN {
             dropPkgsAcked = 0;
             dropPkgsPerHttpReturnCode.clear();
             retryPkgsPerHttpReturnCode.clear();
+            pkgsPerCollectorEndpoint.clear();
+            failoverPkgs = 0;
+            collectorEndpointTrips.clear();
             totalBandwidthConsumedInBytes = 0;
         }
 
@@ -487,7 +509,9 @@ namespace MAT_NS_BEGIN {
         /// Package statistics
         PackageStats packageStats;
 
-        /// Retry count by code distribution
+        /// Number of packages acked by the number of retries they took. Successful
+        /// packages retried HotStatsCounters::RetrySlots - 1 times or more are all
+        /// counted under that last key.
         uint_uint_dict_t retriesCountDistribution;
 
         /// RTT stats
@@ -499,6 +523,9 @@ namespace MAT_NS_BEGIN {
         
         OfflineStorageStats offlineStorageStats;
 
+        /// Delivery latency per event latency and delivery stage
+        DeliveryLatencyTracker::Snapshots deliveryLatency;
+
         void Reset()
         {
             packageStats.Reset();
@@ -507,14 +534,69 @@ namespace MAT_NS_BEGIN {
             recordStats.Reset();
             recordStatsPerLatency.clear();
             offlineStorageStats.Reset();
+            deliveryLatency = DeliveryLatencyTracker::Snapshots();
         }
     };
 
-    
+    /// <summary>
+    /// Counters updated on the event and upload paths, kept apart from TelemetryStats so
+    /// that counting an event takes a few relaxed atomic operations instead of a lock.
+    /// Each counter is moved into the TelemetryStats snapshot and reset in one exchange
+    /// on rollup, so updates racing with a rollup land in either this interval or the next.
+    /// </summary>
+    class HotStatsCounters
+    {
+    public:
+        /// One slot per EventLatency value from EventLatency_Off to EventLatency_Max
+        static constexpr size_t LatencySlots = EventLatency_Max + 1;
+
+        /// Slots 0..14 count packages sent after exactly that many retries. Slot 15 is
+        /// the overflow bucket: it counts every package retried 15 times or more. The
+        /// default CFG_INT_TPM_MAX_RETRY of 5 never reaches it; a larger configured
+        /// maximum only loses the exact count of the longest retry runs.
+        static constexpr size_t RetrySlots = 16;
+
+        HotStatsCounters();
+
+        /// <summary>
+        /// Adds the counters to the snapshot and resets them.
+        /// </summary>
+        void harvest(TelemetryStats& snapshot);
+
+        bool hasData() const noexcept;
+
+        // Record stats
+        std::atomic<unsigned> received;
+        std::atomic<unsigned> receivedStats;
+        std::atomic<unsigned> sent;
+        std::atomic<unsigned> sampledOut;
+        std::atomic<unsigned> totalRecordsSizeInBytes;
+        std::atomic<unsigned> minOfRecordSizeInBytes;
+        std::atomic<unsigned> maxOfRecordSizeInBytes;
+        std::atomic<unsigned> receivedPerLatency[LatencySlots];
+        std::atomic<unsigned> sentPerLatency[LatencySlots];
+        std::atomic<unsigned> bytesPerLatency[LatencySlots];
+
+        // Package stats, cumulative only
+        std::atomic<unsigned> totalPkgsToBeAcked;
+        std::atomic<unsigned> totalMetastatsOnlyPkgsToBeAcked;
+        std::atomic<unsigned> totalPkgsAcked;
+        std::atomic<unsigned> totalMetastatsOnlyPkgsAcked;
+        std::atomic<unsigned> successPkgsAcked;
+        std::atomic<unsigned> totalBandwidthConsumedInBytes;
+        std::atomic<unsigned> minOfLatencyInMilliSecs;
+        std::atomic<unsigned> maxOfLatencyInMilliSecs;
+        std::atomic<unsigned> retriesCount[RetrySlots];
+    };
+
+
     /// <summary>
     /// MetaStats class:
     /// * aggregats all per-tenant and overall stats.
     /// * handles various internal SDK callbacks.
+    /// updateOnEventIncoming, updateOnEventSampledOut, updateOnPostData and
+    /// updateOnPackageSentSucceeded only touch HotStatsCounters and may be called
+    /// concurrently without a lock. All other methods must be serialized by the caller.
     /// </summary>
     class MetaStats
     {
@@ -525,16 +607,27 @@ namespace MAT_NS_BEGIN {
         std::vector< ::CsProtocol::Record> generateStatsEvent(RollUpKind rollupKind);
 
         void updateOnEventIncoming(std::string const& tenanttoken, unsigned size, EventLatency latency, bool metastats);
+        void updateOnEventSampledOut(std::string const& tenantToken, unsigned count);
         void updateOnPostData(unsigned postDataLength, bool metastatsOnly);
         void updateOnPackageSentSucceeded(std::map<std::string, std::string> const& recordIdsAndTenantids, EventLatency eventLatency, unsigned retryFailedTimes, unsigned durationMs, std::vector<unsigned> const& latencyToSendMs, bool metastatsOnly);
         void updateOnPackageFailed(int statusCode);
         void updateOnPackageRetry(int statusCode, unsigned retryFailedTimes);
+        void updateOnCollectorEndpointSelected(unsigned endpoint, bool failover);
+        void updateOnCollectorEndpointTripped(unsigned endpoint);
         void updateOnRecordsDropped(EventDroppedReason reason, std::map<std::string, size_t> const& droppedCount);
         void updateOnRecordsOverFlown(std::map<std::string, size_t> const& overflownCount);
         void updateOnRecordsRejected(EventRejectedReason reason, std::map<std::string, size_t> const& rejectedCount);
         void updateOnStorageOpened(std::string const& type);
         void updateOnStorageFailed(std::string const& reason);
 
+        /// <summary>
+        /// Delivery latency histograms, reported in every stats event. Thread-safe.
+        /// </summary>
+        DeliveryLatencyTracker& getDeliveryLatencyTracker()
+        {
+            return m_deliveryLatency;
+        }
+
     protected:
         /// <summary>
         /// Clear all frequency distributions. Copied as is from old SCT, not sure it's needed.
@@ -559,6 +652,14 @@ namespace MAT_NS_BEGIN {
         /// </summary>
         void rollup(std::vector< ::CsProtocol::Record>& records, RollUpKind rollupKind);
 
+        /// <summary>
+        /// Hot counters of a tenant, registered on first use.
+        /// </summary>
+        HotStatsCounters& getTenantCounters(std::string const& tenantToken);
+
+        using TenantCountersMap = std::unordered_map<std::string, std::shared_ptr<HotStatsCounters>>;
+        std::shared_ptr<const TenantCountersMap> getTenantCountersMap() const;
+
     protected:
 
         IRuntimeConfig&                 m_config;
@@ -585,6 +686,20 @@ namespace MAT_NS_BEGIN {
         /// </summary>
         std::map<std::string, TelemetryStats>  m_telemetryTenantStats;
 
+        /// <summary>
+        /// Overall hot counters
+        /// </summary>
+        HotStatsCounters                m_counters;
+
+        /// <summary>
+        /// Per-tenant hot counters. Lookups are lock-free; registering a tenant
+        /// copies the map under m_tenantCountersLock. Slots are never removed.
+        /// </summary>
+        std::mutex                      m_tenantCountersLock;
+        std::shared_ptr<const TenantCountersMap> m_tenantCounters;
+
+        DeliveryLatencyTracker          m_deliveryLatency;
+
         const std::map<EventLatency, std::string> m_latency_pfx =
         {
             { EventLatency_Normal,       "ln_" },
@@ -593,6 +708,16 @@ namespace MAT_NS_BEGIN {
             { EventLatency_Max,          "lm_" }
         };
 
+        const std::map<DeliveryStage, std::string> m_delivery_stage_pfx =
+        {
+            { DeliveryStage_Queue,       "dl_que_" },
+            { DeliveryStage_Storage,     "dl_sto_" },
+            { DeliveryStage_Packaging,   "dl_pkg_" },
+            { DeliveryStage_Compression, "dl_cmp_" },
+            { DeliveryStage_Network,     "dl_net_" },
+            { DeliveryStage_Total,       "dl_tot_" }
+        };
+
         const std::map<EventRejectedReason, std::string>   m_reject_reasons =
         {
             { REJECTED_REASON_VALIDATION_FAILED,            "rej_inv" },
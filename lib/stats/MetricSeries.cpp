@@ -0,0 +1,333 @@
+//
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// SPDX-License-Identifier: Apache-2.0
+//
+#include "MetricSeries.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <limits>
+#include <thread>
+
+namespace MAT_NS_BEGIN
+{
+    namespace
+    {
+        constexpr double PositiveInfinity = std::numeric_limits<double>::infinity();
+        constexpr double NegativeInfinity = -std::numeric_limits<double>::infinity();
+
+        void AtomicAdd(std::atomic<double>& target, double value) noexcept
+        {
+            double current = target.load(std::memory_order_relaxed);
+            while (!target.compare_exchange_weak(current, current + value, std::memory_order_relaxed))
+            {
+            }
+        }
+
+        void AtomicMin(std::atomic<double>& target, double value) noexcept
+        {
+            double current = target.load(std::memory_order_relaxed);
+            while (value < current && !target.compare_exchange_weak(current, value, std::memory_order_relaxed))
+            {
+            }
+        }
+
+        void AtomicMax(std::atomic<double>& target, double value) noexcept
+        {
+            double current = target.load(std::memory_order_relaxed);
+            while (value > current && !target.compare_exchange_weak(current, value, std::memory_order_relaxed))
+            {
+            }
+        }
+
+        long ToBucketKey(double lowerBound) noexcept
+        {
+            const double maxKey = static_cast<double>(std::numeric_limits<long>::max());
+            return (lowerBound >= maxKey) ? std::numeric_limits<long>::max() : static_cast<long>(lowerBound);
+        }
+
+        // Bit test rather than std::isfinite(), which -ffast-math release builds fold to true
+        bool IsFinite(double value) noexcept
+        {
+            uint64_t bits;
+            std::memcpy(&bits, &value, sizeof(bits));
+            return (bits & 0x7FF0000000000000ULL) != 0x7FF0000000000000ULL;
+        }
+
+        std::atomic<size_t> s_nextThreadIndex{0};
+    }
+
+    // Shards are allocated separately; the trailing padding keeps two shards off one cache line
+    struct MetricSeries::Shard
+    {
+        std::atomic<uint64_t> count{0};
+        std::atomic<double> sum{0};
+        std::atomic<double> sumOfSquares{0};
+        std::atomic<double> min{PositiveInfinity};
+        std::atomic<double> max{NegativeInfinity};
+        std::unique_ptr<std::atomic<uint64_t>[]> buckets;
+        char padding[64];
+    };
+
+    constexpr size_t MetricSeries::MaxShards;
+    constexpr int MetricSeries::SubBuckets;
+    constexpr int MetricSeries::MinExponent;
+    constexpr int MetricSeries::MaxExponent;
+    constexpr size_t MetricSeries::BucketCount;
+
+    void MetricSnapshot::CopyTo(AggregatedMetricData& data) const
+    {
+        data.count = static_cast<long>(count);
+        data.aggregates[AggregateType_Sum] = sum;
+        data.aggregates[AggregateType_Minimum] = min;
+        data.aggregates[AggregateType_Maximum] = max;
+        if (!buckets.empty())
+        {
+            data.aggregates[AggregateType_SumOfSquares] = sumOfSquares;
+            for (auto const& bucket : buckets)
+            {
+                data.buckets[ToBucketKey(MetricSeries::GetBucketLowerBound(bucket.first))] += bucket.second;
+            }
+        }
+    }
+
+    void MetricSnapshot::Merge(MetricSnapshot const& other)
+    {
+        if (other.count == 0)
+        {
+            return;
+        }
+        if (count == 0)
+        {
+            *this = other;
+            return;
+        }
+        count += other.count;
+        sum += other.sum;
+        sumOfSquares += other.sumOfSquares;
+        min = std::min(min, other.min);
+        max = std::max(max, other.max);
+        last = other.last;
+        for (auto const& bucket : other.buckets)
+        {
+            buckets[bucket.first] += bucket.second;
+        }
+    }
+
+    double MetricSnapshot::GetPercentile(double percentile) const
+    {
+        long total = 0;
+        for (auto const& bucket : buckets)
+        {
+            total += bucket.second;
+        }
+        if (total == 0)
+        {
+            return 0;
+        }
+        const double clamped = std::min(100.0, std::max(0.0, percentile));
+        const long rank = std::max(1L, static_cast<long>(std::ceil(clamped / 100.0 * static_cast<double>(total))));
+        long seen = 0;
+        for (auto const& bucket : buckets)
+        {
+            seen += bucket.second;
+            if (seen >= rank)
+            {
+                const double lowerBound = MetricSeries::GetBucketLowerBound(bucket.first);
+                const double upperBound = MetricSeries::GetBucketLowerBound(bucket.first + 1);
+                return std::min(max, std::max(min, (lowerBound + upperBound) / 2));
+            }
+        }
+        return max;
+    }
+
+    MetricSeries::MetricSeries(Kind kind, uint64_t intervalMs) :
+        m_kind(kind),
+        m_intervalMs(intervalMs),
+        m_nextHarvestMs(0),
+        m_last(0)
+    {
+    }
+
+    MetricSeries::~MetricSeries()
+    {
+        for (auto& slot : m_slots)
+        {
+            delete slot.shard.load(std::memory_order_relaxed);
+        }
+    }
+
+    MetricSeries::Slot& MetricSeries::GetSlot()
+    {
+        static thread_local size_t threadIndex = s_nextThreadIndex.fetch_add(1, std::memory_order_relaxed);
+        return m_slots[threadIndex % MaxShards];
+    }
+
+    MetricSeries::Shard& MetricSeries::GetShard(Slot& slot)
+    {
+        // Sequentially consistent with the writers count, see Harvest()
+        Shard* shard = slot.shard.load(std::memory_order_seq_cst);
+        if (shard == nullptr)
+        {
+            std::unique_ptr<Shard> created(new Shard());
+            if (m_kind == Kind::Distribution)
+            {
+                created->buckets.reset(new std::atomic<uint64_t>[BucketCount]);
+                for (size_t i = 0; i < BucketCount; i++)
+                {
+                    created->buckets[i].store(0, std::memory_order_relaxed);
+                }
+            }
+            if (slot.shard.compare_exchange_strong(shard, created.get(), std::memory_order_seq_cst))
+            {
+                shard = created.release();
+            }
+        }
+        return *shard;
+    }
+
+    void MetricSeries::Record(double value)
+    {
+        if (!IsFinite(value))
+        {
+            return;
+        }
+
+        Slot& slot = GetSlot();
+        slot.writers.fetch_add(1, std::memory_order_seq_cst);
+        Shard& shard = GetShard(slot);
+        shard.count.fetch_add(1, std::memory_order_relaxed);
+        switch (m_kind)
+        {
+        case Kind::Counter:
+            AtomicAdd(shard.sum, value);
+            break;
+
+        case Kind::Gauge:
+            m_last.store(value, std::memory_order_relaxed);
+            AtomicMin(shard.min, value);
+            AtomicMax(shard.max, value);
+            break;
+
+        case Kind::Distribution:
+            AtomicAdd(shard.sum, value);
+            AtomicAdd(shard.sumOfSquares, value * value);
+            AtomicMin(shard.min, value);
+            AtomicMax(shard.max, value);
+            shard.buckets[GetBucketIndex(value)].fetch_add(1, std::memory_order_relaxed);
+            break;
+        }
+        slot.writers.fetch_sub(1, std::memory_order_release);
+    }
+
+    bool MetricSeries::Harvest(MetricSnapshot& snapshot)
+    {
+        snapshot = MetricSnapshot();
+        double min = PositiveInfinity;
+        double max = NegativeInfinity;
+        for (auto& slot : m_slots)
+        {
+            Shard* shard = slot.shard.load(std::memory_order_acquire);
+            if (shard == nullptr || shard->count.load(std::memory_order_relaxed) == 0)
+            {
+                continue;
+            }
+            // Swap the whole shard out: the next observation of the slot allocates a new one.
+            // A writer either counted itself before the exchange, and is waited for, or
+            // loads the slot after it, and never sees this shard.
+            shard = slot.shard.exchange(nullptr, std::memory_order_seq_cst);
+            while (slot.writers.load(std::memory_order_seq_cst) != 0)
+            {
+                std::this_thread::yield();
+            }
+            if (shard == nullptr)
+            {
+                continue;
+            }
+            std::unique_ptr<Shard> harvested(shard);
+            snapshot.count += harvested->count.load(std::memory_order_relaxed);
+            snapshot.sum += harvested->sum.load(std::memory_order_relaxed);
+            snapshot.sumOfSquares += harvested->sumOfSquares.load(std::memory_order_relaxed);
+            min = std::min(min, harvested->min.load(std::memory_order_relaxed));
+            max = std::max(max, harvested->max.load(std::memory_order_relaxed));
+            if (harvested->buckets)
+            {
+                for (size_t i = 0; i < BucketCount; i++)
+                {
+                    uint64_t bucketCount = harvested->buckets[i].load(std::memory_order_relaxed);
+                    if (bucketCount != 0)
+                    {
+                        snapshot.buckets[i] += static_cast<long>(bucketCount);
+                    }
+                }
+            }
+        }
+        if (snapshot.count == 0)
+        {
+            return false;
+        }
+        if (m_kind != Kind::Counter)
+        {
+            snapshot.min = min;
+            snapshot.max = max;
+        }
+        snapshot.last = m_last.load(std::memory_order_relaxed);
+        return true;
+    }
+
+    bool MetricSeries::IsHarvestDue(int64_t nowMs) noexcept
+    {
+        if (m_intervalMs == 0)
+        {
+            return false;
+        }
+        int64_t due = m_nextHarvestMs.load(std::memory_order_relaxed);
+        if (due == 0)
+        {
+            // First observation starts the first interval
+            m_nextHarvestMs.compare_exchange_strong(due, nowMs + static_cast<int64_t>(m_intervalMs), std::memory_order_relaxed);
+            return false;
+        }
+        return (nowMs >= due) &&
+            m_nextHarvestMs.compare_exchange_strong(due, nowMs + static_cast<int64_t>(m_intervalMs), std::memory_order_relaxed);
+    }
+
+    size_t MetricSeries::GetBucketIndex(double value) noexcept
+    {
+        if (!(value > 0))
+        {
+            return 0;
+        }
+        int exponent = 0;
+        const double mantissa = std::frexp(value, &exponent);
+        if (exponent < MinExponent)
+        {
+            return 0;
+        }
+        if (exponent > MaxExponent)
+        {
+            return BucketCount - 1;
+        }
+        // mantissa is in [0.5, 1): split it into SubBuckets linear steps
+        const int subBucket = std::min(SubBuckets - 1, static_cast<int>((mantissa - 0.5) * 2 * SubBuckets));
+        return 1 + static_cast<size_t>(exponent - MinExponent) * SubBuckets + static_cast<size_t>(subBucket);
+    }
+
+    double MetricSeries::GetBucketLowerBound(size_t index) noexcept
+    {
+        if (index == 0)
+        {
+            return 0;
+        }
+        if (index >= BucketCount - 1)
+        {
+            return std::ldexp(1.0, MaxExponent);
+        }
+        const int exponent = MinExponent + static_cast<int>((index - 1) / SubBuckets);
+        const int subBucket = static_cast<int>((index - 1) % SubBuckets);
+        return std::ldexp(0.5 + subBucket * (0.5 / SubBuckets), exponent);
+    }
+
+}
+MAT_NS_END
@@ -0,0 +1,154 @@
+//
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// SPDX-License-Identifier: Apache-2.0
+//
+#ifndef METRICSERIES_HPP
+#define METRICSERIES_HPP
+
+#include "ctmacros.hpp"
+#include "ILogger.hpp"
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <map>
+#include <memory>
+
+namespace MAT_NS_BEGIN
+{
+    /// <summary>
+    /// Aggregated values of a metric series over one interval.
+    /// </summary>
+    struct MetricSnapshot
+    {
+        uint64_t count = 0;
+        double sum = 0;
+        double sumOfSquares = 0;
+        double min = 0;
+        double max = 0;
+        double last = 0;
+        /// Histogram: index of each non-empty bucket (see MetricSeries::GetBucketIndex) to its count
+        std::map<size_t, long> buckets;
+
+        /// <summary>
+        /// Copies the aggregates and histogram into the aggregated metric event payload.
+        /// The payload keys each bucket by its lower bound, truncated to an integer.
+        /// </summary>
+        void CopyTo(AggregatedMetricData& data) const;
+
+        /// <summary>
+        /// Adds the aggregates and histogram of a later snapshot of the same series.
+        /// </summary>
+        void Merge(MetricSnapshot const& other);
+
+        /// <summary>
+        /// Estimates a percentile (0 to 100) from the histogram: the middle of the bucket
+        /// holding that rank, clamped to the minimum and maximum. 0 without a histogram.
+        /// </summary>
+        double GetPercentile(double percentile) const;
+    };
+
+    /// <summary>
+    /// Lock-free pre-aggregation of one metric series. Recording threads are spread
+    /// over lazily allocated, cache-line padded shards, so concurrent observations
+    /// touch different cache lines and never take a lock. Harvest() swaps every used
+    /// shard out whole, waits for the observations still being written to it, and merges
+    /// its values into a snapshot: each observation lands in one interval entirely.
+    /// Distributions keep a log-linear histogram: each power of two is split into
+    /// SubBuckets linear buckets, each at most 1/SubBuckets wide relative to its lower bound.
+    /// </summary>
+    class MetricSeries
+    {
+    public:
+        enum class Kind
+        {
+            /// Count and sum of the recorded values
+            Counter,
+            /// Last, minimum and maximum recorded value
+            Gauge,
+            /// Count, sum, sum of squares, extremes and histogram of the recorded values
+            Distribution
+        };
+
+        static constexpr size_t MaxShards = 16;
+        static constexpr int SubBuckets = 4;
+        static constexpr int MinExponent = -7;
+        static constexpr int MaxExponent = 48;
+        /// Bucket 0 holds values below 2^(MinExponent-1) (including zero and negative
+        /// values), the last bucket values of 2^MaxExponent and above.
+        static constexpr size_t BucketCount = 2 + (MaxExponent - MinExponent + 1) * SubBuckets;
+
+        /// <summary>
+        /// Creates a series. An intervalMs of 0 leaves harvesting entirely to the caller.
+        /// </summary>
+        MetricSeries(Kind kind, uint64_t intervalMs = 0);
+        ~MetricSeries();
+
+        MetricSeries(MetricSeries const&) = delete;
+        MetricSeries& operator=(MetricSeries const&) = delete;
+
+        Kind GetKind() const noexcept
+        {
+            return m_kind;
+        }
+
+        uint64_t GetIntervalMs() const noexcept
+        {
+            return m_intervalMs;
+        }
+
+        /// <summary>
+        /// Records one observation. Lock-free and safe to call from any thread.
+        /// NaN and infinite values are ignored.
+        /// </summary>
+        void Record(double value);
+
+        /// <summary>
+        /// Moves everything recorded since the last harvest into the snapshot.
+        /// Observations recorded concurrently may land in the next interval.
+        /// </summary>
+        /// <returns>false if nothing has been recorded since the last harvest.</returns>
+        bool Harvest(MetricSnapshot& snapshot);
+
+        /// <summary>
+        /// Returns true for exactly one caller once the interval has elapsed, and
+        /// moves the deadline to the next interval. That caller should Harvest().
+        /// </summary>
+        bool IsHarvestDue(int64_t nowMs) noexcept;
+
+        /// <summary>
+        /// Index of the histogram bucket of a value.
+        /// </summary>
+        static size_t GetBucketIndex(double value) noexcept;
+
+        /// <summary>
+        /// Smallest value falling into a histogram bucket.
+        /// </summary>
+        static double GetBucketLowerBound(size_t index) noexcept;
+
+    protected:
+        struct Shard;
+
+        // A recording thread counts itself in the slot writers before it loads the shard,
+        // so that Harvest() can tell when a swapped out shard is no longer written to
+        struct Slot
+        {
+            std::atomic<Shard*> shard{nullptr};
+            std::atomic<uint32_t> writers{0};
+            char padding[64];
+        };
+
+        Slot& GetSlot();
+        Shard& GetShard(Slot& slot);
+
+        const Kind m_kind;
+        const uint64_t m_intervalMs;
+        std::atomic<int64_t> m_nextHarvestMs;
+        std::atomic<double> m_last;
+        std::array<Slot, MaxShards> m_slots;
+    };
+
+}
+MAT_NS_END
+
+#endif
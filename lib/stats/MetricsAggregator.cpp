@@ -0,0 +1,276 @@
+//
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// SPDX-License-Identifier: Apache-2.0
+//
+#include "MetricsAggregator.hpp"
+
+#include "pal/PAL.hpp"
+
+#include <algorithm>
+
+namespace MAT_NS_BEGIN
+{
+    namespace
+    {
+        bool TryGetInt(VariantMap& map, const char* key, int64_t& value)
+        {
+            auto it = map.find(key);
+            if (it == map.end() || it->second.type != Variant::TYPE_INT)
+            {
+                return false;
+            }
+            value = it->second;
+            return true;
+        }
+
+        void AppendKeyPart(std::string& key, std::string const& part)
+        {
+            key.append(part);
+            key.push_back('\x1f');
+        }
+
+        // Series emit the properties of their first observation: observations with other
+        // properties go to another series
+        void AppendPropertiesKey(std::string& key, EventProperties const& properties)
+        {
+            AppendKeyPart(key, properties.GetName());
+            for (auto category : { DataCategory_PartC, DataCategory_PartB })
+            {
+                for (auto const& item : properties.GetProperties(category))
+                {
+                    AppendKeyPart(key, item.first);
+                    key.push_back(static_cast<char>('0' + item.second.type));
+                    key.push_back(static_cast<char>('0' + item.second.piiKind));
+                    AppendKeyPart(key, item.second.to_string());
+                }
+                key.push_back('\x1e');
+            }
+        }
+    }
+
+    AggregatedMetricSeries::AggregatedMetricSeries(AggregatedMetricData const& metricData,
+                                                   EventProperties const& properties,
+                                                   ILogger* logger,
+                                                   unsigned intervalInSec) :
+        m_series(MetricSeries::Kind::Distribution, static_cast<uint64_t>(intervalInSec) * 1000),
+        m_metricData(metricData),
+        m_properties(properties),
+        m_logger(logger),
+        m_intervalStartMs(static_cast<int64_t>(PAL::getMonotonicTimeMs()))
+    {
+    }
+
+    void AggregatedMetricSeries::Record(double value)
+    {
+        m_series.Record(value);
+        HarvestIfDue(static_cast<int64_t>(PAL::getMonotonicTimeMs()));
+    }
+
+    void AggregatedMetricSeries::HarvestIfDue(int64_t nowMs)
+    {
+        if (m_series.IsHarvestDue(nowMs))
+        {
+            emit(nowMs);
+        }
+    }
+
+    void AggregatedMetricSeries::Flush()
+    {
+        emit(static_cast<int64_t>(PAL::getMonotonicTimeMs()));
+    }
+
+    void AggregatedMetricSeries::Detach() noexcept
+    {
+        LOCKGUARD(m_emitLock);
+        m_logger = nullptr;
+    }
+
+    void AggregatedMetricSeries::emit(int64_t nowMs)
+    {
+        LOCKGUARD(m_emitLock);
+        MetricSnapshot snapshot;
+        if (!m_series.Harvest(snapshot) || m_logger == nullptr)
+        {
+            return;
+        }
+        AggregatedMetricData metricData(m_metricData);
+        metricData.duration = static_cast<long>((nowMs - m_intervalStartMs) * 1000);
+        snapshot.CopyTo(metricData);
+        m_intervalStartMs = nowMs;
+        m_logger->LogAggregatedMetric(metricData, m_properties);
+    }
+
+    MetricsAggregator::MetricsAggregator() :
+        m_series(std::make_shared<SeriesMap>()),
+        m_enabled(false),
+        m_intervalInSec(60),
+        m_maxSeries(1000),
+        m_taskDispatcher(nullptr)
+    {
+    }
+
+    MetricsAggregator::MetricsAggregator(ILogConfiguration& configuration) :
+        MetricsAggregator()
+    {
+        if (!configuration.HasConfig(CFG_MAP_METRICS) || configuration[CFG_MAP_METRICS].type != Variant::TYPE_OBJ)
+        {
+            return;
+        }
+        VariantMap& config = configuration[CFG_MAP_METRICS];
+
+        auto aggregate = config.find(CFG_BOOL_METRICS_AGGREGATE_SAMPLED);
+        if (aggregate != config.end() && aggregate->second.type == Variant::TYPE_BOOL)
+        {
+            m_enabled = aggregate->second;
+        }
+        int64_t value = 0;
+        if (TryGetInt(config, CFG_INT_METRICS_INTERVAL, value) && value > 0)
+        {
+            m_intervalInSec = static_cast<unsigned>(value);
+        }
+        if (TryGetInt(config, CFG_INT_METRICS_MAX_SERIES, value) && value >= 0)
+        {
+            m_maxSeries = static_cast<size_t>(value);
+        }
+    }
+
+    std::shared_ptr<const MetricsAggregator::SeriesMap> MetricsAggregator::getSeriesMap() const
+    {
+        return std::atomic_load(&m_series);
+    }
+
+    bool MetricsAggregator::RecordSampledMetric(ILogger& logger,
+                                                std::string const& name,
+                                                double value,
+                                                std::string const& units,
+                                                std::string const& instanceName,
+                                                std::string const& objectClass,
+                                                std::string const& objectId,
+                                                EventProperties const& properties)
+    {
+        if (!m_enabled)
+        {
+            return false;
+        }
+
+        std::string key = std::to_string(reinterpret_cast<uintptr_t>(&logger));
+        key.push_back('\x1f');
+        AppendKeyPart(key, name);
+        AppendKeyPart(key, units);
+        AppendKeyPart(key, instanceName);
+        AppendKeyPart(key, objectClass);
+        AppendKeyPart(key, objectId);
+        AppendPropertiesKey(key, properties);
+
+        std::shared_ptr<AggregatedMetricSeries> series;
+        {
+            auto seriesMap = getSeriesMap();
+            auto it = seriesMap->find(key);
+            if (it != seriesMap->end())
+            {
+                series = it->second;
+            }
+        }
+
+        if (!series)
+        {
+            // Copy-on-write: readers keep using the previous map until they reload it
+            LOCKGUARD(m_lock);
+            auto seriesMap = getSeriesMap();
+            auto it = seriesMap->find(key);
+            if (it != seriesMap->end())
+            {
+                series = it->second;
+            }
+            else
+            {
+                if (seriesMap->size() >= m_maxSeries)
+                {
+                    return false;
+                }
+                AggregatedMetricData metricData(name, 0, 0);
+                metricData.units = units;
+                metricData.instanceName = instanceName;
+                metricData.objectClass = objectClass;
+                metricData.objectId = objectId;
+                series = std::make_shared<AggregatedMetricSeries>(metricData, properties, &logger, m_intervalInSec);
+                auto updated = std::make_shared<SeriesMap>(*seriesMap);
+                (*updated)[key] = series;
+                std::atomic_store(&m_series, std::shared_ptr<const SeriesMap>(std::move(updated)));
+            }
+        }
+
+        series->Record(value);
+        return true;
+    }
+
+    void MetricsAggregator::Start(ITaskDispatcher& taskDispatcher)
+    {
+        if (!m_enabled)
+        {
+            return;
+        }
+        LOCKGUARD(m_timerLock);
+        m_taskDispatcher = &taskDispatcher;
+        scheduleHarvest();
+    }
+
+    void MetricsAggregator::scheduleHarvest()
+    {
+        // A quarter of the interval: a series is emitted at most that late
+        unsigned delayMs = std::max(1000u, m_intervalInSec * 1000 / 4);
+        m_scheduledHarvest = PAL::scheduleTask(m_taskDispatcher, delayMs, this, &MetricsAggregator::harvestDue);
+    }
+
+    void MetricsAggregator::harvestDue()
+    {
+        LOCKGUARD(m_timerLock);
+        if (m_taskDispatcher == nullptr)
+        {
+            return;
+        }
+        int64_t nowMs = static_cast<int64_t>(PAL::getMonotonicTimeMs());
+        auto seriesMap = getSeriesMap();
+        for (auto& item : *seriesMap)
+        {
+            item.second->HarvestIfDue(nowMs);
+        }
+        scheduleHarvest();
+    }
+
+    void MetricsAggregator::Flush()
+    {
+        auto seriesMap = getSeriesMap();
+        for (auto& item : *seriesMap)
+        {
+            item.second->Flush();
+        }
+    }
+
+    void MetricsAggregator::Shutdown()
+    {
+        {
+            LOCKGUARD(m_timerLock);
+            m_taskDispatcher = nullptr;
+            m_scheduledHarvest.Cancel();
+        }
+        std::shared_ptr<const SeriesMap> seriesMap;
+        {
+            LOCKGUARD(m_lock);
+            seriesMap = getSeriesMap();
+            std::atomic_store(&m_series, std::shared_ptr<const SeriesMap>(std::make_shared<SeriesMap>()));
+        }
+        for (auto& item : *seriesMap)
+        {
+            item.second->Flush();
+            item.second->Detach();
+        }
+    }
+
+    size_t MetricsAggregator::GetSeriesCount() const
+    {
+        return getSeriesMap()->size();
+    }
+
+}
+MAT_NS_END
@@ -0,0 +1,140 @@
+//
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// SPDX-License-Identifier: Apache-2.0
+//
+#ifndef METRICSAGGREGATOR_HPP
+#define METRICSAGGREGATOR_HPP
+
+#include "pal/PAL.hpp"
+
+#include "ctmacros.hpp"
+#include "EventProperties.hpp"
+#include "ILogConfiguration.hpp"
+#include "ILogger.hpp"
+#include "MetricSeries.hpp"
+#include "pal/TaskDispatcher.hpp"
+
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+
+namespace MAT_NS_BEGIN
+{
+    /// <summary>
+    /// A distribution series that is logged as one AggregatedMetric event per interval.
+    /// A series is emitted by the first observation or HarvestIfDue() call after its
+    /// interval has elapsed, or by an explicit Flush().
+    /// </summary>
+    class AggregatedMetricSeries
+    {
+    public:
+        AggregatedMetricSeries(AggregatedMetricData const& metricData,
+                               EventProperties const& properties,
+                               ILogger* logger,
+                               unsigned intervalInSec);
+
+        /// <summary>
+        /// Records one observation, emitting the previous interval when it is due.
+        /// </summary>
+        void Record(double value);
+
+        /// <summary>
+        /// Emits the current interval if it has elapsed.
+        /// </summary>
+        void HarvestIfDue(int64_t nowMs);
+
+        /// <summary>
+        /// Emits everything recorded since the last emission.
+        /// </summary>
+        void Flush();
+
+        /// <summary>
+        /// Stops emitting: pending and future observations are discarded.
+        /// </summary>
+        void Detach() noexcept;
+
+    protected:
+        void emit(int64_t nowMs);
+
+        MetricSeries m_series;
+        const AggregatedMetricData m_metricData;
+        const EventProperties m_properties;
+        std::mutex m_emitLock;
+        ILogger* m_logger;
+        int64_t m_intervalStartMs;
+    };
+
+    /// <summary>
+    /// Pre-aggregates ILogger::LogSampledMetric observations per logger, metric name,
+    /// dimensions (units, instance name, object class and ID) and event properties when
+    /// enabled through the CFG_MAP_METRICS configuration. Lookups of existing series are
+    /// lock-free; only the creation of a new series takes a lock. Once started, a timer
+    /// on the task dispatcher emits the series whose interval has elapsed, so that a
+    /// series no longer recorded to is still logged.
+    /// </summary>
+    class MetricsAggregator
+    {
+    public:
+        MetricsAggregator();
+        explicit MetricsAggregator(ILogConfiguration& configuration);
+
+        bool IsEnabled() const noexcept
+        {
+            return m_enabled;
+        }
+
+        /// <summary>
+        /// Records a sampled metric observation.
+        /// </summary>
+        /// <returns>false if the observation was not aggregated (disabled, or too many series)
+        /// and must be logged as a regular event.</returns>
+        bool RecordSampledMetric(ILogger& logger,
+                                 std::string const& name,
+                                 double value,
+                                 std::string const& units,
+                                 std::string const& instanceName,
+                                 std::string const& objectClass,
+                                 std::string const& objectId,
+                                 EventProperties const& properties);
+
+        /// <summary>
+        /// Starts the timer that emits the series whose interval has elapsed.
+        /// </summary>
+        void Start(ITaskDispatcher& taskDispatcher);
+
+        /// <summary>
+        /// Emits all pending series.
+        /// </summary>
+        void Flush();
+
+        /// <summary>
+        /// Flushes and drops all series: no events are emitted after this call.
+        /// </summary>
+        void Shutdown();
+
+        size_t GetSeriesCount() const;
+
+    protected:
+        using SeriesMap = std::unordered_map<std::string, std::shared_ptr<AggregatedMetricSeries>>;
+
+        std::shared_ptr<const SeriesMap> getSeriesMap() const;
+        void harvestDue();
+        void scheduleHarvest();
+
+        mutable std::mutex m_lock;
+        std::shared_ptr<const SeriesMap> m_series;
+        bool m_enabled;
+        unsigned m_intervalInSec;
+        size_t m_maxSeries;
+        // Serializes the timer with Shutdown(): no harvest runs once it returns
+        std::mutex m_timerLock;
+        ITaskDispatcher* m_taskDispatcher;
+        PAL::DeferredCallbackHandle m_scheduledHarvest;
+    };
+
+}
+MAT_NS_END
+
+#endif
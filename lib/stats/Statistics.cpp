@@ -18,6 +18,7 @@ namespace MAT_NS_BEGIN {
         m_taskDispatcher(taskDispatcher),
         m_config(telemetrySystem.getConfig()),
         m_logManager(telemetrySystem.getLogManager()),
+        m_eventSampler(nullptr),
         m_baseDecorator(m_logManager),
         m_semanticContextDecorator(m_logManager),
         m_isStarted(false)
@@ -61,10 +62,29 @@ namespace MAT_NS_BEGIN {
         }
 
         std::vector< ::CsProtocol::Record> records;
+        size_t sampledOut = 0;
         {
             LOCKGUARD(m_metaStats_mtx);
+            // Loggers only count the events they sample out: collect the counts here
+            if (m_eventSampler != nullptr)
+            {
+                std::map<std::string, unsigned> counts;
+                m_eventSampler->TakeSampledOut(counts);
+                for (auto const& item : counts)
+                {
+                    m_metaStats.updateOnEventSampledOut(item.first, item.second);
+                    sampledOut += item.second;
+                }
+            }
             records = m_metaStats.generateStatsEvent(rollupKind);
         }
+        if (sampledOut > 0)
+        {
+            DebugEvent evt;
+            evt.type = DebugEventType::EVT_SAMPLED;
+            evt.param1 = sampledOut;
+            OnDebugEvent(evt);
+        }
         std::string tenantToken = m_config.GetMetaStatsTenantToken();
 
         for (auto& record : records)
@@ -122,9 +142,10 @@ namespace MAT_NS_BEGIN {
     bool Statistics::handleOnIncomingEventAccepted(IncomingEventContextPtr const& ctx)
     {
         bool metastats = (ctx->record.tenantToken == m_config.GetMetaStatsTenantToken());
+        m_metaStats.updateOnEventIncoming(ctx->record.tenantToken, static_cast<unsigned>(ctx->record.blob.size()), ctx->record.latency, metastats);
+        if (ctx->submitTimestamp != 0)
         {
-            LOCKGUARD(m_metaStats_mtx);
-            m_metaStats.updateOnEventIncoming(ctx->record.tenantToken, static_cast<unsigned>(ctx->record.blob.size()), ctx->record.latency, metastats);
+            m_metaStats.getDeliveryLatencyTracker().Record(ctx->record.tenantToken, ctx->record.latency, DeliveryStage_Queue, ctx->record.timestamp - ctx->submitTimestamp);
         }
         scheduleSend();
 
@@ -158,9 +179,11 @@ namespace MAT_NS_BEGIN {
     bool Statistics::handleOnUploadStarted(EventsUploadContextPtr const& ctx)
     {
         bool metastatsOnly = (ctx->packageIds.count(m_config.GetMetaStatsTenantToken()) == ctx->packageIds.size());
+        m_metaStats.updateOnPostData(static_cast<unsigned>(ctx->httpRequest->GetSizeEstimate()), metastatsOnly);
+        if (ctx->collectorEndpoint >= 0)
         {
             LOCKGUARD(m_metaStats_mtx);
-            m_metaStats.updateOnPostData(static_cast<unsigned>(ctx->httpRequest->GetSizeEstimate()), metastatsOnly);
+            m_metaStats.updateOnCollectorEndpointSelected(static_cast<unsigned>(ctx->collectorEndpoint), ctx->collectorFailover);
         }
         scheduleSend();
 
@@ -190,14 +213,47 @@ namespace MAT_NS_BEGIN {
         }
 
         bool metastatsOnly = (ctx->packageIds.count(m_config.GetMetaStatsTenantToken()) == ctx->packageIds.size());
+        m_metaStats.updateOnPackageSentSucceeded(ctx->recordIdsAndTenantIds, ctx->latency, ctx->maxRetryCountSeen, ctx->durationMs, latencyToSendMs, metastatsOnly);
+        if (m_metaStats.getDeliveryLatencyTracker().IsEnabled())
         {
-            LOCKGUARD(m_metaStats_mtx);
-            m_metaStats.updateOnPackageSentSucceeded(ctx->recordIdsAndTenantIds, ctx->latency, ctx->maxRetryCountSeen, ctx->durationMs, latencyToSendMs, metastatsOnly);
+            recordDeliveryLatency(ctx, now);
         }
         scheduleSend();
         return true;
     }
 
+    /// <summary>
+    /// Records the delivery stages of every record of a successfully uploaded package.
+    /// Package stages (packaging, compression, network) are counted once per record.
+    /// </summary>
+    /// <param name="ctx">The upload context.</param>
+    /// <param name="now">UTC time the upload was acknowledged.</param>
+    void Statistics::recordDeliveryLatency(EventsUploadContextPtr const& ctx, int64_t now)
+    {
+        DeliveryLatencyTracker& tracker = m_metaStats.getDeliveryLatencyTracker();
+        const size_t count = std::min(ctx->recordOrigins.size(), ctx->recordTimestamps.size());
+        for (size_t i = 0; i < count; i++)
+        {
+            std::string const& tenantToken = ctx->recordOrigins[i].first;
+            const EventLatency latency = ctx->recordOrigins[i].second;
+            const int64_t storedTimestamp = ctx->recordTimestamps[i];
+            tracker.Record(tenantToken, latency, DeliveryStage_Storage, ctx->packagingStartMs - storedTimestamp);
+            if (ctx->packagingMs >= 0)
+            {
+                tracker.Record(tenantToken, latency, DeliveryStage_Packaging, ctx->packagingMs);
+            }
+            if (ctx->compressionMs >= 0)
+            {
+                tracker.Record(tenantToken, latency, DeliveryStage_Compression, ctx->compressionMs);
+            }
+            if (ctx->durationMs >= 0)
+            {
+                tracker.Record(tenantToken, latency, DeliveryStage_Network, ctx->durationMs);
+            }
+            tracker.Record(tenantToken, latency, DeliveryStage_Total, now - storedTimestamp);
+        }
+    }
+
     bool Statistics::handleOnUploadRejected(EventsUploadContextPtr const& ctx)
     {
         unsigned status = (ctx->httpResponse)?ctx->httpResponse->GetStatusCode():0;
@@ -222,6 +278,10 @@ namespace MAT_NS_BEGIN {
         {
             LOCKGUARD(m_metaStats_mtx);
             m_metaStats.updateOnPackageRetry(status, ctx->maxRetryCountSeen);
+            if (ctx->collectorEndpointTripped)
+            {
+                m_metaStats.updateOnCollectorEndpointTripped(static_cast<unsigned>(ctx->collectorEndpoint));
+            }
         }
         scheduleSend();
         return true;
@@ -13,6 +13,7 @@
 #include "decorators/SemanticContextDecorator.hpp"
 
 #include "MetaStats.hpp"
+#include "filter/EventSampler.hpp"
 #include "DebugEvents.hpp"
 #include "pal/TaskDispatcher.hpp"
 
@@ -33,6 +34,19 @@ namespace MAT_NS_BEGIN {
         Statistics(ITelemetrySystem& telemetrySystem, ITaskDispatcher& taskDispatcher);
         ~Statistics();
 
+        DeliveryLatencyTracker& getDeliveryLatencyTracker()
+        {
+            return m_metaStats.getDeliveryLatencyTracker();
+        }
+
+        /// <summary>
+        /// Sets the sampler whose sampled out events are counted on each stats send.
+        /// </summary>
+        void setEventSampler(EventSampler const* sampler)
+        {
+            m_eventSampler = sampler;
+        }
+
     protected:
         virtual void scheduleSend();
         void send(RollUpKind rollupKind);
@@ -50,6 +64,8 @@ namespace MAT_NS_BEGIN {
         bool handleOnUploadRejected(EventsUploadContextPtr const& ctx);
         bool handleOnUploadFailed(EventsUploadContextPtr const& ctx);
 
+        void recordDeliveryLatency(EventsUploadContextPtr const& ctx, int64_t now);
+
         bool handleOnStorageOpened(StorageNotificationContext const* ctx);
         bool handleOnStorageFailed(StorageNotificationContext const* ctx);
         bool handleOnStorageTrimmed(StorageNotificationContext const* ctx);
@@ -57,12 +73,14 @@ namespace MAT_NS_BEGIN {
         bool handleOnStorageRecordsRejected(StorageNotificationContext const* ctx);
 
     protected:
+        // Serializes the MetaStats updates that are not lock-free (see MetaStats)
         std::mutex                  m_metaStats_mtx;
         MetaStats                   m_metaStats;
         ITelemetrySystem&           m_iTelemetrySystem;
         ITaskDispatcher&            m_taskDispatcher;
         IRuntimeConfig&             m_config;
         ILogManager&                m_logManager;
+        EventSampler const*         m_eventSampler;
 
         // Both decorators are associated with m_logManager
         BaseDecorator               m_baseDecorator;
@@ -82,7 +100,7 @@ namespace MAT_NS_BEGIN {
         RoutePassThrough<Statistics>                                    onStop{ this, &Statistics::handleOnStop };
 
 #if 1   // TODO: [MG] - verify this codepath
-        RoutePassThrough<Statistics, IncomingEventContextPtr const&>    onIncomingEventAccepted{ this, &Statistics::handleOnIncomingEventAccepted };
+        MAT_BOUND_ROUTE(Statistics, handleOnIncomingEventAccepted)      onIncomingEventAccepted{ this };
         RoutePassThrough<Statistics, IncomingEventContextPtr const&>    onIncomingEventFailed{ this, &Statistics::handleOnIncomingEventFailed };
 #else
         bool dummy_IncomingEventContextPtr(IncomingEventContextPtr const& ctx)
@@ -91,7 +109,7 @@ namespace MAT_NS_BEGIN {
             return true;
         }
 
-        RoutePassThrough<Statistics, IncomingEventContextPtr const&>    onIncomingEventAccepted{ this, &Statistics::dummy_IncomingEventContextPtr };
+        MAT_BOUND_ROUTE(Statistics, dummy_IncomingEventContextPtr)      onIncomingEventAccepted{ this };
         RoutePassThrough<Statistics, IncomingEventContextPtr const&>    onIncomingEventFailed{ this, &Statistics::dummy_IncomingEventContextPtr };
 #endif
 
@@ -0,0 +1,148 @@
+//
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// SPDX-License-Identifier: Apache-2.0
+//
+#ifndef CONTEXTPOOL_HPP
+#define CONTEXTPOOL_HPP
+
+#include "ctmacros.hpp"
+
+#include <cstddef>
+#include <mutex>
+#include <vector>
+
+namespace MAT_NS_BEGIN {
+
+    /// <summary>
+    /// How a pooled object is prepared for its next use. By default the object's
+    /// reset() is called; types that cannot be changed specialize this.
+    /// </summary>
+    template<typename T>
+    struct ContextPoolTraits
+    {
+        static void reset(T& object)
+        {
+            object.reset();
+        }
+    };
+
+    /// <summary>
+    /// Free list of reusable pipeline contexts. Released objects are reset in place,
+    /// so their strings and vectors keep the capacity they grew to, and handed out
+    /// again by the next acquire(). At most maxIdle released objects are kept, any
+    /// further ones are deleted.
+    /// </summary>
+    template<typename T>
+    class ContextPool
+    {
+    public:
+        /// <summary>
+        /// Object borrowed from a pool for the lifetime of the lease.
+        /// </summary>
+        class Lease
+        {
+        public:
+            explicit Lease(ContextPool& pool) :
+                m_pool(pool),
+                m_object(pool.acquire())
+            {
+            }
+
+            ~Lease()
+            {
+                m_pool.release(m_object);
+            }
+
+            Lease(Lease const&) = delete;
+            Lease& operator=(Lease const&) = delete;
+
+            T& operator*() const noexcept
+            {
+                return *m_object;
+            }
+
+            T* operator->() const noexcept
+            {
+                return m_object;
+            }
+
+            T* get() const noexcept
+            {
+                return m_object;
+            }
+
+        protected:
+            ContextPool& m_pool;
+            T*           m_object;
+        };
+
+        explicit ContextPool(size_t maxIdle) :
+            m_maxIdle(maxIdle)
+        {
+            m_idle.reserve(maxIdle);
+        }
+
+        ~ContextPool()
+        {
+            for (T* object : m_idle)
+            {
+                delete object;
+            }
+        }
+
+        ContextPool(ContextPool const&) = delete;
+        ContextPool& operator=(ContextPool const&) = delete;
+
+        /// <summary>
+        /// Returns an idle object, or a new one when the pool is empty.
+        /// </summary>
+        T* acquire()
+        {
+            {
+                std::lock_guard<std::mutex> lock(m_lock);
+                if (!m_idle.empty())
+                {
+                    T* object = m_idle.back();
+                    m_idle.pop_back();
+                    return object;
+                }
+            }
+            return new T();
+        }
+
+        /// <summary>
+        /// Resets the object and keeps it for reuse, or deletes it when the pool is full.
+        /// </summary>
+        void release(T* object)
+        {
+            if (object == nullptr)
+            {
+                return;
+            }
+            ContextPoolTraits<T>::reset(*object);
+            {
+                std::lock_guard<std::mutex> lock(m_lock);
+                if (m_idle.size() < m_maxIdle)
+                {
+                    m_idle.push_back(object);
+                    return;
+                }
+            }
+            delete object;
+        }
+
+        size_t getIdleCount()
+        {
+            std::lock_guard<std::mutex> lock(m_lock);
+            return m_idle.size();
+        }
+
+    protected:
+        const size_t    m_maxIdle;
+        std::mutex      m_lock;
+        std::vector<T*> m_idle;
+    };
+
+} MAT_NS_END
+
+#endif
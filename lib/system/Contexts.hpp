@@ -8,6 +8,7 @@
 #include "IOfflineStorage.hpp"
 #include "packager/ISplicer.hpp"
 #include "packager/BondSplicer.hpp"
+#include "system/ContextPool.hpp"
 #include "pal/PAL.hpp"
 #include "utils/Utils.hpp"
 
@@ -24,6 +25,8 @@ namespace MAT_NS_BEGIN {
         ::CsProtocol::Record*  source;
         StorageRecord          record;
         std::uint64_t          policyBitFlags;
+        // UTC time the event was submitted, set only when delivery latency is tracked
+        std::int64_t           submitTimestamp = 0;
 
     public:
         IncomingEventContext() :
@@ -51,6 +54,42 @@ namespace MAT_NS_BEGIN {
         virtual ~IncomingEventContext()
         {
         }
+
+        /// <summary>
+        /// Sets up a pooled context for a new event, as the constructor does.
+        /// </summary>
+        void set(std::string&& id, std::string const& tenantToken, EventLatency latency, EventPersistence persistence, ::CsProtocol::Record* source)
+        {
+            this->source = source;
+            record.id = std::move(id);
+            record.tenantToken = tenantToken;
+            record.latency = latency;
+            record.persistence = persistence;
+#ifdef HAVE_MAT_EVT_TRACEID
+            record.traceId = (source != nullptr) ? source->cV : "";
+#endif
+        }
+
+        /// <summary>
+        /// Returns the context to its default state, keeping the capacity of the record strings and blob.
+        /// </summary>
+        void reset() noexcept
+        {
+            source = nullptr;
+            record.id.clear();
+            record.tenantToken.clear();
+            record.latency = EventLatency_Unspecified;
+            record.persistence = EventPersistence_Normal;
+            record.timestamp = 0;
+            record.blob.clear();
+            record.retryCount = 0;
+            record.reservedUntil = 0;
+#ifdef HAVE_MAT_EVT_TRACEID
+            record.traceId.clear();
+#endif
+            policyBitFlags = 0;
+            submitTimestamp = 0;
+        }
     };
 
     typedef IncomingEventContext* IncomingEventContextPtr;
@@ -88,9 +127,47 @@ namespace MAT_NS_BEGIN {
             }
         }
 
+        /**
+        * Return the context to its default state for reuse. Containers other
+        * than the body are cleared in place so that they keep their capacity.
+        */
+        void reset() noexcept
+        {
+            clear();
+            requestedMinLatency = EventLatency_Unspecified;
+            requestedMaxCount = 0;
+            requestedTenantToken.clear();
+            splicer->clear();
+            maxUploadSize = 0;
+            latency = EventLatency_Unspecified;
+            packageIds.clear();
+#ifdef HAVE_MAT_EVT_TRACEID
+            traceId.clear();
+#endif
+            recordIdsAndTenantIds.clear();
+            recordTimestamps.clear();
+            maxRetryCountSeen = 0;
+            recordOrigins.clear();
+            packagingStartMs = 0;
+            packagingMs = -1;
+            // The body is moved in from the splicer, so a kept buffer would never be reused:
+            // release it rather than hold a package per pooled context
+            std::vector<uint8_t>().swap(body);
+            compressed = false;
+            compressionMs = -1;
+            httpRequestId.clear();
+            collectorUrl.clear();
+            collectorEndpoint = -1;
+            collectorFailover = false;
+            collectorEndpointTripped = false;
+            durationMs = -1;
+            fromMemory = false;
+        }
+
         // Retrieving
         EventLatency                         requestedMinLatency = EventLatency_Unspecified;
         unsigned                             requestedMaxCount = 0;
+        std::string                          requestedTenantToken;
 
         // Packaging
         std::unique_ptr<ISplicer>            splicer;
@@ -103,17 +180,29 @@ namespace MAT_NS_BEGIN {
         std::map<std::string, std::string>   recordIdsAndTenantIds;
         std::vector<int64_t>                 recordTimestamps;
         unsigned                             maxRetryCountSeen = 0;
+        // Tenant and latency of each record in recordTimestamps, only collected when delivery latency is tracked
+        std::vector<std::pair<std::string, EventLatency>> recordOrigins;
+        int64_t                              packagingStartMs = 0;
+        int                                  packagingMs = -1;
 
         // Encoding
         std::vector<uint8_t>                 body;
         bool                                 compressed = false;
+        int                                  compressionMs = -1;
 
         // Sending
         IHttpRequest*                        httpRequest = nullptr;
         std::string                          httpRequestId;
+        std::string                          collectorUrl;
+        // Index in the collector endpoint pool, -1 when there are no alternates
+        int                                  collectorEndpoint = -1;
+        // Sent to an alternate because the primary collector is unhealthy
+        bool                                 collectorFailover = false;
 
         // Receiving
         IHttpResponse*                       httpResponse = nullptr;
+        // This response tripped the circuit breaker of the collector endpoint
+        bool                                 collectorEndpointTripped = false;
 
         int                                  durationMs = -1;
         bool                                 fromMemory = false;
@@ -142,6 +231,76 @@ namespace MAT_NS_BEGIN {
 
     using EventsUploadContextPtr = std::shared_ptr<EventsUploadContext>;
 
+    /// <summary>
+    /// Records are generated protocol types without reset(), so every field is reset
+    /// here. The top-level strings and the buffers of the extension and data vectors
+    /// keep their capacity. The extension and data elements are destroyed, along with
+    /// their own strings and maps, so their nested types need no reset.
+    /// </summary>
+    template<>
+    struct ContextPoolTraits<::CsProtocol::Record>
+    {
+        // Fields of the generated Record: 5 strings, 3 scalars, the extension and data vectors and tags
+#ifdef HAVE_CS4_FULL
+        static constexpr size_t VectorCount = 24;
+#else
+        static constexpr size_t VectorCount = 13;
+#endif
+        static constexpr size_t FieldsSize =
+            5 * sizeof(std::string) + 3 * sizeof(int64_t) +
+            VectorCount * sizeof(std::vector< ::CsProtocol::Data>) + sizeof(std::map<std::string, std::string>);
+
+        // Fails when the generated Record gains a field: reset() must then clear it as well
+        static_assert(sizeof(::CsProtocol::Record) ==
+                          (FieldsSize + alignof(::CsProtocol::Record) - 1) / alignof(::CsProtocol::Record) * alignof(::CsProtocol::Record),
+                      "CsProtocol::Record changed: update ContextPoolTraits<Record>::reset()");
+
+        static void reset(::CsProtocol::Record& record) noexcept
+        {
+            record.ver.clear();
+            record.name.clear();
+            record.time = 0;
+            record.popSample = 100;
+            record.iKey.clear();
+            record.flags = 0;
+            record.cV.clear();
+#ifdef HAVE_CS4_FULL
+            record.extIngest.clear();
+#endif
+            record.extProtocol.clear();
+            record.extUser.clear();
+            record.extDevice.clear();
+            record.extOs.clear();
+            record.extApp.clear();
+            record.extUtc.clear();
+#ifdef HAVE_CS4_FULL
+            record.extXbl.clear();
+            record.extJavascript.clear();
+            record.extReceipts.clear();
+#endif
+            record.extNet.clear();
+            record.extSdk.clear();
+            record.extLoc.clear();
+#ifdef HAVE_CS4_FULL
+            record.extCloud.clear();
+            record.extService.clear();
+            record.extCs.clear();
+#endif
+            record.extM365a.clear();
+            record.ext.clear();
+#ifdef HAVE_CS4_FULL
+            record.extMscv.clear();
+            record.extIntWeb.clear();
+            record.extIntService.clear();
+            record.extWeb.clear();
+#endif
+            record.tags.clear();
+            record.baseType.clear();
+            record.baseData.clear();
+            record.data.clear();
+        }
+    };
+
     //---
 
     struct StorageNotificationContext {
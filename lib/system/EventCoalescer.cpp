@@ -0,0 +1,368 @@
+//
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// SPDX-License-Identifier: Apache-2.0
+//
+#include "EventCoalescer.hpp"
+
+#include <algorithm>
+#include <cstring>
+
+namespace MAT_NS_BEGIN {
+
+    namespace
+    {
+        // FNV-1a, 64 bit
+        class FingerprintBuilder
+        {
+        public:
+            void add(const void* data, size_t size) noexcept
+            {
+                auto bytes = static_cast<const uint8_t*>(data);
+                for (size_t i = 0; i < size; i++)
+                {
+                    m_hash ^= bytes[i];
+                    m_hash *= 1099511628211ULL;
+                }
+            }
+
+            void add(std::string const& value) noexcept
+            {
+                add(static_cast<uint64_t>(value.size()));
+                add(value.data(), value.size());
+            }
+
+            void add(uint64_t value) noexcept
+            {
+                add(&value, sizeof(value));
+            }
+
+            void add(double value) noexcept
+            {
+                uint64_t bits;
+                std::memcpy(&bits, &value, sizeof(bits));
+                add(bits);
+            }
+
+            template<typename T>
+            void add(std::vector<T> const& values)
+            {
+                add(static_cast<uint64_t>(values.size()));
+                for (auto const& value : values)
+                {
+                    add(value);
+                }
+            }
+
+            void add(uint8_t value) noexcept
+            {
+                add(&value, sizeof(value));
+            }
+
+            void add(int64_t value) noexcept
+            {
+                add(static_cast<uint64_t>(value));
+            }
+
+            void add(::CsProtocol::Value const& value)
+            {
+                add(static_cast<uint64_t>(value.type));
+                add(static_cast<uint64_t>(value.attributes.size()));
+                for (auto const& attributes : value.attributes)
+                {
+                    for (auto const& pii : attributes.pii)
+                    {
+                        add(static_cast<uint64_t>(pii.Kind));
+                    }
+                    for (auto const& content : attributes.customerContent)
+                    {
+                        add(static_cast<uint64_t>(content.Kind));
+                    }
+                }
+                add(value.stringValue);
+                add(value.longValue);
+                add(value.doubleValue);
+                add(value.guidValue);
+                add(value.stringArray);
+                add(value.longArray);
+                add(value.doubleArray);
+                add(value.guidArray);
+            }
+
+            void add(std::vector<::CsProtocol::Data> const& data)
+            {
+                add(static_cast<uint64_t>(data.size()));
+                for (auto const& item : data)
+                {
+                    add(static_cast<uint64_t>(item.properties.size()));
+                    for (auto const& property : item.properties)
+                    {
+                        add(property.first);
+                        add(property.second);
+                    }
+                }
+            }
+
+            uint64_t get() const noexcept
+            {
+                return m_hash;
+            }
+
+        protected:
+            uint64_t m_hash = 14695981039346656037ULL;
+        };
+    }
+
+    constexpr const char* const EventCoalescer::COALESCED_COUNT;
+    constexpr const char* const EventCoalescer::COALESCED_FIRST_TIME;
+    constexpr const char* const EventCoalescer::COALESCED_LAST_TIME;
+
+    EventCoalescer::EventCoalescer(IRuntimeConfig& runtimeConfig, ITaskDispatcher& taskDispatcher) :
+        m_taskDispatcher(taskDispatcher),
+        m_windowMs(0),
+        m_maxWindows(0),
+        m_stopped(false),
+        m_isScheduled(false)
+    {
+        Variant& window = runtimeConfig[CFG_MAP_COALESCE][CFG_INT_COALESCE_WINDOW_MS];
+        Variant& maxWindows = runtimeConfig[CFG_MAP_COALESCE][CFG_INT_COALESCE_MAX_ENTRIES];
+        if (window.type == Variant::TYPE_INT && maxWindows.type == Variant::TYPE_INT)
+        {
+            int64_t windowMs = window;
+            int64_t maxEntries = maxWindows;
+            if (windowMs > 0 && maxEntries > 0)
+            {
+                m_windowMs = static_cast<unsigned>(windowMs);
+                m_maxWindows = static_cast<size_t>(maxEntries);
+            }
+        }
+    }
+
+    EventCoalescer::~EventCoalescer()
+    {
+        if (m_isScheduled.exchange(false))
+        {
+            m_scheduledFlush.Cancel();
+        }
+    }
+
+    uint64_t EventCoalescer::GetFingerprint(IncomingEventContext const& ctx)
+    {
+        FingerprintBuilder fingerprint;
+        fingerprint.add(ctx.record.tenantToken);
+        fingerprint.add(static_cast<uint64_t>(ctx.record.latency));
+        fingerprint.add(static_cast<uint64_t>(ctx.record.persistence));
+        fingerprint.add(ctx.policyBitFlags);
+        ::CsProtocol::Record const& record = *ctx.source;
+        fingerprint.add(record.name);
+        fingerprint.add(record.baseType);
+        fingerprint.add(record.iKey);
+        fingerprint.add(record.popSample);
+        fingerprint.add(record.flags);
+        fingerprint.add(record.data);
+        fingerprint.add(record.baseData);
+        fingerprint.add(record.ext);
+        return fingerprint.get();
+    }
+
+    uint64_t EventCoalescer::fingerprint(IncomingEventContext const& ctx) const
+    {
+        return GetFingerprint(ctx);
+    }
+
+    bool EventCoalescer::isSameEvent(Window const& window, IncomingEventContext const& ctx)
+    {
+        ::CsProtocol::Record const& opened = *window.record;
+        ::CsProtocol::Record const& record = *ctx.source;
+        return window.tenantToken == ctx.record.tenantToken
+            && window.latency == ctx.record.latency
+            && window.persistence == ctx.record.persistence
+            && window.policyBitFlags == ctx.policyBitFlags
+            && opened.name == record.name
+            && opened.baseType == record.baseType
+            && opened.iKey == record.iKey
+            && opened.popSample == record.popSample
+            && opened.flags == record.flags
+            && opened.data == record.data
+            && opened.baseData == record.baseData
+            && opened.ext == record.ext;
+    }
+
+    bool EventCoalescer::handleCoalesce(IncomingEventContextPtr const& ctx)
+    {
+        if (m_windowMs == 0 || ctx->source == nullptr)
+        {
+            return true;
+        }
+
+        const uint64_t fingerprint = this->fingerprint(*ctx);
+        const int64_t nowMs = static_cast<int64_t>(PAL::getMonotonicTimeMs());
+        std::vector<Window> closed;
+        bool passThrough = true;
+        bool schedule = false;
+        {
+            LOCKGUARD(m_lock);
+            if (m_stopped)
+            {
+                return true;
+            }
+            closeWindows(nowMs, closed);
+
+            auto it = m_index.find(fingerprint);
+            if (it != m_index.end())
+            {
+                Window& window = *(it->second);
+                if (isSameEvent(window, *ctx))
+                {
+                    // Duplicate within an open window: keep a copy for the summary and drop it
+                    if (window.count == 0)
+                    {
+                        *window.record = *ctx->source;
+                        window.firstTime = ctx->source->time;
+                        schedule = true;
+                    }
+                    window.count++;
+                    window.lastTime = ctx->source->time;
+                    passThrough = false;
+                }
+                else
+                {
+                    // Another event with the same hash: not coalesced while this window is open
+                    LOG_TRACE("Fingerprint collision for %s/%s", tenantTokenToId(ctx->record.tenantToken).c_str(), ctx->source->baseType.c_str());
+                }
+            }
+            else
+            {
+                if (m_windows.size() >= m_maxWindows)
+                {
+                    closeFront(closed);
+                }
+                Window window;
+                window.fingerprint = fingerprint;
+                window.endMs = nowMs + m_windowMs;
+                window.tenantToken = ctx->record.tenantToken;
+                window.latency = ctx->record.latency;
+                window.persistence = ctx->record.persistence;
+                window.policyBitFlags = ctx->policyBitFlags;
+                window.record.reset(new ::CsProtocol::Record(*ctx->source));
+                m_windows.push_back(std::move(window));
+                m_index[fingerprint] = std::prev(m_windows.end());
+            }
+        }
+
+        if (schedule)
+        {
+            scheduleFlush();
+        }
+        emit(closed);
+        return passThrough;
+    }
+
+    void EventCoalescer::closeWindows(int64_t nowMs, std::vector<Window>& closed)
+    {
+        while (!m_windows.empty() && m_windows.front().endMs <= nowMs)
+        {
+            closeFront(closed);
+        }
+    }
+
+    void EventCoalescer::closeFront(std::vector<Window>& closed)
+    {
+        Window& window = m_windows.front();
+        m_index.erase(window.fingerprint);
+        if (window.count > 0)
+        {
+            closed.push_back(std::move(window));
+        }
+        m_windows.pop_front();
+    }
+
+    void EventCoalescer::emit(std::vector<Window>& closed)
+    {
+        for (auto& window : closed)
+        {
+            ::CsProtocol::Record& record = *window.record;
+            if (record.data.empty())
+            {
+                record.data.push_back(::CsProtocol::Data());
+            }
+            auto& properties = record.data[0].properties;
+            ::CsProtocol::Value count;
+            count.type = ::CsProtocol::ValueKind::ValueInt64;
+            count.longValue = window.count;
+            properties[COALESCED_COUNT] = count;
+            ::CsProtocol::Value firstTime;
+            firstTime.type = ::CsProtocol::ValueKind::ValueDateTime;
+            firstTime.longValue = window.firstTime;
+            properties[COALESCED_FIRST_TIME] = firstTime;
+            ::CsProtocol::Value lastTime;
+            lastTime.type = ::CsProtocol::ValueKind::ValueDateTime;
+            lastTime.longValue = window.lastTime;
+            properties[COALESCED_LAST_TIME] = lastTime;
+            record.time = window.firstTime;
+
+            IncomingEventContext event(PAL::generateUuidString(), window.tenantToken, window.latency, window.persistence, &record);
+            event.policyBitFlags = window.policyBitFlags;
+            LOG_TRACE("Coalesced %lld events %s/%s", static_cast<long long>(window.count),
+                tenantTokenToId(window.tenantToken).c_str(), record.baseType.c_str());
+            coalesced(&event);
+        }
+    }
+
+    void EventCoalescer::scheduleFlush()
+    {
+        if (!m_isScheduled.exchange(true))
+        {
+            m_scheduledFlush = PAL::scheduleTask(&m_taskDispatcher, m_windowMs, this, &EventCoalescer::handleWindowsExpired);
+        }
+    }
+
+    void EventCoalescer::handleWindowsExpired()
+    {
+        m_isScheduled = false;
+        std::vector<Window> closed;
+        bool pending = false;
+        {
+            LOCKGUARD(m_lock);
+            closeWindows(static_cast<int64_t>(PAL::getMonotonicTimeMs()), closed);
+            pending = !m_stopped && std::any_of(m_windows.cbegin(), m_windows.cend(), [](Window const& window) { return window.count > 0; });
+        }
+        if (pending)
+        {
+            scheduleFlush();
+        }
+        emit(closed);
+    }
+
+    void EventCoalescer::flush()
+    {
+        std::vector<Window> closed;
+        {
+            LOCKGUARD(m_lock);
+            while (!m_windows.empty())
+            {
+                closeFront(closed);
+            }
+        }
+        emit(closed);
+    }
+
+    void EventCoalescer::stop()
+    {
+        {
+            LOCKGUARD(m_lock);
+            m_stopped = true;
+        }
+        if (m_isScheduled.exchange(false))
+        {
+            m_scheduledFlush.Cancel();
+        }
+        flush();
+    }
+
+    size_t EventCoalescer::GetWindowCount()
+    {
+        LOCKGUARD(m_lock);
+        return m_windows.size();
+    }
+
+} MAT_NS_END
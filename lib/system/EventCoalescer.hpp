@@ -0,0 +1,116 @@
+//
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// SPDX-License-Identifier: Apache-2.0
+//
+#ifndef EVENTCOALESCER_HPP
+#define EVENTCOALESCER_HPP
+
+#include "pal/PAL.hpp"
+#include "pal/TaskDispatcher.hpp"
+
+#include "system/Contexts.hpp"
+#include "system/Route.hpp"
+#include "api/IRuntimeConfig.hpp"
+#include "ITaskDispatcher.hpp"
+
+#include <list>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+namespace MAT_NS_BEGIN {
+
+    /// <summary>
+    /// Folds bursts of identical events into one summary record.
+    /// The first occurrence of an event passes through unchanged and opens a
+    /// window (CFG_INT_COALESCE_WINDOW_MS). Identical events logged within that
+    /// window are dropped and counted; when the window closes, one copy of the
+    /// event is emitted through the coalesced route with the number of folded
+    /// events and the time of the first and last of them.
+    /// Events are identical when tenant, name, type, latency, persistence,
+    /// policy flags and all decorated Part B/C properties are equal. Windows are
+    /// found by a hash of these; an event whose hash matches a window of a
+    /// different event passes through.
+    /// </summary>
+    class EventCoalescer
+    {
+    public:
+        /// Number of events folded into a summary record
+        static constexpr const char* const COALESCED_COUNT = "Coalesced.Count";
+        /// Time of the first folded event
+        static constexpr const char* const COALESCED_FIRST_TIME = "Coalesced.FirstTime";
+        /// Time of the last folded event
+        static constexpr const char* const COALESCED_LAST_TIME = "Coalesced.LastTime";
+
+        EventCoalescer(IRuntimeConfig& runtimeConfig, ITaskDispatcher& taskDispatcher);
+        virtual ~EventCoalescer();
+
+        bool IsEnabled() const noexcept
+        {
+            return m_windowMs != 0;
+        }
+
+        /// <summary>
+        /// Emits the summary records of all open windows.
+        /// </summary>
+        void flush();
+
+        /// <summary>
+        /// Emits all pending summary records and passes every later event through.
+        /// </summary>
+        void stop();
+
+        size_t GetWindowCount();
+
+        /// <summary>
+        /// Hash of everything that makes two incoming events identical.
+        /// </summary>
+        static uint64_t GetFingerprint(IncomingEventContext const& ctx);
+
+    protected:
+        struct Window
+        {
+            uint64_t fingerprint = 0;
+            int64_t endMs = 0;
+            int64_t count = 0;
+            int64_t firstTime = 0;
+            int64_t lastTime = 0;
+            // The event that opened the window, replaced by the first folded one for the summary
+            std::unique_ptr<::CsProtocol::Record> record;
+            std::string tenantToken;
+            EventLatency latency = EventLatency_Normal;
+            EventPersistence persistence = EventPersistence_Normal;
+            uint64_t policyBitFlags = 0;
+        };
+
+        using WindowList = std::list<Window>;
+
+        bool handleCoalesce(IncomingEventContextPtr const& ctx);
+        virtual uint64_t fingerprint(IncomingEventContext const& ctx) const;
+        static bool isSameEvent(Window const& window, IncomingEventContext const& ctx);
+        void handleWindowsExpired();
+
+        void closeWindows(int64_t nowMs, std::vector<Window>& closed);
+        void closeFront(std::vector<Window>& closed);
+        void emit(std::vector<Window>& closed);
+        void scheduleFlush();
+
+        std::mutex                                          m_lock;
+        ITaskDispatcher&                                    m_taskDispatcher;
+        unsigned                                            m_windowMs;
+        size_t                                              m_maxWindows;
+        bool                                                m_stopped;
+        // Windows in order of opening, which is also the order in which they close
+        WindowList                                          m_windows;
+        std::unordered_map<uint64_t, WindowList::iterator>  m_index;
+        PAL::DeferredCallbackHandle                         m_scheduledFlush;
+        std::atomic<bool>                                   m_isScheduled;
+
+    public:
+        MAT_BOUND_ROUTE(EventCoalescer, handleCoalesce) coalesce{this, "coalesce"};
+        RouteSource<IncomingEventContextPtr const&>      coalesced;
+    };
+
+} MAT_NS_END
+
+#endif
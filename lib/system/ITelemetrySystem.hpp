@@ -16,6 +16,7 @@
 namespace MAT_NS_BEGIN {
 
     class DebugEventDispatcher;
+    class EventSampler;
     
     /// <summary>
     /// Common interface of a telemetry system
@@ -47,6 +48,12 @@ namespace MAT_NS_BEGIN {
         // Core sendEvent
         virtual void sendEvent(IncomingEventContextPtr const& event) = 0;
 
+        // Source of the counts of events dropped by client-side sampling
+        virtual void setEventSampler(EventSampler const* sampler) = 0;
+
+        // Delivery latency histograms since start
+        virtual std::vector<DeliveryLatencyStats> getDeliveryLatency() = 0;
+
     protected:
         virtual void handleFlushTaskDispatcher() = 0;
         virtual void signalDone() = 0;
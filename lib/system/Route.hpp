@@ -6,8 +6,10 @@
 #define SYSTEM_ROUTE_HPP
 
 #include "pal/PAL.hpp"
+#include "pal/PipelineTrace.hpp"
 
 #include <assert.h>
+#include <type_traits>
 #include <vector>
 
 namespace MAT_NS_BEGIN {
@@ -32,24 +34,46 @@ namespace MAT_NS_BEGIN {
     };
 
 
+#ifdef HAVE_MAT_PIPELINE_TRACE
+    //! Helper - times a route hop, named after the owner type unless a name was given
+    template<typename TOwner>
+    class RouteTraceScope : public PAL::PipelineTraceScope {
+    public:
+        explicit RouteTraceScope(const char* name)
+            : PAL::PipelineTraceScope("route", name)
+        {
+            if (IsActive() && name == nullptr) {
+                SetName(PAL::PipelineTrace::TypeName<TOwner>());
+            }
+        }
+    };
+#endif
+
+
     //! Helper - IRouteSink/IRoutePassThrough implementation over member functor
+    //! The optional name labels the hop in pipeline traces (defaults to the owner type)
     template<typename TParent, typename TOwner, typename... TArgs>
     class RouteHandlerT : public TParent {
     public:
-        RouteHandlerT(TOwner* owner, typename TParent::ReturnType(TOwner::* handler)(TArgs...))
+        RouteHandlerT(TOwner* owner, typename TParent::ReturnType(TOwner::* handler)(TArgs...), const char* name = nullptr)
             : m_owner(owner),
-            m_handler(handler)
+            m_handler(handler),
+            m_name(name)
         {
         }
 
         virtual typename TParent::ReturnType operator()(TArgs... args) override
         {
+#ifdef HAVE_MAT_PIPELINE_TRACE
+            RouteTraceScope<TOwner> trace(m_name);
+#endif
             return (m_owner->*m_handler)(std::forward<TArgs>(args) ...);
         }
 
     protected:
         TOwner * m_owner;
         typename TParent::ReturnType(TOwner::* m_handler)(TArgs...);
+        const char* m_name;
     };
 
 
@@ -63,6 +87,120 @@ namespace MAT_NS_BEGIN {
     using RoutePassThrough = RouteHandlerT<IRoutePassThrough<TArgs...>, TOwner, TArgs...>;
 
 
+    //! Helper - route interface implemented by a handler returning TReturn
+    template<typename TReturn, typename... TArgs>
+    struct RouteInterface;
+
+    template<typename... TArgs>
+    struct RouteInterface<void, TArgs...> {
+        using Type = IRouteSink<TArgs...>;
+    };
+
+    template<typename... TArgs>
+    struct RouteInterface<bool, TArgs...> {
+        using Type = IRoutePassThrough<TArgs...>;
+    };
+
+
+    //! Route sink (void handler) or pass-through (bool handler) over a member function fixed
+    //! at compile time. Works as a dynamic route node like RouteSink/RoutePassThrough, and
+    //! lets StaticRoute call the handler directly through invoke().
+    template<typename THandler, THandler Handler>
+    class BoundRouteHandler;
+
+    template<typename TOwner, typename TReturn, typename... TArgs, TReturn(TOwner::* Handler)(TArgs...)>
+    class BoundRouteHandler<TReturn(TOwner::*)(TArgs...), Handler> : public RouteInterface<TReturn, TArgs...>::Type {
+    public:
+        BoundRouteHandler(TOwner* owner, const char* name = nullptr)
+            : m_owner(owner),
+            m_name(name)
+        {
+        }
+
+        TReturn invoke(TArgs... args)
+        {
+#ifdef HAVE_MAT_PIPELINE_TRACE
+            RouteTraceScope<TOwner> trace(m_name);
+#endif
+            return (m_owner->*Handler)(std::forward<TArgs>(args) ...);
+        }
+
+        virtual TReturn operator()(TArgs... args) override
+        {
+            return invoke(std::forward<TArgs>(args) ...);
+        }
+
+    protected:
+        TOwner*     m_owner;
+        const char* m_name;
+    };
+
+    //! Type of the route node bound to a member function, e.g. MAT_BOUND_ROUTE(Packager, handleFinalizePackage)
+#define MAT_BOUND_ROUTE(owner_, handler_) BoundRouteHandler<decltype(&owner_::handler_), &owner_::handler_>
+
+
+    //! Compile-time route over a fixed chain of bound handlers: the pass-throughs run in order
+    //! until one returns false, then the final sink (if any). Each hop is a direct call that
+    //! can be inlined, instead of a virtual call per element of RouteSource's passthrough list.
+    template<typename... TNodes>
+    class StaticRoute;
+
+    template<>
+    class StaticRoute<> {
+    public:
+        template<typename... TArgs>
+        void operator()(TArgs&& ...) const
+        {
+        }
+    };
+
+    template<typename TNode, typename... TRest>
+    class StaticRoute<TNode, TRest...> {
+        static_assert(sizeof...(TRest) == 0 || std::is_same<typename TNode::ReturnType, bool>::value,
+            "Only the last node of a route can be a sink");
+
+    public:
+        explicit StaticRoute(TNode& node, TRest& ... rest)
+            : m_node(node),
+            m_rest(rest...)
+        {
+        }
+
+        //! Arguments are passed on as lvalues, so every node sees the same objects
+        template<typename... TArgs>
+        void operator()(TArgs&& ... args) const
+        {
+            if (call(static_cast<typename TNode::ReturnType*>(nullptr), args...)) {
+                m_rest(args...);
+            }
+        }
+
+    protected:
+        template<typename... TArgs>
+        bool call(bool*, TArgs&& ... args) const
+        {
+            return m_node.invoke(args...);
+        }
+
+        template<typename... TArgs>
+        bool call(void*, TArgs&& ... args) const
+        {
+            m_node.invoke(args...);
+            return false;
+        }
+
+        TNode&                m_node;
+        StaticRoute<TRest...> m_rest;
+    };
+
+    //! Helper - builds a StaticRoute from route nodes
+    template<typename... TNodes>
+    StaticRoute<TNodes...> makeStaticRoute(TNodes& ... nodes)
+    {
+        return StaticRoute<TNodes...>(nodes...);
+    }
+
+
     template<typename... TArgs>
     class RouteBuilder;
 
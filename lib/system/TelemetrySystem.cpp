@@ -31,12 +31,14 @@ namespace MAT_NS_BEGIN {
         :
         TelemetrySystemBase(logManager, runtimeConfig, taskDispatcher),
         compression(runtimeConfig),
-        hcm(logManager, httpClient, taskDispatcher),
+        hcm(logManager, httpClient, taskDispatcher, bandwidthController),
         httpEncoder(*this, httpClient),
+        endpoints(runtimeConfig),
         httpDecoder(*this),
         storage(*this, offlineStorage),
         packager(runtimeConfig),
-        tpm(*this, taskDispatcher, bandwidthController)
+        tpm(*this, taskDispatcher, bandwidthController),
+        coalescer(runtimeConfig, taskDispatcher)
     {
 
         // Handler for start
@@ -60,29 +62,23 @@ namespace MAT_NS_BEGIN {
             bool result = true;
             int64_t stopTimes[5] = { 0, 0, 0, 0, 0 };
 
+            // Summaries of still open coalescing windows are stored before the final upload
+            coalescer.stop();
+
             // Perform upload only if not paused
             if ((timeoutInSec > 0) && (!tpm.isPaused()))
             {
                 // perform uploads if required
                 stopTimes[0] = GetUptimeMs();
                 LOG_TRACE("Shutdown timer started...");
-                upload();
-                // Try to push thru as much data as possible.
-                // If either data is available for upload or
-                // If there's outstanding request (some records marked in-flight),
-                // then try to wait for up to config[CFG_INT_MAX_TEARDOWN_TIME]
-                while (storage.GetRecordCount() || tpm.isUploadInProgress() )
+                // Try to push thru as much data as possible within config[CFG_INT_MAX_TEARDOWN_TIME],
+                // while the RAM queue is saved to disk
+                if (!tpm.drain(std::chrono::seconds { timeoutInSec }))
                 {
-                    auto uploadTime = GetUptimeMs() - stopTimes[0];
-                    if (uploadTime >= (1000L * timeoutInSec))
-                    {
-                        // Hard-stop if it takes longer than planned
-                        LOG_TRACE("Shutdown timer expired, exiting...");
-                        break;
-                    }
-                    MAT::sleep(100);
-                    LOG_INFO("offline records=%zu, pending uploads=%zu", storage.GetRecordCount(), hcm.requestCount());
+                    // Hard-stop if it takes longer than planned
+                    LOG_TRACE("Shutdown timer expired, exiting...");
                 }
+                LOG_INFO("offline records=%zu, pending uploads=%zu", storage.GetRecordCount(), hcm.requestCount());
                 stopTimes[0] = GetUptimeMs() - stopTimes[0];
             }
 
@@ -147,14 +143,13 @@ namespace MAT_NS_BEGIN {
         };
 
         tpm.allUploadsFinished >> stats.onStop >> this->flushTaskDispatcher;
+        tpm.drainStarted >> storage.flush;
 
-        // On an arbitrary user thread
-        this->sending >> bondSerializer.serialize >> this->incomingEventPrepared;
-
-        // On the inner worker thread
-        this->preparedIncomingEvent >> storage.storeRecord >> stats.onIncomingEventAccepted >> tpm.eventArrived;
-
+        // On an arbitrary user thread: single events take m_sendingRoute (coalescer -> serializer -> incomingEventPrepared).
+        // Summaries of coalesced events are submitted when their window closes, like any other event.
+        coalescer.coalesced >> this->coalescedEventSubmitted >> bondSerializer.serialize >> this->incomingEventPrepared;
 
+        // On the inner worker thread: prepared events take m_preparedRoute (storage -> stats -> tpm)
         storage.storeRecordFailed >> stats.onIncomingEventFailed;
 
         tpm.initiateUpload >> storage.retrieveEvents;
@@ -169,13 +164,13 @@ namespace MAT_NS_BEGIN {
 #ifdef HAVE_MAT_ZLIB
         compression.compress >>
 #endif
-        httpEncoder.encode >> clockSkewDelta.encode >> stats.onUploadStarted >> hcm.sendRequest;
+        httpEncoder.encode >> endpoints.select >> clockSkewDelta.encode >> stats.onUploadStarted >> hcm.sendRequest;
 
 #ifdef HAVE_MAT_ZLIB
         compression.compressionFailed >> storage.releaseRecords >> stats.onPackagingFailed >> tpm.packagingFailed;
 #endif
 
-        hcm.requestDone >> clockSkewDelta.decode >> httpDecoder.decode;
+        hcm.requestDone >> endpoints.record >> clockSkewDelta.decode >> httpDecoder.decode;
 
         httpDecoder.eventsAccepted >> storage.deleteRecords >> stats.onUploadSuccessful >> tpm.eventsUploadSuccessful;
         httpDecoder.eventsRejected >> storage.deleteRecords >> stats.onUploadRejected >> tpm.eventsUploadRejected;
@@ -201,6 +196,7 @@ namespace MAT_NS_BEGIN {
 
     bool TelemetrySystem::upload()
     {
+        coalescer.flush();
         size_t recordCount = storage.GetRecordCount();
         if (recordCount)
         {
@@ -229,6 +225,23 @@ namespace MAT_NS_BEGIN {
         preparedIncomingEventAsync(event);
     }
 
+    void TelemetrySystem::preparedIncomingEventAsync(IncomingEventContextPtr const& event)
+    {
+        m_preparedRoute(event);
+    }
+
+    void TelemetrySystem::sendEvent(IncomingEventContextPtr const& event)
+    {
+        markSubmitted(event);
+        m_sendingRoute(event);
+    }
+
+    bool TelemetrySystem::handleCoalescedEventSubmitted(IncomingEventContextPtr const& event)
+    {
+        markSubmitted(event);
+        return true;
+    }
+
     void TelemetrySystem::handleFlushTaskDispatcher()
     {
         signalDone();
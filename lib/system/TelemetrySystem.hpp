@@ -8,6 +8,7 @@
 #include "pal/PAL.hpp"
 
 #include "system/TelemetrySystemBase.hpp"
+#include "system/EventCoalescer.hpp"
 
 #include "bond/BondSerializer.hpp"
 
@@ -15,6 +16,7 @@
 #include "compression/HttpDeflateCompression.hpp"
 #endif
 
+#include "http/CollectorEndpointPool.hpp"
 #include "http/HttpClientManager.hpp"
 #include "http/HttpRequestEncoder.hpp"
 #include "http/HttpResponseDecoder.hpp"
@@ -56,10 +58,13 @@ namespace MAT_NS_BEGIN {
 
         virtual bool upload() override;
         virtual void handleIncomingEventPrepared(IncomingEventContextPtr const& event) override;
+        virtual void preparedIncomingEventAsync(IncomingEventContextPtr const& event) override;
+        virtual void sendEvent(IncomingEventContextPtr const& event) override;
 
     protected:
 
         virtual void handleFlushTaskDispatcher() override;
+        bool handleCoalescedEventSubmitted(IncomingEventContextPtr const& event);
 
 #ifdef HAVE_MAT_ZLIB
         HttpDeflateCompression    compression;
@@ -69,15 +74,25 @@ namespace MAT_NS_BEGIN {
 
         HttpClientManager         hcm;
         HttpRequestEncoder        httpEncoder;
+        CollectorEndpointPool     endpoints;
         HttpResponseDecoder       httpDecoder;
         StorageObserver           storage;
         Packager                  packager;
         TransmissionPolicyManager tpm;
         ClockSkewDelta            clockSkewDelta;
+        EventCoalescer            coalescer;
 
     public:
         RouteSink<TelemetrySystem>                                 flushTaskDispatcher{ this, &TelemetrySystem::handleFlushTaskDispatcher };
-        RouteSink<TelemetrySystem, IncomingEventContextPtr const&> incomingEventPrepared{ this, &TelemetrySystem::handleIncomingEventPrepared };
+        MAT_BOUND_ROUTE(TelemetrySystem, handleIncomingEventPrepared) incomingEventPrepared{ this };
+        RoutePassThrough<TelemetrySystem, IncomingEventContextPtr const&> coalescedEventSubmitted{ this, &TelemetrySystem::handleCoalescedEventSubmitted };
+
+    protected:
+        // Per-event routes, composed at compile time
+        StaticRoute<decltype(EventCoalescer::coalesce), decltype(BondSerializer::serialize), decltype(TelemetrySystem::incomingEventPrepared)>
+            m_sendingRoute{ coalescer.coalesce, bondSerializer.serialize, incomingEventPrepared };
+        StaticRoute<decltype(StorageObserver::storeRecord), decltype(Statistics::onIncomingEventAccepted), decltype(TransmissionPolicyManager::eventArrived)>
+            m_preparedRoute{ storage.storeRecord, stats.onIncomingEventAccepted, tpm.eventArrived };
     };
 
 } MAT_NS_END
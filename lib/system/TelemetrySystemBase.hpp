@@ -34,6 +34,8 @@ namespace MAT_NS_BEGIN {
             m_config(runtimeConfig),
             m_isStarted(false),
             m_isPaused(false),
+            // A few uploads are in flight at most, one per latency
+            m_uploadContextPool(std::make_shared<ContextPool<EventsUploadContext>>(4)),
             stats(*this, taskDispatcher)
         {
             onStart  = []() { return true; };
@@ -129,14 +131,22 @@ namespace MAT_NS_BEGIN {
         {
         };
 
-        virtual void preparedIncomingEventAsync(IncomingEventContextPtr const& event) override
+        /// <summary>
+        /// Sets the sampler whose counts of sampled out events the stats report.
+        /// </summary>
+        /// <param name="sampler">The event sampler, owned by the log manager.</param>
+        void setEventSampler(EventSampler const* sampler) override
         {
-            preparedIncomingEvent(event);
-        };
+            stats.setEventSampler(sampler);
+        }
 
-        void sendEvent(IncomingEventContextPtr const& event) override
+        /// <summary>
+        /// Gets the delivery latency histograms recorded since start.
+        /// </summary>
+        /// <returns></returns>
+        std::vector<DeliveryLatencyStats> getDeliveryLatency() override
         {
-            sending(event);
+            return stats.getDeliveryLatencyTracker().GetStats();
         }
 
         /// <summary>
@@ -164,7 +174,9 @@ namespace MAT_NS_BEGIN {
 
         EventsUploadContextPtr createEventsUploadContext() override
         {
-            return std::make_shared<EventsUploadContext>();
+            // The deleter keeps the pool alive for contexts that outlive the system
+            auto pool = m_uploadContextPool;
+            return EventsUploadContextPtr(pool->acquire(), [pool](EventsUploadContext* ctx) { pool->release(ctx); });
         }
 
         virtual bool DispatchEvent(DebugEvent evt) override
@@ -179,6 +191,7 @@ namespace MAT_NS_BEGIN {
         std::atomic<bool>       m_isStarted;
         std::atomic<bool>       m_isPaused;
         PAL::Event              m_done;
+        std::shared_ptr<ContextPool<EventsUploadContext>> m_uploadContextPool;
         BondSerializer          bondSerializer;
         Statistics              stats;
 
@@ -188,11 +201,16 @@ namespace MAT_NS_BEGIN {
         std::function<bool(void)>                                  onResume;
         std::function<bool(void)>                                  onCleanup;
 
-    // TODO: [MG] - clean this up - get rid of RouteSource
-    public:
-        RouteSource<IncomingEventContextPtr const&>                sending;
-        RouteSource<IncomingEventContextPtr const&>                preparedIncomingEvent;
-
+        /// <summary>
+        /// Stamps the submit time used for delivery latency tracking.
+        /// </summary>
+        void markSubmitted(IncomingEventContextPtr const& event)
+        {
+            if (stats.getDeliveryLatencyTracker().IsEnabled())
+            {
+                event->submitTimestamp = PAL::getUtcSystemTimeMs();
+            }
+        }
     };
 
 } MAT_NS_END
@@ -0,0 +1,148 @@
+//
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// SPDX-License-Identifier: Apache-2.0
+//
+
+#include "TenantUploadScheduler.hpp"
+#include "utils/Utils.hpp"
+
+#include <algorithm>
+#include <limits>
+
+namespace MAT_NS_BEGIN {
+
+    MATSDK_LOG_INST_COMPONENT_CLASS(TenantUploadScheduler, "EventsSDK.TenantScheduler", "Events telemetry client - TenantUploadScheduler class");
+
+    TenantUploadScheduler::TenantUploadScheduler(IRuntimeConfig& config)
+    {
+        VariantMap& tpmConfig = config[CFG_MAP_TPM];
+        auto it = tpmConfig.find(CFG_BOOL_TPM_FAIR_UPLOAD);
+        if (it != tpmConfig.end() && it->second.type == Variant::TYPE_BOOL)
+        {
+            bool enabled = it->second;
+            m_enabled = enabled;
+        }
+
+        it = tpmConfig.find(CFG_MAP_TPM_TENANT_WEIGHTS);
+        if (it != tpmConfig.end() && it->second.type == Variant::TYPE_OBJ)
+        {
+            VariantMap& weights = it->second;
+            for (auto& kv : weights)
+            {
+                if (kv.second.type == Variant::TYPE_INT)
+                {
+                    int64_t weight = kv.second;
+                    m_weights[kv.first] = static_cast<unsigned>(std::max<int64_t>(1, std::min<int64_t>(weight, UINT16_MAX)));
+                }
+            }
+        }
+    }
+
+    unsigned TenantUploadScheduler::getWeight(std::string const& tenantId) const
+    {
+        auto it = m_weights.find(tenantId);
+        return (it != m_weights.end()) ? it->second : 1;
+    }
+
+    TenantUploadScheduler::TenantQueue& TenantUploadScheduler::getQueue(std::string const& tenantToken)
+    {
+        auto it = m_queues.find(tenantToken);
+        if (it == m_queues.end())
+        {
+            it = m_queues.emplace(tenantToken, TenantQueue()).first;
+            it->second.weight = getWeight(tenantTokenToId(tenantToken));
+        }
+        return it->second;
+    }
+
+    void TenantUploadScheduler::activate(TenantQueue& queue)
+    {
+        if (queue.active)
+        {
+            return;
+        }
+        double minTime = std::numeric_limits<double>::max();
+        for (auto const& kv : m_queues)
+        {
+            if (kv.second.active)
+            {
+                minTime = std::min(minTime, kv.second.virtualTime);
+            }
+        }
+        if (minTime != std::numeric_limits<double>::max())
+        {
+            queue.virtualTime = std::max(queue.virtualTime, minTime);
+        }
+        queue.active = true;
+    }
+
+    void TenantUploadScheduler::noteArrival(std::string const& tenantToken)
+    {
+        LOCKGUARD(m_lock);
+        activate(getQueue(tenantToken));
+    }
+
+    void TenantUploadScheduler::charge(std::string const& tenantToken, size_t eventCount)
+    {
+        LOCKGUARD(m_lock);
+        TenantQueue& queue = getQueue(tenantToken);
+        activate(queue);
+        queue.virtualTime += static_cast<double>(eventCount) / queue.weight;
+    }
+
+    void TenantUploadScheduler::release(std::string const& tenantToken)
+    {
+        LOCKGUARD(m_lock);
+        auto it = m_queues.find(tenantToken);
+        if (it != m_queues.end())
+        {
+            it->second.inFlight = false;
+        }
+    }
+
+    void TenantUploadScheduler::markIdle(std::string const& tenantToken)
+    {
+        LOCKGUARD(m_lock);
+        auto it = m_queues.find(tenantToken);
+        if (it != m_queues.end())
+        {
+            LOG_TRACE("Tenant %s has no backlog", tenantTokenToId(tenantToken).c_str());
+            it->second.active = false;
+            it->second.inFlight = false;
+        }
+    }
+
+    std::vector<std::string> TenantUploadScheduler::pickTenants(size_t maxCount)
+    {
+        LOCKGUARD(m_lock);
+        std::vector<std::pair<double, std::string>> candidates;
+        for (auto const& kv : m_queues)
+        {
+            if (kv.second.active && !kv.second.inFlight)
+            {
+                candidates.emplace_back(kv.second.virtualTime, kv.first);
+            }
+        }
+        std::sort(candidates.begin(), candidates.end());
+
+        std::vector<std::string> result;
+        for (auto const& candidate : candidates)
+        {
+            if (result.size() >= maxCount)
+            {
+                break;
+            }
+            m_queues[candidate.second].inFlight = true;
+            result.push_back(candidate.second);
+        }
+        return result;
+    }
+
+    size_t TenantUploadScheduler::activeTenantCount() const
+    {
+        LOCKGUARD(m_lock);
+        return static_cast<size_t>(std::count_if(m_queues.begin(), m_queues.end(),
+            [](std::pair<const std::string, TenantQueue> const& kv) { return kv.second.active; }));
+    }
+
+} MAT_NS_END
@@ -0,0 +1,101 @@
+//
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// SPDX-License-Identifier: Apache-2.0
+//
+#ifndef TENANTUPLOADSCHEDULER_HPP
+#define TENANTUPLOADSCHEDULER_HPP
+
+#include "api/IRuntimeConfig.hpp"
+#include "pal/PAL.hpp"
+
+#include <cstdint>
+#include <map>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace MAT_NS_BEGIN {
+
+    /// <summary>
+    /// Weighted fair queueing of tenants sharing one offline storage.
+    /// Every tenant with a backlog owns a virtual queue whose virtual time
+    /// is the number of events uploaded for it divided by its weight.
+    /// Each upload round builds one package per tenant, starting with the
+    /// tenants that are furthest behind, so one noisy tenant cannot fill
+    /// every package and starve the others.
+    /// </summary>
+    class TenantUploadScheduler
+    {
+    public:
+        TenantUploadScheduler(IRuntimeConfig& config);
+
+        /// <summary>
+        /// Returns true if fair tenant scheduling is enabled in CFG_MAP_TPM.
+        /// </summary>
+        bool isEnabled() const noexcept
+        {
+            return m_enabled;
+        }
+
+        /// <summary>
+        /// Marks the tenant as having a backlog. A tenant joining the active
+        /// set starts at the current virtual time instead of claiming credit
+        /// for the period it was idle.
+        /// </summary>
+        void noteArrival(std::string const& tenantToken);
+
+        /// <summary>
+        /// Accounts events of the tenant that were taken out of storage, by its
+        /// own package or by a generic one.
+        /// </summary>
+        void charge(std::string const& tenantToken, size_t eventCount);
+
+        /// <summary>
+        /// Releases the in-flight package slot the tenant got from pickTenants().
+        /// </summary>
+        void release(std::string const& tenantToken);
+
+        /// <summary>
+        /// Marks the tenant as having no backlog left.
+        /// </summary>
+        void markIdle(std::string const& tenantToken);
+
+        /// <summary>
+        /// Picks up to maxCount active tenants without a package in flight,
+        /// ordered by ascending virtual time, and marks them in flight.
+        /// </summary>
+        std::vector<std::string> pickTenants(size_t maxCount);
+
+        /// <summary>
+        /// Returns number of tenants that currently have a backlog.
+        /// </summary>
+        size_t activeTenantCount() const;
+
+        /// <summary>
+        /// Returns the configured weight of a tenant (1 if not configured).
+        /// </summary>
+        unsigned getWeight(std::string const& tenantId) const;
+
+    protected:
+        struct TenantQueue
+        {
+            double   virtualTime { 0.0 };
+            unsigned weight { 1 };
+            bool     active { false };
+            bool     inFlight { false };
+        };
+
+        TenantQueue& getQueue(std::string const& tenantToken);
+        void activate(TenantQueue& queue);
+
+        mutable std::mutex                  m_lock;
+        bool                                m_enabled { false };
+        std::map<std::string, unsigned>     m_weights;
+        std::map<std::string, TenantQueue>  m_queues;
+
+        MATSDK_LOG_DECL_COMPONENT_CLASS();
+    };
+
+} MAT_NS_END
+
+#endif // TENANTUPLOADSCHEDULER_HPP
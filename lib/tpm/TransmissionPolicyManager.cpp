@@ -5,8 +5,10 @@
 
 #include "TransmissionPolicyManager.hpp"
 #include "TransmitProfiles.hpp"
+#include "offline/KillSwitchManager.hpp"
 #include "utils/Utils.hpp"
 
+#include <algorithm>
 #include <limits>
 
 namespace MAT_NS_BEGIN {
@@ -41,13 +43,25 @@ namespace MAT_NS_BEGIN {
         return (a > b) ? (a - b) : (b - a);
     }
 
+    static int getRetryAfterMs(EventsUploadContextPtr const& ctx)
+    {
+        if (ctx->httpResponse == nullptr)
+        {
+            return 0;
+        }
+        int64_t secs = KillSwitchManager::getRetryAfterSecs(ctx->httpResponse->GetHeaders());
+        return static_cast<int>(std::min<int64_t>(secs, std::numeric_limits<int>::max() / 1000) * 1000);
+    }
+
     MATSDK_LOG_INST_COMPONENT_CLASS(TransmissionPolicyManager, "EventsSDK.TPM", "Events telemetry client - TransmissionPolicyManager class");
 
     TransmissionPolicyManager::TransmissionPolicyManager(ITelemetrySystem& system, ITaskDispatcher& taskDispatcher, IBandwidthController* bandwidthController) :
         m_system(system),
         m_taskDispatcher(taskDispatcher),
         m_config(m_system.getConfig()),
-        m_bandwidthController(bandwidthController)
+        m_bandwidthController(bandwidthController),
+        m_tenantScheduler(m_config),
+        m_uploadTrigger(m_config)
     {
         m_backoff = IBackoff::createFromConfig(m_backoffConfig);
         assert(m_backoff);
@@ -62,6 +76,15 @@ namespace MAT_NS_BEGIN {
     void TransmissionPolicyManager::checkBackoffConfigUpdate()
     {
         LOCKGUARD(m_backoffMutex);
+        // Backoff is bumped on every failed upload: avoid re-reading and
+        // comparing the config string more than once per interval.
+        uint64_t now = PAL::getMonotonicTimeMs();
+        if (m_backoff && now < m_backoffConfigCheckTime)
+        {
+            return;
+        }
+        m_backoffConfigCheckTime = now + BackoffConfigCheckIntervalMs;
+
         std::string config = m_config.GetUploadRetryBackoffConfig();
         if (config != m_backoffConfig)
         {
@@ -74,28 +97,51 @@ namespace MAT_NS_BEGIN {
             {
                 m_backoff = std::move(backoff);
                 m_backoffConfig = config;
+                m_endpointBackoffs.clear();
             }
         }
     }
 
-    void TransmissionPolicyManager::resetBackoff()
+    IBackoff* TransmissionPolicyManager::getBackoff(std::string const& endpoint)
     {
         LOCKGUARD(m_backoffMutex);
-        if (m_backoff)
-            m_backoff->reset();
+        if (endpoint.empty())
+        {
+            return m_backoff.get();
+        }
+
+        auto it = m_endpointBackoffs.find(endpoint);
+        if (it == m_endpointBackoffs.end())
+        {
+            it = m_endpointBackoffs.emplace(endpoint, IBackoff::createFromConfig(m_backoffConfig)).first;
+        }
+        return it->second.get();
     }
 
-    std::chrono::milliseconds TransmissionPolicyManager::increaseBackoff()
+    void TransmissionPolicyManager::resetBackoff(std::string const& endpoint)
+    {
+        LOCKGUARD(m_backoffMutex);
+        IBackoff* backoff = getBackoff(endpoint);
+        if (backoff)
+            backoff->reset();
+    }
+
+    std::chrono::milliseconds TransmissionPolicyManager::increaseBackoff(std::string const& endpoint, int retryAfterMs)
     {
         LOCKGUARD(m_backoffMutex);
         checkBackoffConfigUpdate();
-        if (m_backoff == nullptr)
+        IBackoff* backoff = getBackoff(endpoint);
+        if (backoff == nullptr)
         {
             return std::chrono::milliseconds{};
         }
 
-        std::chrono::milliseconds delay{m_backoff->getValue()};
-        m_backoff->increase();
+        if (retryAfterMs > 0)
+        {
+            backoff->setRetryAfter(retryAfterMs);
+        }
+        std::chrono::milliseconds delay{backoff->getValue()};
+        backoff->increase();
         return delay;
     }
 
@@ -122,6 +168,11 @@ namespace MAT_NS_BEGIN {
             LOG_TRACE("Scheduled upload aborted, no upload.");
             return;
         }
+        if (m_isDraining)
+        {
+            LOG_TRACE("Draining before shutdown, no upload scheduled.");
+            return;
+        }
         if (uploadCount() >= static_cast<uint32_t>(m_config[CFG_INT_MAX_PENDING_REQ]) )
         {
             LOG_TRACE("Maximum number of HTTP requests reached");
@@ -186,6 +237,10 @@ namespace MAT_NS_BEGIN {
         }
         m_runningLatency = latency;
         m_scheduledUploadTime = std::numeric_limits<uint64_t>::max();
+        if (m_uploadTrigger.isEnabled())
+        {
+            m_uploadTrigger.onUploadStarted(latency);
+        }
 
         {
             LOCKGUARD(m_scheduledUploadMutex);
@@ -216,10 +271,125 @@ namespace MAT_NS_BEGIN {
         }
 #endif
 
-        auto ctx = m_system.createEventsUploadContext();
-        ctx->requestedMinLatency = m_runningLatency;
-        addUpload(ctx);
-        initiateUpload(ctx);
+        if (m_bandwidthController) {
+            unsigned delayMs = m_bandwidthController->GetSendDelayMs(latency);
+            if (delayMs > 0) {
+                LOG_TRACE("Upload budget of lat=%d exhausted, will retry %u ms later", latency, delayMs);
+                scheduleUpload(std::chrono::milliseconds { delayMs }, latency);
+                return;
+            }
+        }
+
+        if (!m_tenantScheduler.isEnabled())
+        {
+            auto ctx = m_system.createEventsUploadContext();
+            ctx->requestedMinLatency = m_runningLatency;
+            addUpload(ctx);
+            initiateUpload(ctx);
+            return;
+        }
+
+        // One package per tenant, tenants furthest behind their fair share first,
+        // uploaded concurrently up to the pending request limit.
+        size_t maxPending = static_cast<uint32_t>(m_config[CFG_INT_MAX_PENDING_REQ]);
+        size_t pending = uploadCount();
+        auto tenants = m_tenantScheduler.pickTenants(std::max<size_t>(1, (maxPending > pending) ? (maxPending - pending) : 0));
+        if (tenants.empty())
+        {
+            if (m_tenantScheduler.activeTenantCount() > 0)
+            {
+                // Every tenant with a backlog has a package in flight already,
+                // the upload finishing first schedules the next one.
+                LOG_TRACE("All tenants have an upload in progress");
+                return;
+            }
+            // No known backlog (e.g. events persisted by a previous session):
+            // a regular package discovers the tenants present in storage.
+            tenants.push_back(std::string());
+        }
+        for (auto const& tenantToken : tenants)
+        {
+            auto ctx = m_system.createEventsUploadContext();
+            ctx->requestedMinLatency = m_runningLatency;
+            ctx->requestedTenantToken = tenantToken;
+            addUpload(ctx);
+            initiateUpload(ctx);
+        }
+    }
+
+    bool TransmissionPolicyManager::drain(std::chrono::milliseconds timeout)
+    {
+        {
+            LOCKGUARD(m_scheduledUploadMutex);
+            // The drain takes over from the regular upload timer
+            cancelUploadTask();
+        }
+        {
+            LOCKGUARD(m_activeUploads_lock);
+            m_isDraining = true;
+            m_isDrained = false;
+            m_drainExhausted = false;
+            m_drainDeadline = PAL::getMonotonicTimeMs() + static_cast<uint64_t>(std::max<int64_t>(0, timeout.count()));
+        }
+        auto deadline = std::chrono::steady_clock::now() + timeout;
+        scheduleDrain();
+
+        // Meanwhile, on this thread (e.g. moving the RAM queue to disk)
+        drainStarted();
+
+        std::unique_lock<std::mutex> lock(m_activeUploads_lock);
+        bool drained = m_drainChanged.wait_until(lock, deadline, [this]() { return m_isDrained; });
+        m_isDraining = false;
+        LOG_TRACE("Drain %s with %zu uploads in progress", drained ? "done" : "timed out", m_activeUploads.size());
+        return drained;
+    }
+
+    void TransmissionPolicyManager::scheduleDrain()
+    {
+        {
+            LOCKGUARD(m_activeUploads_lock);
+            if (m_isDrainScheduled)
+            {
+                return;
+            }
+            m_isDrainScheduled = true;
+        }
+        m_drainTask = PAL::scheduleTask(&m_taskDispatcher, 0, this, &TransmissionPolicyManager::drainAsync);
+    }
+
+    // Runs on the worker thread at the start of the drain and after every upload finishing during it.
+    // No PauseGuard: FlushAndTeardown pauses the log manager before the system is stopped.
+    void TransmissionPolicyManager::drainAsync()
+    {
+        size_t maxPending = static_cast<uint32_t>(m_config[CFG_INT_MAX_PENDING_REQ]);
+        for (;;)
+        {
+            {
+                LOCKGUARD(m_activeUploads_lock);
+                m_isDrainScheduled = false;
+                if (!m_isDraining || m_isDrained)
+                {
+                    return;
+                }
+                int durationMs = m_uploadDurationMs;
+                bool fits = (durationMs < 0) || (PAL::getMonotonicTimeMs() + static_cast<uint64_t>(durationMs) <= m_drainDeadline);
+                if (m_isPaused || !m_config.IsCollectorUrlSet() || m_drainExhausted || !fits || (m_activeUploads.size() >= maxPending))
+                {
+                    if (m_activeUploads.empty())
+                    {
+                        m_isDrained = true;
+                        m_drainChanged.notify_all();
+                    }
+                    return;
+                }
+            }
+            // Storage reserves the events of the package right away, so the next
+            // upload of the loop picks up where this one ends
+            auto ctx = m_system.createEventsUploadContext();
+            ctx->requestedMinLatency = EventLatency_Normal;
+            addUpload(ctx);
+            initiateUpload(ctx);
+        }
     }
 
     void TransmissionPolicyManager::finishUpload(EventsUploadContextPtr const& ctx, const std::chrono::milliseconds& nextUpload)
@@ -231,6 +401,43 @@ namespace MAT_NS_BEGIN {
             LOG_WARN("HTTP NOT removing non-existing ctx from active uploads ctx=%p", ctx.get());
         }
 
+        if (m_tenantScheduler.isEnabled())
+        {
+            std::map<std::string, size_t> eventCounts;
+            for (auto const& item : ctx->recordIdsAndTenantIds)
+            {
+                eventCounts[item.second]++;
+            }
+            for (auto const& tenant : eventCounts)
+            {
+                m_tenantScheduler.charge(tenant.first, tenant.second);
+            }
+            // Only the package picked for a tenant holds its in-flight slot; a generic
+            // package with events of a tenant must not free the slot of its own package
+            if (!ctx->requestedTenantToken.empty())
+            {
+                if (eventCounts.count(ctx->requestedTenantToken) == 0)
+                {
+                    m_tenantScheduler.markIdle(ctx->requestedTenantToken);
+                }
+                else
+                {
+                    m_tenantScheduler.release(ctx->requestedTenantToken);
+                }
+            }
+        }
+
+        if (m_isDraining)
+        {
+            {
+                LOCKGUARD(m_activeUploads_lock);
+                // Only a successful upload keeps the drain going, anything else is left for the next session
+                m_drainExhausted |= (nextUpload.count() != 0);
+            }
+            scheduleDrain();
+            return;
+        }
+
         PauseGuard guard(m_system.getLogManager());
         if (guard.isPaused()) {
             return;
@@ -287,6 +494,7 @@ namespace MAT_NS_BEGIN {
             // Make sure we wait for completion of the upload scheduling task that may be running
             cancelUploadTask();
         }
+        m_drainTask.Cancel(getCancelWaitTime().count());
 
         // Make sure we wait for all active upload callbacks to finish
         while (uploadCount() > 0)
@@ -331,6 +539,11 @@ namespace MAT_NS_BEGIN {
         }
         bool forceTimerRestart = false;
 
+        if (m_tenantScheduler.isEnabled())
+        {
+            m_tenantScheduler.noteArrival(event->record.tenantToken);
+        }
+
         /* This logic needs to be revised: one event in a dedicated HTTP post is wasteful! */
         // Initiate upload right away
         if (event->record.latency > EventLatency_RealTime) {
@@ -341,6 +554,12 @@ namespace MAT_NS_BEGIN {
             return;
         }
 
+        if (m_uploadTrigger.isEnabled())
+        {
+            triggerUpload(event->record.latency, event->record.blob.size());
+            return;
+        }
+
         // Schedule async upload if not scheduled yet
         if (!m_isUploadScheduled || TransmitProfiles::isTimerUpdateRequired())
         {
@@ -357,6 +576,31 @@ namespace MAT_NS_BEGIN {
         }
     }
 
+    void TransmissionPolicyManager::triggerUpload(EventLatency latency, size_t bytes)
+    {
+        updateTimersIfNecessary();
+        if (m_uploadTrigger.onEventQueued(latency, bytes))
+        {
+            scheduleUpload(std::chrono::milliseconds {}, (m_isUploadScheduled ? std::min(latency, m_runningLatency) : latency), true);
+            return;
+        }
+
+        // Bring the scheduled upload forward if this event must go out sooner
+        auto maxDelay = m_uploadTrigger.getMaxDelay(latency, m_timers);
+        if (maxDelay.count() < 0)
+        {
+            return;
+        }
+        if (!m_isUploadScheduled)
+        {
+            scheduleUpload(maxDelay, latency);
+        }
+        else if (PAL::getMonotonicTimeMs() + static_cast<uint64_t>(maxDelay.count()) < m_scheduledUploadTime)
+        {
+            scheduleUpload(maxDelay, std::min(latency, m_runningLatency), true);
+        }
+    }
+
     // We do only Normal if too few values or timers[0] == timers[2]
     // We do only RealTime if timers[0] < 0 (do not transmit)
     // We alternate RealTime and Normal otherwise (timers differ)
@@ -385,8 +629,19 @@ namespace MAT_NS_BEGIN {
     void TransmissionPolicyManager::handleNothingToUpload(EventsUploadContextPtr const& ctx)
     {
         LOG_TRACE("No stored events to send at the moment");
-        resetBackoff();
-        if (ctx->requestedMinLatency == EventLatency_Normal)
+        {
+            // Storage is empty, so no endpoint has a failed package left to retry
+            LOCKGUARD(m_backoffMutex);
+            m_endpointBackoffs.clear();
+        }
+        resetBackoff(ctx->collectorUrl);
+        if (m_uploadTrigger.isEnabled())
+        {
+            // Events of lower latency left behind still need the next upload,
+            // otherwise stay idle until the next event arrives.
+            finishUpload(ctx, m_uploadTrigger.hasQueuedEvents() ? m_timerdelay : std::chrono::milliseconds{ -1 });
+        }
+        else if (ctx->requestedMinLatency == EventLatency_Normal)
         {
             finishUpload(ctx, std::chrono::milliseconds{ -1 });
         }
@@ -403,18 +658,23 @@ namespace MAT_NS_BEGIN {
 
     void TransmissionPolicyManager::handleEventsUploadSuccessful(EventsUploadContextPtr const& ctx)
     {
-        resetBackoff();
+        if (ctx->durationMs >= 0)
+        {
+            int durationMs = m_uploadDurationMs;
+            m_uploadDurationMs = (durationMs < 0) ? ctx->durationMs : (3 * durationMs + ctx->durationMs) / 4;
+        }
+        resetBackoff(ctx->collectorUrl);
         finishUpload(ctx, std::chrono::milliseconds{});
     }
 
     void TransmissionPolicyManager::handleEventsUploadRejected(EventsUploadContextPtr const& ctx)
     {
-        finishUpload(ctx, increaseBackoff());
+        finishUpload(ctx, increaseBackoff(ctx->collectorUrl, getRetryAfterMs(ctx)));
     }
 
     void TransmissionPolicyManager::handleEventsUploadFailed(EventsUploadContextPtr const& ctx)
     {
-        finishUpload(ctx, increaseBackoff());
+        finishUpload(ctx, increaseBackoff(ctx->collectorUrl, getRetryAfterMs(ctx)));
     }
 
     void TransmissionPolicyManager::handleEventsUploadAborted(EventsUploadContextPtr const& ctx)
@@ -16,14 +16,18 @@
 #include "system/ITelemetrySystem.hpp"
 
 #include "DeviceStateHandler.hpp"
+#include "TenantUploadScheduler.hpp"
+#include "UploadTrigger.hpp"
 #include "pal/TaskDispatcher.hpp"
 
 #include "TransmitProfiles.hpp"
 
 #include <atomic>
 #include <chrono>
+#include <condition_variable>
 #include <cstdint>
 #include <limits>
+#include <map>
 #include <set>
 
 namespace MAT_NS_BEGIN {
@@ -42,6 +46,9 @@ constexpr std::chrono::milliseconds DefaultTaskCancelTime { 500 };
 
 constexpr const char* const DefaultBackoffConfig = "E,3000,300000,2,1";
 
+// Minimum interval between re-reading the backoff configuration string
+constexpr uint64_t BackoffConfigCheckIntervalMs = 1000;
+
     class TransmissionPolicyManager
     {
 
@@ -50,13 +57,26 @@ constexpr const char* const DefaultBackoffConfig = "E,3000,300000,2,1";
         virtual ~TransmissionPolicyManager();
         virtual void scheduleUpload(const std::chrono::milliseconds& delay, EventLatency latency, bool force = false);
 
+        /// <summary>
+        /// Uploads what is left in storage before shutdown, up to CFG_INT_MAX_PENDING_REQ
+        /// requests at a time, and returns as soon as the last one is done. An upload that
+        /// fails or finds nothing to send ends the drain, and no upload is started that is
+        /// not expected to finish before the timeout.
+        /// </summary>
+        /// <param name="timeout">Time left for the shutdown uploads.</param>
+        /// <returns>false if uploads were still in progress at the timeout</returns>
+        virtual bool drain(std::chrono::milliseconds timeout);
+
     protected:
         MATSDK_LOG_DECL_COMPONENT_CLASS();
         void checkBackoffConfigUpdate();
-        void resetBackoff();
-        std::chrono::milliseconds increaseBackoff();
+        void resetBackoff(std::string const& endpoint = std::string());
+        std::chrono::milliseconds increaseBackoff(std::string const& endpoint = std::string(), int retryAfterMs = 0);
+        IBackoff* getBackoff(std::string const& endpoint);
 
         void uploadAsync(EventLatency priority);
+        void scheduleDrain();
+        void drainAsync();
         void finishUpload(EventsUploadContextPtr const& ctx, const std::chrono::milliseconds& nextUpload);
         bool updateTimersIfNecessary();
 
@@ -67,6 +87,7 @@ constexpr const char* const DefaultBackoffConfig = "E,3000,300000,2,1";
         void handleFinishAllUploads();
 
         void handleEventArrived(IncomingEventContextPtr const& event);
+        void triggerUpload(EventLatency latency, size_t bytes);
 
         void handleNothingToUpload(EventsUploadContextPtr const& ctx);
         void handlePackagingFailed(EventsUploadContextPtr const& ctx);
@@ -83,10 +104,14 @@ constexpr const char* const DefaultBackoffConfig = "E,3000,300000,2,1";
         ITaskDispatcher&                 m_taskDispatcher;
         IRuntimeConfig&                  m_config;
         IBandwidthController*            m_bandwidthController;
+        TenantUploadScheduler            m_tenantScheduler;
+        UploadTrigger                    m_uploadTrigger;
 
         std::recursive_mutex             m_backoffMutex;
         std::string                      m_backoffConfig { DefaultBackoffConfig };
         std::unique_ptr<IBackoff>        m_backoff;
+        std::map<std::string, std::unique_ptr<IBackoff>> m_endpointBackoffs;
+        uint64_t                         m_backoffConfigCheckTime { 0 };
         DeviceStateHandler               m_deviceStateHandler;
 
         std::atomic<bool>                m_isPaused { true };
@@ -98,6 +123,18 @@ constexpr const char* const DefaultBackoffConfig = "E,3000,300000,2,1";
 
         mutable std::mutex               m_activeUploads_lock;
         std::set<EventsUploadContextPtr> m_activeUploads;
+
+        // Shutdown drain state, guarded by m_activeUploads_lock
+        std::condition_variable          m_drainChanged;
+        std::atomic<bool>                m_isDraining { false };
+        bool                             m_isDrained { false };
+        bool                             m_drainExhausted { false };
+        bool                             m_isDrainScheduled { false };
+        uint64_t                         m_drainDeadline { 0 };
+        PAL::DeferredCallbackHandle      m_drainTask;
+
+        // Smoothed duration of successful uploads, negative until the first one
+        std::atomic<int>                 m_uploadDurationMs { -1 };
         
         /// <summary>
         /// Thread-safe method to add the upload to active uploads.
@@ -141,8 +178,9 @@ constexpr const char* const DefaultBackoffConfig = "E,3000,300000,2,1";
         RoutePassThrough<TransmissionPolicyManager>                          cleanup{ this,&TransmissionPolicyManager::handleCleanup };
         RouteSink<TransmissionPolicyManager>                                 finishAllUploads{ this, &TransmissionPolicyManager::handleFinishAllUploads };
         RouteSource<>                                                        allUploadsFinished;
+        RouteSource<>                                                        drainStarted;
 
-        RouteSink<TransmissionPolicyManager, IncomingEventContextPtr const&> eventArrived{ this, &TransmissionPolicyManager::handleEventArrived };
+        MAT_BOUND_ROUTE(TransmissionPolicyManager, handleEventArrived)       eventArrived{ this };
 
         RouteSource<EventsUploadContextPtr const&>                           initiateUpload;
         RouteSink<TransmissionPolicyManager, EventsUploadContextPtr const&>  nothingToUpload{ this, &TransmissionPolicyManager::handleNothingToUpload };
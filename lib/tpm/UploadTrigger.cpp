@@ -0,0 +1,121 @@
+//
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// SPDX-License-Identifier: Apache-2.0
+//
+
+#include "UploadTrigger.hpp"
+#include "utils/StringUtils.hpp"
+
+#include <algorithm>
+
+namespace MAT_NS_BEGIN {
+
+    MATSDK_LOG_INST_COMPONENT_CLASS(UploadTrigger, "EventsSDK.UploadTrigger", "Events telemetry client - UploadTrigger class");
+
+    UploadTrigger::UploadTrigger(IRuntimeConfig& config)
+    {
+        for (auto& maxDelayMs : m_maxDelayMs)
+        {
+            maxDelayMs = -1;
+        }
+
+        VariantMap& tpmConfig = config[CFG_MAP_TPM];
+        auto it = tpmConfig.find(CFG_BOOL_TPM_EVENT_TRIGGERS);
+        if (it != tpmConfig.end() && it->second.type == Variant::TYPE_BOOL)
+        {
+            bool enabled = it->second;
+            m_enabled = enabled;
+        }
+
+        it = tpmConfig.find(CFG_INT_TPM_WATERMARK_COUNT);
+        if (it != tpmConfig.end() && it->second.type == Variant::TYPE_INT)
+        {
+            int64_t count = it->second;
+            m_watermarkCount = static_cast<size_t>(std::max<int64_t>(0, count));
+        }
+
+        it = tpmConfig.find(CFG_INT_TPM_WATERMARK_BYTES);
+        if (it != tpmConfig.end() && it->second.type == Variant::TYPE_INT)
+        {
+            int64_t bytes = it->second;
+            m_watermarkBytes = static_cast<size_t>(std::max<int64_t>(0, bytes));
+        }
+
+        it = tpmConfig.find(CFG_MAP_TPM_MAX_DELAY);
+        if (it != tpmConfig.end() && it->second.type == Variant::TYPE_OBJ)
+        {
+            VariantMap& delays = it->second;
+            for (int latency = EventLatency_Off; latency <= EventLatency_Max; latency++)
+            {
+                auto delay = delays.find(latencyToStr(static_cast<EventLatency>(latency)));
+                if (delay != delays.end() && delay->second.type == Variant::TYPE_INT)
+                {
+                    int64_t delayMs = delay->second;
+                    m_maxDelayMs[latency] = delayMs;
+                }
+            }
+        }
+    }
+
+    bool UploadTrigger::onEventQueued(EventLatency latency, size_t bytes)
+    {
+        if (latency < EventLatency_Off || latency > EventLatency_Max)
+        {
+            return false;
+        }
+
+        LOCKGUARD(m_lock);
+        Queue& queue = m_queues[latency];
+        queue.count++;
+        queue.bytes += bytes;
+        bool crossed = ((m_watermarkCount != 0) && (queue.count >= m_watermarkCount)) ||
+                       ((m_watermarkBytes != 0) && (queue.bytes >= m_watermarkBytes));
+        if (crossed)
+        {
+            LOG_TRACE("Watermark crossed for lat=%d: %u events, %u bytes queued",
+                latency, static_cast<unsigned>(queue.count), static_cast<unsigned>(queue.bytes));
+        }
+        return crossed;
+    }
+
+    void UploadTrigger::onUploadStarted(EventLatency minLatency)
+    {
+        LOCKGUARD(m_lock);
+        for (int latency = std::max<int>(EventLatency_Off, minLatency); latency <= EventLatency_Max; latency++)
+        {
+            m_queues[latency] = Queue();
+        }
+    }
+
+    bool UploadTrigger::hasQueuedEvents() const
+    {
+        LOCKGUARD(m_lock);
+        for (auto const& queue : m_queues)
+        {
+            if (queue.count != 0)
+            {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    std::chrono::milliseconds UploadTrigger::getMaxDelay(EventLatency latency, TimerArray const& timers) const
+    {
+        if (latency < EventLatency_Off || latency > EventLatency_Max)
+        {
+            latency = EventLatency_Normal;
+        }
+        if (m_maxDelayMs[latency] >= 0)
+        {
+            return std::chrono::milliseconds { m_maxDelayMs[latency] };
+        }
+        if (latency == EventLatency_Max)
+        {
+            return std::chrono::milliseconds {};
+        }
+        // Same mapping as the timer-driven schedule: timers[1] is the real-time timer
+        return std::chrono::milliseconds { (latency >= EventLatency_RealTime) ? timers[1] : timers[0] };
+    }
+
+} MAT_NS_END
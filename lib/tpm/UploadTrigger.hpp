@@ -0,0 +1,81 @@
+//
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// SPDX-License-Identifier: Apache-2.0
+//
+#ifndef UPLOADTRIGGER_HPP
+#define UPLOADTRIGGER_HPP
+
+#include "api/IRuntimeConfig.hpp"
+#include "pal/PAL.hpp"
+
+#include "TransmitProfiles.hpp"
+
+#include <chrono>
+#include <cstdint>
+#include <mutex>
+
+namespace MAT_NS_BEGIN {
+
+    /// <summary>
+    /// Event-driven upload triggers. Tracks count and bytes of events queued
+    /// per latency since the last upload of that latency. An upload is due
+    /// immediately once either watermark is crossed, otherwise no later than
+    /// the max delay of the latency. Nothing is due while the queues are empty,
+    /// so an idle process does not wake up to poll the storage.
+    /// </summary>
+    class UploadTrigger
+    {
+    public:
+        UploadTrigger(IRuntimeConfig& config);
+
+        /// <summary>
+        /// Returns true if event-driven triggers are enabled in CFG_MAP_TPM.
+        /// </summary>
+        bool isEnabled() const noexcept
+        {
+            return m_enabled;
+        }
+
+        /// <summary>
+        /// Accounts a newly queued event.
+        /// </summary>
+        /// <returns>true if a watermark of the event latency has been crossed</returns>
+        bool onEventQueued(EventLatency latency, size_t bytes);
+
+        /// <summary>
+        /// Resets the queues that an upload of the given minimum latency drains.
+        /// </summary>
+        void onUploadStarted(EventLatency minLatency);
+
+        /// <summary>
+        /// Returns true if any event was queued since the last upload.
+        /// </summary>
+        bool hasQueuedEvents() const;
+
+        /// <summary>
+        /// Returns the max delay of the latency: configured in CFG_MAP_TPM_MAX_DELAY
+        /// or taken from the current transmit profile timers. Negative means the
+        /// latency must not be uploaded by timer.
+        /// </summary>
+        std::chrono::milliseconds getMaxDelay(EventLatency latency, TimerArray const& timers) const;
+
+    protected:
+        struct Queue
+        {
+            size_t count { 0 };
+            size_t bytes { 0 };
+        };
+
+        mutable std::mutex  m_lock;
+        bool                m_enabled { false };
+        size_t              m_watermarkCount { 0 };
+        size_t              m_watermarkBytes { 0 };
+        int64_t             m_maxDelayMs[EventLatency_Max + 1];
+        Queue               m_queues[EventLatency_Max + 1];
+
+        MATSDK_LOG_DECL_COMPONENT_CLASS();
+    };
+
+} MAT_NS_END
+
+#endif // UPLOADTRIGGER_HPP
@@ -0,0 +1,115 @@
+//
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// SPDX-License-Identifier: Apache-2.0
+//
+#ifndef BENCHMARKCOMMON_HPP
+#define BENCHMARKCOMMON_HPP
+
+#include "mat/config.h"
+
+#include <benchmark/benchmark.h>
+
+#include "CsProtocol_types.hpp"
+#include "IHttpClient.hpp"
+#include "IOfflineStorage.hpp"
+
+#include <atomic>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace benchmarks {
+
+    /// <summary>
+    /// Process-wide heap allocation counters, maintained by the global
+    /// operator new replacement in Main.cpp.
+    /// </summary>
+    struct AllocationStats
+    {
+        static std::atomic<uint64_t> count;
+        static std::atomic<uint64_t> bytes;
+    };
+
+    /// <summary>
+    /// Snapshots the allocation counters and reports the difference as
+    /// allocs/op and bytes/op counters of the benchmark. Background SDK
+    /// threads allocating meanwhile are attributed to the benchmark too.
+    /// </summary>
+    class AllocationCounter
+    {
+    public:
+        AllocationCounter() :
+            m_count(AllocationStats::count.load()),
+            m_bytes(AllocationStats::bytes.load())
+        {
+        }
+
+        void report(benchmark::State& state) const
+        {
+            state.counters["allocs/op"] = benchmark::Counter(static_cast<double>(AllocationStats::count.load() - m_count), benchmark::Counter::kAvgIterations);
+            state.counters["bytes/op"] = benchmark::Counter(static_cast<double>(AllocationStats::bytes.load() - m_bytes), benchmark::Counter::kAvgIterations);
+        }
+
+    private:
+        uint64_t m_count;
+        uint64_t m_bytes;
+    };
+
+    /// <summary>
+    /// HTTP client which never touches the network: every request
+    /// immediately succeeds with an empty 200 response.
+    /// </summary>
+    class NullHttpClient : public MAT::IHttpClient
+    {
+    public:
+        virtual MAT::IHttpRequest* CreateRequest() override
+        {
+            return new MAT::SimpleHttpRequest(std::to_string(++m_lastId));
+        }
+
+        virtual void SendRequestAsync(MAT::IHttpRequest* request, MAT::IHttpResponseCallback* callback) override
+        {
+            MAT::SimpleHttpResponse* response = new MAT::SimpleHttpResponse(request->GetId());
+            response->m_result = MAT::HttpResult_OK;
+            response->m_statusCode = 200;
+            callback->OnHttpResponse(response);
+        }
+
+        virtual void CancelRequestAsync(std::string const&) override
+        {
+        }
+
+    private:
+        std::atomic<uint64_t> m_lastId { 0 };
+    };
+
+    /// <summary>
+    /// Storage observer ignoring all notifications.
+    /// </summary>
+    class NullStorageObserver : public MAT::IOfflineStorageObserver
+    {
+    public:
+        virtual void OnStorageOpened(std::string const&) override {}
+        virtual void OnStorageFailed(std::string const&) override {}
+        virtual void OnStorageOpenFailed(std::string const&) override {}
+        virtual void OnStorageTrimmed(std::map<std::string, size_t> const&) override {}
+        virtual void OnStorageRecordsDropped(std::map<std::string, size_t> const&) override {}
+        virtual void OnStorageRecordsRejected(std::map<std::string, size_t> const&) override {}
+        virtual void OnStorageRecordsSaved(size_t) override {}
+    };
+
+    extern const char* const BenchmarkTenantToken;
+
+    /// <summary>
+    /// Builds a Common Schema record resembling a typical custom event.
+    /// </summary>
+    CsProtocol::Record makeRecord(size_t propertyCount);
+
+    /// <summary>
+    /// Builds a storage record with a pseudo-random blob of the given size.
+    /// </summary>
+    MAT::StorageRecord makeStorageRecord(size_t index, size_t blobSize);
+
+} // namespace benchmarks
+
+#endif
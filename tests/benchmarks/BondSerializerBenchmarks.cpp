@@ -0,0 +1,27 @@
+//
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// SPDX-License-Identifier: Apache-2.0
+//
+#include "BenchmarkCommon.hpp"
+#include "bond/BondSerializer.hpp"
+
+using namespace MAT;
+using namespace benchmarks;
+
+static void BondSerializer_Serialize(benchmark::State& state)
+{
+    BondSerializer serializer;
+    CsProtocol::Record record = makeRecord(static_cast<size_t>(state.range(0)));
+
+    AllocationCounter counter;
+    for (auto _ : state)
+    {
+        IncomingEventContext event("record-id", BenchmarkTenantToken, EventLatency_Normal, EventPersistence_Normal, &record);
+        IncomingEventContextPtr ctx = &event;
+        serializer.serialize(ctx);
+        benchmark::DoNotOptimize(event.record.blob.data());
+        state.SetBytesProcessed(state.bytes_processed() + static_cast<int64_t>(event.record.blob.size()));
+    }
+    counter.report(state);
+}
+BENCHMARK(BondSerializer_Serialize)->Arg(4)->Arg(32);
@@ -0,0 +1,36 @@
+//
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// SPDX-License-Identifier: Apache-2.0
+//
+#include "BenchmarkCommon.hpp"
+#include "packager/BondSplicer.hpp"
+
+using namespace MAT;
+using namespace benchmarks;
+
+static void BondSplicer_Splice(benchmark::State& state)
+{
+    size_t const recordCount = static_cast<size_t>(state.range(0));
+    std::vector<std::vector<uint8_t>> blobs;
+    for (size_t i = 0; i < recordCount; i++)
+    {
+        blobs.push_back(makeStorageRecord(i, 512).blob);
+    }
+
+    BondSplicer splicer;
+    AllocationCounter counter;
+    for (auto _ : state)
+    {
+        size_t package = splicer.addTenantToken(BenchmarkTenantToken);
+        for (auto const& blob : blobs)
+        {
+            splicer.addRecord(package, blob);
+        }
+        std::vector<uint8_t> body = splicer.splice();
+        benchmark::DoNotOptimize(body.data());
+        splicer.clear();
+    }
+    counter.report(state);
+    state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(recordCount));
+}
+BENCHMARK(BondSplicer_Splice)->Arg(1)->Arg(100);
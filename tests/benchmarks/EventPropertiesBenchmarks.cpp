@@ -0,0 +1,46 @@
+//
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// SPDX-License-Identifier: Apache-2.0
+//
+#include "BenchmarkCommon.hpp"
+#include "EventProperties.hpp"
+
+using namespace MAT;
+using namespace benchmarks;
+
+static void EventProperties_SetProperties(benchmark::State& state)
+{
+    AllocationCounter counter;
+    for (auto _ : state)
+    {
+        EventProperties props("Benchmark.SampleEvent");
+        props.SetProperty("strKey", "a typical string value");
+        props.SetProperty("intKey", int64_t { 12345 });
+        props.SetProperty("dblKey", 3.14);
+        props.SetProperty("boolKey", true);
+        props.SetProperty("piiKey", "user@example.com", PiiKind_Identity);
+        props.SetLatency(EventLatency_Normal);
+        benchmark::DoNotOptimize(props.GetProperties().size());
+    }
+    counter.report(state);
+}
+BENCHMARK(EventProperties_SetProperties);
+
+static void EventProperties_InitializerList(benchmark::State& state)
+{
+    AllocationCounter counter;
+    for (auto _ : state)
+    {
+        EventProperties props("Benchmark.SampleEvent",
+            {
+                { "strKey", "a typical string value" },
+                { "intKey", int64_t { 12345 } },
+                { "dblKey", 3.14 },
+                { "boolKey", true },
+                { "guidKey", GUID_t("00010203-0405-0607-0809-0A0B0C0D0E0F") },
+            });
+        benchmark::DoNotOptimize(props.GetProperties().size());
+    }
+    counter.report(state);
+}
+BENCHMARK(EventProperties_InitializerList);
@@ -0,0 +1,42 @@
+//
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// SPDX-License-Identifier: Apache-2.0
+//
+#include "BenchmarkCommon.hpp"
+#include "compression/HttpDeflateCompression.hpp"
+#include "config/RuntimeConfig_Default.hpp"
+#include "packager/BondSplicer.hpp"
+
+using namespace MAT;
+using namespace benchmarks;
+
+static void HttpDeflateCompression_Compress(benchmark::State& state)
+{
+    ILogConfiguration logConfig;
+    RuntimeConfig_Default config(logConfig);
+    config[CFG_MAP_HTTP][CFG_BOOL_HTTP_COMPRESSION] = true;
+    HttpDeflateCompression compression(config);
+
+    // Realistic payload: a spliced package of serialized records
+    BondSplicer splicer;
+    size_t package = splicer.addTenantToken(BenchmarkTenantToken);
+    for (size_t i = 0; i < static_cast<size_t>(state.range(0)); i++)
+    {
+        splicer.addRecord(package, makeStorageRecord(i, 256).blob);
+    }
+    std::vector<uint8_t> const body = splicer.splice();
+
+    AllocationCounter counter;
+    for (auto _ : state)
+    {
+        state.PauseTiming();
+        EventsUploadContextPtr ctx = std::make_shared<EventsUploadContext>();
+        ctx->body = body;
+        state.ResumeTiming();
+        compression.compress(ctx);
+        benchmark::DoNotOptimize(ctx->body.data());
+    }
+    counter.report(state);
+    state.SetBytesProcessed(state.iterations() * static_cast<int64_t>(body.size()));
+}
+BENCHMARK(HttpDeflateCompression_Compress)->Arg(10)->Arg(500);
@@ -0,0 +1,67 @@
+//
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// SPDX-License-Identifier: Apache-2.0
+//
+#include "BenchmarkCommon.hpp"
+#include "api/LogManagerImpl.hpp"
+#include "utils/Utils.hpp"
+
+#include <cstdio>
+
+using namespace MAT;
+using namespace benchmarks;
+
+namespace {
+
+    /// <summary>
+    /// Log manager which drops the events right after Logger::LogEvent built
+    /// their IncomingEventContext, so that only the API path is measured.
+    /// </summary>
+    class BenchmarkLogManager : public LogManagerImpl
+    {
+    public:
+        BenchmarkLogManager(ILogConfiguration& configuration) :
+            LogManagerImpl(configuration)
+        {
+        }
+
+        virtual void sendEvent(IncomingEventContextPtr const& event) override
+        {
+            benchmark::DoNotOptimize(event->source);
+        }
+    };
+
+    std::string const cacheFilePath = GetTempDirectory() + "LoggerBenchmarks.db";
+
+    ILogConfiguration makeConfiguration()
+    {
+        ILogConfiguration configuration;
+        configuration[CFG_STR_CACHE_FILE_PATH] = cacheFilePath;
+        configuration[CFG_INT_MAX_TEARDOWN_TIME] = 0;
+        configuration.AddModule(CFG_MODULE_HTTP_CLIENT, std::make_shared<NullHttpClient>());
+        return configuration;
+    }
+
+}
+
+static void Logger_LogEvent(benchmark::State& state)
+{
+    ILogConfiguration configuration = makeConfiguration();
+    {
+        BenchmarkLogManager logManager(configuration);
+        ILogger* logger = logManager.GetLogger(BenchmarkTenantToken);
+
+        AllocationCounter counter;
+        for (auto _ : state)
+        {
+            EventProperties props("Benchmark.SampleEvent");
+            props.SetProperty("strKey", "a typical string value");
+            props.SetProperty("intKey", int64_t { 12345 });
+            props.SetProperty("dblKey", 3.14);
+            logger->LogEvent(props);
+        }
+        counter.report(state);
+    }
+    std::remove(cacheFilePath.c_str());
+}
+BENCHMARK(Logger_LogEvent);
@@ -0,0 +1,83 @@
+//
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// SPDX-License-Identifier: Apache-2.0
+//
+#include "BenchmarkCommon.hpp"
+
+#include <cstdlib>
+#include <new>
+
+namespace benchmarks {
+
+    std::atomic<uint64_t> AllocationStats::count { 0 };
+    std::atomic<uint64_t> AllocationStats::bytes { 0 };
+
+    const char* const BenchmarkTenantToken = "6d084bbf6a9644ef83f40a77c9e34580-c2d379e0-4408-4325-9b4d-2a7d78131e14-7322";
+
+    CsProtocol::Record makeRecord(size_t propertyCount)
+    {
+        CsProtocol::Record record;
+        record.ver = "3.0";
+        record.name = "Benchmark.SampleEvent";
+        record.time = 1577836800000;
+        record.iKey = "o:6d084bbf6a9644ef83f40a77c9e34580";
+        record.baseType = "custom";
+        record.data.push_back(CsProtocol::Data());
+        for (size_t i = 0; i < propertyCount; i++)
+        {
+            CsProtocol::Value value;
+            if (i % 2 == 0)
+            {
+                value.stringValue = "value of a typical string property #" + std::to_string(i);
+            }
+            else
+            {
+                value.type = CsProtocol::ValueKind::ValueInt64;
+                value.longValue = static_cast<int64_t>(i * 12345);
+            }
+            record.data[0].properties["property_" + std::to_string(i)] = value;
+        }
+        return record;
+    }
+
+    MAT::StorageRecord makeStorageRecord(size_t index, size_t blobSize)
+    {
+        std::vector<uint8_t> blob(blobSize);
+        uint32_t seed = static_cast<uint32_t>(index) * 2654435761u;
+        for (auto& b : blob)
+        {
+            seed = seed * 1103515245u + 12345u;
+            b = static_cast<uint8_t>(seed >> 24);
+        }
+        return MAT::StorageRecord("record-" + std::to_string(index), BenchmarkTenantToken,
+            MAT::EventLatency_Normal, MAT::EventPersistence_Normal, 1577836800000 + static_cast<int64_t>(index), std::move(blob));
+    }
+
+} // namespace benchmarks
+
+// Count every heap allocation of the process for the allocs/op and bytes/op counters.
+// The array and nothrow forms of the default operator new forward to these.
+
+void* operator new(std::size_t size)
+{
+    benchmarks::AllocationStats::count.fetch_add(1, std::memory_order_relaxed);
+    benchmarks::AllocationStats::bytes.fetch_add(size, std::memory_order_relaxed);
+    void* ptr = std::malloc(size == 0 ? 1 : size);
+    if (ptr == nullptr)
+    {
+        throw std::bad_alloc();
+    }
+    return ptr;
+}
+
+void operator delete(void* ptr) noexcept
+{
+    std::free(ptr);
+}
+
+void operator delete(void* ptr, std::size_t) noexcept
+{
+    std::free(ptr);
+}
+
+BENCHMARK_MAIN();
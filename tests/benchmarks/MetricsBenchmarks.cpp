@@ -0,0 +1,47 @@
+//
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// SPDX-License-Identifier: Apache-2.0
+//
+#include "BenchmarkCommon.hpp"
+#include "stats/MetricSeries.hpp"
+
+using namespace MAT;
+using namespace benchmarks;
+
+static MetricSeries s_distribution(MetricSeries::Kind::Distribution);
+
+static void MetricSeries_RecordDistribution(benchmark::State& state)
+{
+    double value = 1.0 + state.thread_index();
+    for (auto _ : state)
+    {
+        s_distribution.Record(value);
+        value += 0.5;
+    }
+    state.SetItemsProcessed(state.iterations());
+    if (state.thread_index() == 0)
+    {
+        MetricSnapshot snapshot;
+        s_distribution.Harvest(snapshot);
+        benchmark::DoNotOptimize(snapshot.count);
+    }
+}
+BENCHMARK(MetricSeries_RecordDistribution)->ThreadRange(1, 8)->UseRealTime();
+
+static void MetricSeries_Harvest(benchmark::State& state)
+{
+    MetricSeries series(MetricSeries::Kind::Distribution);
+    for (auto _ : state)
+    {
+        state.PauseTiming();
+        for (int i = 0; i < 1000; i++)
+        {
+            series.Record(i);
+        }
+        state.ResumeTiming();
+        MetricSnapshot snapshot;
+        series.Harvest(snapshot);
+        benchmark::DoNotOptimize(snapshot.buckets.size());
+    }
+}
+BENCHMARK(MetricSeries_Harvest);
@@ -0,0 +1,81 @@
+//
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// SPDX-License-Identifier: Apache-2.0
+//
+#include "BenchmarkCommon.hpp"
+#include "system/Route.hpp"
+
+using namespace MAT;
+using namespace benchmarks;
+
+namespace {
+
+    // Three pass-through stages and a sink, the shape of the per-event pipeline
+    class RouteStages
+    {
+    public:
+        uint64_t total = 0;
+
+        bool first(uint64_t& value)
+        {
+            value += 1;
+            return true;
+        }
+
+        bool second(uint64_t& value)
+        {
+            value ^= 0x5a;
+            return true;
+        }
+
+        bool third(uint64_t& value)
+        {
+            return value != 0;
+        }
+
+        void sink(uint64_t& value)
+        {
+            total += value;
+        }
+    };
+
+} // namespace
+
+static void Route_DynamicHops(benchmark::State& state)
+{
+    RouteStages stages;
+    RoutePassThrough<RouteStages, uint64_t&> first{&stages, &RouteStages::first};
+    RoutePassThrough<RouteStages, uint64_t&> second{&stages, &RouteStages::second};
+    RoutePassThrough<RouteStages, uint64_t&> third{&stages, &RouteStages::third};
+    RouteSink<RouteStages, uint64_t&> sink{&stages, &RouteStages::sink};
+    RouteSource<uint64_t&> source;
+    source >> first >> second >> third >> sink;
+
+    uint64_t value = 0;
+    for (auto _ : state)
+    {
+        source(value);
+    }
+    benchmark::DoNotOptimize(stages.total);
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(Route_DynamicHops);
+
+static void Route_StaticHops(benchmark::State& state)
+{
+    RouteStages stages;
+    MAT_BOUND_ROUTE(RouteStages, first) first{&stages};
+    MAT_BOUND_ROUTE(RouteStages, second) second{&stages};
+    MAT_BOUND_ROUTE(RouteStages, third) third{&stages};
+    MAT_BOUND_ROUTE(RouteStages, sink) sink{&stages};
+    auto route = makeStaticRoute(first, second, third, sink);
+
+    uint64_t value = 0;
+    for (auto _ : state)
+    {
+        route(value);
+    }
+    benchmark::DoNotOptimize(stages.total);
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(Route_StaticHops);
@@ -0,0 +1,83 @@
+//
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// SPDX-License-Identifier: Apache-2.0
+//
+#include "BenchmarkCommon.hpp"
+#include "api/LogManagerImpl.hpp"
+#include "utils/Utils.hpp"
+
+#if defined(__linux__)
+#include "pal/posix/sysinfo_sources_impl.hpp"
+#endif
+
+#include <cstdio>
+
+using namespace MAT;
+using namespace benchmarks;
+
+namespace {
+
+    std::string const cacheFilePath = GetTempDirectory() + "StartupBenchmarks.db";
+
+}
+
+/// <summary>
+/// Time from constructing a log manager to its first LogEvent returning, with
+/// the offline storage opened on the caller (0) or on the worker thread (1).
+/// The database is left in place between iterations, as on a warm restart.
+/// </summary>
+static void Startup_FirstLogEvent(benchmark::State& state)
+{
+    std::remove(cacheFilePath.c_str());
+    for (auto _ : state)
+    {
+        ILogConfiguration configuration;
+        configuration[CFG_STR_CACHE_FILE_PATH] = cacheFilePath;
+        configuration[CFG_INT_MAX_TEARDOWN_TIME] = 0;
+        configuration[CFG_BOOL_ASYNC_STORAGE_OPEN] = (state.range(0) != 0);
+        configuration.AddModule(CFG_MODULE_HTTP_CLIENT, std::make_shared<NullHttpClient>());
+
+        std::unique_ptr<LogManagerImpl> logManager(new LogManagerImpl(configuration));
+        logManager->GetLogger(BenchmarkTenantToken)->LogEvent("Benchmark.FirstEvent");
+
+        state.PauseTiming();
+        logManager.reset();
+        state.ResumeTiming();
+    }
+    std::remove(cacheFilePath.c_str());
+}
+BENCHMARK(Startup_FirstLogEvent)->Arg(0)->Arg(1)->Unit(benchmark::kMicrosecond);
+
+#if defined(__linux__)
+/// <summary>
+/// Resolving the system information fields which the PAL puts in the semantic
+/// context, from the system (0) or from what an earlier start saved (1).
+/// </summary>
+static void Startup_SystemInformation(benchmark::State& state)
+{
+    static const char* const fields[] = { "tz", "appId", "osName", "osVer", "osRel", "devClass", "devId", "devMake", "devModel" };
+    std::string saved;
+    {
+        sysinfo_sources_impl sysInfo;
+        for (auto field : fields)
+        {
+            sysInfo.get(field);
+        }
+        saved = sysInfo.save();
+    }
+
+    for (auto _ : state)
+    {
+        sysinfo_sources_impl sysInfo;
+        if (state.range(0) != 0)
+        {
+            sysInfo.load(saved);
+        }
+        for (auto field : fields)
+        {
+            benchmark::DoNotOptimize(sysInfo.get(field));
+        }
+    }
+}
+BENCHMARK(Startup_SystemInformation)->Arg(0)->Arg(1)->Unit(benchmark::kMicrosecond);
+#endif
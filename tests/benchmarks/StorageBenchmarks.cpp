@@ -0,0 +1,89 @@
+//
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// SPDX-License-Identifier: Apache-2.0
+//
+#include "BenchmarkCommon.hpp"
+#include "config/RuntimeConfig_Default.hpp"
+#include "offline/MemoryStorage.hpp"
+#include "utils/Utils.hpp"
+#include "NullObjects.hpp"
+#ifdef HAVE_MAT_STORAGE
+#include "offline/OfflineStorage_SQLite.hpp"
+#endif
+
+#include <cstdio>
+
+using namespace MAT;
+using namespace benchmarks;
+
+namespace {
+
+    // Stores a batch, reserves it for upload and deletes it as after a successful upload
+    void storeReserveDelete(benchmark::State& state, IOfflineStorage& storage)
+    {
+        size_t const batchSize = static_cast<size_t>(state.range(0));
+        std::vector<StorageRecord> records;
+        for (size_t i = 0; i < batchSize; i++)
+        {
+            records.push_back(makeStorageRecord(i, 512));
+        }
+
+        std::vector<StorageRecordId> ids;
+        auto consumer = [&ids](StorageRecord&& record) -> bool {
+            ids.push_back(record.id);
+            return true;
+        };
+
+        AllocationCounter counter;
+        for (auto _ : state)
+        {
+            for (auto const& record : records)
+            {
+                storage.StoreRecord(record);
+            }
+            ids.clear();
+            storage.GetAndReserveRecords(consumer, 120000);
+            bool fromMemory = false;
+            storage.DeleteRecords(ids, HttpHeaders(), fromMemory);
+        }
+        counter.report(state);
+        state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(batchSize));
+    }
+
+}
+
+static void MemoryStorage_StoreReserveDelete(benchmark::State& state)
+{
+    NullLogManager logManager;
+    ILogConfiguration logConfig;
+    RuntimeConfig_Default config(logConfig);
+    NullStorageObserver observer;
+
+    MemoryStorage storage(logManager, config);
+    storage.Initialize(observer);
+    storeReserveDelete(state, storage);
+    storage.Shutdown();
+}
+BENCHMARK(MemoryStorage_StoreReserveDelete)->Arg(1)->Arg(100);
+
+#ifdef HAVE_MAT_STORAGE
+static void OfflineStorage_SQLite_StoreRetrieveDelete(benchmark::State& state)
+{
+    NullLogManager logManager;
+    ILogConfiguration logConfig;
+    std::string const cacheFilePath = GetTempDirectory() + "StorageBenchmarks.db";
+    std::remove(cacheFilePath.c_str());
+    logConfig[CFG_STR_CACHE_FILE_PATH] = cacheFilePath;
+    RuntimeConfig_Default config(logConfig);
+    NullStorageObserver observer;
+
+    {
+        OfflineStorage_SQLite storage(logManager, config);
+        storage.Initialize(observer);
+        storeReserveDelete(state, storage);
+        storage.Shutdown();
+    }
+    std::remove(cacheFilePath.c_str());
+}
+BENCHMARK(OfflineStorage_SQLite_StoreRetrieveDelete)->Arg(1)->Arg(100);
+#endif
@@ -52,6 +52,8 @@ namespace testing {
         MOCK_METHOD0(getContext, ISemanticContext&());
         MOCK_METHOD1(DispatchEvent, bool(DebugEvent evt));
         MOCK_METHOD1(sendEvent, void(IncomingEventContextPtr const& event));
+        MOCK_METHOD1(setEventSampler, void(EventSampler const* sampler));
+        MOCK_METHOD0(getDeliveryLatency, std::vector<DeliveryLatencyStats>());
         MOCK_METHOD0(startAsync, void());
         MOCK_METHOD0(stopAsync, void());
         MOCK_METHOD0(handleFlushTaskDispatcher, void());
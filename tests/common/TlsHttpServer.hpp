@@ -0,0 +1,212 @@
+//
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// SPDX-License-Identifier: Apache-2.0
+//
+
+#pragma once
+
+#ifdef HAVE_MAT_TEST_TLS
+
+#include <openssl/err.h>
+#include <openssl/evp.h>
+#include <openssl/ssl.h>
+#include <openssl/x509.h>
+
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <atomic>
+#include <cstring>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace testing {
+
+// Minimal HTTPS stand-in for the collector: a self-signed certificate, a thread
+// per connection, answers every request with "200 OK" and counts the TLS
+// handshakes it has done, how many of them resumed an earlier session and
+// the connections still open.
+// Out of scope: anything but what HTTP client tests need to observe.
+class TlsHttpServer
+{
+  public:
+    std::atomic<unsigned> handshakes { 0 };
+    std::atomic<unsigned> resumedHandshakes { 0 };
+    std::atomic<unsigned> requests { 0 };
+    std::atomic<unsigned> openConnections { 0 };
+
+    // Close the connection after every response, so that each request needs a handshake
+    bool closeAfterResponse = false;
+
+    TlsHttpServer()
+    {
+        m_ctx = SSL_CTX_new(TLS_server_method());
+        EVP_PKEY* key = EVP_EC_gen("P-256");
+        X509* cert = X509_new();
+        ASN1_INTEGER_set(X509_get_serialNumber(cert), 1);
+        X509_gmtime_adj(X509_getm_notBefore(cert), 0);
+        X509_gmtime_adj(X509_getm_notAfter(cert), 3600);
+        X509_set_pubkey(cert, key);
+        X509_NAME* name = X509_get_subject_name(cert);
+        X509_NAME_add_entry_by_txt(name, "CN", MBSTRING_ASC, reinterpret_cast<const unsigned char*>("localhost"), -1, -1, 0);
+        X509_set_issuer_name(cert, name);
+        X509_sign(cert, key, EVP_sha256());
+        SSL_CTX_use_certificate(m_ctx, cert);
+        SSL_CTX_use_PrivateKey(m_ctx, key);
+        X509_free(cert);
+        EVP_PKEY_free(key);
+    }
+
+    ~TlsHttpServer()
+    {
+        stop();
+        SSL_CTX_free(m_ctx);
+    }
+
+    // Listens on a free port of the loopback interface, returns the port
+    int start()
+    {
+        m_listener = socket(AF_INET, SOCK_STREAM, 0);
+        sockaddr_in address {};
+        address.sin_family = AF_INET;
+        address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+        bind(m_listener, reinterpret_cast<sockaddr*>(&address), sizeof(address));
+        listen(m_listener, 8);
+        socklen_t length = sizeof(address);
+        getsockname(m_listener, reinterpret_cast<sockaddr*>(&address), &length);
+        m_running = true;
+        m_thread = std::thread([this]() { run(); });
+        return ntohs(address.sin_port);
+    }
+
+    void stop()
+    {
+        if (m_running.exchange(false))
+        {
+            m_thread.join();
+            for (auto& connection : m_connections)
+            {
+                connection.join();
+            }
+            m_connections.clear();
+            ::close(m_listener);
+        }
+    }
+
+  protected:
+    SSL_CTX*          m_ctx;
+    int               m_listener = -1;
+    std::atomic<bool> m_running { false };
+    std::thread       m_thread;
+    std::vector<std::thread> m_connections;
+
+    bool waitReadable(int fd)
+    {
+        while (m_running)
+        {
+            pollfd item { fd, POLLIN, 0 };
+            int result = poll(&item, 1, 50);
+            if (result != 0)
+            {
+                return result > 0;
+            }
+        }
+        return false;
+    }
+
+    void run()
+    {
+        while (waitReadable(m_listener))
+        {
+            int fd = accept(m_listener, nullptr, nullptr);
+            if (fd < 0)
+            {
+                continue;
+            }
+            m_connections.emplace_back([this, fd]() { connection(fd); });
+        }
+    }
+
+    void connection(int fd)
+    {
+        openConnections++;
+        SSL* ssl = SSL_new(m_ctx);
+        SSL_set_fd(ssl, fd);
+        if (SSL_accept(ssl) == 1)
+        {
+            handshakes++;
+            if (SSL_session_reused(ssl))
+            {
+                resumedHandshakes++;
+            }
+            serve(ssl, fd);
+            SSL_shutdown(ssl);
+        }
+        SSL_free(ssl);
+        ::close(fd);
+        openConnections--;
+    }
+
+    void serve(SSL* ssl, int fd)
+    {
+        std::string buffer;
+        char chunk[4096];
+        for (;;)
+        {
+            size_t end = buffer.find("\r\n\r\n");
+            if (end == std::string::npos)
+            {
+                if (SSL_pending(ssl) == 0 && !waitReadable(fd))
+                {
+                    return;
+                }
+                int read = SSL_read(ssl, chunk, sizeof(chunk));
+                if (read <= 0)
+                {
+                    return;
+                }
+                buffer.append(chunk, static_cast<size_t>(read));
+                continue;
+            }
+
+            size_t contentLength = 0;
+            std::string headers = buffer.substr(0, end);
+            for (auto& c : headers)
+            {
+                c = static_cast<char>(tolower(c));
+            }
+            size_t field = headers.find("content-length:");
+            if (field != std::string::npos)
+            {
+                contentLength = static_cast<size_t>(atol(headers.c_str() + field + 15));
+            }
+            while (buffer.size() < end + 4 + contentLength)
+            {
+                int read = SSL_read(ssl, chunk, sizeof(chunk));
+                if (read <= 0)
+                {
+                    return;
+                }
+                buffer.append(chunk, static_cast<size_t>(read));
+            }
+            buffer.erase(0, end + 4 + contentLength);
+            requests++;
+
+            std::string response = "HTTP/1.1 200 OK\r\nContent-Type: application/json\r\nContent-Length: 2\r\n";
+            response += closeAfterResponse ? "Connection: close\r\n\r\n{}" : "\r\n{}";
+            SSL_write(ssl, response.data(), static_cast<int>(response.size()));
+            if (closeAfterResponse)
+            {
+                return;
+            }
+        }
+    }
+};
+
+} // namespace testing
+
+#endif // HAVE_MAT_TEST_TLS
@@ -788,8 +788,7 @@ TEST_F(BasicFuncTests, restartRecoversEventsFromStorage)
         LogManager::UploadNow();
 
         // 1st request for realtime event
-        waitForEvents(3, 5); // start, first_event, second_event, ongoing, stop, start, fooEvent
-        // we drop two of the events during pause, though.
+        waitForEvents(3, 7); // start, first_event, second_event, ongoing, stop, start, fooEvent
         EXPECT_GE(receivedRequests.size(), (size_t)1);
         if (receivedRequests.size() != 0)
         {
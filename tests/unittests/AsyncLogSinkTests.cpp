@@ -0,0 +1,127 @@
+//
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// SPDX-License-Identifier: Apache-2.0
+//
+
+#include "common/Common.hpp"
+#include "pal/AsyncLogSink.hpp"
+#include "utils/Utils.hpp"
+
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+
+using namespace testing;
+using namespace MAT;
+
+class AsyncLogSinkTests : public ::testing::Test
+{
+protected:
+    std::string path;
+
+    virtual void SetUp() override
+    {
+        path = GetTempDirectory() + "AsyncLogSinkTests.log";
+        std::remove(path.c_str());
+        std::remove((path + ".1").c_str());
+    }
+
+    virtual void TearDown() override
+    {
+        std::remove(path.c_str());
+        std::remove((path + ".1").c_str());
+    }
+
+    static std::string ReadFile(std::string const& filePath)
+    {
+        std::ifstream file(filePath, std::ios::binary);
+        std::stringstream content;
+        content << file.rdbuf();
+        return content.str();
+    }
+
+    static bool Write(PAL::AsyncLogSink& sink, std::string const& line)
+    {
+        return sink.Write(line.data(), line.size());
+    }
+};
+
+TEST_F(AsyncLogSinkTests, Lines_AreWrittenInOrder)
+{
+    PAL::AsyncLogSink sink(path, 0);
+    ASSERT_TRUE(sink.IsOpen());
+    std::string expected;
+    for (int i = 0; i < 100; i++)
+    {
+        std::string line = "line " + std::to_string(i) + "\n";
+        EXPECT_TRUE(Write(sink, line));
+        expected += line;
+    }
+    sink.Flush();
+    EXPECT_THAT(ReadFile(path), Eq(expected));
+    EXPECT_THAT(sink.GetDroppedCount(), Eq(0u));
+}
+
+TEST_F(AsyncLogSinkTests, Stop_WritesQueuedLines)
+{
+    PAL::AsyncLogSink sink(path, 0);
+    EXPECT_TRUE(Write(sink, "first\n"));
+    sink.Stop();
+    EXPECT_FALSE(Write(sink, "late\n"));
+    EXPECT_THAT(ReadFile(path), Eq("first\n"));
+}
+
+TEST_F(AsyncLogSinkTests, FullFile_IsRotated)
+{
+    PAL::AsyncLogSink sink(path, 20);
+    EXPECT_TRUE(Write(sink, "0123456789\n"));
+    sink.Flush();
+    EXPECT_TRUE(Write(sink, "abcdefghij\n"));
+    sink.Flush();
+    EXPECT_THAT(ReadFile(path + ".1"), Eq("0123456789\n"));
+    EXPECT_THAT(ReadFile(path), Eq("abcdefghij\n"));
+}
+
+TEST_F(AsyncLogSinkTests, FullRing_DropsAndReportsLines)
+{
+    PAL::AsyncLogSink sink(path, 0, 64);
+    EXPECT_FALSE(Write(sink, std::string(65, 'x')));
+    EXPECT_THAT(sink.GetDroppedCount(), Eq(1u));
+    EXPECT_TRUE(Write(sink, "next\n"));
+    sink.Flush();
+    EXPECT_THAT(ReadFile(path), Eq("[1 log lines dropped]\nnext\n"));
+}
+
+TEST_F(AsyncLogSinkTests, ConcurrentWriters_WrapTheRing)
+{
+    PAL::AsyncLogSink sink(path, 0, 256);
+    std::vector<std::thread> writers;
+    for (int t = 0; t < 4; t++)
+    {
+        writers.emplace_back([&sink, t]() {
+            for (int i = 0; i < 500; i++)
+            {
+                std::string line = "writer " + std::to_string(t) + "\n";
+                sink.Write(line.data(), line.size());
+            }
+        });
+    }
+    for (auto& writer : writers)
+    {
+        writer.join();
+    }
+    sink.Flush();
+
+    // Every line that was not dropped is intact
+    std::istringstream lines(ReadFile(path));
+    size_t written = 0;
+    for (std::string line; std::getline(lines, line);)
+    {
+        if (line.find("dropped") == std::string::npos)
+        {
+            EXPECT_THAT(line, MatchesRegex("writer [0-3]"));
+            written++;
+        }
+    }
+    EXPECT_THAT(written + sink.GetDroppedCount(), Eq(2000u));
+}
@@ -0,0 +1,76 @@
+//
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// SPDX-License-Identifier: Apache-2.0
+//
+
+#include "common/Common.hpp"
+#include "backoff/Backoff_DecorrelatedJitter.hpp"
+
+using namespace testing;
+
+
+TEST(BackoffTests_DecorrelatedJitter, ValidatesArguments)
+{
+    EXPECT_THAT(MAT::Backoff_DecorrelatedJitter(1000, 300000).good(), true);
+    EXPECT_THAT(MAT::Backoff_DecorrelatedJitter(1000,   1000).good(), true);
+
+    EXPECT_THAT(MAT::Backoff_DecorrelatedJitter(0,    300000).good(), false);
+    EXPECT_THAT(MAT::Backoff_DecorrelatedJitter(1000,    999).good(), false);
+}
+
+TEST(BackoffTests_DecorrelatedJitter, FirstValueIsRandomizedAboveBase)
+{
+    std::set<int> seen;
+    for (int i = 0; i < 100; i++) {
+        MAT::Backoff_DecorrelatedJitter b(1000, 300000);
+        int x = b.getValue();
+        EXPECT_THAT(x, AllOf(Ge(1000), Le(3000)));
+        seen.insert(x);
+    }
+    // Clients starting together must not retry in lock-step
+    EXPECT_THAT(seen.size(), Gt(10u));
+}
+
+TEST(BackoffTests_DecorrelatedJitter, StaysWithinBaseAndMaximum)
+{
+    MAT::Backoff_DecorrelatedJitter b(1000, 16000);
+    int previous = b.getValue();
+    for (int i = 0; i < 1000; i++) {
+        b.increase();
+        int x = b.getValue();
+        EXPECT_THAT(x, AllOf(Ge(1000), Le(std::min(16000, previous * 3))));
+        previous = x;
+    }
+}
+
+TEST(BackoffTests_DecorrelatedJitter, GrowsTowardsMaximum)
+{
+    MAT::Backoff_DecorrelatedJitter b(1000, 300000);
+    for (int i = 0; i < 100; i++) {
+        b.increase();
+    }
+    EXPECT_THAT(b.getValue(), Gt(3000));
+}
+
+TEST(BackoffTests_DecorrelatedJitter, ResetReturnsToBase)
+{
+    MAT::Backoff_DecorrelatedJitter b(1000, 300000);
+    for (int i = 0; i < 100; i++) {
+        b.increase();
+    }
+    b.reset();
+    EXPECT_THAT(b.getValue(), AllOf(Ge(1000), Le(3000)));
+}
+
+TEST(BackoffTests_DecorrelatedJitter, CanBeCreatedFromConfig)
+{
+    std::unique_ptr<MAT::IBackoff> b = MAT::IBackoff::createFromConfig("D,1000,16000");
+    ASSERT_THAT(b, NotNull());
+    EXPECT_THAT(b->getValue(), AllOf(Ge(1000), Le(3000)));
+
+    EXPECT_THAT(MAT::IBackoff::createFromConfig("D,1000"),         IsNull());
+    EXPECT_THAT(MAT::IBackoff::createFromConfig("D,1000!16000"),   IsNull());
+    EXPECT_THAT(MAT::IBackoff::createFromConfig("D,1000,16000!"),  IsNull());
+    EXPECT_THAT(MAT::IBackoff::createFromConfig("D,0,16000"),      IsNull());
+    EXPECT_THAT(MAT::IBackoff::createFromConfig("D,1000,999"),     IsNull());
+}
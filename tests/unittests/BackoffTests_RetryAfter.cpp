@@ -0,0 +1,83 @@
+//
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// SPDX-License-Identifier: Apache-2.0
+//
+
+#include "common/Common.hpp"
+#include "backoff/Backoff_ExponentialWithJitter.hpp"
+#include "backoff/Backoff_RetryAfter.hpp"
+
+using namespace testing;
+
+
+static std::unique_ptr<MAT::IBackoff> fixedExponential()
+{
+    return std::unique_ptr<MAT::IBackoff>(new MAT::Backoff_ExponentialWithJitter(1000, 300000, 2.0, 0.0));
+}
+
+TEST(BackoffTests_RetryAfter, ValidatesArguments)
+{
+    EXPECT_THAT(MAT::Backoff_RetryAfter(fixedExponential(), 0.0).good(), true);
+    EXPECT_THAT(MAT::Backoff_RetryAfter(fixedExponential(), -0.1).good(), false);
+    EXPECT_THAT(MAT::Backoff_RetryAfter(nullptr, 0.1).good(), false);
+}
+
+TEST(BackoffTests_RetryAfter, UsesInnerBackoffWithoutHint)
+{
+    MAT::Backoff_RetryAfter b(fixedExponential(), 0.5);
+    EXPECT_THAT(b.getValue(), Eq(1000));
+    b.increase();
+    EXPECT_THAT(b.getValue(), Eq(2000));
+}
+
+TEST(BackoffTests_RetryAfter, HonorsHintWithSpread)
+{
+    MAT::Backoff_RetryAfter b(fixedExponential(), 0.5);
+    b.setRetryAfter(60000);
+    for (int i = 0; i < 100; i++) {
+        EXPECT_THAT(b.getValue(), AllOf(Ge(60000), Le(90000)));
+    }
+}
+
+TEST(BackoffTests_RetryAfter, HintShorterThanBackoffIsIgnored)
+{
+    MAT::Backoff_RetryAfter b(fixedExponential(), 0.0);
+    b.setRetryAfter(500);
+    EXPECT_THAT(b.getValue(), Eq(1000));
+}
+
+TEST(BackoffTests_RetryAfter, HintIsConsumedByIncrease)
+{
+    MAT::Backoff_RetryAfter b(fixedExponential(), 0.0);
+    b.setRetryAfter(60000);
+    EXPECT_THAT(b.getValue(), Eq(60000));
+    b.increase();
+    EXPECT_THAT(b.getValue(), Eq(2000));
+
+    b.setRetryAfter(60000);
+    b.reset();
+    EXPECT_THAT(b.getValue(), Eq(1000));
+}
+
+TEST(BackoffTests_RetryAfter, OtherBackoffsIgnoreHint)
+{
+    std::unique_ptr<MAT::IBackoff> b = fixedExponential();
+    b->setRetryAfter(60000);
+    EXPECT_THAT(b->getValue(), Eq(1000));
+}
+
+TEST(BackoffTests_RetryAfter, CanBeCreatedFromConfig)
+{
+    std::unique_ptr<MAT::IBackoff> b = MAT::IBackoff::createFromConfig("R,0,E,1000,16000,2,0");
+    ASSERT_THAT(b, NotNull());
+    EXPECT_THAT(b->getValue(), Eq(1000));
+    b->setRetryAfter(5000);
+    EXPECT_THAT(b->getValue(), Eq(5000));
+
+    EXPECT_THAT(MAT::IBackoff::createFromConfig("R,0.1,D,3000,300000"),  NotNull());
+    EXPECT_THAT(MAT::IBackoff::createFromConfig("R,0.1"),                IsNull());
+    EXPECT_THAT(MAT::IBackoff::createFromConfig("R,0.1,"),               IsNull());
+    EXPECT_THAT(MAT::IBackoff::createFromConfig("R,0.1,x,1000"),         IsNull());
+    EXPECT_THAT(MAT::IBackoff::createFromConfig("R,-1,D,3000,300000"),   IsNull());
+    EXPECT_THAT(MAT::IBackoff::createFromConfig("R!0.1,D,3000,300000"),  IsNull());
+}
@@ -0,0 +1,220 @@
+// Copyright (c) Microsoft Corporation. All rights reserved.
+
+#include "common/Common.hpp"
+#include "http/CollectorEndpointPool.hpp"
+#include "config/RuntimeConfig_Default.hpp"
+
+using namespace testing;
+using namespace MAT;
+
+class TestCollectorEndpointPool : public CollectorEndpointPool
+{
+  public:
+    int64_t now = 1000;
+
+    TestCollectorEndpointPool(IRuntimeConfig& config) :
+        CollectorEndpointPool(config)
+    {
+    }
+
+  protected:
+    virtual int64_t getMonotonicTimeMs() override
+    {
+        return now;
+    }
+};
+
+class CollectorEndpointPoolTests : public Test {
+  protected:
+    ILogConfiguration                      logConfig;
+    std::unique_ptr<RuntimeConfig_Default> config;
+    std::unique_ptr<TestCollectorEndpointPool> pool;
+
+    void Create(std::string const& selection, std::string const& alternates = "https://b/, https://c/")
+    {
+        logConfig[CFG_STR_COLLECTOR_URL] = "https://a/";
+        logConfig[CFG_STR_COLLECTOR_ALTERNATE_URLS] = alternates;
+        logConfig[CFG_STR_COLLECTOR_SELECTION] = selection;
+        logConfig[CFG_INT_COLLECTOR_BREAKER_COOLDOWN] = 5000;
+        config.reset(new RuntimeConfig_Default(logConfig));
+        pool.reset(new TestCollectorEndpointPool(*config));
+    }
+
+    EventsUploadContextPtr Select()
+    {
+        auto ctx = std::make_shared<EventsUploadContext>();
+        ctx->httpRequest = new SimpleHttpRequest("CollectorEndpointPoolTests");
+        ctx->httpRequestId = ctx->httpRequest->GetId();
+        ctx->collectorUrl = config->GetCollectorUrl();
+        ctx->httpRequest->SetUrl(ctx->collectorUrl);
+        EXPECT_TRUE(pool->select(ctx));
+        return ctx;
+    }
+
+    void Complete(EventsUploadContextPtr const& ctx, HttpResult result, unsigned status, int durationMs)
+    {
+        SimpleHttpResponse* response = new SimpleHttpResponse(ctx->httpRequestId);
+        response->m_result = result;
+        response->m_statusCode = status;
+        ctx->httpResponse = response;
+        ctx->durationMs = durationMs;
+        EXPECT_TRUE(pool->record(ctx));
+    }
+
+    std::string Upload(HttpResult result, unsigned status, int durationMs)
+    {
+        auto ctx = Select();
+        std::string url = ctx->collectorUrl;
+        Complete(ctx, result, status, durationMs);
+        return url;
+    }
+};
+
+TEST_F(CollectorEndpointPoolTests, NoAlternates_LeavesRequestAlone)
+{
+    Create("leastLatency", "");
+    EXPECT_THAT(pool->GetSize(), Eq(1u));
+    auto ctx = Select();
+    EXPECT_THAT(ctx->collectorEndpoint, Eq(-1));
+    EXPECT_THAT(ctx->collectorUrl, Eq("https://a/"));
+    Complete(ctx, HttpResult_NetworkFailure, 0, 10);
+    EXPECT_THAT(pool->GetStatus()[0].samples, Eq(0u));
+}
+
+TEST_F(CollectorEndpointPoolTests, Alternates_AreParsed)
+{
+    Create("primary", " https://b/ ,,https://a/,https://c/");
+    auto status = pool->GetStatus();
+    ASSERT_THAT(status.size(), Eq(3u));
+    EXPECT_THAT(status[0].url, Eq("https://a/"));
+    EXPECT_THAT(status[1].url, Eq("https://b/"));
+    EXPECT_THAT(status[2].url, Eq("https://c/"));
+}
+
+TEST_F(CollectorEndpointPoolTests, Primary_FailsOverAndRecovers)
+{
+    Create("primary");
+    for (unsigned i = 0; i < CollectorEndpointPool::TripThreshold; i++)
+    {
+        auto ctx = Select();
+        EXPECT_THAT(ctx->collectorEndpoint, Eq(0));
+        EXPECT_FALSE(ctx->collectorFailover);
+        Complete(ctx, HttpResult_OK, 503, 10);
+        EXPECT_THAT(ctx->collectorEndpointTripped, Eq(i + 1 == CollectorEndpointPool::TripThreshold));
+    }
+    EXPECT_THAT(pool->GetStatus()[0].state, Eq(CollectorEndpointPool::BreakerState::Open));
+
+    // The primary is out of rotation until the cooldown is over
+    auto ctx = Select();
+    EXPECT_THAT(ctx->collectorEndpoint, Eq(1));
+    EXPECT_TRUE(ctx->collectorFailover);
+    EXPECT_THAT(ctx->collectorUrl, Eq("https://b/"));
+    EXPECT_THAT(static_cast<SimpleHttpRequest*>(ctx->httpRequest)->m_url, Eq("https://b/"));
+    Complete(ctx, HttpResult_OK, 200, 10);
+
+    // One probe goes to the primary, concurrent uploads keep using the alternate
+    pool->now += 5000;
+    auto probe = Select();
+    EXPECT_THAT(probe->collectorEndpoint, Eq(0));
+    EXPECT_THAT(Select()->collectorEndpoint, Eq(1));
+    Complete(probe, HttpResult_OK, 200, 10);
+    EXPECT_THAT(pool->GetStatus()[0].state, Eq(CollectorEndpointPool::BreakerState::Closed));
+    EXPECT_THAT(Upload(HttpResult_OK, 200, 10), Eq("https://a/"));
+}
+
+TEST_F(CollectorEndpointPoolTests, FailedProbe_ReopensBreaker)
+{
+    Create("primary");
+    for (unsigned i = 0; i < CollectorEndpointPool::TripThreshold; i++)
+    {
+        Upload(HttpResult_NetworkFailure, 0, 10);
+    }
+    pool->now += 5000;
+    auto probe = Select();
+    EXPECT_THAT(probe->collectorEndpoint, Eq(0));
+    Complete(probe, HttpResult_NetworkFailure, 0, 10);
+    EXPECT_TRUE(probe->collectorEndpointTripped);
+    EXPECT_THAT(Upload(HttpResult_OK, 200, 10), Eq("https://b/"));
+}
+
+TEST_F(CollectorEndpointPoolTests, AllTripped_FallsBackToPrimary)
+{
+    Create("primary", "https://b/");
+    for (int i = 0; i < 6; i++)
+    {
+        Upload(HttpResult_NetworkFailure, 0, 10);
+    }
+    auto status = pool->GetStatus();
+    EXPECT_THAT(status[0].state, Eq(CollectorEndpointPool::BreakerState::Open));
+    EXPECT_THAT(status[1].state, Eq(CollectorEndpointPool::BreakerState::Open));
+    auto ctx = Select();
+    EXPECT_THAT(ctx->collectorEndpoint, Eq(0));
+    EXPECT_FALSE(ctx->collectorFailover);
+}
+
+TEST_F(CollectorEndpointPoolTests, Aborted_IsNotCounted)
+{
+    Create("primary");
+    for (int i = 0; i < 5; i++)
+    {
+        Upload(HttpResult_Aborted, 0, 10);
+    }
+    auto status = pool->GetStatus();
+    EXPECT_THAT(status[0].samples, Eq(0u));
+    EXPECT_THAT(status[0].state, Eq(CollectorEndpointPool::BreakerState::Closed));
+    EXPECT_THAT(status[0].uploads, Eq(5u));
+}
+
+TEST_F(CollectorEndpointPoolTests, LeastLatency_PrefersFastestEndpoint)
+{
+    Create("leastLatency");
+    // Every endpoint is measured once, then the fastest one wins
+    EXPECT_THAT(Upload(HttpResult_OK, 200, 300), Eq("https://a/"));
+    EXPECT_THAT(Upload(HttpResult_OK, 200, 50), Eq("https://b/"));
+    EXPECT_THAT(Upload(HttpResult_OK, 200, 100), Eq("https://c/"));
+    EXPECT_THAT(Upload(HttpResult_OK, 200, 50), Eq("https://b/"));
+
+    // Errors make an endpoint more expensive than a slower healthy one
+    Upload(HttpResult_OK, 500, 50);
+    Upload(HttpResult_OK, 500, 50);
+    EXPECT_THAT(Upload(HttpResult_OK, 200, 100), Eq("https://c/"));
+    auto status = pool->GetStatus();
+    EXPECT_THAT(status[1].errorRate, Gt(0.3));
+    EXPECT_THAT(status[1].latencyMs, DoubleEq(50));
+    EXPECT_THAT(status[2].latencyMs, DoubleEq(100));
+}
+
+TEST_F(CollectorEndpointPoolTests, Weighted_SpreadsByInverseCost)
+{
+    Create("weighted", "https://b/");
+    Upload(HttpResult_OK, 200, 100);
+    Upload(HttpResult_OK, 200, 300);
+
+    std::map<std::string, int> counts;
+    for (int i = 0; i < 400; i++)
+    {
+        auto ctx = Select();
+        counts[ctx->collectorUrl]++;
+        Complete(ctx, HttpResult_OK, 200, (ctx->collectorEndpoint == 0) ? 100 : 300);
+    }
+    // Weights are about 3:1
+    EXPECT_THAT(counts["https://a/"], AllOf(Gt(280), Lt(320)));
+    EXPECT_THAT(counts["https://b/"], AllOf(Gt(80), Lt(120)));
+}
+
+TEST_F(CollectorEndpointPoolTests, PrimaryChange_ResetsPrimary)
+{
+    Create("primary");
+    for (unsigned i = 0; i < CollectorEndpointPool::TripThreshold; i++)
+    {
+        Upload(HttpResult_NetworkFailure, 0, 10);
+    }
+    auto ctx = Select();
+    EXPECT_THAT(ctx->collectorEndpoint, Eq(1));
+
+    (*config)[CFG_STR_COLLECTOR_URL] = "https://d/";
+    EXPECT_THAT(Upload(HttpResult_OK, 200, 10), Eq("https://d/"));
+    auto status = pool->GetStatus();
+    EXPECT_THAT(status[0].url, Eq("https://d/"));
+    EXPECT_THAT(status[0].samples, Eq(1u));
+}
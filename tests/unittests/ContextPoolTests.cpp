@@ -0,0 +1,128 @@
+//
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// SPDX-License-Identifier: Apache-2.0
+//
+
+#include "common/Common.hpp"
+#include "system/ContextPool.hpp"
+#include "system/Contexts.hpp"
+
+using namespace testing;
+using namespace MAT;
+
+TEST(ContextPoolTests, ReleasedObjects_AreReused)
+{
+    ContextPool<IncomingEventContext> pool(2);
+    IncomingEventContext* first = pool.acquire();
+    pool.release(first);
+    EXPECT_THAT(pool.getIdleCount(), Eq(1u));
+    EXPECT_THAT(pool.acquire(), Eq(first));
+    EXPECT_THAT(pool.getIdleCount(), Eq(0u));
+    pool.release(first);
+}
+
+TEST(ContextPoolTests, ObjectsBeyondMaxIdle_AreDeleted)
+{
+    ContextPool<IncomingEventContext> pool(1);
+    IncomingEventContext* first = pool.acquire();
+    IncomingEventContext* second = pool.acquire();
+    EXPECT_THAT(second, Ne(first));
+    pool.release(first);
+    pool.release(second);
+    EXPECT_THAT(pool.getIdleCount(), Eq(1u));
+}
+
+TEST(ContextPoolTests, Lease_ReturnsObjectToPool)
+{
+    ContextPool<IncomingEventContext> pool(2);
+    IncomingEventContext* leased;
+    {
+        ContextPool<IncomingEventContext>::Lease lease(pool);
+        leased = lease.get();
+        EXPECT_THAT(pool.getIdleCount(), Eq(0u));
+    }
+    EXPECT_THAT(pool.getIdleCount(), Eq(1u));
+    ContextPool<IncomingEventContext>::Lease lease(pool);
+    EXPECT_THAT(lease.get(), Eq(leased));
+}
+
+TEST(ContextPoolTests, IncomingEventContext_ResetKeepsBlobCapacity)
+{
+    ::CsProtocol::Record source;
+    ContextPool<IncomingEventContext> pool(1);
+    IncomingEventContext* ctx = pool.acquire();
+    ctx->set("id", "token", EventLatency_RealTime, EventPersistence_Critical, &source);
+    ctx->policyBitFlags = 3;
+    ctx->submitTimestamp = 1234;
+    ctx->record.blob.assign(1000, 0x55);
+    pool.release(ctx);
+
+    ctx = pool.acquire();
+    EXPECT_THAT(ctx->source, IsNull());
+    EXPECT_THAT(ctx->record.id, IsEmpty());
+    EXPECT_THAT(ctx->record.tenantToken, IsEmpty());
+    EXPECT_THAT(ctx->record.latency, Eq(EventLatency_Unspecified));
+    EXPECT_THAT(ctx->record.persistence, Eq(EventPersistence_Normal));
+    EXPECT_THAT(ctx->record.blob, IsEmpty());
+    EXPECT_THAT(ctx->record.blob.capacity(), Ge(1000u));
+    EXPECT_THAT(ctx->policyBitFlags, Eq(0u));
+    EXPECT_THAT(ctx->submitTimestamp, Eq(0));
+    pool.release(ctx);
+}
+
+TEST(ContextPoolTests, Record_ResetMatchesDefault)
+{
+    ContextPool<::CsProtocol::Record> pool(1);
+    ::CsProtocol::Record* record = pool.acquire();
+    record->name = "Event.Name";
+    record->time = 42;
+    record->popSample = 10;
+    record->extApp.resize(1);
+    record->extApp[0].id = "app";
+    record->data.resize(1);
+    record->tags["tag"] = "value";
+    pool.release(record);
+
+    record = pool.acquire();
+    EXPECT_TRUE(*record == ::CsProtocol::Record());
+    EXPECT_THAT(record->extApp.capacity(), Ge(1u));
+    pool.release(record);
+}
+
+TEST(ContextPoolTests, EventsUploadContext_ResetRestoresDefaults)
+{
+    ContextPool<EventsUploadContext> pool(1);
+    EventsUploadContext* ctx = pool.acquire();
+    ctx->requestedMinLatency = EventLatency_RealTime;
+    ctx->requestedMaxCount = 10;
+    ctx->maxUploadSize = 100;
+    ctx->packageIds["token"] = 0;
+    ctx->recordIdsAndTenantIds["id"] = "token";
+    ctx->recordTimestamps.assign(50, 1);
+    ctx->body.assign(100, 1);
+    ctx->compressed = true;
+    ctx->packagingMs = 5;
+    ctx->httpRequestId = "request";
+    ctx->fromMemory = true;
+    ctx->splicer->addTenantToken("token");
+    pool.release(ctx);
+
+    ctx = pool.acquire();
+    EXPECT_THAT(ctx->requestedMinLatency, Eq(EventLatency_Unspecified));
+    EXPECT_THAT(ctx->requestedMaxCount, Eq(0u));
+    EXPECT_THAT(ctx->maxUploadSize, Eq(0u));
+    EXPECT_THAT(ctx->packageIds, IsEmpty());
+    EXPECT_THAT(ctx->recordIdsAndTenantIds, IsEmpty());
+    EXPECT_THAT(ctx->recordTimestamps, IsEmpty());
+    EXPECT_THAT(ctx->recordTimestamps.capacity(), Ge(50u));
+    EXPECT_THAT(ctx->body, IsEmpty());
+    // Pooled contexts do not hold on to package buffers
+    EXPECT_THAT(ctx->body.capacity(), Eq(0u));
+    EXPECT_FALSE(ctx->compressed);
+    EXPECT_THAT(ctx->packagingMs, Eq(-1));
+    EXPECT_THAT(ctx->httpRequestId, IsEmpty());
+    EXPECT_FALSE(ctx->fromMemory);
+    EXPECT_THAT(ctx->splicer->getSizeEstimate(), Eq(BondSplicer().getSizeEstimate()));
+    EXPECT_THAT(ctx->httpRequest, IsNull());
+    pool.release(ctx);
+}
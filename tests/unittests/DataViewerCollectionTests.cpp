@@ -44,10 +44,46 @@ class MockIDataViewer : public IDataViewer
     const std::string m_testEndpoint{"TestEndpoint"};
 };
 
+class BlockingDataViewer : public MockIDataViewer
+{
+   public:
+
+    BlockingDataViewer(const char* name) : MockIDataViewer(name, /*isTransmissionEnabled*/ true) {}
+
+    void ReceivePacket(const DataViewerPacket& packet) noexcept override
+    {
+        std::unique_lock<std::mutex> lock(m_lock);
+        m_received.push_back(packet);
+        m_changed.notify_all();
+        m_changed.wait(lock, [this]() { return m_released; });
+    }
+
+    void WaitForFirstPacket()
+    {
+        std::unique_lock<std::mutex> lock(m_lock);
+        m_changed.wait(lock, [this]() { return !m_received.empty(); });
+    }
+
+    void Release()
+    {
+        std::lock_guard<std::mutex> lock(m_lock);
+        m_released = true;
+        m_changed.notify_all();
+    }
+
+    std::mutex m_lock;
+    std::condition_variable m_changed;
+    bool m_released = false;
+    std::vector<DataViewerPacket> m_received;
+};
+
 class TestDataViewerCollection : public DataViewerCollection
 {
    public:
 
+    TestDataViewerCollection(size_t maxQueuedPackets = DefaultMaxQueuedViewerPackets) :
+        DataViewerCollection(maxQueuedPackets) {}
+
     using DataViewerCollection::DispatchDataViewerEvent;
     using DataViewerCollection::IsViewerEnabled;
     using DataViewerCollection::IsViewerRegistered;
@@ -264,3 +300,109 @@ TEST(DataViewerCollectionTests, IsViewerEnabledNoParam_MultipleViewersRegistered
     ASSERT_TRUE(dataViewerCollection.IsViewerEnabled());
 }
 
+
+TEST(DataViewerCollectionTests, DispatchDataViewerEvent_TransmittingViewer_ReceivesPacketOnDeliveryThread)
+{
+    auto viewer = std::make_shared<MockIDataViewer>("sharedName", /*isTransmissionEnabled*/ true);
+    TestDataViewerCollection dataViewerCollection { };
+    dataViewerCollection.RegisterViewer(viewer);
+
+    dataViewerCollection.DispatchDataViewerEvent(std::vector<uint8_t> { 1, 127, 255 });
+    dataViewerCollection.WaitForPendingPackets();
+
+    EXPECT_THAT(viewer->localPacketData, Eq(std::vector<uint8_t> { 1, 127, 255 }));
+}
+
+TEST(DataViewerCollectionTests, DispatchDataViewerEvent_NoViewerTransmitting_NothingDelivered)
+{
+    auto viewer = std::make_shared<MockIDataViewer>("sharedName", /*isTransmissionEnabled*/ false);
+    TestDataViewerCollection dataViewerCollection { };
+    dataViewerCollection.RegisterViewer(viewer);
+
+    dataViewerCollection.DispatchDataViewerEvent(std::vector<uint8_t> { 1, 127, 255 });
+    dataViewerCollection.WaitForPendingPackets();
+
+    EXPECT_TRUE(viewer->localPacketData.empty());
+}
+
+TEST(DataViewerCollectionTests, DispatchDataViewerPacket_MultipleViewers_ShareTheSamePacket)
+{
+    auto viewer1 = std::make_shared<BlockingDataViewer>("sharedName1");
+    auto viewer2 = std::make_shared<BlockingDataViewer>("sharedName2");
+    viewer1->Release();
+    viewer2->Release();
+    TestDataViewerCollection dataViewerCollection { };
+    dataViewerCollection.RegisterViewer(viewer1);
+    dataViewerCollection.RegisterViewer(viewer2);
+
+    DataViewerPacket packet = std::make_shared<const std::vector<uint8_t>>(std::vector<uint8_t> { 1, 2, 3 });
+    dataViewerCollection.DispatchDataViewerPacket(packet);
+    dataViewerCollection.WaitForPendingPackets();
+
+    ASSERT_EQ(viewer1->m_received.size(), size_t { 1 });
+    ASSERT_EQ(viewer2->m_received.size(), size_t { 1 });
+    EXPECT_EQ(viewer1->m_received[0].get(), packet.get());
+    EXPECT_EQ(viewer2->m_received[0].get(), packet.get());
+}
+
+TEST(DataViewerCollectionTests, DispatchDataViewerEvent_LaggingViewer_DoesNotBlockAndDropsOldestPackets)
+{
+    auto viewer = std::make_shared<BlockingDataViewer>("sharedName");
+    TestDataViewerCollection dataViewerCollection { 2 };
+    dataViewerCollection.RegisterViewer(viewer);
+
+    dataViewerCollection.DispatchDataViewerEvent(std::vector<uint8_t> { 0 });
+    viewer->WaitForFirstPacket();
+
+    // The viewer is stuck in the first packet: dispatching must neither block nor grow the queue
+    for (uint8_t i = 1; i <= 5; i++)
+    {
+        dataViewerCollection.DispatchDataViewerEvent(std::vector<uint8_t> { i });
+    }
+    EXPECT_EQ(dataViewerCollection.GetDroppedPacketCount(), size_t { 3 });
+
+    viewer->Release();
+    dataViewerCollection.WaitForPendingPackets();
+    ASSERT_EQ(viewer->m_received.size(), size_t { 3 });
+    EXPECT_THAT(*viewer->m_received[1], Eq(std::vector<uint8_t> { 4 }));
+    EXPECT_THAT(*viewer->m_received[2], Eq(std::vector<uint8_t> { 5 }));
+}
+
+TEST(DataViewerCollectionTests, UnregisterViewer_PendingPackets_AreNotDelivered)
+{
+    auto viewer = std::make_shared<BlockingDataViewer>("sharedName");
+    TestDataViewerCollection dataViewerCollection { };
+    dataViewerCollection.RegisterViewer(viewer);
+
+    dataViewerCollection.DispatchDataViewerEvent(std::vector<uint8_t> { 0 });
+    viewer->WaitForFirstPacket();
+    dataViewerCollection.DispatchDataViewerEvent(std::vector<uint8_t> { 1 });
+    dataViewerCollection.UnregisterViewer("sharedName");
+
+    viewer->Release();
+    dataViewerCollection.WaitForPendingPackets();
+    EXPECT_EQ(viewer->m_received.size(), size_t { 1 });
+}
+
+TEST(DataViewerCollectionTests, Destructor_DropsPendingPacketsOfLaggingViewer)
+{
+    auto viewer = std::make_shared<BlockingDataViewer>("sharedName");
+    std::unique_ptr<TestDataViewerCollection> dataViewerCollection { new TestDataViewerCollection() };
+    dataViewerCollection->RegisterViewer(viewer);
+
+    dataViewerCollection->DispatchDataViewerEvent(std::vector<uint8_t> { 0 });
+    viewer->WaitForFirstPacket();
+    for (uint8_t i = 1; i <= 3; i++)
+    {
+        dataViewerCollection->DispatchDataViewerEvent(std::vector<uint8_t> { i });
+    }
+
+    // The destructor waits for the packet in delivery only
+    std::thread release([&viewer]() {
+        std::this_thread::sleep_for(std::chrono::milliseconds(100));
+        viewer->Release();
+    });
+    dataViewerCollection.reset();
+    release.join();
+    EXPECT_EQ(viewer->m_received.size(), size_t { 1 });
+}
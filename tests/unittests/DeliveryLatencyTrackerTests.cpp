@@ -0,0 +1,136 @@
+//
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// SPDX-License-Identifier: Apache-2.0
+//
+
+#include "common/Common.hpp"
+#include "config/RuntimeConfig_Default.hpp"
+#include "stats/DeliveryLatencyTracker.hpp"
+
+using namespace testing;
+using namespace MAT;
+
+class DeliveryLatencyTrackerTests : public ::testing::Test
+{
+protected:
+    ILogConfiguration configuration;
+    std::unique_ptr<RuntimeConfig_Default> runtimeConfig;
+    std::unique_ptr<DeliveryLatencyTracker> tracker;
+
+    void Create(bool enabled)
+    {
+        configuration[CFG_MAP_METASTATS_CONFIG][CFG_BOOL_METASTATS_DELIVERY_LATENCY] = enabled;
+        runtimeConfig.reset(new RuntimeConfig_Default(configuration));
+        tracker.reset(new DeliveryLatencyTracker(*runtimeConfig));
+    }
+
+    static DeliveryLatencyStats const* Find(std::vector<DeliveryLatencyStats> const& stats, std::string const& tenantToken, EventLatency latency, DeliveryStage stage)
+    {
+        for (auto const& entry : stats)
+        {
+            if (entry.tenantToken == tenantToken && entry.latency == latency && entry.stage == stage)
+            {
+                return &entry;
+            }
+        }
+        return nullptr;
+    }
+};
+
+TEST_F(DeliveryLatencyTrackerTests, DisabledByDefault_RecordsNothing)
+{
+    runtimeConfig.reset(new RuntimeConfig_Default(configuration));
+    tracker.reset(new DeliveryLatencyTracker(*runtimeConfig));
+    EXPECT_FALSE(tracker->IsEnabled());
+    tracker->Record("tenant", EventLatency_Normal, DeliveryStage_Total, 10);
+    EXPECT_TRUE(tracker->GetStats().empty());
+}
+
+TEST_F(DeliveryLatencyTrackerTests, GetStats_ReportsPercentilesPerTenantLatencyAndStage)
+{
+    Create(true);
+    for (int64_t ms = 1; ms <= 1000; ms++)
+    {
+        tracker->Record("tenant-a", EventLatency_Normal, DeliveryStage_Total, ms);
+    }
+    tracker->Record("tenant-a", EventLatency_RealTime, DeliveryStage_Network, 40);
+    tracker->Record("tenant-b", EventLatency_Normal, DeliveryStage_Queue, -5);
+
+    auto stats = tracker->GetStats();
+    ASSERT_EQ(3u, stats.size());
+
+    auto total = Find(stats, "tenant-a", EventLatency_Normal, DeliveryStage_Total);
+    ASSERT_NE(nullptr, total);
+    EXPECT_EQ(1000u, total->count);
+    EXPECT_EQ(1, total->minMs);
+    EXPECT_EQ(1000, total->maxMs);
+    EXPECT_NEAR(500.5, total->meanMs, 0.001);
+    // Percentiles are accurate to the histogram bucket width
+    EXPECT_NEAR(500, total->p50Ms, 500 * 0.25);
+    EXPECT_NEAR(990, total->p99Ms, 990 * 0.25);
+    EXPECT_LE(total->p99Ms, total->p999Ms);
+    EXPECT_LE(total->p999Ms, 1000);
+
+    auto network = Find(stats, "tenant-a", EventLatency_RealTime, DeliveryStage_Network);
+    ASSERT_NE(nullptr, network);
+    EXPECT_EQ(1u, network->count);
+    EXPECT_EQ(40, network->p50Ms);
+    EXPECT_EQ(40, network->p999Ms);
+
+    // Clock adjustments are recorded as 0
+    auto queue = Find(stats, "tenant-b", EventLatency_Normal, DeliveryStage_Queue);
+    ASSERT_NE(nullptr, queue);
+    EXPECT_EQ(0, queue->maxMs);
+}
+
+TEST_F(DeliveryLatencyTrackerTests, TakeInterval_ResetsIntervalButNotTotals)
+{
+    Create(true);
+    tracker->Record("tenant", EventLatency_Normal, DeliveryStage_Storage, 100);
+    tracker->Record("tenant", EventLatency_Normal, DeliveryStage_Storage, 300);
+
+    std::map<std::string, DeliveryLatencyTracker::Snapshots> interval;
+    tracker->TakeInterval(interval);
+    ASSERT_EQ(1u, interval.size());
+    EXPECT_EQ(2u, interval["tenant"][EventLatency_Normal][DeliveryStage_Storage].count);
+    EXPECT_EQ(0u, interval["tenant"][EventLatency_Normal][DeliveryStage_Total].count);
+
+    tracker->TakeInterval(interval);
+    EXPECT_TRUE(interval.empty());
+
+    tracker->Record("tenant", EventLatency_Normal, DeliveryStage_Storage, 200);
+    tracker->TakeInterval(interval);
+    EXPECT_EQ(1u, interval["tenant"][EventLatency_Normal][DeliveryStage_Storage].count);
+
+    auto stats = tracker->GetStats();
+    ASSERT_EQ(1u, stats.size());
+    EXPECT_EQ(3u, stats[0].count);
+    EXPECT_EQ(100, stats[0].minMs);
+    EXPECT_EQ(300, stats[0].maxMs);
+}
+
+TEST_F(DeliveryLatencyTrackerTests, Snapshot_MergeAndPercentile)
+{
+    MetricSeries first(MetricSeries::Kind::Distribution);
+    MetricSeries second(MetricSeries::Kind::Distribution);
+    for (int i = 0; i < 99; i++)
+    {
+        first.Record(10);
+    }
+    second.Record(5000);
+
+    MetricSnapshot merged;
+    MetricSnapshot snapshot;
+    ASSERT_TRUE(first.Harvest(snapshot));
+    merged.Merge(snapshot);
+    ASSERT_TRUE(second.Harvest(snapshot));
+    merged.Merge(snapshot);
+
+    EXPECT_EQ(100u, merged.count);
+    EXPECT_EQ(10, merged.min);
+    EXPECT_EQ(5000, merged.max);
+    EXPECT_NEAR(10, merged.GetPercentile(50), 10 * 0.25);
+    EXPECT_NEAR(10, merged.GetPercentile(99), 10 * 0.25);
+    EXPECT_NEAR(5000, merged.GetPercentile(99.9), 5000 * 0.25);
+    EXPECT_EQ(0, MetricSnapshot().GetPercentile(50));
+}
@@ -0,0 +1,205 @@
+//
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// SPDX-License-Identifier: Apache-2.0
+//
+
+#include "common/Common.hpp"
+#include "config/RuntimeConfig_Default.hpp"
+#include "system/EventCoalescer.hpp"
+
+using namespace testing;
+using namespace MAT;
+
+// Every event hashes to the same window
+class CollidingEventCoalescer : public EventCoalescer
+{
+public:
+    using EventCoalescer::EventCoalescer;
+
+protected:
+    virtual uint64_t fingerprint(IncomingEventContext const&) const override
+    {
+        return 0;
+    }
+};
+
+class EventCoalescerTests : public ::testing::Test
+{
+protected:
+    ILogConfiguration configuration;
+    std::unique_ptr<RuntimeConfig_Default> runtimeConfig;
+    std::unique_ptr<EventCoalescer> coalescer;
+    std::vector<::CsProtocol::Record> emitted;
+    int64_t nextTime = 1000;
+
+    RouteSink<EventCoalescerTests, IncomingEventContextPtr const&> summaries{this, &EventCoalescerTests::onSummary};
+
+    void onSummary(IncomingEventContextPtr const& ctx)
+    {
+        emitted.push_back(*ctx->source);
+    }
+
+    void Create(int64_t windowMs, int64_t maxEntries = 256)
+    {
+        configuration[CFG_MAP_COALESCE][CFG_INT_COALESCE_WINDOW_MS] = windowMs;
+        configuration[CFG_MAP_COALESCE][CFG_INT_COALESCE_MAX_ENTRIES] = maxEntries;
+        runtimeConfig.reset(new RuntimeConfig_Default(configuration));
+        coalescer.reset(new EventCoalescer(*runtimeConfig, *PAL::getDefaultTaskDispatcher()));
+        coalescer->coalesced >> summaries;
+    }
+
+    virtual void TearDown() override
+    {
+        if (coalescer)
+        {
+            coalescer->stop();
+        }
+    }
+
+    bool Send(std::string const& name, std::string const& value, std::string const& tenantToken = "tenant-token")
+    {
+        ::CsProtocol::Record record;
+        record.name = name;
+        record.baseType = name;
+        record.time = nextTime++;
+        record.data.push_back(::CsProtocol::Data());
+        ::CsProtocol::Value property;
+        property.stringValue = value;
+        record.data[0].properties["value"] = property;
+        IncomingEventContext event(PAL::generateUuidString(), tenantToken, EventLatency_Normal, EventPersistence_Normal, &record);
+        return coalescer->coalesce(&event);
+    }
+};
+
+TEST_F(EventCoalescerTests, DisabledByDefault_PassesEverything)
+{
+    runtimeConfig.reset(new RuntimeConfig_Default(configuration));
+    coalescer.reset(new EventCoalescer(*runtimeConfig, *PAL::getDefaultTaskDispatcher()));
+    EXPECT_FALSE(coalescer->IsEnabled());
+    EXPECT_TRUE(Send("event", "a"));
+    EXPECT_TRUE(Send("event", "a"));
+    EXPECT_EQ(0u, coalescer->GetWindowCount());
+}
+
+TEST_F(EventCoalescerTests, Duplicates_AreFoldedIntoOneSummary)
+{
+    Create(60000);
+    EXPECT_TRUE(Send("event", "a"));
+    EXPECT_FALSE(Send("event", "a"));
+    EXPECT_FALSE(Send("event", "a"));
+    EXPECT_FALSE(Send("event", "a"));
+    EXPECT_TRUE(emitted.empty());
+
+    coalescer->flush();
+    ASSERT_EQ(1u, emitted.size());
+    auto& properties = emitted[0].data[0].properties;
+    EXPECT_EQ(3, properties[EventCoalescer::COALESCED_COUNT].longValue);
+    EXPECT_EQ(1001, properties[EventCoalescer::COALESCED_FIRST_TIME].longValue);
+    EXPECT_EQ(1003, properties[EventCoalescer::COALESCED_LAST_TIME].longValue);
+    EXPECT_EQ(::CsProtocol::ValueKind::ValueDateTime, properties[EventCoalescer::COALESCED_LAST_TIME].type);
+    EXPECT_EQ("a", properties["value"].stringValue);
+    EXPECT_EQ(1001, emitted[0].time);
+    EXPECT_EQ(0u, coalescer->GetWindowCount());
+}
+
+TEST_F(EventCoalescerTests, DistinctEvents_PassThrough)
+{
+    Create(60000);
+    EXPECT_TRUE(Send("event", "a"));
+    EXPECT_TRUE(Send("event", "b"));
+    EXPECT_TRUE(Send("other", "a"));
+    EXPECT_TRUE(Send("event", "a", "other-token"));
+    EXPECT_EQ(4u, coalescer->GetWindowCount());
+
+    // Windows without duplicates close without a summary
+    coalescer->flush();
+    EXPECT_TRUE(emitted.empty());
+}
+
+TEST_F(EventCoalescerTests, FingerprintCollision_DoesNotMergeDistinctEvents)
+{
+    Create(60000);
+    coalescer.reset(new CollidingEventCoalescer(*runtimeConfig, *PAL::getDefaultTaskDispatcher()));
+    coalescer->coalesced >> summaries;
+    EXPECT_TRUE(Send("event", "a"));
+    EXPECT_TRUE(Send("event", "b"));
+    EXPECT_FALSE(Send("event", "a"));
+    EXPECT_TRUE(Send("event", "b"));
+    EXPECT_TRUE(Send("event", "a", "other-token"));
+    EXPECT_EQ(1u, coalescer->GetWindowCount());
+
+    coalescer->flush();
+    ASSERT_EQ(1u, emitted.size());
+    EXPECT_EQ(1, emitted[0].data[0].properties[EventCoalescer::COALESCED_COUNT].longValue);
+    EXPECT_EQ("a", emitted[0].data[0].properties["value"].stringValue);
+}
+
+TEST_F(EventCoalescerTests, WindowState_IsBounded)
+{
+    Create(60000, 2);
+    EXPECT_TRUE(Send("event", "a"));
+    EXPECT_FALSE(Send("event", "a"));
+    EXPECT_TRUE(Send("event", "b"));
+    // Third window closes the oldest one early
+    EXPECT_TRUE(Send("event", "c"));
+    EXPECT_EQ(2u, coalescer->GetWindowCount());
+    ASSERT_EQ(1u, emitted.size());
+    EXPECT_EQ("a", emitted[0].data[0].properties["value"].stringValue);
+    // The next "a" opens a new window
+    EXPECT_TRUE(Send("event", "a"));
+}
+
+TEST_F(EventCoalescerTests, ExpiredWindow_EmitsSummaryAndReopens)
+{
+    Create(50);
+    EXPECT_TRUE(Send("event", "a"));
+    EXPECT_FALSE(Send("event", "a"));
+    PAL::sleep(100);
+    EXPECT_TRUE(Send("event", "a"));
+    ASSERT_EQ(1u, emitted.size());
+    EXPECT_EQ(1, emitted[0].data[0].properties[EventCoalescer::COALESCED_COUNT].longValue);
+}
+
+TEST_F(EventCoalescerTests, Stop_FlushesAndPassesLaterEvents)
+{
+    Create(60000);
+    EXPECT_TRUE(Send("event", "a"));
+    EXPECT_FALSE(Send("event", "a"));
+    coalescer->stop();
+    EXPECT_EQ(1u, emitted.size());
+    EXPECT_TRUE(Send("event", "a"));
+    EXPECT_TRUE(Send("event", "a"));
+}
+
+TEST_F(EventCoalescerTests, Fingerprint_CoversPropertyTypesAndAttributes)
+{
+    ::CsProtocol::Record record;
+    record.name = "event";
+    record.data.push_back(::CsProtocol::Data());
+    ::CsProtocol::Value value;
+    value.type = ::CsProtocol::ValueKind::ValueInt64;
+    value.longValue = 1;
+    record.data[0].properties["key"] = value;
+    IncomingEventContext event("id", "tenant-token", EventLatency_Normal, EventPersistence_Normal, &record);
+    const uint64_t original = EventCoalescer::GetFingerprint(event);
+
+    record.data[0].properties["key"].type = ::CsProtocol::ValueKind::ValueDateTime;
+    EXPECT_NE(original, EventCoalescer::GetFingerprint(event));
+    record.data[0].properties["key"].type = ::CsProtocol::ValueKind::ValueInt64;
+    EXPECT_EQ(original, EventCoalescer::GetFingerprint(event));
+
+    ::CsProtocol::Attributes attributes;
+    ::CsProtocol::PII pii;
+    pii.Kind = ::CsProtocol::PIIKind::Identity;
+    attributes.pii.push_back(pii);
+    record.data[0].properties["key"].attributes.push_back(attributes);
+    EXPECT_NE(original, EventCoalescer::GetFingerprint(event));
+    record.data[0].properties["key"].attributes.clear();
+
+    // Per-event fields do not matter
+    record.time = 12345;
+    EXPECT_EQ(original, EventCoalescer::GetFingerprint(event));
+
+    event.record.latency = EventLatency_RealTime;
+    EXPECT_NE(original, EventCoalescer::GetFingerprint(event));
+}
@@ -34,6 +34,26 @@ public:
     bool CanEventPropertiesBeSent(const EventProperties&) const noexcept override { return CanEventPropertiesBeSentReturnValue; }
 };
 
+class CountingEventFilter : public IEventFilter
+{
+public:
+    CountingEventFilter(bool isDecisionCacheable, std::atomic<size_t>& calls) noexcept
+        : IsDecisionCacheableReturnValue(isDecisionCacheable), Calls(calls) { }
+
+    const char* GetName() const noexcept override { return "CountingEventFilter"; }
+
+    bool CanEventPropertiesBeSent(const EventProperties& properties) const noexcept override
+    {
+        Calls++;
+        return properties.GetName() != "Blocked";
+    }
+
+    bool IsDecisionCacheable() const noexcept override { return IsDecisionCacheableReturnValue; }
+
+    bool IsDecisionCacheableReturnValue;
+    std::atomic<size_t>& Calls;
+};
+
 TEST(EventFilterCollectionTests, Constructor_DefaultConstructed_NoRegisteredFilters)
 {
     TestEventFilterCollection collection;
@@ -174,3 +194,102 @@ TEST(EventFilterCollectionTests, CanEventPropertiesBeSent_TwoRegisteredFiltersOn
     collection.RegisterEventFilter(std::unique_ptr<IEventFilter>(new TestEventFilter(false)));
     EXPECT_FALSE(collection.CanEventPropertiesBeSent(EventProperties{}));
 }
+
+TEST(EventFilterCollectionTests, CanEventPropertiesBeSent_CacheableFilter_EvaluatedOncePerNameAndLevel)
+{
+    std::atomic<size_t> calls { 0 };
+    EventFilterCollection collection;
+    collection.RegisterEventFilter(std::unique_ptr<IEventFilter>(new CountingEventFilter(true, calls)));
+
+    EventProperties allowed("Allowed");
+    EventProperties blocked("Blocked");
+    for (int i = 0; i < 10; i++)
+    {
+        EXPECT_TRUE(collection.CanEventPropertiesBeSent(allowed));
+        EXPECT_FALSE(collection.CanEventPropertiesBeSent(blocked));
+    }
+    EXPECT_EQ(calls.load(), size_t { 2 });
+
+    allowed.SetLevel(DIAG_LEVEL_REQUIRED);
+    EXPECT_TRUE(collection.CanEventPropertiesBeSent(allowed));
+    EXPECT_TRUE(collection.CanEventPropertiesBeSent(allowed));
+    EXPECT_EQ(calls.load(), size_t { 3 });
+}
+
+TEST(EventFilterCollectionTests, CanEventPropertiesBeSent_NonCacheableFilter_EvaluatedEveryTime)
+{
+    std::atomic<size_t> calls { 0 };
+    EventFilterCollection collection;
+    collection.RegisterEventFilter(std::unique_ptr<IEventFilter>(new CountingEventFilter(false, calls)));
+
+    for (int i = 0; i < 10; i++)
+    {
+        EXPECT_TRUE(collection.CanEventPropertiesBeSent(EventProperties("Allowed")));
+    }
+    EXPECT_EQ(calls.load(), size_t { 10 });
+}
+
+TEST(EventFilterCollectionTests, CanEventPropertiesBeSent_CacheableAndNonCacheableFilters_BothApply)
+{
+    std::atomic<size_t> calls { 0 };
+    EventFilterCollection collection;
+    collection.RegisterEventFilter(std::unique_ptr<IEventFilter>(new CountingEventFilter(true, calls)));
+    collection.RegisterEventFilter(std::unique_ptr<IEventFilter>(new TestEventFilter(false)));
+
+    EXPECT_FALSE(collection.CanEventPropertiesBeSent(EventProperties("Allowed")));
+    collection.UnregisterEventFilter(DefaultTestEventFilterName);
+    EXPECT_TRUE(collection.CanEventPropertiesBeSent(EventProperties("Allowed")));
+}
+
+TEST(EventFilterCollectionTests, RegisterEventFilter_CachedDecisions_AreInvalidated)
+{
+    std::atomic<size_t> calls { 0 };
+    EventFilterCollection collection;
+    collection.RegisterEventFilter(std::unique_ptr<IEventFilter>(new CountingEventFilter(true, calls)));
+
+    EXPECT_TRUE(collection.CanEventPropertiesBeSent(EventProperties("Allowed")));
+    EXPECT_TRUE(collection.CanEventPropertiesBeSent(EventProperties("Allowed")));
+    EXPECT_EQ(calls.load(), size_t { 1 });
+
+    collection.RegisterEventFilter(std::unique_ptr<IEventFilter>(new TestEventFilter(true)));
+    EXPECT_TRUE(collection.CanEventPropertiesBeSent(EventProperties("Allowed")));
+    EXPECT_EQ(calls.load(), size_t { 2 });
+}
+
+TEST(EventFilterCollectionTests, CanEventPropertiesBeSent_ManyDistinctNames_StaysCorrect)
+{
+    std::atomic<size_t> calls { 0 };
+    EventFilterCollection collection;
+    collection.RegisterEventFilter(std::unique_ptr<IEventFilter>(new CountingEventFilter(true, calls)));
+
+    // More keys than cache slots: decisions not cached must still be evaluated
+    for (int round = 0; round < 2; round++)
+    {
+        for (int i = 0; i < 1000; i++)
+        {
+            EXPECT_TRUE(collection.CanEventPropertiesBeSent(EventProperties("Event" + std::to_string(i))));
+        }
+        EXPECT_FALSE(collection.CanEventPropertiesBeSent(EventProperties("Blocked")));
+    }
+}
+
+TEST(EventFilterCollectionTests, CanEventPropertiesBeSent_FullCache_KeepsCachedDecisions)
+{
+    std::atomic<size_t> calls { 0 };
+    EventFilterCollection collection;
+    collection.RegisterEventFilter(std::unique_ptr<IEventFilter>(new CountingEventFilter(true, calls)));
+
+    EXPECT_TRUE(collection.CanEventPropertiesBeSent(EventProperties("Allowed")));
+    for (int i = 0; i < 1000; i++)
+    {
+        EXPECT_TRUE(collection.CanEventPropertiesBeSent(EventProperties("Event" + std::to_string(i))));
+    }
+    calls = 0;
+
+    // Names that found no free slot are evaluated every time, cached ones never again
+    for (int round = 0; round < 3; round++)
+    {
+        EXPECT_TRUE(collection.CanEventPropertiesBeSent(EventProperties("Allowed")));
+    }
+    EXPECT_EQ(calls.load(), size_t { 0 });
+}
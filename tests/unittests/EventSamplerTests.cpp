@@ -0,0 +1,166 @@
+//
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// SPDX-License-Identifier: Apache-2.0
+//
+
+#include "common/Common.hpp"
+#include "filter/EventSampler.hpp"
+
+using namespace testing;
+using namespace MAT;
+
+class EventSamplerTests : public ::testing::Test
+{
+protected:
+    ILogConfiguration config;
+
+    void AddRule(const char* tenant, const char* event, int level, Variant rate)
+    {
+        VariantMap rule;
+        if (tenant != nullptr)
+            rule["tenant"] = tenant;
+        if (event != nullptr)
+            rule["event"] = event;
+        if (level >= 0)
+            rule["level"] = level;
+        rule[CFG_INT_SAMPLE_RATE] = rate;
+        if (!config.HasConfig(CFG_MAP_SAMPLE) || config[CFG_MAP_SAMPLE].type != Variant::TYPE_OBJ)
+        {
+            config[CFG_MAP_SAMPLE] = VariantMap();
+        }
+        VariantMap& sampleConfig = config[CFG_MAP_SAMPLE];
+        if (sampleConfig.find(CFG_ARR_SAMPLE_RULES) == sampleConfig.end())
+        {
+            sampleConfig[CFG_ARR_SAMPLE_RULES] = VariantArray();
+        }
+        VariantArray& rules = sampleConfig[CFG_ARR_SAMPLE_RULES];
+        rules.push_back(rule);
+    }
+};
+
+TEST_F(EventSamplerTests, DisabledByDefault)
+{
+    EventSampler sampler(config);
+    EXPECT_FALSE(sampler.IsEnabled());
+    EXPECT_EQ(EventSampler::FullRate, sampler.GetSampleRate("tenant-token", "event", 1));
+    EXPECT_TRUE(sampler.IsSampledIn(sampler.GetSampleRate("tenant-token", "event", 1)));
+}
+
+TEST_F(EventSamplerTests, LegacyZeroDefaultRate_DoesNotSample)
+{
+    config[CFG_MAP_SAMPLE][CFG_INT_SAMPLE_RATE] = 0;
+    EventSampler sampler(config);
+    EXPECT_FALSE(sampler.IsEnabled());
+    EXPECT_EQ(EventSampler::FullRate, sampler.GetSampleRate("tenant-token", "event", 1));
+}
+
+TEST_F(EventSamplerTests, DefaultRate_AppliesToUnmatchedEvents)
+{
+    config[CFG_MAP_SAMPLE][CFG_INT_SAMPLE_RATE] = 25;
+    AddRule(nullptr, "important", -1, 100);
+    EventSampler sampler(config);
+    EXPECT_TRUE(sampler.IsEnabled());
+    EXPECT_EQ(25.0, sampler.GetSampleRate("tenant-token", "other", 1));
+    EXPECT_EQ(100.0, sampler.GetSampleRate("tenant-token", "important", 1));
+}
+
+TEST_F(EventSamplerTests, Rules_MatchTenantEventAndLevel)
+{
+    AddRule("tenant", "debug.*", 3, 1.5);
+    AddRule(nullptr, "debug.*", -1, 10);
+    AddRule("other", nullptr, -1, 50);
+    EventSampler sampler(config);
+    ASSERT_TRUE(sampler.IsEnabled());
+
+    EXPECT_EQ(1.5, sampler.GetSampleRate("tenant-token", "debug.trace", 3));
+    EXPECT_EQ(10.0, sampler.GetSampleRate("tenant-token", "debug.trace", 2));
+    EXPECT_EQ(10.0, sampler.GetSampleRate("tenantx-token", "debug.trace", 3));
+    EXPECT_EQ(50.0, sampler.GetSampleRate("other-token", "usage", 1));
+    EXPECT_EQ(100.0, sampler.GetSampleRate("tenant-token", "usage", 1));
+    EXPECT_EQ(100.0, sampler.GetSampleRate("tenant-token", "debug", 1));
+}
+
+TEST_F(EventSamplerTests, Rules_WithoutRateAreIgnored)
+{
+    config[CFG_MAP_SAMPLE][CFG_ARR_SAMPLE_RULES] = VariantArray();
+    VariantArray& rules = config[CFG_MAP_SAMPLE][CFG_ARR_SAMPLE_RULES];
+    VariantMap rule;
+    rule["event"] = "noise";
+    rules.push_back(rule);
+    EventSampler sampler(config);
+    EXPECT_FALSE(sampler.IsEnabled());
+}
+
+TEST_F(EventSamplerTests, Rates_AreClamped)
+{
+    AddRule(nullptr, "low", -1, -5);
+    AddRule(nullptr, "high", -1, 500);
+    EventSampler sampler(config);
+    EXPECT_EQ(0.0, sampler.GetSampleRate("t-token", "low", 1));
+    EXPECT_EQ(100.0, sampler.GetSampleRate("t-token", "high", 1));
+    EXPECT_FALSE(sampler.IsSampledIn(0.0));
+    EXPECT_TRUE(sampler.IsSampledIn(100.0));
+}
+
+TEST_F(EventSamplerTests, SameSamplingId_GivesSameDecisions)
+{
+    AddRule(nullptr, nullptr, -1, 30);
+    config[CFG_MAP_SAMPLE][CFG_STR_SAMPLE_KEY] = "user-1234";
+    EventSampler first(config);
+    EventSampler second(config);
+    EXPECT_EQ(EventSampler::GetBucket("user-1234"), first.GetBucket());
+    EXPECT_EQ(first.GetBucket(), second.GetBucket());
+    for (double rate : { 0.5, 10.0, 30.0, 75.0 })
+    {
+        EXPECT_EQ(first.IsSampledIn(rate), second.IsSampledIn(rate));
+        EXPECT_EQ(first.GetBucket() < rate * 100, first.IsSampledIn(rate));
+    }
+}
+
+TEST_F(EventSamplerTests, Decisions_AreMonotonicInRate)
+{
+    AddRule(nullptr, nullptr, -1, 30);
+    config[CFG_MAP_SAMPLE][CFG_STR_SAMPLE_KEY] = "session";
+    EventSampler sampler(config);
+    bool previous = false;
+    for (double rate = 0.0; rate <= 100.0; rate += 0.5)
+    {
+        bool kept = sampler.IsSampledIn(rate);
+        EXPECT_TRUE(kept || !previous) << "rate " << rate;
+        previous = kept;
+    }
+    EXPECT_TRUE(previous);
+}
+
+TEST_F(EventSamplerTests, Buckets_ApproximateRateAcrossDevices)
+{
+    const size_t devices = 20000;
+    size_t kept = 0;
+    for (size_t i = 0; i < devices; i++)
+    {
+        std::string id = "device-" + std::to_string(i);
+        if (EventSampler::GetBucket(id) < 1000)
+        {
+            kept++;
+        }
+    }
+    // 10% of devices, give or take 2%
+    EXPECT_THAT(kept, AllOf(Ge(devices * 8 / 100), Le(devices * 12 / 100)));
+}
+
+TEST_F(EventSamplerTests, SampledOutCounters_AreTakenPerTenant)
+{
+    EventSampler sampler;
+    sampler.GetSampledOutCounter("t1").fetch_add(2);
+    sampler.GetSampledOutCounter("t2").fetch_add(1);
+    sampler.GetSampledOutCounter("t3");
+    EXPECT_EQ(&sampler.GetSampledOutCounter("t1"), &sampler.GetSampledOutCounter("t1"));
+
+    std::map<std::string, unsigned> counts;
+    sampler.TakeSampledOut(counts);
+    EXPECT_THAT(counts, ElementsAre(Pair("t1", 2u), Pair("t2", 1u)));
+
+    counts.clear();
+    sampler.TakeSampledOut(counts);
+    EXPECT_TRUE(counts.empty());
+}
@@ -0,0 +1,128 @@
+//
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// SPDX-License-Identifier: Apache-2.0
+//
+#include "common/Common.hpp"
+#include "common/TlsHttpServer.hpp"
+
+#if defined(HAVE_MAT_DEFAULT_HTTP_CLIENT) && defined(HAVE_MAT_TEST_TLS) && !defined(_MSC_VER)
+
+#include "http/HttpClient_Curl.hpp"
+
+#include <condition_variable>
+
+using namespace testing;
+using namespace MAT;
+
+class HttpClientCurlTests : public Test,
+                            public IHttpResponseCallback
+{
+  protected:
+    TlsHttpServer                    server;
+    std::string                      url;
+    std::unique_ptr<HttpClient_Curl> client;
+
+    std::mutex                       lock;
+    std::condition_variable          responded;
+    std::vector<std::unique_ptr<IHttpResponse>> responses;
+
+    virtual void SetUp() override
+    {
+        url = "https://127.0.0.1:" + std::to_string(server.start()) + "/OneCollector/1.0/";
+        client.reset(new HttpClient_Curl());
+    }
+
+    virtual void TearDown() override
+    {
+        client.reset();
+        server.stop();
+    }
+
+    virtual void OnHttpResponse(IHttpResponse* response) override
+    {
+        std::lock_guard<std::mutex> guard(lock);
+        responses.emplace_back(response);
+        responded.notify_all();
+    }
+
+    IHttpResponse& Post()
+    {
+        IHttpRequest* request = client->CreateRequest();
+        request->SetMethod("POST");
+        request->SetUrl(url);
+        std::vector<uint8_t> body { '{', '}' };
+        request->SetBody(body);
+        size_t expected = responses.size() + 1;
+        client->SendRequestAsync(request, this);
+        std::unique_lock<std::mutex> guard(lock);
+        EXPECT_TRUE(responded.wait_for(guard, std::chrono::seconds(10), [&]() { return responses.size() >= expected; }));
+        // The request is not owned by the client
+        std::unique_ptr<IHttpRequest> owned(request);
+        return *responses.back();
+    }
+};
+
+TEST_F(HttpClientCurlTests, Upload_ConnectsOnce)
+{
+    EXPECT_THAT(Post().GetStatusCode(), Eq(200u));
+    EXPECT_THAT(server.requests.load(), Eq(1u));
+    EXPECT_THAT(server.handshakes.load(), Eq(1u));
+}
+
+TEST_F(HttpClientCurlTests, NextUpload_ResumesTlsSession)
+{
+    EXPECT_THAT(Post().GetStatusCode(), Eq(200u));
+    EXPECT_THAT(Post().GetStatusCode(), Eq(200u));
+    EXPECT_THAT(server.handshakes.load(), Eq(2u));
+    EXPECT_THAT(server.resumedHandshakes.load(), Eq(1u));
+}
+
+TEST_F(HttpClientCurlTests, Prewarm_FirstUploadResumesTlsSession)
+{
+    client->Prewarm(url);
+    client->Prewarm(url);
+    EXPECT_THAT(Post().GetStatusCode(), Eq(200u));
+    EXPECT_THAT(server.requests.load(), Eq(1u));
+    EXPECT_THAT(server.handshakes.load(), Eq(2u));
+    EXPECT_THAT(server.resumedHandshakes.load(), Eq(1u));
+}
+
+TEST_F(HttpClientCurlTests, Prewarm_ClosesItsConnection)
+{
+    client->Prewarm(url);
+    EXPECT_THAT(Post().GetStatusCode(), Eq(200u));
+    for (int i = 0; (i < 100) && (server.openConnections.load() > 0); i++)
+    {
+        std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    }
+    EXPECT_THAT(server.openConnections.load(), Eq(0u));
+}
+
+TEST_F(HttpClientCurlTests, Prewarm_UnreachableHostDoesNotBlockShutdown)
+{
+    client->Prewarm("https://127.0.0.1:1/");
+    client.reset();
+}
+
+#if LIBCURL_VERSION_NUM >= 0x080C00
+TEST_F(HttpClientCurlTests, ImportedTlsSessions_AreResumedAfterRestart)
+{
+    EXPECT_THAT(Post().GetStatusCode(), Eq(200u));
+    std::string sessions = client->ExportTlsSessions();
+    EXPECT_THAT(sessions, Not(IsEmpty()));
+
+    client.reset(new HttpClient_Curl());
+    EXPECT_THAT(client->ImportTlsSessions(sessions + "garbage\n"), Gt(0u));
+    EXPECT_THAT(Post().GetStatusCode(), Eq(200u));
+    EXPECT_THAT(server.resumedHandshakes.load(), Eq(1u));
+}
+#else
+TEST_F(HttpClientCurlTests, TlsSessionExport_NeedsCurl8_12)
+{
+    EXPECT_THAT(Post().GetStatusCode(), Eq(200u));
+    EXPECT_THAT(client->ExportTlsSessions(), IsEmpty());
+    EXPECT_THAT(client->ImportTlsSessions("00 00 00 0\n"), Eq(0u));
+}
+#endif
+
+#endif
@@ -1,6 +1,7 @@
 // Copyright (c) Microsoft Corporation. All rights reserved.
 
 #include "common/Common.hpp"
+#include "common/MockIBandwidthController.hpp"
 #include "common/MockIHttpClient.hpp"
 #include "http/HttpClientManager.hpp"
 
@@ -14,8 +15,8 @@ static NullLogManager dummyLogManager;
 
 class HttpClientManager4Test : public HttpClientManager {
   public:
-    HttpClientManager4Test(IHttpClient& httpClient)
-      : HttpClientManager(dummyLogManager, httpClient, *PAL::getDefaultTaskDispatcher())
+    HttpClientManager4Test(IHttpClient& httpClient, IBandwidthController* bandwidthController = nullptr)
+      : HttpClientManager(dummyLogManager, httpClient, *PAL::getDefaultTaskDispatcher(), bandwidthController)
     {
     }
 
@@ -74,3 +75,30 @@ TEST_F(HttpClientManagerTests, HandlesRequestFlow)
     EXPECT_THAT(ctx->httpResponse, rspRef);
     EXPECT_THAT(ctx->durationMs, Gt(199));
 }
+
+TEST(HttpClientManagerBandwidthTests, ChargesTheRequestedLatency)
+{
+    MockIHttpClient httpClientMock;
+    StrictMock<MockIBandwidthController> bandwidthControllerMock;
+    HttpClientManager4Test hcm(httpClientMock, &bandwidthControllerMock);
+
+    SimpleHttpRequest* req = new SimpleHttpRequest("HttpClientManagerTests");
+    auto ctx = std::make_shared<EventsUploadContext>();
+    ctx->httpRequestId = req->GetId();
+    ctx->httpRequest = req;
+    ctx->requestedMinLatency = EventLatency_RealTime;
+    ctx->latency = EventLatency_Normal;
+
+    // The TPM checked the RealTime budget before packaging a Normal package
+    EXPECT_CALL(bandwidthControllerMock, OnBytesSent(EventLatency_RealTime, _));
+    IHttpResponseCallback* callback = nullptr;
+    EXPECT_CALL(httpClientMock, SendRequestAsync(ctx->httpRequest, _))
+        .WillOnce(SaveArg<1>(&callback));
+    hcm.sendRequest(ctx);
+    ASSERT_THAT(callback, NotNull());
+
+    std::unique_ptr<SimpleHttpResponse> rsp(new SimpleHttpResponse("HttpClientManagerTests"));
+    rsp->m_result = HttpResult_OK;
+    rsp->m_statusCode = 200;
+    callback->OnHttpResponse(rsp.release());
+}
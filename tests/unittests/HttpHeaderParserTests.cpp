@@ -0,0 +1,113 @@
+//
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// SPDX-License-Identifier: Apache-2.0
+//
+
+#include "common/Common.hpp"
+#include "http/HttpHeaderParser.hpp"
+
+using namespace testing;
+using namespace MAT;
+
+class HttpHeaderParserTests : public Test
+{
+protected:
+    HttpHeaders      headers;
+    HttpHeaderParser parser{headers};
+
+    void Feed(std::string const& data)
+    {
+        parser.Feed(data.data(), data.size());
+    }
+};
+
+TEST_F(HttpHeaderParserTests, ParsesStatusAndHeaders)
+{
+    Feed("HTTP/1.1 200 OK\r\n");
+    Feed("Content-Type: application/json\r\n");
+    Feed("time-delta-millis:   1234  \r\n");
+    Feed("\r\n");
+
+    EXPECT_THAT(parser.GetStatusCode(), Eq(200));
+    EXPECT_THAT(headers.size(), Eq(2u));
+    EXPECT_THAT(headers.get("Content-Type"), Eq("application/json"));
+    EXPECT_THAT(headers.get("time-delta-millis"), Eq("1234"));
+}
+
+TEST_F(HttpHeaderParserTests, RepeatedHeadersAreKept)
+{
+    Feed("HTTP/2 200\r\nkill-tokens: a\r\nkill-tokens: b\r\nkill-duration: 60\r\n\r\n");
+
+    EXPECT_THAT(parser.GetStatusCode(), Eq(200));
+    EXPECT_THAT(headers.count("kill-tokens"), Eq(2u));
+    EXPECT_THAT(headers, Contains(Pair("kill-tokens", "a")));
+    EXPECT_THAT(headers, Contains(Pair("kill-tokens", "b")));
+}
+
+TEST_F(HttpHeaderParserTests, LinesSplitAcrossCalls)
+{
+    Feed("HTTP/1.1 5");
+    Feed("03 Service Unavailable\r\nRetry-");
+    Feed("After: 1");
+    Feed("20\r");
+    Feed("\nX-Last: value");
+    parser.Finish();
+
+    EXPECT_THAT(parser.GetStatusCode(), Eq(503));
+    EXPECT_THAT(headers.get("Retry-After"), Eq("120"));
+    EXPECT_THAT(headers.get("X-Last"), Eq("value"));
+}
+
+TEST_F(HttpHeaderParserTests, FinalResponseReplacesInterimOne)
+{
+    Feed("HTTP/1.1 100 Continue\r\nX-Interim: 1\r\n\r\n");
+    Feed("HTTP/1.1 204 No Content\r\nX-Final: 2\r\n\r\n");
+
+    EXPECT_THAT(parser.GetStatusCode(), Eq(204));
+    EXPECT_FALSE(headers.has("X-Interim"));
+    EXPECT_THAT(headers.get("X-Final"), Eq("2"));
+}
+
+TEST_F(HttpHeaderParserTests, FoldedAndMalformedLines)
+{
+    Feed("HTTP/1.1 200 OK\r\nX-Folded: first\r\n  second\r\nno colon here\r\n: no name\r\nX-Empty:\r\n\r\n");
+
+    EXPECT_THAT(headers.size(), Eq(2u));
+    EXPECT_THAT(headers.get("X-Folded"), Eq("first second"));
+    EXPECT_TRUE(headers.has("X-Empty"));
+    EXPECT_THAT(headers.get("X-Empty"), IsEmpty());
+}
+
+TEST_F(HttpHeaderParserTests, Reset_ClearsHeaders)
+{
+    Feed("HTTP/1.1 200 OK\r\nX-Header: 1\r\npartial");
+    parser.Reset();
+    parser.Finish();
+
+    EXPECT_THAT(parser.GetStatusCode(), Eq(0));
+    EXPECT_THAT(headers, IsEmpty());
+}
+
+TEST(HttpHeaderParserStatusTests, ParseStatusLine)
+{
+    long status = 0;
+    EXPECT_TRUE(HttpHeaderParser::ParseStatusLine("HTTP/1.0 404 Not Found", 22, status));
+    EXPECT_THAT(status, Eq(404));
+    EXPECT_FALSE(HttpHeaderParser::ParseStatusLine("HTTP/1.1 20", 11, status));
+    EXPECT_FALSE(HttpHeaderParser::ParseStatusLine("HTTP/1.1 2000", 13, status));
+    EXPECT_FALSE(HttpHeaderParser::ParseStatusLine("Content-Type: x", 15, status));
+    EXPECT_THAT(status, Eq(404));
+}
+
+TEST(HttpHeadersTests, GetFallsBackToCaseInsensitiveMatch)
+{
+    HttpHeaders headers;
+    headers.add("retry-after", "30");
+    headers.add("Time-Delta-Millis", "5");
+
+    EXPECT_THAT(headers.get("Retry-After"), Eq("30"));
+    EXPECT_THAT(headers.get("time-delta-millis"), Eq("5"));
+    EXPECT_TRUE(headers.has("RETRY-AFTER"));
+    EXPECT_FALSE(headers.has("Retry-After-"));
+    EXPECT_THAT(headers.get("retry_after"), IsEmpty());
+}
@@ -3,6 +3,7 @@
 #include "common/Common.hpp"
 #include "common/MockIHttpClient.hpp"
 #include "http/HttpRequestEncoder.hpp"
+#include "api/AuthTokensController.hpp"
 #include "config/RuntimeConfig_Default.hpp"
 
 using namespace testing;
@@ -25,6 +26,20 @@ public:
     StorageBlob dataPacket;
 };
 
+class AuthHttpRequestEncoder : public HttpRequestEncoder
+{
+public:
+    AuthHttpRequestEncoder(ITelemetrySystem& system, IHttpClient& httpClient)
+        : HttpRequestEncoder(system, httpClient) { }
+
+    IAuthTokensController* GetAuthTokensController() override
+    {
+        return &authTokens;
+    }
+
+    AuthTokensController authTokens;
+};
+
 class HttpRequestEncoderTests : public Test {
 
 public:
@@ -126,3 +141,98 @@ TEST_F(HttpRequestEncoderTests, DispatchDataViewerEventCorrectly)
 
     EXPECT_THAT(mockEncoder.dataPacket, Eq(std::vector<uint8_t>{1, 127, 255}));
 }
+
+TEST_F(HttpRequestEncoderTests, AuthHeadersFollowTokenChanges)
+{
+    EventsUploadContextPtr ctx = std::make_shared<EventsUploadContext>();
+    ctx->packageIds["tenant1-token"] = 0;
+    AuthHttpRequestEncoder authEncoder(system, mockHttpClient);
+
+    authEncoder.encode(ctx);
+    SimpleHttpRequest const* req = static_cast<SimpleHttpRequest*>(ctx->httpRequest);
+    EXPECT_THAT(req->m_headers.get("Aad-Token"), IsEmpty());
+    EXPECT_THAT(req->m_headers, Contains(Pair("APIKey", "tenant1-token")));
+
+    authEncoder.authTokens.SetTicketToken(TicketType::TicketType_AAD, "token1");
+    authEncoder.encode(ctx);
+    req = static_cast<SimpleHttpRequest*>(ctx->httpRequest);
+    EXPECT_THAT(req->m_headers, Contains(Pair("Aad-Token", "token1")));
+
+    authEncoder.authTokens.SetTicketToken(TicketType::TicketType_AAD, "token2");
+    authEncoder.authTokens.SetTicketToken(TicketType::TicketType_MSA_User, "user");
+    authEncoder.authTokens.SetStrictMode(true);
+    authEncoder.encode(ctx);
+    req = static_cast<SimpleHttpRequest*>(ctx->httpRequest);
+    EXPECT_THAT(req->m_headers, Contains(Pair("Aad-Token", "token2")));
+    EXPECT_THAT(req->m_headers, Contains(Pair("Tickets", "\"1000" + std::to_string(TicketType::TicketType_MSA_User) + "\"=\"p:user\"")));
+    EXPECT_THAT(req->m_headers, Contains(Pair("Strict", "true")));
+
+    authEncoder.authTokens.Clear();
+    authEncoder.authTokens.SetStrictMode(false);
+    authEncoder.encode(ctx);
+    req = static_cast<SimpleHttpRequest*>(ctx->httpRequest);
+    EXPECT_THAT(req->m_headers.get("Aad-Token"), IsEmpty());
+    EXPECT_THAT(req->m_headers.get("Tickets"), IsEmpty());
+    EXPECT_THAT(req->m_headers.get("Strict"), IsEmpty());
+    EXPECT_THAT(req->m_headers, Contains(Pair("APIKey", "tenant1-token")));
+}
+
+TEST_F(HttpRequestEncoderTests, AuthHeadersFollowTokensSetWhileRendering)
+{
+    // Sets a device token while the encoder has read the device tokens but not yet the user tokens
+    class RacingAuthTokensController : public AuthTokensController
+    {
+    public:
+        std::map<TicketType, std::string> const& GetUserTokens() override
+        {
+            if (!raced)
+            {
+                raced = true;
+                SetTicketToken(TicketType::TicketType_AAD, "late");
+            }
+            return AuthTokensController::GetUserTokens();
+        }
+        bool raced = false;
+    };
+    class RacingHttpRequestEncoder : public HttpRequestEncoder
+    {
+    public:
+        RacingHttpRequestEncoder(ITelemetrySystem& system, IHttpClient& httpClient)
+            : HttpRequestEncoder(system, httpClient) { }
+
+        IAuthTokensController* GetAuthTokensController() override
+        {
+            return &authTokens;
+        }
+
+        RacingAuthTokensController authTokens;
+    };
+
+    EventsUploadContextPtr ctx = std::make_shared<EventsUploadContext>();
+    ctx->packageIds["tenant1-token"] = 0;
+    RacingHttpRequestEncoder racingEncoder(system, mockHttpClient);
+
+    racingEncoder.encode(ctx);
+    SimpleHttpRequest const* req = static_cast<SimpleHttpRequest*>(ctx->httpRequest);
+    EXPECT_THAT(req->m_headers.get("Aad-Token"), IsEmpty());
+
+    racingEncoder.encode(ctx);
+    req = static_cast<SimpleHttpRequest*>(ctx->httpRequest);
+    EXPECT_THAT(req->m_headers, Contains(Pair("Aad-Token", "late")));
+}
+
+TEST_F(HttpRequestEncoderTests, UploadTimeIsSetPerRequest)
+{
+    EventsUploadContextPtr ctx = std::make_shared<EventsUploadContext>();
+    int64_t before = PAL::getUtcSystemTimeMs();
+    encoder.encode(ctx);
+    SimpleHttpRequest const* req = static_cast<SimpleHttpRequest*>(ctx->httpRequest);
+    EXPECT_THAT(std::stoll(req->m_headers.get("Upload-Time")), Ge(before));
+
+    PAL::sleep(5);
+    before = PAL::getUtcSystemTimeMs();
+    encoder.encode(ctx);
+    req = static_cast<SimpleHttpRequest*>(ctx->httpRequest);
+    EXPECT_THAT(std::stoll(req->m_headers.get("Upload-Time")), Ge(before));
+    EXPECT_THAT(req->m_headers.count("Upload-Time"), Eq(1u));
+}
@@ -0,0 +1,417 @@
+//
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// SPDX-License-Identifier: Apache-2.0
+//
+
+#include "common/Common.hpp"
+
+#ifdef HAVE_MAT_LOCAL_AGENT
+
+#include "common/HttpServer.hpp"
+#include "http/HttpClient_LocalAgent.hpp"
+#include "http/LocalAgentProtocol.hpp"
+#include "http/LocalAgentServer.hpp"
+#ifdef HAVE_MAT_DEFAULT_HTTP_CLIENT
+#include "http/HttpClient_Curl.hpp"
+#endif
+
+#include <condition_variable>
+#include <cstdio>
+#include <cstring>
+#include <mutex>
+
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+using namespace testing;
+using namespace MAT;
+
+namespace
+{
+    /// Upstream client of the forwarder: records requests and either answers them
+    /// immediately or holds them until they are cancelled.
+    class FakeUpstream : public IHttpClient
+    {
+    public:
+        bool hold = false;
+        std::mutex lock;
+        std::vector<std::unique_ptr<SimpleHttpRequest>> received;
+        std::map<std::string, IHttpResponseCallback*> held;
+
+        virtual IHttpRequest* CreateRequest() override
+        {
+            return new SimpleHttpRequest("UP-" + std::to_string(nextId++));
+        }
+
+        virtual void SendRequestAsync(IHttpRequest* request, IHttpResponseCallback* callback) override
+        {
+            auto simple = static_cast<SimpleHttpRequest*>(request);
+            {
+                std::lock_guard<std::mutex> guard(lock);
+                std::unique_ptr<SimpleHttpRequest> copy(new SimpleHttpRequest(simple->m_id));
+                copy->m_method = simple->m_method;
+                copy->m_url = simple->m_url;
+                copy->m_headers = simple->m_headers;
+                copy->m_body = simple->m_body;
+                copy->m_latency = simple->m_latency;
+                received.push_back(std::move(copy));
+                if (hold)
+                {
+                    held[simple->m_id] = callback;
+                    return;
+                }
+            }
+            auto response = new SimpleHttpResponse(simple->m_id);
+            response->m_result = HttpResult_OK;
+            response->m_statusCode = 200;
+            response->m_headers.add("time-delta-millis", "42");
+            response->m_body.assign({'{', '}'});
+            callback->OnHttpResponse(response);
+        }
+
+        virtual void CancelRequestAsync(std::string const& id) override
+        {
+            IHttpResponseCallback* callback = nullptr;
+            {
+                std::lock_guard<std::mutex> guard(lock);
+                auto it = held.find(id);
+                if (it == held.end())
+                {
+                    return;
+                }
+                callback = it->second;
+                held.erase(it);
+            }
+            auto response = new SimpleHttpResponse(id);
+            response->m_result = HttpResult_Aborted;
+            callback->OnHttpResponse(response);
+        }
+
+        size_t GetReceivedCount()
+        {
+            std::lock_guard<std::mutex> guard(lock);
+            return received.size();
+        }
+
+    protected:
+        int nextId = 0;
+    };
+
+    /// Collector stand-in for a real upstream client: answers every upload with 200.
+    class CollectorStub : public HttpServer::Callback
+    {
+    public:
+        HttpServer server;
+        int port;
+
+        CollectorStub()
+        {
+            port = server.addListeningPort(0);
+            server.addHandler("/OneCollector/", *this);
+            server.start();
+        }
+
+        ~CollectorStub()
+        {
+            server.stop();
+        }
+
+        virtual int onHttpRequest(HttpServer::Request const&, HttpServer::Response& response) override
+        {
+            response.headers["Content-Type"] = "application/json";
+            response.content = "{}";
+            return 200;
+        }
+    };
+
+    class ResponseWaiter : public IHttpResponseCallback
+    {
+    public:
+        std::unique_ptr<IHttpResponse> response;
+
+        virtual void OnHttpResponse(IHttpResponse* result) override
+        {
+            std::lock_guard<std::mutex> guard(lock);
+            response.reset(result);
+            done.notify_all();
+        }
+
+        virtual void OnHttpStateEvent(HttpStateEvent, void*, size_t) override
+        {
+        }
+
+        bool Wait()
+        {
+            std::unique_lock<std::mutex> guard(lock);
+            return done.wait_for(guard, std::chrono::seconds(10), [this]() { return response != nullptr; });
+        }
+
+    protected:
+        std::mutex lock;
+        std::condition_variable done;
+    };
+}
+
+class LocalAgentTests : public Test
+{
+protected:
+    std::string socketPath;
+    FakeUpstream upstream;
+    std::set<std::string> collectorUrls { "https://collector.example/OneCollector/1.0/" };
+
+    virtual void SetUp() override
+    {
+        socketPath = "/tmp/LocalAgentTests." + std::to_string(getpid()) + ".sock";
+    }
+
+    virtual void TearDown() override
+    {
+        std::remove(socketPath.c_str());
+    }
+
+    static std::unique_ptr<IHttpRequest> MakeRequest(IHttpClient& client, size_t bodySize)
+    {
+        std::unique_ptr<IHttpRequest> request(client.CreateRequest());
+        request->SetMethod("POST");
+        request->SetUrl("https://collector.example/OneCollector/1.0/");
+        request->GetHeaders().add("Client-Id", "NO_AUTH");
+        request->GetHeaders().add("Content-Type", "application/bond-compact-binary");
+        std::vector<uint8_t> body(bodySize);
+        for (size_t i = 0; i < bodySize; i++)
+        {
+            body[i] = static_cast<uint8_t>(i * 7);
+        }
+        request->SetBody(body);
+        request->SetLatency(EventLatency_RealTime);
+        return request;
+    }
+};
+
+TEST_F(LocalAgentTests, Request_RoundTrip)
+{
+    LocalAgentProtocol::Request request;
+    request.id = "LA-7";
+    request.method = "POST";
+    request.url = "https://collector.example/";
+    request.headers.add("a", "1");
+    request.headers.add("a", "2");
+    request.latency = EventLatency_Max;
+    request.body.assign({1, 2, 3});
+
+    std::vector<uint8_t> payload;
+    LocalAgentProtocol::EncodeRequest(request, false, payload);
+    LocalAgentProtocol::Request decoded;
+    ASSERT_TRUE(LocalAgentProtocol::DecodeRequest(payload, false, decoded));
+    EXPECT_THAT(decoded.id, Eq("LA-7"));
+    EXPECT_THAT(decoded.method, Eq("POST"));
+    EXPECT_THAT(decoded.url, Eq(request.url));
+    EXPECT_THAT(decoded.headers.count("a"), Eq(2u));
+    EXPECT_THAT(decoded.latency, Eq(EventLatency_Max));
+    EXPECT_THAT(decoded.body, Eq(request.body));
+
+    // A truncated payload is rejected
+    payload.pop_back();
+    LocalAgentProtocol::Request truncated;
+    EXPECT_FALSE(LocalAgentProtocol::DecodeRequest(payload, false, truncated));
+}
+
+TEST_F(LocalAgentTests, Response_RoundTrip)
+{
+    LocalAgentProtocol::Response response;
+    response.id = "LA-1";
+    response.result = HttpResult_OK;
+    response.statusCode = 503;
+    response.headers.add("Retry-After", "10");
+    response.body.assign({'x'});
+
+    std::vector<uint8_t> payload;
+    LocalAgentProtocol::EncodeResponse(response, payload);
+    LocalAgentProtocol::Response decoded;
+    ASSERT_TRUE(LocalAgentProtocol::DecodeResponse(payload, decoded));
+    EXPECT_THAT(decoded.id, Eq("LA-1"));
+    EXPECT_THAT(decoded.result, Eq(HttpResult_OK));
+    EXPECT_THAT(decoded.statusCode, Eq(503u));
+    EXPECT_THAT(decoded.headers.get("Retry-After"), Eq("10"));
+    EXPECT_THAT(decoded.body, Eq(response.body));
+}
+
+TEST_F(LocalAgentTests, Request_IsForwardedUpstream)
+{
+    LocalAgentServer server(socketPath, upstream, collectorUrls);
+    ASSERT_TRUE(server.Start());
+    HttpClient_LocalAgent client(socketPath);
+
+    auto request = MakeRequest(client, 100);
+    ResponseWaiter waiter;
+    client.SendRequestAsync(request.get(), &waiter);
+    ASSERT_TRUE(waiter.Wait());
+
+    EXPECT_THAT(waiter.response->GetId(), Eq(request->GetId()));
+    EXPECT_THAT(waiter.response->GetResult(), Eq(HttpResult_OK));
+    EXPECT_THAT(waiter.response->GetStatusCode(), Eq(200u));
+    EXPECT_THAT(waiter.response->GetHeaders().get("time-delta-millis"), Eq("42"));
+    EXPECT_THAT(waiter.response->GetBody().size(), Eq(2u));
+
+    ASSERT_THAT(upstream.GetReceivedCount(), Eq(1u));
+    auto const& forwarded = *upstream.received[0];
+    EXPECT_THAT(forwarded.m_method, Eq("POST"));
+    EXPECT_THAT(forwarded.m_url, Eq("https://collector.example/OneCollector/1.0/"));
+    EXPECT_THAT(forwarded.m_headers.get("Client-Id"), Eq("NO_AUTH"));
+    EXPECT_THAT(forwarded.m_latency, Eq(EventLatency_RealTime));
+    EXPECT_THAT(forwarded.m_body, Eq(request->GetBody()));
+    server.Stop();
+    EXPECT_THAT(server.GetForwardedCount(), Eq(1u));
+}
+
+TEST_F(LocalAgentTests, Socket_IsRestrictedToOwnerAndGroup)
+{
+    LocalAgentServer server(socketPath, upstream, collectorUrls);
+    ASSERT_TRUE(server.Start());
+
+    struct stat info;
+    ASSERT_THAT(::stat(socketPath.c_str(), &info), Eq(0));
+    EXPECT_THAT(info.st_mode & 0777, Eq(LocalAgentServer::SocketMode));
+}
+
+TEST_F(LocalAgentTests, RunningForwarder_KeepsItsSocket)
+{
+    LocalAgentServer first(socketPath, upstream, collectorUrls);
+    ASSERT_TRUE(first.Start());
+    LocalAgentServer second(socketPath, upstream, collectorUrls);
+    EXPECT_FALSE(second.Start());
+
+    // The first forwarder still serves requests
+    HttpClient_LocalAgent client(socketPath);
+    auto request = MakeRequest(client, 10);
+    ResponseWaiter waiter;
+    client.SendRequestAsync(request.get(), &waiter);
+    ASSERT_TRUE(waiter.Wait());
+    EXPECT_THAT(waiter.response->GetResult(), Eq(HttpResult_OK));
+}
+
+TEST_F(LocalAgentTests, StaleSocketFile_IsReplaced)
+{
+    // A bound socket that nobody listens on, as left behind by a crashed forwarder
+    int stale = ::socket(AF_UNIX, SOCK_STREAM, 0);
+    struct sockaddr_un address;
+    memset(&address, 0, sizeof(address));
+    address.sun_family = AF_UNIX;
+    memcpy(address.sun_path, socketPath.c_str(), socketPath.size());
+    ASSERT_THAT(::bind(stale, reinterpret_cast<struct sockaddr*>(&address), sizeof(address)), Eq(0));
+    ::close(stale);
+
+    LocalAgentServer server(socketPath, upstream, collectorUrls);
+    EXPECT_TRUE(server.Start());
+}
+
+TEST_F(LocalAgentTests, OtherRequests_AreRefused)
+{
+    LocalAgentServer server(socketPath, upstream, collectorUrls);
+    ASSERT_TRUE(server.Start());
+    HttpClient_LocalAgent client(socketPath);
+
+    auto get = MakeRequest(client, 10);
+    get->SetMethod("GET");
+    auto elsewhere = MakeRequest(client, 10);
+    elsewhere->SetUrl("https://elsewhere.example/OneCollector/1.0/");
+    for (auto request : { get.get(), elsewhere.get() })
+    {
+        ResponseWaiter waiter;
+        client.SendRequestAsync(request, &waiter);
+        ASSERT_TRUE(waiter.Wait());
+        EXPECT_THAT(waiter.response->GetId(), Eq(request->GetId()));
+        EXPECT_THAT(waiter.response->GetResult(), Eq(HttpResult_LocalFailure));
+    }
+
+    // The connection stays usable for uploads to the collector
+    auto post = MakeRequest(client, 10);
+    ResponseWaiter waiter;
+    client.SendRequestAsync(post.get(), &waiter);
+    ASSERT_TRUE(waiter.Wait());
+    EXPECT_THAT(waiter.response->GetResult(), Eq(HttpResult_OK));
+
+    EXPECT_THAT(upstream.GetReceivedCount(), Eq(1u));
+    server.Stop();
+    EXPECT_THAT(server.GetForwardedCount(), Eq(1u));
+}
+
+TEST_F(LocalAgentTests, LargeBody_IsForwardedIntact)
+{
+    LocalAgentServer server(socketPath, upstream, collectorUrls);
+    ASSERT_TRUE(server.Start());
+    HttpClient_LocalAgent client(socketPath);
+
+    auto request = MakeRequest(client, LocalAgentProtocol::FdBodyThreshold * 3 + 5);
+    ResponseWaiter waiter;
+    client.SendRequestAsync(request.get(), &waiter);
+    ASSERT_TRUE(waiter.Wait());
+
+    EXPECT_THAT(waiter.response->GetResult(), Eq(HttpResult_OK));
+    ASSERT_THAT(upstream.GetReceivedCount(), Eq(1u));
+    EXPECT_THAT(upstream.received[0]->m_body, Eq(request->GetBody()));
+}
+
+TEST_F(LocalAgentTests, NoForwarder_IsNetworkFailure)
+{
+    HttpClient_LocalAgent client(socketPath);
+
+    auto request = MakeRequest(client, 10);
+    ResponseWaiter waiter;
+    client.SendRequestAsync(request.get(), &waiter);
+    ASSERT_TRUE(waiter.Wait());
+
+    EXPECT_THAT(waiter.response->GetResult(), Eq(HttpResult_NetworkFailure));
+}
+
+TEST_F(LocalAgentTests, Cancel_AbortsHeldRequest)
+{
+    upstream.hold = true;
+    LocalAgentServer server(socketPath, upstream, collectorUrls);
+    ASSERT_TRUE(server.Start());
+    HttpClient_LocalAgent client(socketPath);
+
+    auto request = MakeRequest(client, 10);
+    ResponseWaiter waiter;
+    client.SendRequestAsync(request.get(), &waiter);
+    while (upstream.GetReceivedCount() == 0)
+    {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    client.CancelRequestAsync(request->GetId());
+    ASSERT_TRUE(waiter.Wait());
+    EXPECT_THAT(waiter.response->GetResult(), Eq(HttpResult_Aborted));
+
+    // Stopping the forwarder cancels the upstream request it still holds
+    server.Stop();
+    EXPECT_THAT(upstream.held.size(), Eq(0u));
+    EXPECT_THAT(server.GetForwardedCount(), Eq(1u));
+}
+
+#ifdef HAVE_MAT_DEFAULT_HTTP_CLIENT
+TEST_F(LocalAgentTests, CurlUpstream_ForwardsAndStops)
+{
+    // HttpClient_Curl answers on its own threads and waits for that answer when a request is deleted
+    CollectorStub collector;
+    HttpClient_Curl curl;
+    std::string collectorUrl = "http://127.0.0.1:" + std::to_string(collector.port) + "/OneCollector/1.0/";
+    LocalAgentServer server(socketPath, curl, { collectorUrl });
+    ASSERT_TRUE(server.Start());
+    HttpClient_LocalAgent client(socketPath);
+
+    for (int i = 0; i < 3; i++)
+    {
+        auto request = MakeRequest(client, 100);
+        request->SetUrl(collectorUrl);
+        ResponseWaiter waiter;
+        client.SendRequestAsync(request.get(), &waiter);
+        ASSERT_TRUE(waiter.Wait());
+        EXPECT_THAT(waiter.response->GetResult(), Eq(HttpResult_OK));
+        EXPECT_THAT(waiter.response->GetStatusCode(), Eq(200u));
+    }
+    server.Stop();
+    EXPECT_THAT(server.GetForwardedCount(), Eq(3u));
+}
+#endif
+
+#endif // HAVE_MAT_LOCAL_AGENT
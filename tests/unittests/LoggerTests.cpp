@@ -21,9 +21,11 @@ public:
     using Logger::CanEventPropertiesBeSent;
 
     bool SubmitCalled = {};
-    void submit(::CsProtocol::Record&, const EventProperties&) override
+    double SubmittedPopSample = {};
+    void submit(::CsProtocol::Record& record, const EventProperties&) override
     {
         SubmitCalled = true;
+        SubmittedPopSample = record.popSample;
     }
 };
 
@@ -324,4 +326,108 @@ TEST_F(LoggerTests, LogSession_CanEventPropertiesBeSentReturnsTrue_CallsSubmit)
     EXPECT_TRUE(logger.SubmitCalled);
 }
 
+TEST(LoggerSamplingTests, LogEvent_SampledOutEvent_DoesNotCallSubmit)
+{
+    ILogConfiguration configuration;
+    // Variant copies do not carry array contents: fill the rules array in place
+    configuration[CFG_MAP_SAMPLE][CFG_ARR_SAMPLE_RULES] = VariantArray();
+    VariantArray& rules = configuration[CFG_MAP_SAMPLE][CFG_ARR_SAMPLE_RULES];
+    VariantMap rule;
+    rule["event"] = "debug.*";
+    rule[CFG_INT_SAMPLE_RATE] = 0;
+    rules.push_back(rule);
+    LogManagerImpl logManager(configuration);
+    ContextFieldsProvider contextFieldsProvider;
+    RuntimeConfig_Default runtimeConfig(configuration);
+    TestLogger logger("", "", "", logManager, contextFieldsProvider, runtimeConfig);
+
+    logger.LogEvent("debug.noise");
+    logger.LogEvent("debug.noise");
+    EXPECT_FALSE(logger.SubmitCalled);
+
+    logger.LogEvent("usage");
+    EXPECT_TRUE(logger.SubmitCalled);
+    EXPECT_EQ(EventSampler::FullRate, logger.SubmittedPopSample);
+
+    // Drops are only counted, until the stats collect them
+    std::map<std::string, unsigned> counts;
+    logManager.GetEventSampler().TakeSampledOut(counts);
+    EXPECT_EQ(2u, counts[""]);
+    counts.clear();
+    logManager.GetEventSampler().TakeSampledOut(counts);
+    EXPECT_TRUE(counts.empty());
+}
+
+TEST(LoggerSamplingTests, LogEvent_SampledInEvent_RecordsEffectiveRate)
+{
+    ILogConfiguration configuration;
+    configuration[CFG_MAP_SAMPLE][CFG_INT_SAMPLE_RATE] = 100;
+    configuration[CFG_MAP_SAMPLE][CFG_ARR_SAMPLE_RULES] = VariantArray();
+    VariantArray& rules = configuration[CFG_MAP_SAMPLE][CFG_ARR_SAMPLE_RULES];
+    VariantMap rule;
+    rule["event"] = "debug.*";
+    rule[CFG_INT_SAMPLE_RATE] = 50;
+    rules.push_back(rule);
+    // Pick a sampling ID that falls in the lower half of the buckets
+    std::string samplingId;
+    for (int i = 0; samplingId.empty(); i++)
+    {
+        std::string id = "user-" + std::to_string(i);
+        if (EventSampler::GetBucket(id) < EventSampler::BucketCount / 2)
+            samplingId = id;
+    }
+    configuration[CFG_MAP_SAMPLE][CFG_STR_SAMPLE_KEY] = samplingId;
+    LogManagerImpl logManager(configuration);
+    ContextFieldsProvider contextFieldsProvider;
+    RuntimeConfig_Default runtimeConfig(configuration);
+    TestLogger logger("", "", "", logManager, contextFieldsProvider, runtimeConfig);
+
+    EventProperties properties("debug.noise");
+    properties.SetPopsample(20);
+    logger.LogEvent(properties);
+    EXPECT_TRUE(logger.SubmitCalled);
+    EXPECT_DOUBLE_EQ(10.0, logger.SubmittedPopSample);
+}
+
+TEST(LoggerMetricsTests, LogSampledMetric_Aggregated_SubmitsOnFlush)
+{
+    ILogConfiguration configuration;
+    configuration[CFG_MAP_METRICS][CFG_BOOL_METRICS_AGGREGATE_SAMPLED] = true;
+    LogManagerImpl logManager(configuration);
+    ContextFieldsProvider contextFieldsProvider;
+    RuntimeConfig_Default runtimeConfig(configuration);
+    TestLogger logger("", "", "", logManager, contextFieldsProvider, runtimeConfig);
+
+    EventProperties properties("metric");
+    logger.LogSampledMetric("latency", 12.0, "ms", properties);
+    logger.LogSampledMetric("latency", 20.0, "ms", properties);
+    EXPECT_FALSE(logger.SubmitCalled);
+    EXPECT_EQ(1u, logManager.GetMetricsAggregator().GetSeriesCount());
 
+    logManager.GetMetricsAggregator().Flush();
+    EXPECT_TRUE(logger.SubmitCalled);
+}
+
+TEST(LoggerMetricsTests, LogSampledMetric_Aggregated_SkipsFilteredObservations)
+{
+    class RejectAllFilter : public IEventFilter
+    {
+    public:
+        const char* GetName() const noexcept override { return "RejectAllFilter"; }
+        bool CanEventPropertiesBeSent(const EventProperties&) const noexcept override { return false; }
+    };
+
+    ILogConfiguration configuration;
+    configuration[CFG_MAP_METRICS][CFG_BOOL_METRICS_AGGREGATE_SAMPLED] = true;
+    LogManagerImpl logManager(configuration);
+    ContextFieldsProvider contextFieldsProvider;
+    RuntimeConfig_Default runtimeConfig(configuration);
+    TestLogger logger("", "", "", logManager, contextFieldsProvider, runtimeConfig);
+    logger.GetEventFilters().RegisterEventFilter(std::unique_ptr<IEventFilter>(new RejectAllFilter()));
+
+    logger.LogSampledMetric("latency", 12.0, "ms", EventProperties("metric"));
+    EXPECT_EQ(0u, logManager.GetMetricsAggregator().GetSeriesCount());
+
+    logManager.GetMetricsAggregator().Flush();
+    EXPECT_FALSE(logger.SubmitCalled);
+}
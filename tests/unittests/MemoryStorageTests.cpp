@@ -294,6 +294,31 @@ TEST_F(MemoryStorageTests, GetAndReserveSome)
     EXPECT_EQ(totalCount - howMany, storage.GetRecordCount());
 }
 
+TEST_F(MemoryStorageTests, GetAndReserveTenantRecords)
+{
+    MemoryStorage storage(testLogManager, *testConfig);
+    storage.Initialize(testObserver);
+    for (size_t i = 0; i < 10; i++)
+    {
+        StorageRecord record{ PAL::generateUuidString(), (i % 2) ? "a-token" : "b-token", EventLatency_Normal, EventPersistence_Normal, 0, { 1, 2, 3 } };
+        storage.StoreRecord(record);
+    }
+
+    std::vector<std::string> tenants;
+    EXPECT_TRUE(storage.GetAndReserveTenantRecords(
+        [&tenants](StorageRecord && record)->bool
+        {
+            tenants.push_back(record.tenantToken);
+            return true;
+        },
+        1000, "a-token"));
+
+    EXPECT_THAT(tenants, ElementsAre("a-token", "a-token", "a-token", "a-token", "a-token"));
+    EXPECT_EQ(5u, storage.LastReadRecordCount());
+    EXPECT_EQ(5u, storage.GetRecordCount(EventLatency_Normal));
+    EXPECT_EQ(5u, storage.GetReservedCount());
+}
+
 // This method is not implemented for RAM storage
 TEST_F(MemoryStorageTests, StoreSetting)
 {
@@ -7,6 +7,8 @@
 #include "common/MockIRuntimeConfig.hpp"
 #include "stats/MetaStats.hpp"
 
+#include <thread>
+
 using namespace testing;
 using namespace MAT;
 
@@ -120,3 +122,173 @@ TEST_F(MetaStatsTests, NoNewDataOrMetastatsOnlyGenerateNoEvents)
     //EXPECT_THAT(events[0].Extension, Contains(Pair("requests_acked_succeeded", "1")));
 }
 
+
+TEST_F(MetaStatsTests, SampledOutEventsAreReported)
+{
+    EXPECT_CALL(runtimeConfigMock, GetMetaStatsSendIntervalSec()).WillRepeatedly(Return(123));
+    EXPECT_CALL(runtimeConfigMock, GetMetaStatsTenantToken()).WillRepeatedly(Return("metastats-tenant-token"));
+
+    // Sampled-out events alone are enough to generate an ongoing stats event
+    stats.updateOnEventSampledOut("t1", 2);
+    stats.updateOnEventSampledOut("t2", 1);
+    auto events = stats.generateStatsEvent(ACT_STATS_ROLLUP_KIND_ONGOING);
+    ASSERT_THAT(events, SizeIs(1));
+    auto const& properties = events[0].data[0].properties;
+    ASSERT_THAT(properties, Contains(Key("evt_smp")));
+    EXPECT_THAT(properties.at("evt_smp").stringValue, Eq("3"));
+
+    events = stats.generateStatsEvent(ACT_STATS_ROLLUP_KIND_ONGOING);
+    EXPECT_THAT(events, SizeIs(0));
+}
+
+TEST_F(MetaStatsTests, ConcurrentUpdatesAreAllCounted)
+{
+    EXPECT_CALL(runtimeConfigMock, GetMetaStatsSendIntervalSec()).WillRepeatedly(Return(123));
+    EXPECT_CALL(runtimeConfigMock, GetMetaStatsTenantToken()).WillRepeatedly(Return("metastats-tenant-token"));
+
+    const unsigned threadCount = 4;
+    const unsigned perThread = 10000;
+    std::vector<std::thread> threads;
+    for (unsigned t = 0; t < threadCount; t++)
+    {
+        threads.emplace_back([this, t, perThread]() {
+            for (unsigned i = 0; i < perThread; i++)
+            {
+                stats.updateOnEventIncoming("t1", 10 + t, EventLatency_RealTime, false);
+                stats.updateOnEventSampledOut("t1", 1);
+            }
+        });
+    }
+    for (auto& thread : threads)
+    {
+        thread.join();
+    }
+
+    auto events = stats.generateStatsEvent(ACT_STATS_ROLLUP_KIND_ONGOING);
+    ASSERT_THAT(events, SizeIs(1));
+    auto const& properties = events[0].data[0].properties;
+    EXPECT_THAT(properties.at("evt_rcv").stringValue, Eq("40000"));
+    EXPECT_THAT(properties.at("evt_smp").stringValue, Eq("40000"));
+    EXPECT_THAT(properties.at("evt_bytes").stringValue, Eq("460000"));
+    EXPECT_THAT(properties.at("evt_bytes_min").stringValue, Eq("10"));
+    EXPECT_THAT(properties.at("evt_bytes_max").stringValue, Eq("13"));
+    EXPECT_THAT(properties.at("lr_rcv").stringValue, Eq("40000"));
+
+    // Counters are reset by the rollup
+    events = stats.generateStatsEvent(ACT_STATS_ROLLUP_KIND_ONGOING);
+    EXPECT_THAT(events, SizeIs(0));
+}
+
+TEST(MetaStatsTenantTests, PerTenantCountersAreReportedWhenSplitIsEnabled)
+{
+    ILogConfiguration config;
+    config[CFG_MAP_METASTATS_CONFIG]["split"] = true;
+    StrictMock<MockIRuntimeConfig> runtimeConfig(config);
+    EXPECT_CALL(runtimeConfig, GetMetaStatsSendIntervalSec()).WillRepeatedly(Return(123));
+    EXPECT_CALL(runtimeConfig, GetMetaStatsTenantToken()).WillRepeatedly(Return("metastats-tenant-token"));
+    MetaStats stats(runtimeConfig);
+
+    stats.updateOnEventIncoming("t1-token", 10, EventLatency_Normal, false);
+    stats.updateOnEventIncoming("t1-token", 10, EventLatency_Normal, false);
+    stats.updateOnEventIncoming("t2-token", 20, EventLatency_RealTime, false);
+    std::map<std::string, std::string> recordIdAndTenantid;
+    recordIdAndTenantid["r1"] = "t1-token";
+    recordIdAndTenantid["r2"] = "t1-token";
+    recordIdAndTenantid["r3"] = "t2-token";
+    stats.updateOnPackageSentSucceeded(recordIdAndTenantid, EventLatency_Normal, 0, 50, std::vector<unsigned>{}, false);
+
+    auto events = stats.generateStatsEvent(ACT_STATS_ROLLUP_KIND_ONGOING);
+    ASSERT_THAT(events, SizeIs(3));
+
+    // Cumulative
+    auto const& overall = events[0].data[0].properties;
+    EXPECT_THAT(overall.at("evt_rcv").stringValue, Eq("3"));
+    EXPECT_THAT(overall.at("evt_snt").stringValue, Eq("1"));
+    EXPECT_THAT(overall.at("ln_rcv").stringValue, Eq("2"));
+    EXPECT_THAT(overall.at("lr_rcv").stringValue, Eq("1"));
+    EXPECT_THAT(overall.at("pkg_ok").stringValue, Eq("1"));
+    EXPECT_THAT(overall.at("rtt_max").stringValue, Eq("50"));
+
+    // Per-tenant, in tenant token order
+    auto const& first = events[1].data[0].properties;
+    EXPECT_THAT(first.at("evt_rcv").stringValue, Eq("2"));
+    EXPECT_THAT(first.at("evt_snt").stringValue, Eq("2"));
+    EXPECT_THAT(first.at("ln_snt").stringValue, Eq("2"));
+    auto const& second = events[2].data[0].properties;
+    EXPECT_THAT(second.at("evt_rcv").stringValue, Eq("1"));
+    EXPECT_THAT(second.at("evt_bytes").stringValue, Eq("20"));
+    EXPECT_THAT(second.at("ln_snt").stringValue, Eq("1"));
+}
+
+TEST(MetaStatsTenantTests, SentRecordsAreCountedPerTenantWhenTenantsInterleave)
+{
+    ILogConfiguration config;
+    config[CFG_MAP_METASTATS_CONFIG]["split"] = true;
+    StrictMock<MockIRuntimeConfig> runtimeConfig(config);
+    EXPECT_CALL(runtimeConfig, GetMetaStatsSendIntervalSec()).WillRepeatedly(Return(123));
+    EXPECT_CALL(runtimeConfig, GetMetaStatsTenantToken()).WillRepeatedly(Return("metastats-tenant-token"));
+    MetaStats stats(runtimeConfig);
+
+    stats.updateOnEventIncoming("t1-token", 10, EventLatency_Normal, false);
+    stats.updateOnEventIncoming("t2-token", 10, EventLatency_Normal, false);
+    std::map<std::string, std::string> recordIdAndTenantid;
+    recordIdAndTenantid["r1"] = "t1-token";
+    recordIdAndTenantid["r2"] = "t2-token";
+    recordIdAndTenantid["r3"] = "t1-token";
+    recordIdAndTenantid["r4"] = "t2-token";
+    recordIdAndTenantid["r5"] = "t1-token";
+    stats.updateOnPackageSentSucceeded(recordIdAndTenantid, EventLatency_Normal, 0, 50, std::vector<unsigned>{}, false);
+
+    auto events = stats.generateStatsEvent(ACT_STATS_ROLLUP_KIND_ONGOING);
+    ASSERT_THAT(events, SizeIs(3));
+    EXPECT_THAT(events[1].data[0].properties.at("evt_snt").stringValue, Eq("3"));
+    EXPECT_THAT(events[2].data[0].properties.at("evt_snt").stringValue, Eq("2"));
+}
+
+TEST(MetaStatsTenantTests, DeliveryLatencyPercentilesAreReportedWhenEnabled)
+{
+    ILogConfiguration config;
+    config[CFG_MAP_METASTATS_CONFIG][CFG_BOOL_METASTATS_DELIVERY_LATENCY] = true;
+    StrictMock<MockIRuntimeConfig> runtimeConfig(config);
+    EXPECT_CALL(runtimeConfig, GetMetaStatsSendIntervalSec()).WillRepeatedly(Return(123));
+    EXPECT_CALL(runtimeConfig, GetMetaStatsTenantToken()).WillRepeatedly(Return("metastats-tenant-token"));
+    MetaStats stats(runtimeConfig);
+
+    stats.updateOnEventIncoming("t1-token", 10, EventLatency_Normal, false);
+    stats.getDeliveryLatencyTracker().Record("t1-token", EventLatency_Normal, DeliveryStage_Total, 40);
+    stats.getDeliveryLatencyTracker().Record("t1-token", EventLatency_Normal, DeliveryStage_Total, 40);
+
+    auto events = stats.generateStatsEvent(ACT_STATS_ROLLUP_KIND_ONGOING);
+    ASSERT_THAT(events, SizeIs(1));
+    auto const& properties = events[0].data[0].properties;
+    EXPECT_THAT(properties.at("ln_dl_tot_cnt").stringValue, Eq("2"));
+    EXPECT_THAT(properties.at("ln_dl_tot_p50").stringValue, Eq("40"));
+    EXPECT_THAT(properties.at("ln_dl_tot_max").stringValue, Eq("40"));
+    EXPECT_THAT(properties.count("ln_dl_net_cnt"), Eq(0u));
+
+    // Reported per interval
+    stats.updateOnEventIncoming("t1-token", 10, EventLatency_Normal, false);
+    events = stats.generateStatsEvent(ACT_STATS_ROLLUP_KIND_ONGOING);
+    ASSERT_THAT(events, SizeIs(1));
+    EXPECT_THAT(events[0].data[0].properties.count("ln_dl_tot_cnt"), Eq(0u));
+}
+
+TEST_F(MetaStatsTests, CollectorEndpointRoutingIsReported)
+{
+    EXPECT_CALL(runtimeConfigMock, GetMetaStatsSendIntervalSec()).WillRepeatedly(Return(123));
+    EXPECT_CALL(runtimeConfigMock, GetMetaStatsTenantToken()).WillRepeatedly(Return("metastats-tenant-token"));
+
+    stats.updateOnEventIncoming("t1-token", 10, EventLatency_Normal, false);
+    stats.updateOnCollectorEndpointSelected(0, false);
+    stats.updateOnCollectorEndpointTripped(0);
+    stats.updateOnCollectorEndpointSelected(1, true);
+    stats.updateOnCollectorEndpointSelected(1, true);
+
+    auto events = stats.generateStatsEvent(ACT_STATS_ROLLUP_KIND_ONGOING);
+    ASSERT_THAT(events, SizeIs(1));
+    auto const& properties = events[0].data[0].properties;
+    EXPECT_THAT(properties.at("pkg_ep_0").stringValue, Eq("1"));
+    EXPECT_THAT(properties.at("pkg_ep_1").stringValue, Eq("2"));
+    EXPECT_THAT(properties.at("pkg_fovr").stringValue, Eq("2"));
+    EXPECT_THAT(properties.at("ep_trip_0").stringValue, Eq("1"));
+}
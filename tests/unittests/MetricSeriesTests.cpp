@@ -0,0 +1,213 @@
+//
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// SPDX-License-Identifier: Apache-2.0
+//
+
+#include "common/Common.hpp"
+#include "stats/MetricSeries.hpp"
+
+#include <limits>
+#include <thread>
+
+using namespace testing;
+using namespace MAT;
+
+TEST(MetricSeriesTests, Harvest_EmptySeries_ReturnsFalse)
+{
+    MetricSeries series(MetricSeries::Kind::Distribution);
+    MetricSnapshot snapshot;
+    EXPECT_FALSE(series.Harvest(snapshot));
+    EXPECT_EQ(0u, snapshot.count);
+}
+
+TEST(MetricSeriesTests, Distribution_AggregatesValues)
+{
+    MetricSeries series(MetricSeries::Kind::Distribution);
+    series.Record(1.0);
+    series.Record(3.0);
+    series.Record(8.0);
+
+    MetricSnapshot snapshot;
+    ASSERT_TRUE(series.Harvest(snapshot));
+    EXPECT_EQ(3u, snapshot.count);
+    EXPECT_EQ(12.0, snapshot.sum);
+    EXPECT_EQ(74.0, snapshot.sumOfSquares);
+    EXPECT_EQ(1.0, snapshot.min);
+    EXPECT_EQ(8.0, snapshot.max);
+    long total = 0;
+    for (auto const& bucket : snapshot.buckets)
+    {
+        total += bucket.second;
+    }
+    EXPECT_EQ(3, total);
+
+    // Harvest resets the series
+    EXPECT_FALSE(series.Harvest(snapshot));
+    series.Record(-2.0);
+    ASSERT_TRUE(series.Harvest(snapshot));
+    EXPECT_EQ(1u, snapshot.count);
+    EXPECT_EQ(-2.0, snapshot.min);
+    EXPECT_EQ(-2.0, snapshot.max);
+}
+
+TEST(MetricSeriesTests, Counter_KeepsCountAndSumOnly)
+{
+    MetricSeries series(MetricSeries::Kind::Counter);
+    series.Record(2.0);
+    series.Record(5.0);
+    MetricSnapshot snapshot;
+    ASSERT_TRUE(series.Harvest(snapshot));
+    EXPECT_EQ(2u, snapshot.count);
+    EXPECT_EQ(7.0, snapshot.sum);
+    EXPECT_TRUE(snapshot.buckets.empty());
+
+    AggregatedMetricData data("counter", 0, 0);
+    snapshot.CopyTo(data);
+    EXPECT_EQ(2, data.count);
+    EXPECT_EQ(7.0, data.aggregates[AggregateType_Sum]);
+    EXPECT_EQ(0u, data.aggregates.count(AggregateType_SumOfSquares));
+}
+
+TEST(MetricSeriesTests, Gauge_KeepsLastAndExtremes)
+{
+    MetricSeries series(MetricSeries::Kind::Gauge);
+    series.Record(4.0);
+    series.Record(9.0);
+    series.Record(6.0);
+    MetricSnapshot snapshot;
+    ASSERT_TRUE(series.Harvest(snapshot));
+    EXPECT_EQ(6.0, snapshot.last);
+    EXPECT_EQ(4.0, snapshot.min);
+    EXPECT_EQ(9.0, snapshot.max);
+}
+
+TEST(MetricSeriesTests, NonFiniteValues_AreIgnored)
+{
+    MetricSeries series(MetricSeries::Kind::Distribution);
+    series.Record(std::numeric_limits<double>::quiet_NaN());
+    series.Record(std::numeric_limits<double>::infinity());
+    series.Record(-std::numeric_limits<double>::infinity());
+    MetricSnapshot snapshot;
+    EXPECT_FALSE(series.Harvest(snapshot));
+}
+
+TEST(MetricSeriesTests, BucketIndex_IsMonotonicAndWithinRelativeError)
+{
+    size_t previous = 0;
+    for (double value = 0.01; value < 1e12; value *= 1.07)
+    {
+        size_t index = MetricSeries::GetBucketIndex(value);
+        ASSERT_LT(index, MetricSeries::BucketCount);
+        EXPECT_GE(index, previous) << value;
+        previous = index;
+        double lowerBound = MetricSeries::GetBucketLowerBound(index);
+        EXPECT_LE(lowerBound, value);
+        EXPECT_LT(value, lowerBound * (1.0 + 1.0 / MetricSeries::SubBuckets)) << value;
+    }
+    EXPECT_EQ(0u, MetricSeries::GetBucketIndex(0.0));
+    EXPECT_EQ(0u, MetricSeries::GetBucketIndex(-1.0));
+    EXPECT_EQ(MetricSeries::BucketCount - 1, MetricSeries::GetBucketIndex(1e300));
+}
+
+TEST(MetricSeriesTests, Percentiles_OfValuesBelowOne)
+{
+    MetricSeries series(MetricSeries::Kind::Distribution);
+    for (int i = 0; i < 100; i++)
+    {
+        series.Record(0.1);
+        series.Record(0.8);
+    }
+    MetricSnapshot snapshot;
+    ASSERT_TRUE(series.Harvest(snapshot));
+    EXPECT_EQ(2u, snapshot.buckets.size());
+    EXPECT_NEAR(0.1, snapshot.GetPercentile(25), 0.1 * 0.25);
+    EXPECT_NEAR(0.8, snapshot.GetPercentile(75), 0.8 * 0.25);
+
+    AggregatedMetricData data("distribution", 0, 0);
+    snapshot.CopyTo(data);
+    ASSERT_EQ(1u, data.buckets.size());
+    EXPECT_EQ(200, data.buckets[0]);
+}
+
+TEST(MetricSeriesTests, IsHarvestDue_FiresOncePerInterval)
+{
+    MetricSeries series(MetricSeries::Kind::Counter, 1000);
+    EXPECT_FALSE(series.IsHarvestDue(5000));
+    EXPECT_FALSE(series.IsHarvestDue(5999));
+    EXPECT_TRUE(series.IsHarvestDue(6000));
+    EXPECT_FALSE(series.IsHarvestDue(6000));
+    EXPECT_TRUE(series.IsHarvestDue(7000));
+
+    MetricSeries manual(MetricSeries::Kind::Counter);
+    EXPECT_FALSE(manual.IsHarvestDue(1));
+    EXPECT_FALSE(manual.IsHarvestDue(1000000));
+}
+
+TEST(MetricSeriesTests, ConcurrentRecording_LosesNoObservations)
+{
+    MetricSeries series(MetricSeries::Kind::Distribution);
+    const size_t threadCount = 8;
+    const size_t perThread = 10000;
+    std::vector<std::thread> threads;
+    for (size_t t = 0; t < threadCount; t++)
+    {
+        threads.emplace_back([&series, perThread]() {
+            for (size_t i = 0; i < perThread; i++)
+            {
+                series.Record(1.0);
+            }
+        });
+    }
+    for (auto& thread : threads)
+    {
+        thread.join();
+    }
+    MetricSnapshot snapshot;
+    ASSERT_TRUE(series.Harvest(snapshot));
+    EXPECT_EQ(threadCount * perThread, snapshot.count);
+    EXPECT_EQ(static_cast<double>(threadCount * perThread), snapshot.sum);
+    EXPECT_EQ(static_cast<long>(threadCount * perThread), snapshot.buckets[MetricSeries::GetBucketIndex(1.0)]);
+}
+
+TEST(MetricSeriesTests, HarvestDuringRecording_KeepsIntervalsConsistent)
+{
+    MetricSeries series(MetricSeries::Kind::Distribution);
+    const size_t threadCount = 4;
+    const size_t perThread = 20000;
+    std::atomic<size_t> running{threadCount};
+    std::vector<std::thread> threads;
+    for (size_t t = 0; t < threadCount; t++)
+    {
+        threads.emplace_back([&series, &running, perThread]() {
+            for (size_t i = 0; i < perThread; i++)
+            {
+                series.Record(1.0);
+            }
+            running--;
+        });
+    }
+
+    // Every observation adds 1 to count, sum and its bucket: a torn interval breaks the equality
+    uint64_t total = 0;
+    bool consistent = true;
+    MetricSnapshot snapshot;
+    auto harvest = [&]() {
+        if (series.Harvest(snapshot))
+        {
+            total += snapshot.count;
+            consistent &= (static_cast<double>(snapshot.count) == snapshot.sum);
+            consistent &= (static_cast<long>(snapshot.count) == snapshot.buckets[MetricSeries::GetBucketIndex(1.0)]);
+        }
+    };
+    while (running > 0)
+    {
+        harvest();
+    }
+    for (auto& thread : threads)
+    {
+        thread.join();
+    }
+    harvest();
+    EXPECT_TRUE(consistent);
+    EXPECT_EQ(threadCount * perThread, total);
+}
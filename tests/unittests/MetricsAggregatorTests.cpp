@@ -0,0 +1,219 @@
+//
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// SPDX-License-Identifier: Apache-2.0
+//
+
+#include "common/Common.hpp"
+#include "AggregatedMetric.hpp"
+#include "NullObjects.hpp"
+#include "stats/MetricsAggregator.hpp"
+
+using namespace testing;
+using namespace MAT;
+
+namespace
+{
+    class ManualTaskDispatcher : public ITaskDispatcher
+    {
+    public:
+        std::vector<Task*> tasks;
+
+        virtual ~ManualTaskDispatcher()
+        {
+            for (auto task : tasks)
+            {
+                delete task;
+            }
+        }
+
+        virtual void Join() override {}
+
+        virtual void Queue(Task* task) override
+        {
+            tasks.push_back(task);
+        }
+
+        virtual bool Cancel(Task* task, uint64_t) override
+        {
+            auto it = std::find(tasks.begin(), tasks.end(), task);
+            if (it != tasks.end())
+            {
+                tasks.erase(it);
+                delete task;
+            }
+            return true;
+        }
+
+        void RunAll()
+        {
+            std::vector<Task*> pending;
+            pending.swap(tasks);
+            for (auto task : pending)
+            {
+                (*task)();
+                delete task;
+            }
+        }
+    };
+
+    class AggregatedMetricLogger : public NullLogger
+    {
+    public:
+        std::vector<AggregatedMetricData> logged;
+
+        virtual void LogAggregatedMetric(AggregatedMetricData const& metricData, EventProperties const&) override
+        {
+            logged.push_back(metricData);
+        }
+    };
+}
+
+class MetricsAggregatorTests : public ::testing::Test
+{
+protected:
+    ILogConfiguration config;
+    AggregatedMetricLogger logger;
+    EventProperties properties{"metric"};
+
+    void Enable(int64_t maxSeries = 1000)
+    {
+        config[CFG_MAP_METRICS][CFG_BOOL_METRICS_AGGREGATE_SAMPLED] = true;
+        config[CFG_MAP_METRICS][CFG_INT_METRICS_INTERVAL] = 3600;
+        config[CFG_MAP_METRICS][CFG_INT_METRICS_MAX_SERIES] = maxSeries;
+    }
+};
+
+TEST_F(MetricsAggregatorTests, DisabledByDefault)
+{
+    MetricsAggregator aggregator(config);
+    EXPECT_FALSE(aggregator.IsEnabled());
+    EXPECT_FALSE(aggregator.RecordSampledMetric(logger, "latency", 1.0, "ms", "", "", "", properties));
+    EXPECT_EQ(0u, aggregator.GetSeriesCount());
+}
+
+TEST_F(MetricsAggregatorTests, Flush_EmitsOneEventPerSeries)
+{
+    Enable();
+    MetricsAggregator aggregator(config);
+    ASSERT_TRUE(aggregator.IsEnabled());
+
+    EXPECT_TRUE(aggregator.RecordSampledMetric(logger, "latency", 10.0, "ms", "", "", "", properties));
+    EXPECT_TRUE(aggregator.RecordSampledMetric(logger, "latency", 30.0, "ms", "", "", "", properties));
+    EXPECT_TRUE(aggregator.RecordSampledMetric(logger, "latency", 5.0, "ms", "disk", "", "", properties));
+    EXPECT_EQ(2u, aggregator.GetSeriesCount());
+    EXPECT_TRUE(logger.logged.empty());
+
+    aggregator.Flush();
+    ASSERT_EQ(2u, logger.logged.size());
+    for (auto const& data : logger.logged)
+    {
+        EXPECT_EQ("latency", data.name);
+        EXPECT_EQ("ms", data.units);
+        if (data.instanceName.empty())
+        {
+            EXPECT_EQ(2, data.count);
+            EXPECT_EQ(40.0, data.aggregates.at(AggregateType_Sum));
+            EXPECT_EQ(10.0, data.aggregates.at(AggregateType_Minimum));
+            EXPECT_EQ(30.0, data.aggregates.at(AggregateType_Maximum));
+        }
+        else
+        {
+            EXPECT_EQ("disk", data.instanceName);
+            EXPECT_EQ(1, data.count);
+        }
+    }
+
+    // Nothing pending: no new events
+    aggregator.Flush();
+    EXPECT_EQ(2u, logger.logged.size());
+}
+
+TEST_F(MetricsAggregatorTests, MaxSeries_FallsBackToRegularEvents)
+{
+    Enable(1);
+    MetricsAggregator aggregator(config);
+    EXPECT_TRUE(aggregator.RecordSampledMetric(logger, "first", 1.0, "", "", "", "", properties));
+    EXPECT_FALSE(aggregator.RecordSampledMetric(logger, "second", 1.0, "", "", "", "", properties));
+    EXPECT_TRUE(aggregator.RecordSampledMetric(logger, "first", 2.0, "", "", "", "", properties));
+    EXPECT_EQ(1u, aggregator.GetSeriesCount());
+}
+
+TEST_F(MetricsAggregatorTests, DifferentProperties_GoToDifferentSeries)
+{
+    Enable();
+    MetricsAggregator aggregator(config);
+    EventProperties other("metric");
+    other.SetProperty("region", "west");
+    EventProperties same("metric");
+    same.SetProperty("region", "west");
+    EventProperties pii("metric");
+    pii.SetProperty("region", "west", PiiKind_Identity);
+
+    EXPECT_TRUE(aggregator.RecordSampledMetric(logger, "latency", 1.0, "ms", "", "", "", properties));
+    EXPECT_TRUE(aggregator.RecordSampledMetric(logger, "latency", 1.0, "ms", "", "", "", other));
+    EXPECT_TRUE(aggregator.RecordSampledMetric(logger, "latency", 1.0, "ms", "", "", "", same));
+    EXPECT_TRUE(aggregator.RecordSampledMetric(logger, "latency", 1.0, "ms", "", "", "", pii));
+    EXPECT_EQ(3u, aggregator.GetSeriesCount());
+}
+
+TEST_F(MetricsAggregatorTests, Timer_EmitsElapsedSeriesWithoutNewObservations)
+{
+    Enable();
+    config[CFG_MAP_METRICS][CFG_INT_METRICS_INTERVAL] = 1;
+    MetricsAggregator aggregator(config);
+    ManualTaskDispatcher taskDispatcher;
+    aggregator.Start(taskDispatcher);
+    ASSERT_EQ(1u, taskDispatcher.tasks.size());
+
+    aggregator.RecordSampledMetric(logger, "latency", 1.0, "ms", "", "", "", properties);
+    taskDispatcher.RunAll();
+    EXPECT_TRUE(logger.logged.empty());
+    ASSERT_EQ(1u, taskDispatcher.tasks.size());
+
+    PAL::sleep(1100);
+    taskDispatcher.RunAll();
+    ASSERT_EQ(1u, logger.logged.size());
+    EXPECT_EQ(1, logger.logged[0].count);
+
+    // No harvest is scheduled after shutdown
+    aggregator.Shutdown();
+    EXPECT_TRUE(taskDispatcher.tasks.empty());
+}
+
+TEST_F(MetricsAggregatorTests, Shutdown_FlushesAndDropsSeries)
+{
+    Enable();
+    MetricsAggregator aggregator(config);
+    aggregator.RecordSampledMetric(logger, "latency", 1.0, "", "", "", "", properties);
+    aggregator.Shutdown();
+    EXPECT_EQ(1u, logger.logged.size());
+    EXPECT_EQ(0u, aggregator.GetSeriesCount());
+}
+
+TEST_F(MetricsAggregatorTests, AggregatedMetric_EmitsOnDestruction)
+{
+    {
+        Models::AggregatedMetric metric("requests", "count", 3600, "instance", "class", "id", properties, &logger);
+        for (int i = 1; i <= 4; i++)
+        {
+            metric.PushMetric(i);
+        }
+        EXPECT_TRUE(logger.logged.empty());
+    }
+    ASSERT_EQ(1u, logger.logged.size());
+    auto const& data = logger.logged[0];
+    EXPECT_EQ("requests", data.name);
+    EXPECT_EQ("instance", data.instanceName);
+    EXPECT_EQ("class", data.objectClass);
+    EXPECT_EQ("id", data.objectId);
+    EXPECT_EQ(4, data.count);
+    EXPECT_EQ(10.0, data.aggregates.at(AggregateType_Sum));
+    EXPECT_EQ(30.0, data.aggregates.at(AggregateType_SumOfSquares));
+    EXPECT_GE(data.duration, 0);
+}
+
+TEST_F(MetricsAggregatorTests, AggregatedMetric_WithoutLoggerDoesNothing)
+{
+    Models::AggregatedMetric metric("requests", "count", 1, properties);
+    metric.PushMetric(1.0);
+}
@@ -0,0 +1,158 @@
+//
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// SPDX-License-Identifier: Apache-2.0
+//
+#include "common/Common.hpp"
+#include "common/MockIOfflineStorageObserver.hpp"
+#include "config/RuntimeConfig_Default.hpp"
+#include "utils/Utils.hpp"
+#include "NullObjects.hpp"
+
+#ifdef HAVE_MAT_STORAGE
+
+#include "offline/OfflineStorageHandler.hpp"
+
+#include <algorithm>
+#include <cstdio>
+
+using namespace testing;
+using namespace MAT;
+
+/// Holds the queued tasks until the test runs them
+class ManualTaskDispatcher : public ITaskDispatcher
+{
+  public:
+    std::vector<Task*> tasks;
+
+    virtual ~ManualTaskDispatcher()
+    {
+        for (auto task : tasks)
+        {
+            delete task;
+        }
+    }
+
+    virtual void Join() override {}
+
+    virtual void Queue(Task* task) override
+    {
+        tasks.push_back(task);
+    }
+
+    virtual bool Cancel(Task* task, uint64_t) override
+    {
+        auto it = std::find(tasks.begin(), tasks.end(), task);
+        if (it != tasks.end())
+        {
+            tasks.erase(it);
+            delete task;
+        }
+        return true;
+    }
+
+    void RunAll()
+    {
+        std::vector<Task*> pending;
+        pending.swap(tasks);
+        for (auto task : pending)
+        {
+            (*task)();
+            delete task;
+        }
+    }
+};
+
+class OfflineStorageHandlerTests : public Test
+{
+  protected:
+    std::string path;
+    NullLogManager logManager;
+    ILogConfiguration configuration;
+    std::unique_ptr<RuntimeConfig_Default> config;
+    ManualTaskDispatcher taskDispatcher;
+    NiceMock<MockIOfflineStorageObserver> observer;
+
+    virtual void SetUp() override
+    {
+        path = GetTempDirectory() + "OfflineStorageHandlerTests.db";
+        std::remove(path.c_str());
+        configuration[CFG_STR_CACHE_FILE_PATH] = path;
+        configuration[CFG_BOOL_ASYNC_STORAGE_OPEN] = true;
+    }
+
+    virtual void TearDown() override
+    {
+        std::remove(path.c_str());
+    }
+
+    std::unique_ptr<OfflineStorageHandler> Open()
+    {
+        config.reset(new RuntimeConfig_Default(configuration));
+        std::unique_ptr<OfflineStorageHandler> storage(new OfflineStorageHandler(logManager, *config, taskDispatcher));
+        storage->Initialize(observer);
+        return storage;
+    }
+
+    static StorageRecord MakeRecord(std::string const& id)
+    {
+        return StorageRecord(id, "tenant", EventLatency_Normal, EventPersistence_Normal, 1234, std::vector<uint8_t>(10, 1));
+    }
+};
+
+TEST_F(OfflineStorageHandlerTests, AsyncOpen_OpensOnWorker)
+{
+    EXPECT_CALL(observer, OnStorageOpened(_)).Times(0);
+    auto storage = Open();
+    ASSERT_THAT(taskDispatcher.tasks.size(), Eq(1u));
+    Mock::VerifyAndClearExpectations(&observer);
+
+    // Records wait in the RAM queue meanwhile
+    EXPECT_TRUE(storage->StoreRecord(MakeRecord("a")));
+    EXPECT_THAT(storage->GetRecordCount(), Eq(1u));
+
+    EXPECT_CALL(observer, OnStorageOpened("SQLite/Default")).Times(1);
+    taskDispatcher.RunAll();
+    storage->Flush();
+    EXPECT_THAT(storage->GetRecordCount(), Eq(1u));
+    storage->Shutdown();
+}
+
+TEST_F(OfflineStorageHandlerTests, AsyncOpen_SettingsOpenRightAway)
+{
+    auto storage = Open();
+    EXPECT_CALL(observer, OnStorageOpened("SQLite/Default")).Times(1);
+    EXPECT_TRUE(storage->StoreSetting("name", "value"));
+    EXPECT_THAT(storage->GetSetting("name"), Eq("value"));
+
+    // The worker has nothing left to do
+    taskDispatcher.RunAll();
+    storage->Shutdown();
+}
+
+TEST_F(OfflineStorageHandlerTests, AsyncOpen_ShutdownSavesRamQueue)
+{
+    {
+        auto storage = Open();
+        EXPECT_TRUE(storage->StoreRecord(MakeRecord("a")));
+        EXPECT_TRUE(storage->StoreRecord(MakeRecord("b")));
+        storage->Shutdown();
+        EXPECT_THAT(taskDispatcher.tasks.size(), Eq(0u));
+    }
+
+    configuration[CFG_BOOL_ASYNC_STORAGE_OPEN] = false;
+    auto storage = Open();
+    EXPECT_THAT(taskDispatcher.tasks.size(), Eq(0u));
+    EXPECT_THAT(storage->GetRecordCount(), Eq(2u));
+    storage->Shutdown();
+}
+
+TEST_F(OfflineStorageHandlerTests, AsyncOpen_NeedsRamQueue)
+{
+    configuration[CFG_INT_RAM_QUEUE_SIZE] = 0;
+    EXPECT_CALL(observer, OnStorageOpened("SQLite/Default")).Times(1);
+    auto storage = Open();
+    EXPECT_THAT(taskDispatcher.tasks.size(), Eq(0u));
+    storage->Shutdown();
+}
+
+#endif // HAVE_MAT_STORAGE
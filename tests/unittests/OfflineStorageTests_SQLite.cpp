@@ -167,6 +167,21 @@ TEST_F(OfflineStorageTests_SQLite, ReservedRecordIsNotReturned)
     ASSERT_THAT(consumer.records.size(), 2);
 }
 
+TEST_F(OfflineStorageTests_SQLite, TenantRecordsAreReturnedForRequestedTenantOnly)
+{
+    initializeStorage();
+    ASSERT_THAT(offlineStorage->StoreRecord({"guid1", "token1", EventLatency_Normal, EventPersistence_Normal, 1, {}}), true);
+    ASSERT_THAT(offlineStorage->StoreRecord({"guid2", "token2", EventLatency_Normal, EventPersistence_Normal, 1, {}}), true);
+    ASSERT_THAT(offlineStorage->StoreRecord({"guid3", "token1", EventLatency_Normal, EventPersistence_Normal, 1, {}}), true);
+    TestRecordConsumer consumer;
+    EXPECT_THAT(offlineStorage->GetAndReserveTenantRecords(consumer, 100000, "token2"), true);
+    ASSERT_THAT(consumer.records.size(), 1);
+    EXPECT_THAT(consumer.records[0].id, StrEq("guid2"));
+    consumer.records.clear();
+    EXPECT_THAT(offlineStorage->GetAndReserveRecords(consumer, 100000), true);
+    ASSERT_THAT(consumer.records.size(), 2);
+}
+
 TEST_F(OfflineStorageTests_SQLite, DeletedRecordsAreNotReturned)
 {
     initializeStorage();
@@ -0,0 +1,504 @@
+//
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// SPDX-License-Identifier: Apache-2.0
+//
+#include "common/Common.hpp"
+#include "common/MockIOfflineStorageObserver.hpp"
+#include "config/RuntimeConfig_Default.hpp"
+#include "utils/Utils.hpp"
+#include "NullObjects.hpp"
+
+#ifdef HAVE_MAT_SHARED_QUEUE
+
+#include "offline/OfflineStorage_SharedMemory.hpp"
+
+#include <cstdio>
+#include <set>
+#include <thread>
+
+#include <sys/wait.h>
+#include <unistd.h>
+
+using namespace testing;
+using namespace MAT;
+
+class SharedMemoryStorage4Test : public OfflineStorage_SharedMemory
+{
+public:
+    SharedMemoryStorage4Test(ILogManager& logManager, IRuntimeConfig& runtimeConfig) :
+        OfflineStorage_SharedMemory(logManager, runtimeConfig)
+    {
+    }
+
+    using OfflineStorage_SharedMemory::m_pid;
+    using OfflineStorage_SharedMemory::m_ring;
+    using OfflineStorage_SharedMemory::m_stalledSince;
+
+    // Same layout as OfflineStorage_SharedMemory::SlotHeader
+    struct Slot
+    {
+        uint32_t state;
+        uint32_t size;
+        int32_t  pid;
+        uint32_t reserved;
+    };
+
+    Slot& SlotAt(size_t offset)
+    {
+        return *reinterpret_cast<Slot*>(m_ring + offset);
+    }
+};
+
+class OfflineStorageTests_SharedMemory : public Test
+{
+protected:
+    std::string path;
+    NullLogManager logManager;
+    ILogConfiguration configuration;
+    std::unique_ptr<RuntimeConfig_Default> config;
+    NiceMock<MockIOfflineStorageObserver> observer;
+
+    virtual void SetUp() override
+    {
+        path = GetTempDirectory() + "SharedQueueTests." + std::to_string(getpid());
+        std::remove(path.c_str());
+        std::remove((path + ".lock").c_str());
+        configuration[CFG_STR_SHARED_QUEUE_PATH] = path;
+        configuration[CFG_INT_SHARED_QUEUE_SIZE] = 65536;
+        config.reset(new RuntimeConfig_Default(configuration));
+    }
+
+    virtual void TearDown() override
+    {
+        std::remove(path.c_str());
+        std::remove((path + ".lock").c_str());
+    }
+
+    std::unique_ptr<OfflineStorage_SharedMemory> Open()
+    {
+        std::unique_ptr<OfflineStorage_SharedMemory> storage(new OfflineStorage_SharedMemory(logManager, *config));
+        storage->Initialize(observer);
+        return storage;
+    }
+
+    std::unique_ptr<SharedMemoryStorage4Test> OpenForTest()
+    {
+        std::unique_ptr<SharedMemoryStorage4Test> storage(new SharedMemoryStorage4Test(logManager, *config));
+        storage->Initialize(observer);
+        return storage;
+    }
+
+    static int32_t DeadPid()
+    {
+        pid_t pid = fork();
+        if (pid == 0)
+        {
+            _exit(0);
+        }
+        waitpid(pid, nullptr, 0);
+        return static_cast<int32_t>(pid);
+    }
+
+    static std::vector<std::string> Ids(std::vector<StorageRecord> const& records)
+    {
+        std::vector<std::string> ids;
+        for (auto const& record : records)
+        {
+            ids.push_back(record.id);
+        }
+        return ids;
+    }
+
+    static StorageRecord MakeRecord(std::string const& id, size_t blobSize = 10)
+    {
+        std::vector<uint8_t> blob(blobSize, static_cast<uint8_t>(id.size()));
+        return StorageRecord(id, "tenant-" + id.substr(0, 1), EventLatency_Normal, EventPersistence_Normal, 1234, std::move(blob));
+    }
+
+    static std::vector<StorageRecord> TakeAll(OfflineStorage_SharedMemory& storage)
+    {
+        std::vector<StorageRecord> records;
+        EXPECT_TRUE(storage.GetAndReserveRecords([&records](StorageRecord&& record) {
+            records.push_back(std::move(record));
+            return true;
+        }, 60000));
+        std::vector<StorageRecordId> ids;
+        for (auto const& record : records)
+        {
+            ids.push_back(record.id);
+        }
+        bool fromMemory = true;
+        storage.DeleteRecords(ids, HttpHeaders(), fromMemory);
+        return records;
+    }
+};
+
+TEST_F(OfflineStorageTests_SharedMemory, FirstReader_UploadsRecordsOfAllWriters)
+{
+    auto first = Open();
+    auto second = Open();
+    EXPECT_TRUE(first->StoreRecord(MakeRecord("a1")));
+    EXPECT_TRUE(second->StoreRecord(MakeRecord("b1")));
+    EXPECT_TRUE(first->StoreRecord(MakeRecord("a2")));
+    EXPECT_THAT(first->GetQueuedCount(), Eq(3u));
+
+    auto records = TakeAll(*first);
+    EXPECT_TRUE(first->IsUploader());
+    std::vector<std::string> ids;
+    for (auto const& record : records)
+    {
+        ids.push_back(record.id);
+    }
+    EXPECT_THAT(ids, UnorderedElementsAre("a1", "b1", "a2"));
+
+    // The other process only appends while the uploader is busy, but sees the queued records
+    EXPECT_TRUE(second->StoreRecord(MakeRecord("b2")));
+    EXPECT_THAT(TakeAll(*second).size(), Eq(0u));
+    EXPECT_FALSE(second->IsUploader());
+    EXPECT_THAT(second->GetRecordCount(), Eq(1u));
+    EXPECT_THAT(first->GetRecordCount(), Eq(1u));
+    EXPECT_THAT(TakeAll(*first).size(), Eq(1u));
+
+    second->Shutdown();
+    first->Shutdown();
+}
+
+TEST_F(OfflineStorageTests_SharedMemory, IdleUploader_LetsOthersTakeOver)
+{
+    auto first = Open();
+    auto second = Open();
+    EXPECT_TRUE(first->StoreRecord(MakeRecord("a1")));
+    EXPECT_THAT(Ids(TakeAll(*first)), ElementsAre("a1"));
+    EXPECT_TRUE(first->IsUploader());
+
+    // Nothing left to upload
+    EXPECT_THAT(TakeAll(*first).size(), Eq(0u));
+    EXPECT_FALSE(first->IsUploader());
+
+    EXPECT_TRUE(second->StoreRecord(MakeRecord("b1")));
+    EXPECT_THAT(second->GetRecordCount(), Eq(1u));
+    EXPECT_THAT(Ids(TakeAll(*second)), ElementsAre("b1"));
+    EXPECT_TRUE(second->IsUploader());
+
+    second->Shutdown();
+    first->Shutdown();
+}
+
+TEST_F(OfflineStorageTests_SharedMemory, AppendOnlyWriter_LeavesUploadToForwarder)
+{
+    ILogConfiguration appendOnlyConfiguration;
+    appendOnlyConfiguration[CFG_STR_SHARED_QUEUE_PATH] = path;
+    appendOnlyConfiguration[CFG_INT_SHARED_QUEUE_SIZE] = 65536;
+    appendOnlyConfiguration[CFG_BOOL_SHARED_QUEUE_UPLOAD] = false;
+    RuntimeConfig_Default appendOnlyConfig(appendOnlyConfiguration);
+    OfflineStorage_SharedMemory writer(logManager, appendOnlyConfig);
+    writer.Initialize(observer);
+    auto forwarder = Open();
+
+    EXPECT_TRUE(writer.StoreRecord(MakeRecord("a1")));
+    EXPECT_THAT(writer.GetRecordCount(), Eq(0u));
+    EXPECT_THAT(TakeAll(writer).size(), Eq(0u));
+    EXPECT_FALSE(writer.IsUploader());
+
+    // Nothing else holds the upload lock, and still only the forwarder takes the records
+    EXPECT_THAT(forwarder->GetRecordCount(), Eq(1u));
+    EXPECT_THAT(Ids(TakeAll(*forwarder)), ElementsAre("a1"));
+    EXPECT_TRUE(forwarder->IsUploader());
+
+    forwarder->Shutdown();
+    writer.Shutdown();
+}
+
+TEST_F(OfflineStorageTests_SharedMemory, UploaderWithRecordsInFlight_KeepsTheRole)
+{
+    auto first = Open();
+    auto second = Open();
+    EXPECT_TRUE(first->StoreRecord(MakeRecord("a1")));
+    size_t reserved = 0;
+    EXPECT_TRUE(first->GetAndReserveRecords([&reserved](StorageRecord&&) { reserved++; return true; }, 60000));
+    EXPECT_THAT(reserved, Eq(1u));
+
+    EXPECT_THAT(TakeAll(*first).size(), Eq(0u));
+    EXPECT_TRUE(first->IsUploader());
+    EXPECT_THAT(TakeAll(*second).size(), Eq(0u));
+    EXPECT_FALSE(second->IsUploader());
+
+    second->Shutdown();
+    first->Shutdown();
+}
+
+TEST_F(OfflineStorageTests_SharedMemory, OtherCollector_CannotOpenQueue)
+{
+    auto first = Open();
+    EXPECT_TRUE(first->StoreRecord(MakeRecord("a1")));
+
+    configuration[CFG_STR_COLLECTOR_URL] = "https://collector.example/OneCollector/1.0/";
+    config.reset(new RuntimeConfig_Default(configuration));
+    EXPECT_CALL(observer, OnStorageOpenFailed(_)).Times(1);
+    auto second = Open();
+    EXPECT_FALSE(second->StoreRecord(MakeRecord("b1")));
+    EXPECT_THAT(first->GetQueuedCount(), Eq(1u));
+
+    second->Shutdown();
+    first->Shutdown();
+}
+
+TEST_F(OfflineStorageTests_SharedMemory, DeleteAllRecords_DeletesOwnRecordsOnly)
+{
+    auto storage = OpenForTest();
+    auto other = OpenForTest();
+    other->m_pid = storage->m_pid + 1;
+
+    // Drained by the uploader
+    EXPECT_TRUE(storage->StoreRecord(MakeRecord("a1")));
+    EXPECT_TRUE(other->StoreRecord(MakeRecord("b1")));
+    size_t reserved = 0;
+    EXPECT_TRUE(storage->GetAndReserveRecords([&reserved](StorageRecord&&) { reserved++; return true; }, 60000));
+    EXPECT_THAT(reserved, Eq(2u));
+    storage->ReleaseAllRecords();
+    // Still in the ring
+    EXPECT_TRUE(storage->StoreRecord(MakeRecord("a2")));
+    EXPECT_TRUE(other->StoreRecord(MakeRecord("b2")));
+
+    storage->DeleteAllRecords();
+    EXPECT_THAT(storage->GetQueuedCount(), Eq(1u));
+    EXPECT_THAT(Ids(TakeAll(*storage)), UnorderedElementsAre("b1", "b2"));
+
+    other->Shutdown();
+    storage->Shutdown();
+}
+
+TEST_F(OfflineStorageTests_SharedMemory, DeleteRecords_AppliesFilterToOwnRecords)
+{
+    auto storage = OpenForTest();
+    auto other = OpenForTest();
+    other->m_pid = storage->m_pid + 1;
+    EXPECT_TRUE(storage->StoreRecord(MakeRecord("a1")));
+    EXPECT_TRUE(storage->StoreRecord(MakeRecord("c1")));
+    EXPECT_TRUE(other->StoreRecord(MakeRecord("a2")));
+
+    storage->DeleteRecords({ { "tenant_token", "tenant-a" } });
+    EXPECT_THAT(Ids(TakeAll(*storage)), UnorderedElementsAre("c1", "a2"));
+
+    other->Shutdown();
+    storage->Shutdown();
+}
+
+TEST_F(OfflineStorageTests_SharedMemory, DeleteAllRecords_LeavesRecordsOfBusyUploader)
+{
+    auto uploader = Open();
+    auto storage = Open();
+    EXPECT_TRUE(uploader->StoreRecord(MakeRecord("a1")));
+    size_t reserved = 0;
+    EXPECT_TRUE(uploader->GetAndReserveRecords([&reserved](StorageRecord&&) { reserved++; return true; }, 60000));
+    EXPECT_THAT(reserved, Eq(1u));
+
+    EXPECT_TRUE(storage->StoreRecord(MakeRecord("b1")));
+    storage->DeleteAllRecords();
+    EXPECT_FALSE(storage->IsUploader());
+    EXPECT_THAT(uploader->GetQueuedCount(), Eq(1u));
+
+    storage->Shutdown();
+    uploader->Shutdown();
+}
+
+TEST_F(OfflineStorageTests_SharedMemory, RecordFields_AreKept)
+{
+    auto storage = Open();
+    StorageRecord record("id-1", "token", EventLatency_RealTime, EventPersistence_Critical, 987654321, { 1, 2, 3 }, 2);
+    EXPECT_TRUE(storage->StoreRecord(record));
+
+    auto records = TakeAll(*storage);
+    ASSERT_THAT(records.size(), Eq(1u));
+    EXPECT_THAT(records[0].id, Eq("id-1"));
+    EXPECT_THAT(records[0].tenantToken, Eq("token"));
+    EXPECT_THAT(records[0].latency, Eq(EventLatency_RealTime));
+    EXPECT_THAT(records[0].persistence, Eq(EventPersistence_Critical));
+    EXPECT_THAT(records[0].timestamp, Eq(987654321));
+    EXPECT_THAT(records[0].retryCount, Eq(2));
+    EXPECT_THAT(records[0].blob, ElementsAre(1, 2, 3));
+    storage->Shutdown();
+}
+
+TEST_F(OfflineStorageTests_SharedMemory, Ring_WrapsAround)
+{
+    auto storage = Open();
+    int next = 0;
+    std::set<std::string> received;
+    for (int round = 0; round < 50; round++)
+    {
+        for (int i = 0; i < 20; i++)
+        {
+            ASSERT_TRUE(storage->StoreRecord(MakeRecord(std::to_string(next++), 700)));
+        }
+        for (auto const& record : TakeAll(*storage))
+        {
+            EXPECT_THAT(record.blob.size(), Eq(700u));
+            received.insert(record.id);
+        }
+        EXPECT_THAT(received.size(), Eq(static_cast<size_t>(next)));
+    }
+    storage->Shutdown();
+}
+
+TEST_F(OfflineStorageTests_SharedMemory, FullRing_RejectsRecords)
+{
+    auto storage = Open();
+    EXPECT_CALL(observer, OnStorageTrimmed(_)).Times(AtLeast(1));
+    size_t stored = 0;
+    while (storage->StoreRecord(MakeRecord("x" + std::to_string(stored), 1000)))
+    {
+        stored++;
+    }
+    EXPECT_THAT(stored, Gt(50u));
+    EXPECT_THAT(TakeAll(*storage).size(), Eq(stored));
+
+    // Draining frees the space again
+    EXPECT_TRUE(storage->StoreRecord(MakeRecord("y", 1000)));
+    storage->Shutdown();
+}
+
+TEST_F(OfflineStorageTests_SharedMemory, UploaderShutdown_HandsRecordsToNextUploader)
+{
+    auto first = Open();
+    auto second = Open();
+    EXPECT_TRUE(second->StoreRecord(MakeRecord("a")));
+    EXPECT_TRUE(second->StoreRecord(MakeRecord("b")));
+
+    // Reserved for an upload that never completes
+    size_t reserved = 0;
+    EXPECT_TRUE(first->GetAndReserveRecords([&reserved](StorageRecord&&) { reserved++; return true; }, 60000));
+    EXPECT_THAT(reserved, Eq(2u));
+    first->Shutdown();
+
+    auto records = TakeAll(*second);
+    EXPECT_TRUE(second->IsUploader());
+    EXPECT_THAT(records.size(), Eq(2u));
+    second->Shutdown();
+}
+
+TEST_F(OfflineStorageTests_SharedMemory, Drain_StopsWhenMemoryIsFull)
+{
+    configuration[CFG_INT_RAM_QUEUE_SIZE] = 4096;
+    config.reset(new RuntimeConfig_Default(configuration));
+    auto storage = Open();
+    for (int i = 0; i < 20; i++)
+    {
+        ASSERT_TRUE(storage->StoreRecord(MakeRecord("x" + std::to_string(i), 1000)));
+    }
+
+    size_t first = TakeAll(*storage).size();
+    EXPECT_THAT(first, AllOf(Gt(0u), Lt(20u)));
+    EXPECT_THAT(storage->GetQueuedCount(), Eq(20u - first));
+
+    size_t received = first;
+    for (int i = 0; (i < 20) && (received < 20); i++)
+    {
+        received += TakeAll(*storage).size();
+    }
+    EXPECT_THAT(received, Eq(20u));
+    EXPECT_THAT(storage->GetQueuedCount(), Eq(0u));
+    storage->Shutdown();
+}
+
+TEST_F(OfflineStorageTests_SharedMemory, DeadWriter_SlotIsSkipped)
+{
+    auto storage = OpenForTest();
+    EXPECT_TRUE(storage->StoreRecord(MakeRecord("a")));
+    EXPECT_TRUE(storage->StoreRecord(MakeRecord("b")));
+
+    // "a" was reserved by a process that died in the middle of writing it
+    auto& slot = storage->SlotAt(0);
+    slot.state = 1;
+    slot.pid = DeadPid();
+
+    EXPECT_THAT(Ids(TakeAll(*storage)), ElementsAre("b"));
+    storage->Shutdown();
+}
+
+TEST_F(OfflineStorageTests_SharedMemory, LiveWriter_SlotIsWaitedFor)
+{
+    auto storage = OpenForTest();
+    EXPECT_TRUE(storage->StoreRecord(MakeRecord("a")));
+    EXPECT_TRUE(storage->StoreRecord(MakeRecord("b")));
+
+    // Still being written by this process
+    auto& slot = storage->SlotAt(0);
+    slot.state = 1;
+    EXPECT_THAT(TakeAll(*storage).size(), Eq(0u));
+    storage->m_stalledSince -= OfflineStorage_SharedMemory::StallTimeoutMs;
+    EXPECT_THAT(TakeAll(*storage).size(), Eq(0u));
+
+    slot.state = 2;
+    EXPECT_THAT(Ids(TakeAll(*storage)), UnorderedElementsAre("a", "b"));
+    storage->Shutdown();
+}
+
+TEST_F(OfflineStorageTests_SharedMemory, StalledSlot_IsDiscardedAfterTimeout)
+{
+    auto storage = OpenForTest();
+    EXPECT_TRUE(storage->StoreRecord(MakeRecord("a")));
+    EXPECT_TRUE(storage->StoreRecord(MakeRecord("b")));
+
+    // Space reserved by a writer that died before writing the slot header
+    memset(&storage->SlotAt(0), 0, sizeof(SharedMemoryStorage4Test::Slot));
+    EXPECT_THAT(TakeAll(*storage).size(), Eq(0u));
+    EXPECT_THAT(TakeAll(*storage).size(), Eq(0u));
+
+    // Everything reserved up to then is given up, later records are uploaded again
+    storage->m_stalledSince -= OfflineStorage_SharedMemory::StallTimeoutMs;
+    EXPECT_THAT(TakeAll(*storage).size(), Eq(0u));
+    EXPECT_TRUE(storage->StoreRecord(MakeRecord("c")));
+    EXPECT_THAT(Ids(TakeAll(*storage)), ElementsAre("c"));
+    storage->Shutdown();
+}
+
+TEST_F(OfflineStorageTests_SharedMemory, ConcurrentWriters_LoseNothing)
+{
+    auto reader = Open();
+    TakeAll(*reader);
+
+    std::vector<std::unique_ptr<OfflineStorage_SharedMemory>> writers;
+    for (int w = 0; w < 4; w++)
+    {
+        writers.push_back(Open());
+    }
+    std::atomic<size_t> written(0);
+    std::vector<std::thread> threads;
+    for (auto& writer : writers)
+    {
+        OfflineStorage_SharedMemory* storage = writer.get();
+        threads.emplace_back([storage, &written]() {
+            for (int i = 0; i < 500; i++)
+            {
+                // Retry while the ring is full
+                while (!storage->StoreRecord(MakeRecord("w" + std::to_string(i), 100)))
+                {
+                    std::this_thread::yield();
+                }
+                written++;
+            }
+        });
+    }
+
+    size_t received = 0;
+    while (received < 2000)
+    {
+        received += TakeAll(*reader).size();
+    }
+    for (auto& thread : threads)
+    {
+        thread.join();
+    }
+    EXPECT_THAT(written.load(), Eq(2000u));
+    EXPECT_THAT(received, Eq(2000u));
+    EXPECT_THAT(reader->GetQueuedCount(), Eq(0u));
+
+    for (auto& writer : writers)
+    {
+        writer->Shutdown();
+    }
+    reader->Shutdown();
+}
+
+#endif // HAVE_MAT_SHARED_QUEUE
@@ -0,0 +1,130 @@
+//
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// SPDX-License-Identifier: Apache-2.0
+//
+
+#include "common/Common.hpp"
+#include "pal/PipelineTrace.hpp"
+#include "pal/TaskDispatcher.hpp"
+#include "pal/WorkerThread.hpp"
+#include "system/Route.hpp"
+
+using namespace testing;
+using namespace MAT;
+
+class PipelineTraceTests : public ::testing::Test
+{
+protected:
+    virtual void SetUp() override
+    {
+        PAL::PipelineTrace::Enable(true);
+        PAL::PipelineTrace::Clear();
+    }
+
+    virtual void TearDown() override
+    {
+        PAL::PipelineTrace::Enable(false);
+        PAL::PipelineTrace::Clear();
+    }
+
+public:
+    std::atomic<bool> taskDone{false};
+
+    void markDone()
+    {
+        taskDone = true;
+    }
+
+    bool handleValue(int value)
+    {
+        return value > 0;
+    }
+
+protected:
+    static size_t Count(std::string const& text, std::string const& pattern)
+    {
+        size_t count = 0;
+        for (size_t pos = text.find(pattern); pos != std::string::npos; pos = text.find(pattern, pos + 1))
+        {
+            count++;
+        }
+        return count;
+    }
+};
+
+TEST_F(PipelineTraceTests, Scopes_AreExportedAsCompleteEvents)
+{
+    {
+        PAL::PipelineTraceScope scope("route", "serialize");
+    }
+    PAL::PipelineTrace::Record("task", "with \"quotes\"", 100, 150);
+
+    std::string json = PAL::PipelineTrace::GetJson();
+    EXPECT_THAT(json, StartsWith("{\"traceEvents\":[{\"name\":\"serialize\",\"cat\":\"route\",\"ph\":\"X\""));
+    EXPECT_THAT(json, HasSubstr("{\"name\":\"with \\\"quotes\\\"\",\"cat\":\"task\",\"ph\":\"X\",\"ts\":100,\"dur\":50,"));
+    EXPECT_THAT(json, EndsWith("],\"displayTimeUnit\":\"ms\"}"));
+}
+
+TEST_F(PipelineTraceTests, Disabled_RecordsNothing)
+{
+    PAL::PipelineTrace::Enable(false);
+    {
+        PAL::PipelineTraceScope scope("route", "serialize");
+        EXPECT_FALSE(scope.IsActive());
+    }
+    EXPECT_THAT(PAL::PipelineTrace::GetJson(), Eq("{\"traceEvents\":[],\"displayTimeUnit\":\"ms\"}"));
+}
+
+TEST_F(PipelineTraceTests, Ring_KeepsMostRecentEntries)
+{
+    const size_t total = PAL::PipelineTrace::Capacity + 10;
+    for (size_t i = 0; i < total; i++)
+    {
+        PAL::PipelineTrace::Record("task", (i < 10) ? "old" : "new", 1, 2);
+    }
+    std::string json = PAL::PipelineTrace::GetJson();
+    EXPECT_THAT(Count(json, "\"name\":\"new\""), Eq(PAL::PipelineTrace::Capacity));
+    EXPECT_THAT(Count(json, "\"name\":\"old\""), Eq(0u));
+
+    PAL::PipelineTrace::Clear();
+    EXPECT_THAT(Count(PAL::PipelineTrace::GetJson(), "\"name\""), Eq(0u));
+}
+
+TEST_F(PipelineTraceTests, LongNames_AreTruncated)
+{
+    std::string name(PAL::PipelineTrace::MaxNameLength + 20, 'x');
+    PAL::PipelineTrace::Record("task", name.c_str(), 1, 2);
+    std::string json = PAL::PipelineTrace::GetJson();
+    EXPECT_THAT(json, HasSubstr("\"" + std::string(PAL::PipelineTrace::MaxNameLength, 'x') + "\""));
+    EXPECT_THAT(json, Not(HasSubstr(std::string(PAL::PipelineTrace::MaxNameLength + 1, 'x'))));
+}
+
+#ifdef HAVE_MAT_PIPELINE_TRACE
+TEST_F(PipelineTraceTests, RouteHops_AreTimed)
+{
+    RoutePassThrough<PipelineTraceTests, int> named{this, &PipelineTraceTests::handleValue, "named-hop"};
+    RoutePassThrough<PipelineTraceTests, int> unnamed{this, &PipelineTraceTests::handleValue};
+    RouteSource<int> source;
+    source >> named >> unnamed;
+
+    source(1);
+    source(0);
+
+    std::string json = PAL::PipelineTrace::GetJson();
+    EXPECT_THAT(Count(json, "{\"name\":\"named-hop\",\"cat\":\"route\""), Eq(2u));
+    // The second hop only runs for the first value
+    EXPECT_THAT(Count(json, "\"cat\":\"route\""), Eq(3u));
+#if HAS_RTTI
+    EXPECT_THAT(json, HasSubstr("PipelineTraceTests"));
+#endif
+}
+
+TEST_F(PipelineTraceTests, WorkerTasks_AreTimed)
+{
+    std::shared_ptr<ITaskDispatcher> dispatcher = PAL::WorkerThreadFactory::Create();
+    PAL::dispatchTask(dispatcher.get(), static_cast<PipelineTraceTests*>(this), &PipelineTraceTests::markDone);
+    dispatcher->Join();
+    EXPECT_TRUE(taskDone);
+    EXPECT_THAT(PAL::PipelineTrace::GetJson(), HasSubstr("\"cat\":\"task\""));
+}
+#endif
@@ -79,6 +79,10 @@ class RouteTests : public StrictMock<Test> {
         std::vector<int> x = std::move(e);
         handleSink5(a, b, c, d);
     }
+
+    MAT_BOUND_ROUTE(RouteTests, handlePassThrough1a)                                       boundPassThrough1a{this};
+    MAT_BOUND_ROUTE(RouteTests, handlePassThrough1b)                                       boundPassThrough1b{this};
+    MAT_BOUND_ROUTE(RouteTests, handleSink1)                                               boundSink1{this};
 };
 
 
@@ -208,3 +212,52 @@ TEST_F(RouteTests, RoutesCanCoexistsAcrossTheSamePath)
     sourceA(123);
 }
 
+
+
+TEST_F(RouteTests, BoundHandlersWorkInDynamicRoutes)
+{
+    RouteSource<int> source1;
+    source1 >> boundPassThrough1a >> boundSink1;
+
+    InSequence order;
+    EXPECT_CALL(*this, handlePassThrough1a(123))
+        .WillOnce(Return(true));
+    EXPECT_CALL(*this, handleSink1(123))
+        .WillOnce(Return());
+    source1(123);
+}
+
+TEST_F(RouteTests, StaticRouteInvokesPassThroughsThenSink)
+{
+    auto route = makeStaticRoute(boundPassThrough1a, boundPassThrough1b, boundSink1);
+
+    InSequence order;
+    EXPECT_CALL(*this, handlePassThrough1a(123))
+        .WillOnce(Return(true));
+    EXPECT_CALL(*this, handlePassThrough1b(123))
+        .WillOnce(Return(true));
+    EXPECT_CALL(*this, handleSink1(123))
+        .WillOnce(Return());
+    route(123);
+}
+
+TEST_F(RouteTests, StaticRoutePassThroughCanStopTheFlow)
+{
+    auto route = makeStaticRoute(boundPassThrough1a, boundPassThrough1b, boundSink1);
+
+    InSequence order;
+    EXPECT_CALL(*this, handlePassThrough1a(123))
+        .WillOnce(Return(true));
+    EXPECT_CALL(*this, handlePassThrough1b(123))
+        .WillOnce(Return(false));
+    route(123);
+}
+
+TEST_F(RouteTests, StaticRouteWithoutSinkIsOk)
+{
+    auto route = makeStaticRoute(boundPassThrough1b);
+
+    EXPECT_CALL(*this, handlePassThrough1b(5))
+        .WillOnce(Return(true));
+    route(5);
+}
@@ -0,0 +1,136 @@
+//
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// SPDX-License-Identifier: Apache-2.0
+//
+
+#include "common/Common.hpp"
+#include "pal/posix/sysinfo_sources_impl.hpp"
+#include "utils/FileUtils.hpp"
+#include "utils/Utils.hpp"
+
+using namespace testing;
+using namespace MAT;
+
+class TestSysInfoSources : public sysinfo_sources
+{
+  public:
+    TestSysInfoSources(std::string const& bootIdPath) :
+        m_bootIdPath(bootIdPath)
+    {
+        add("bootId", { m_bootIdPath.c_str(), SYSINFO_FIRST_LINE, nullptr });
+        bootFields = { "devId", "osName" };
+    }
+
+  private:
+    // sysinfo_source_t does not own its path
+    std::string m_bootIdPath;
+};
+
+class SysInfoSourcesTests : public Test
+{
+  protected:
+    std::string bootIdPath = GetTempDirectory() + "SysInfoSourcesTests.boot";
+    std::string releasePath = GetTempDirectory() + "SysInfoSourcesTests.release";
+
+    virtual void SetUp() override
+    {
+        FileWrite(bootIdPath.c_str(), "1234\n");
+        FileWrite(releasePath.c_str(), "NAME=\"Some Linux\"\nVERSION_ID=\"12\"\nID=some\n");
+    }
+
+    virtual void TearDown() override
+    {
+        FileDelete(bootIdPath.c_str());
+        FileDelete(releasePath.c_str());
+    }
+};
+
+TEST_F(SysInfoSourcesTests, Parse_OsRelease)
+{
+    std::string contents = "PRETTY_NAME=\"Debian GNU/Linux 12 (bookworm)\"\nVERSION_ID=\"12\"\nVERSION=\"12 (bookworm)\"\nID=debian\r\nID_LIKE='rhel fedora'\n";
+    EXPECT_THAT(sysinfo_sources::parse(contents, SYSINFO_ENV_VALUE, "ID"), Eq("debian"));
+    EXPECT_THAT(sysinfo_sources::parse(contents, SYSINFO_ENV_VALUE, "VERSION_ID"), Eq("12"));
+    EXPECT_THAT(sysinfo_sources::parse(contents, SYSINFO_ENV_VALUE, "VERSION"), Eq("12 (bookworm)"));
+    EXPECT_THAT(sysinfo_sources::parse(contents, SYSINFO_ENV_VALUE, "ID_LIKE"), Eq("rhel fedora"));
+    EXPECT_THAT(sysinfo_sources::parse(contents, SYSINFO_ENV_VALUE, "NAME"), IsEmpty());
+    EXPECT_THAT(sysinfo_sources::parse("ID=", SYSINFO_ENV_VALUE, "ID"), IsEmpty());
+}
+
+TEST_F(SysInfoSourcesTests, Parse_LinesAndArguments)
+{
+    EXPECT_THAT(sysinfo_sources::parse("Linux version 6.1\n#1 SMP\n", SYSINFO_FIRST_LINE, nullptr), Eq("Linux version 6.1"));
+    EXPECT_THAT(sysinfo_sources::parse("no line break", SYSINFO_FIRST_LINE, nullptr), Eq("no line break"));
+    EXPECT_THAT(sysinfo_sources::parse(std::string("/usr/bin/app\0--flag\0", 21), SYSINFO_FIRST_ARG, nullptr), Eq("/usr/bin/app"));
+    EXPECT_THAT(sysinfo_sources::parse("abc\n", SYSINFO_WHOLE_FILE, nullptr), Eq("abc\n"));
+}
+
+TEST_F(SysInfoSourcesTests, Get_ResolvesOnFirstUse)
+{
+    TestSysInfoSources sysInfo(bootIdPath);
+    int resolved = 0;
+    sysInfo.add("osName", { releasePath.c_str(), SYSINFO_ENV_VALUE, "ID" });
+    sysInfo.add("devId", { "/nonexistent/machine-id", SYSINFO_WHOLE_FILE, nullptr });
+    sysInfo.fallback("devId", [&]() { resolved++; return std::string(); });
+    sysInfo.fallback("devId", [&]() { resolved++; return std::string("fallback"); });
+
+    // Nothing has been read yet
+    FileWrite(releasePath.c_str(), "ID=other\n");
+    EXPECT_THAT(resolved, Eq(0));
+    EXPECT_THAT(sysInfo.get("osName"), Eq("other"));
+    EXPECT_THAT(sysInfo.get("devId"), Eq("fallback"));
+    EXPECT_THAT(sysInfo.get("devId"), Eq("fallback"));
+    EXPECT_THAT(resolved, Eq(2));
+}
+
+TEST_F(SysInfoSourcesTests, Load_SameBoot_SkipsSources)
+{
+    std::string saved;
+    {
+        TestSysInfoSources sysInfo(bootIdPath);
+        sysInfo.fallback("devId", []() { return std::string("line\\1\nline 2\n"); });
+        sysInfo.add("osName", { releasePath.c_str(), SYSINFO_ENV_VALUE, "ID" });
+        sysInfo.get("devId");
+        sysInfo.get("osName");
+        saved = sysInfo.save();
+    }
+    EXPECT_THAT(saved, Eq("1234\ndevId=line\\\\1\\nline 2\\n\nosName=some\n"));
+
+    TestSysInfoSources sysInfo(bootIdPath);
+    int resolved = 0;
+    sysInfo.fallback("devId", [&]() { resolved++; return std::string("other"); });
+    EXPECT_TRUE(sysInfo.load(saved));
+    EXPECT_THAT(sysInfo.get("devId"), Eq("line\\1\nline 2\n"));
+    EXPECT_THAT(sysInfo.get("osName"), Eq("some"));
+    EXPECT_THAT(resolved, Eq(0));
+}
+
+TEST_F(SysInfoSourcesTests, Load_OtherBoot_IsIgnored)
+{
+    TestSysInfoSources sysInfo(bootIdPath);
+    sysInfo.fallback("devId", []() { return std::string("current"); });
+    EXPECT_FALSE(sysInfo.load("5678\ndevId=saved\n"));
+    EXPECT_FALSE(sysInfo.load(""));
+    EXPECT_THAT(sysInfo.get("devId"), Eq("current"));
+
+    // Fields resolved already are kept, only boot fields are restored
+    EXPECT_TRUE(sysInfo.load("1234\ndevId=saved\ntz=+01:00\n"));
+    EXPECT_THAT(sysInfo.get("devId"), Eq("current"));
+    EXPECT_THAT(sysInfo.get("tz"), IsEmpty());
+}
+
+TEST_F(SysInfoSourcesTests, Save_WithoutBootId_IsEmpty)
+{
+    TestSysInfoSources sysInfo("/nonexistent/boot_id");
+    sysInfo.fallback("devId", []() { return std::string("current"); });
+    sysInfo.get("devId");
+    EXPECT_THAT(sysInfo.save(), IsEmpty());
+}
+
+TEST_F(SysInfoSourcesTests, Impl_ReadsLinuxSources)
+{
+    auto& sysInfo = sysinfo_sources_impl::GetSysInfo();
+    EXPECT_THAT(sysInfo.get("osName"), Not(IsEmpty()));
+    EXPECT_THAT(sysInfo.get("tz"), MatchesRegex("[+-][0-9][0-9]:[0-9][0-9]"));
+    EXPECT_THAT(sysInfo.get("bootId"), Not(IsEmpty()));
+    EXPECT_THAT(sysInfo.get("appId"), HasSubstr("UnitTests"));
+}
@@ -0,0 +1,119 @@
+//
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// SPDX-License-Identifier: Apache-2.0
+//
+
+#include "common/Common.hpp"
+#include "common/MockIRuntimeConfig.hpp"
+#include "tpm/TenantUploadScheduler.hpp"
+
+using namespace testing;
+using namespace MAT;
+
+class TenantUploadSchedulerTests : public Test
+{
+protected:
+    ILogConfiguration           config;
+    std::unique_ptr<MockIRuntimeConfig> runtimeConfig;
+
+    void SetUp() override
+    {
+        config[CFG_MAP_TPM][CFG_BOOL_TPM_FAIR_UPLOAD] = true;
+        config[CFG_MAP_TPM][CFG_MAP_TPM_TENANT_WEIGHTS]["heavy"] = 3;
+        runtimeConfig.reset(new MockIRuntimeConfig(config));
+    }
+
+    // Simulates upload rounds with one slot each: every tenant always has a backlog
+    std::map<std::string, size_t> upload(TenantUploadScheduler& scheduler, size_t rounds, size_t eventsPerPackage)
+    {
+        std::map<std::string, size_t> uploaded;
+        for (size_t i = 0; i < rounds; i++)
+        {
+            for (auto const& tenant : scheduler.pickTenants(1))
+            {
+                uploaded[tenant] += eventsPerPackage;
+                scheduler.charge(tenant, eventsPerPackage);
+                scheduler.release(tenant);
+            }
+        }
+        return uploaded;
+    }
+};
+
+TEST_F(TenantUploadSchedulerTests, DisabledByDefault)
+{
+    ILogConfiguration emptyConfig;
+    MockIRuntimeConfig defaultConfig(emptyConfig);
+    TenantUploadScheduler scheduler(defaultConfig);
+    EXPECT_FALSE(scheduler.isEnabled());
+}
+
+TEST_F(TenantUploadSchedulerTests, ReadsWeightsFromConfig)
+{
+    TenantUploadScheduler scheduler(*runtimeConfig);
+    EXPECT_TRUE(scheduler.isEnabled());
+    EXPECT_EQ(3u, scheduler.getWeight("heavy"));
+    EXPECT_EQ(1u, scheduler.getWeight("other"));
+}
+
+TEST_F(TenantUploadSchedulerTests, NoisyTenantDoesNotStarveQuietTenant)
+{
+    TenantUploadScheduler scheduler(*runtimeConfig);
+    scheduler.noteArrival("noisy-token");
+    upload(scheduler, 10, 100);
+
+    // Quiet tenant joins at the current virtual time and gets the next free slot
+    EXPECT_THAT(scheduler.pickTenants(1), ElementsAre("noisy-token"));
+    scheduler.noteArrival("quiet-token");
+    EXPECT_THAT(scheduler.pickTenants(1), ElementsAre("quiet-token"));
+    scheduler.charge("noisy-token", 100);
+    scheduler.release("noisy-token");
+    scheduler.charge("quiet-token", 100);
+    scheduler.release("quiet-token");
+
+    auto uploaded = upload(scheduler, 10, 100);
+    EXPECT_EQ(500u, uploaded["noisy-token"]);
+    EXPECT_EQ(500u, uploaded["quiet-token"]);
+}
+
+TEST_F(TenantUploadSchedulerTests, WeightsSplitUploadsProportionally)
+{
+    TenantUploadScheduler scheduler(*runtimeConfig);
+    scheduler.noteArrival("other-token");
+    scheduler.noteArrival("heavy-token");
+    auto uploaded = upload(scheduler, 8, 100);
+    EXPECT_EQ(200u, uploaded["other-token"]);
+    EXPECT_EQ(600u, uploaded["heavy-token"]);
+}
+
+TEST_F(TenantUploadSchedulerTests, InFlightAndIdleTenantsAreNotPicked)
+{
+    TenantUploadScheduler scheduler(*runtimeConfig);
+    scheduler.noteArrival("a-token");
+    scheduler.noteArrival("b-token");
+    EXPECT_EQ(2u, scheduler.activeTenantCount());
+    EXPECT_EQ(2u, scheduler.pickTenants(4).size());
+    EXPECT_EQ(0u, scheduler.pickTenants(4).size());
+
+    scheduler.charge("a-token", 10);
+    scheduler.release("a-token");
+    scheduler.markIdle("b-token");
+    EXPECT_EQ(1u, scheduler.activeTenantCount());
+    auto picked = scheduler.pickTenants(4);
+    ASSERT_EQ(1u, picked.size());
+    EXPECT_EQ("a-token", picked[0]);
+}
+
+TEST_F(TenantUploadSchedulerTests, ChargeKeepsTenantInFlight)
+{
+    TenantUploadScheduler scheduler(*runtimeConfig);
+    scheduler.noteArrival("a-token");
+    EXPECT_THAT(scheduler.pickTenants(1), ElementsAre("a-token"));
+
+    // Events of the tenant went out in a generic package while its own is still in flight
+    scheduler.charge("a-token", 10);
+    EXPECT_EQ(0u, scheduler.pickTenants(1).size());
+
+    scheduler.release("a-token");
+    EXPECT_THAT(scheduler.pickTenants(1), ElementsAre("a-token"));
+}
@@ -0,0 +1,100 @@
+//
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// SPDX-License-Identifier: Apache-2.0
+//
+
+#include "common/Common.hpp"
+#include "common/MockIRuntimeConfig.hpp"
+#include "bwcontrol/TokenBucketBandwidthController.hpp"
+
+using namespace testing;
+using namespace MAT;
+
+class TokenBucketBandwidthController4Test : public TokenBucketBandwidthController
+{
+public:
+    TokenBucketBandwidthController4Test(unsigned rateBps, unsigned burstBytes) :
+        TokenBucketBandwidthController(rateBps, burstBytes)
+    {
+    }
+
+    uint64_t nowMs { 1000 };
+
+protected:
+    virtual uint64_t getMonotonicTimeMs() const override
+    {
+        return nowMs;
+    }
+};
+
+TEST(TokenBucketBandwidthControllerTests, BurstIsSentWithoutDelay)
+{
+    TokenBucketBandwidthController4Test controller(1000, 5000);
+    EXPECT_EQ(1000u, controller.GetProposedBandwidthBps());
+    EXPECT_EQ(0u, controller.GetSendDelayMs(EventLatency_Normal));
+    controller.OnBytesSent(EventLatency_Normal, 5000);
+    EXPECT_EQ(0u, controller.GetSendDelayMs(EventLatency_Normal));
+}
+
+TEST(TokenBucketBandwidthControllerTests, DebtIsPaidOffAtConfiguredRate)
+{
+    TokenBucketBandwidthController4Test controller(1000, 5000);
+    controller.OnBytesSent(EventLatency_Normal, 7000);
+    EXPECT_EQ(2000u, controller.GetSendDelayMs(EventLatency_Normal));
+    controller.nowMs += 1500;
+    EXPECT_EQ(500u, controller.GetSendDelayMs(EventLatency_Normal));
+    controller.nowMs += 500;
+    EXPECT_EQ(0u, controller.GetSendDelayMs(EventLatency_Normal));
+}
+
+TEST(TokenBucketBandwidthControllerTests, AchievedRateMatchesConfiguredRate)
+{
+    TokenBucketBandwidthController4Test controller(10000, 1000);
+    uint64_t startMs = controller.nowMs;
+    size_t sentBytes = 0;
+    // Upload 1 KB requests as fast as the controller allows for 10 seconds
+    while (controller.nowMs - startMs < 10000)
+    {
+        unsigned delayMs = controller.GetSendDelayMs(EventLatency_Normal);
+        if (delayMs > 0)
+        {
+            controller.nowMs += delayMs;
+            continue;
+        }
+        controller.OnBytesSent(EventLatency_Normal, 1000);
+        sentBytes += 1000;
+    }
+    double achievedBps = sentBytes * 1000.0 / static_cast<double>(controller.nowMs - startMs);
+    EXPECT_NEAR(10000.0, achievedBps, 10000.0 * 0.02);
+}
+
+TEST(TokenBucketBandwidthControllerTests, LatenciesHaveSeparateBuckets)
+{
+    TokenBucketBandwidthController4Test controller(1000, 1000);
+    controller.setLatencyRate(EventLatency_RealTime, 0);
+    controller.OnBytesSent(EventLatency_Normal, 3000);
+    controller.OnBytesSent(EventLatency_RealTime, 3000);
+    EXPECT_EQ(2000u, controller.GetSendDelayMs(EventLatency_Normal));
+    EXPECT_EQ(0u, controller.GetSendDelayMs(EventLatency_CostDeferred));
+    EXPECT_EQ(0u, controller.GetSendDelayMs(EventLatency_RealTime));
+}
+
+TEST(TokenBucketBandwidthControllerTests, CreateFromConfig)
+{
+    ILogConfiguration config;
+    config[CFG_MAP_TPM][CFG_INT_TPM_BANDWIDTH_BPS] = 0;
+    MockIRuntimeConfig disabledConfig(config);
+    EXPECT_EQ(nullptr, TokenBucketBandwidthController::createFromConfig(disabledConfig));
+
+    config[CFG_MAP_TPM][CFG_INT_TPM_BANDWIDTH_BPS] = 2048;
+    config[CFG_MAP_TPM][CFG_INT_TPM_BANDWIDTH_BURST] = 4096;
+    config[CFG_MAP_TPM][CFG_MAP_TPM_BANDWIDTH_LATENCY_BPS]["RealTime"] = 0;
+    MockIRuntimeConfig enabledConfig(config);
+    auto controller = TokenBucketBandwidthController::createFromConfig(enabledConfig);
+    ASSERT_NE(nullptr, controller);
+    EXPECT_EQ(2048u, controller->GetProposedBandwidthBps());
+    controller->OnBytesSent(EventLatency_RealTime, 100000);
+    EXPECT_EQ(0u, controller->GetSendDelayMs(EventLatency_RealTime));
+    controller->OnBytesSent(EventLatency_Normal, 100000);
+    EXPECT_LT(0u, controller->GetSendDelayMs(EventLatency_Normal));
+}
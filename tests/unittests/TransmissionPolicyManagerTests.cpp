@@ -11,6 +11,8 @@
 #include "tpm/TransmissionPolicyManager.hpp"
 #include "TransmitProfiles.hpp"
 
+#include <future>
+
 using namespace testing;
 using namespace MAT;
 
@@ -33,6 +35,7 @@ class TransmissionPolicyManager4Test : public TransmissionPolicyManager {
     }
 
     using TransmissionPolicyManager::increaseBackoff;
+    using TransmissionPolicyManager::resetBackoff;
     using TransmissionPolicyManager::addUpload;
     using TransmissionPolicyManager::removeUpload;
     using TransmissionPolicyManager::getCancelWaitTime;
@@ -46,6 +49,9 @@ class TransmissionPolicyManager4Test : public TransmissionPolicyManager {
     using TransmissionPolicyManager::m_timerdelay;
     using TransmissionPolicyManager::m_runningLatency;
     using TransmissionPolicyManager::m_backoffConfig;
+    using TransmissionPolicyManager::m_uploadDurationMs;
+    using TransmissionPolicyManager::m_tenantScheduler;
+    using TransmissionPolicyManager::m_uploadTrigger;
 
     MOCK_METHOD3(scheduleUpload, void(const std::chrono::milliseconds&, EventLatency,bool));
     MOCK_METHOD1(uploadAsync, void(EventLatency));
@@ -295,6 +301,87 @@ TEST_F(TransmissionPolicyManagerTests, UploadInitiatesUpload)
     EXPECT_THAT(tpm.activeUploads(), Contains(upload));
 }
 
+TEST_F(TransmissionPolicyManagerTests, FairUpload_NoGenericPackageWhileAllTenantsAreInFlight)
+{
+    VariantMap& tpmConfig = testing::getSystem().getConfig()[CFG_MAP_TPM];
+    tpmConfig[CFG_BOOL_TPM_FAIR_UPLOAD] = true;
+    NiceMock<TransmissionPolicyManager4Test> fairTpm(testing::getSystem(), nullptr);
+    tpmConfig.erase(CFG_BOOL_TPM_FAIR_UPLOAD);
+    fairTpm.initiateUpload >> initiateUpload;
+    fairTpm.paused(false);
+    ASSERT_TRUE(fairTpm.m_tenantScheduler.isEnabled());
+
+    // Nothing known yet: a generic package finds the tenants in storage
+    EventsUploadContextPtr upload;
+    EXPECT_CALL(*this, resultInitiateUpload(_))
+        .WillOnce(SaveArg<0>(&upload));
+    fairTpm.uploadAsyncParent(EventLatency_Normal);
+    ASSERT_THAT(upload, NotNull());
+    EXPECT_THAT(upload->requestedTenantToken, IsEmpty());
+    Mock::VerifyAndClearExpectations(this);
+    EventsUploadContextPtr generic = upload;
+
+    fairTpm.m_tenantScheduler.noteArrival("noisy");
+    EXPECT_CALL(*this, resultInitiateUpload(_))
+        .WillOnce(SaveArg<0>(&upload));
+    fairTpm.uploadAsyncParent(EventLatency_Normal);
+    EXPECT_THAT(upload->requestedTenantToken, Eq("noisy"));
+    Mock::VerifyAndClearExpectations(this);
+
+    // The only tenant is in flight
+    EXPECT_CALL(*this, resultInitiateUpload(_)).Times(0);
+    fairTpm.uploadAsyncParent(EventLatency_Normal);
+    EXPECT_THAT(fairTpm.activeUploads(), SizeIs(2));
+
+    // Events of the tenant in the generic package do not free the slot of its own package
+    generic->recordIdsAndTenantIds["r1"] = "noisy";
+    fairTpm.eventsUploadAborted(generic);
+    fairTpm.uploadAsyncParent(EventLatency_Normal);
+    EXPECT_THAT(fairTpm.activeUploads(), SizeIs(1));
+    Mock::VerifyAndClearExpectations(this);
+
+    EXPECT_CALL(*this, resultInitiateUpload(_))
+        .WillOnce(SaveArg<0>(&upload));
+    upload->recordIdsAndTenantIds["r2"] = "noisy";
+    fairTpm.eventsUploadAborted(upload);
+    fairTpm.uploadAsyncParent(EventLatency_Normal);
+    EXPECT_THAT(upload->requestedTenantToken, Eq("noisy"));
+}
+
+TEST_F(TransmissionPolicyManagerTests, EventTriggers_WatermarkAndQueuedEventsDriveUploads)
+{
+    VariantMap& tpmConfig = testing::getSystem().getConfig()[CFG_MAP_TPM];
+    VariantMap defaults = tpmConfig;
+    tpmConfig[CFG_BOOL_TPM_EVENT_TRIGGERS] = true;
+    tpmConfig[CFG_INT_TPM_WATERMARK_COUNT] = 2;
+    tpmConfig[CFG_MAP_TPM_MAX_DELAY]["Normal"] = 5000;
+    TransmissionPolicyManager4Test triggerTpm(testing::getSystem(), nullptr);
+    tpmConfig = defaults;
+    triggerTpm.paused(false);
+    ASSERT_TRUE(triggerTpm.m_uploadTrigger.isEnabled());
+
+    IncomingEventContext event;
+    event.record.latency = EventLatency_Normal;
+    EXPECT_CALL(triggerTpm, scheduleUpload(std::chrono::milliseconds { 5000 }, EventLatency_Normal, false))
+        .WillOnce(Return());
+    triggerTpm.eventArrived(&event);
+
+    // The watermark starts the upload right away
+    EXPECT_CALL(triggerTpm, scheduleUpload(std::chrono::milliseconds { 0 }, EventLatency_Normal, true))
+        .WillOnce(Return());
+    triggerTpm.eventArrived(&event);
+
+    // Events queued meanwhile still need the next upload
+    EXPECT_CALL(triggerTpm, scheduleUpload(triggerTpm.m_timerdelay, _, false))
+        .WillOnce(Return());
+    triggerTpm.nothingToUpload(triggerTpm.fakeActiveUpload(EventLatency_Normal));
+
+    // Otherwise stays idle until the next event
+    triggerTpm.m_uploadTrigger.onUploadStarted(EventLatency_Off);
+    EXPECT_CALL(triggerTpm, scheduleUpload(_, _, _)).Times(0);
+    triggerTpm.nothingToUpload(triggerTpm.fakeActiveUpload(EventLatency_Normal));
+}
+
 TEST_F(TransmissionPolicyManagerTests, EmptyUploadCeasesUploadingForRunningLatencyNormal)
 {
     auto upload = tpm.fakeActiveUpload(EventLatency_Normal);
@@ -624,3 +711,177 @@ TEST_F(TransmissionPolicyManagerTests, increaseBackoff_CalledTwice_ReturnsHigher
     auto first = tpm.increaseBackoff();
     ASSERT_GT(tpm.increaseBackoff(), first);
 }
+
+TEST_F(TransmissionPolicyManagerTests, increaseBackoff_EndpointsHaveIndependentState)
+{
+    auto first = tpm.increaseBackoff("https://a.example.com/");
+    auto second = tpm.increaseBackoff("https://a.example.com/");
+    ASSERT_GT(second, first);
+    ASSERT_LT(tpm.increaseBackoff("https://b.example.com/"), second);
+}
+
+TEST_F(TransmissionPolicyManagerTests, resetBackoff_OnlyResetsGivenEndpoint)
+{
+    tpm.increaseBackoff("https://a.example.com/");
+    tpm.increaseBackoff("https://b.example.com/");
+    auto second = tpm.increaseBackoff("https://b.example.com/");
+    tpm.resetBackoff("https://a.example.com/");
+    ASSERT_LT(tpm.increaseBackoff("https://a.example.com/"), second);
+    ASSERT_GT(tpm.increaseBackoff("https://b.example.com/"), second);
+}
+
+TEST_F(TransmissionPolicyManagerTests, EmptyUploadResetsBackoffOfEveryEndpoint)
+{
+    tpm.increaseBackoff("https://a.example.com/");
+    auto second = tpm.increaseBackoff("https://a.example.com/");
+    tpm.increaseBackoff("https://b.example.com/");
+    EXPECT_CALL(tpm, scheduleUpload(_, _, _))
+      .WillRepeatedly(Return());
+    tpm.nothingToUpload(tpm.fakeActiveUpload());
+    ASSERT_LT(tpm.increaseBackoff("https://a.example.com/"), second);
+    ASSERT_LT(tpm.increaseBackoff("https://b.example.com/"), second);
+}
+
+/// Keeps the uploads the TPM starts until the test finishes them
+class HeldUploads
+{
+  public:
+    std::mutex lock;
+    std::condition_variable changed;
+    std::vector<EventsUploadContextPtr> uploads;
+
+    void hold(EventsUploadContextPtr const& ctx)
+    {
+        std::lock_guard<std::mutex> guard(lock);
+        uploads.push_back(ctx);
+        changed.notify_all();
+    }
+
+    bool waitFor(size_t count)
+    {
+        std::unique_lock<std::mutex> guard(lock);
+        return changed.wait_for(guard, std::chrono::seconds(5), [&]() { return uploads.size() >= count; });
+    }
+
+    // Uploads held so far: the TPM may add more while the test finishes these
+    std::vector<EventsUploadContextPtr> taken()
+    {
+        std::lock_guard<std::mutex> guard(lock);
+        return uploads;
+    }
+};
+
+TEST_F(TransmissionPolicyManagerTests, drain_UploadsInParallelUntilNothingIsLeft)
+{
+    tpm.paused(false);
+    HeldUploads held;
+    EXPECT_CALL(*this, resultInitiateUpload(_))
+        .Times(4)
+        .WillOnce(Invoke(&held, &HeldUploads::hold))
+        .WillOnce(Invoke(&held, &HeldUploads::hold))
+        .WillOnce(Invoke(&held, &HeldUploads::hold))
+        .WillOnce(Invoke([this](EventsUploadContextPtr const& ctx) { tpm.nothingToUpload(ctx); }));
+
+    auto start = std::chrono::steady_clock::now();
+    auto drained = std::async(std::launch::async, [this]() { return tpm.drain(std::chrono::seconds(10)); });
+    ASSERT_TRUE(held.waitFor(3));
+    for (auto const& ctx : held.taken())
+    {
+        tpm.eventsUploadSuccessful(ctx);
+    }
+    EXPECT_TRUE(drained.get());
+    EXPECT_LT(std::chrono::steady_clock::now() - start, std::chrono::seconds(5));
+    EXPECT_THAT(tpm.activeUploads(), SizeIs(0));
+}
+
+TEST_F(TransmissionPolicyManagerTests, drain_SuccessfulUploadMakesRoomForTheNextOne)
+{
+    tpm.paused(false);
+    auto& config = testing::getSystem().getConfig();
+    config[CFG_INT_MAX_PENDING_REQ] = 1;
+    HeldUploads held;
+    EXPECT_CALL(*this, resultInitiateUpload(_))
+        .Times(3)
+        .WillOnce(Invoke(&held, &HeldUploads::hold))
+        .WillOnce(Invoke(&held, &HeldUploads::hold))
+        .WillOnce(Invoke([this](EventsUploadContextPtr const& ctx) { tpm.nothingToUpload(ctx); }));
+
+    auto drained = std::async(std::launch::async, [this]() { return tpm.drain(std::chrono::seconds(10)); });
+    ASSERT_TRUE(held.waitFor(1));
+    tpm.eventsUploadSuccessful(held.taken()[0]);
+    ASSERT_TRUE(held.waitFor(2));
+    tpm.eventsUploadSuccessful(held.taken()[1]);
+    EXPECT_TRUE(drained.get());
+    config[CFG_INT_MAX_PENDING_REQ] = 4;
+}
+
+TEST_F(TransmissionPolicyManagerTests, drain_FailedUploadEndsDrain)
+{
+    tpm.paused(false);
+    HeldUploads held;
+    EXPECT_CALL(*this, resultInitiateUpload(_))
+        .Times(4)
+        .WillRepeatedly(Invoke(&held, &HeldUploads::hold));
+
+    auto drained = std::async(std::launch::async, [this]() { return tpm.drain(std::chrono::seconds(10)); });
+    ASSERT_TRUE(held.waitFor(4));
+    auto uploads = held.taken();
+    tpm.eventsUploadFailed(uploads[0]);
+    for (size_t i = 1; i < uploads.size(); i++)
+    {
+        tpm.eventsUploadSuccessful(uploads[i]);
+    }
+    EXPECT_TRUE(drained.get());
+}
+
+TEST_F(TransmissionPolicyManagerTests, drain_ReturnsAtTimeout)
+{
+    tpm.paused(false);
+    HeldUploads held;
+    EXPECT_CALL(*this, resultInitiateUpload(_))
+        .Times(4)
+        .WillRepeatedly(Invoke(&held, &HeldUploads::hold));
+
+    auto start = std::chrono::steady_clock::now();
+    EXPECT_FALSE(tpm.drain(std::chrono::milliseconds(200)));
+    EXPECT_GE(std::chrono::steady_clock::now() - start, std::chrono::milliseconds(200));
+    ASSERT_TRUE(held.waitFor(4));
+    EXPECT_THAT(tpm.activeUploads(), SizeIs(4));
+
+    // Uploads aborted after the drain are not rescheduled
+    for (auto const& ctx : held.taken())
+    {
+        tpm.eventsUploadAborted(ctx);
+    }
+    EXPECT_THAT(tpm.activeUploads(), SizeIs(0));
+}
+
+TEST_F(TransmissionPolicyManagerTests, drain_SkipsUploadsThatCannotFinishInTime)
+{
+    tpm.paused(false);
+    tpm.m_uploadDurationMs = 5000;
+    EXPECT_CALL(*this, resultInitiateUpload(_)).Times(0);
+    EXPECT_TRUE(tpm.drain(std::chrono::milliseconds(1000)));
+}
+
+TEST_F(TransmissionPolicyManagerTests, drain_NothingToDoWhenPaused)
+{
+    EXPECT_CALL(*this, resultInitiateUpload(_)).Times(0);
+    EXPECT_TRUE(tpm.drain(std::chrono::milliseconds(1000)));
+}
+
+TEST_F(TransmissionPolicyManagerTests, SuccessfulUploads_SmoothUploadDuration)
+{
+    tpm.paused(false);
+    EXPECT_CALL(tpm, scheduleUpload(std::chrono::milliseconds { 0 }, _, false))
+        .Times(2);
+    auto upload = tpm.fakeActiveUpload();
+    upload->durationMs = 100;
+    tpm.eventsUploadSuccessful(upload);
+    EXPECT_THAT(tpm.m_uploadDurationMs.load(), Eq(100));
+
+    upload = tpm.fakeActiveUpload();
+    upload->durationMs = 200;
+    tpm.eventsUploadSuccessful(upload);
+    EXPECT_THAT(tpm.m_uploadDurationMs.load(), Eq(125));
+}
@@ -0,0 +1,74 @@
+//
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// SPDX-License-Identifier: Apache-2.0
+//
+
+#include "common/Common.hpp"
+#include "common/MockIRuntimeConfig.hpp"
+#include "tpm/UploadTrigger.hpp"
+
+using namespace testing;
+using namespace MAT;
+
+class UploadTriggerTests : public Test
+{
+protected:
+    ILogConfiguration           config;
+    std::unique_ptr<MockIRuntimeConfig> runtimeConfig;
+    TimerArray                  timers { { 30000, 2000 } };
+
+    void SetUp() override
+    {
+        config[CFG_MAP_TPM][CFG_BOOL_TPM_EVENT_TRIGGERS] = true;
+        config[CFG_MAP_TPM][CFG_INT_TPM_WATERMARK_COUNT] = 3;
+        config[CFG_MAP_TPM][CFG_INT_TPM_WATERMARK_BYTES] = 1000;
+        config[CFG_MAP_TPM][CFG_MAP_TPM_MAX_DELAY]["RealTime"] = 50;
+        runtimeConfig.reset(new MockIRuntimeConfig(config));
+    }
+};
+
+TEST_F(UploadTriggerTests, DisabledByDefault)
+{
+    ILogConfiguration emptyConfig;
+    MockIRuntimeConfig defaultConfig(emptyConfig);
+    UploadTrigger trigger(defaultConfig);
+    EXPECT_FALSE(trigger.isEnabled());
+}
+
+TEST_F(UploadTriggerTests, CountWatermarkIsPerLatency)
+{
+    UploadTrigger trigger(*runtimeConfig);
+    EXPECT_TRUE(trigger.isEnabled());
+    EXPECT_FALSE(trigger.onEventQueued(EventLatency_Normal, 10));
+    EXPECT_FALSE(trigger.onEventQueued(EventLatency_RealTime, 10));
+    EXPECT_FALSE(trigger.onEventQueued(EventLatency_Normal, 10));
+    EXPECT_TRUE(trigger.onEventQueued(EventLatency_Normal, 10));
+}
+
+TEST_F(UploadTriggerTests, BytesWatermark)
+{
+    UploadTrigger trigger(*runtimeConfig);
+    EXPECT_FALSE(trigger.onEventQueued(EventLatency_Normal, 600));
+    EXPECT_TRUE(trigger.onEventQueued(EventLatency_Normal, 600));
+}
+
+TEST_F(UploadTriggerTests, UploadDrainsQueuesOfRequestedLatencyAndAbove)
+{
+    UploadTrigger trigger(*runtimeConfig);
+    EXPECT_FALSE(trigger.hasQueuedEvents());
+    trigger.onEventQueued(EventLatency_Normal, 10);
+    trigger.onEventQueued(EventLatency_RealTime, 10);
+
+    trigger.onUploadStarted(EventLatency_RealTime);
+    EXPECT_TRUE(trigger.hasQueuedEvents());
+    trigger.onUploadStarted(EventLatency_Normal);
+    EXPECT_FALSE(trigger.hasQueuedEvents());
+}
+
+TEST_F(UploadTriggerTests, MaxDelayFromConfigOrProfileTimers)
+{
+    UploadTrigger trigger(*runtimeConfig);
+    EXPECT_EQ(50, trigger.getMaxDelay(EventLatency_RealTime, timers).count());
+    EXPECT_EQ(30000, trigger.getMaxDelay(EventLatency_Normal, timers).count());
+    EXPECT_EQ(0, trigger.getMaxDelay(EventLatency_Max, timers).count());
+}
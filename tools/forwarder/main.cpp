@@ -0,0 +1,118 @@
+//
+// Copyright (c) Microsoft Corporation. All rights reserved.
+// SPDX-License-Identifier: Apache-2.0
+//
+
+// Reference local-agent forwarder: uploads the packages of every SDK instance on
+// the host that is configured with
+//     config[CFG_MAP_HTTP][CFG_STR_HTTP_LOCAL_AGENT_SOCKET] = "<socket path>"
+// through one shared HTTP client. Only uploads to the given collector URLs (the
+// production collector by default) are relayed.
+//
+// With --queue the forwarder also uploads at the record level: it opens the shared
+// queue at the given path as its uploader and sends the records of every SDK
+// instance on the host that is configured with
+//     config[CFG_STR_SHARED_QUEUE_PATH] = "<queue path>"
+//     config[CFG_BOOL_SHARED_QUEUE_UPLOAD] = false
+// to the first collector URL. The instances then only append their records; the
+// queue keeps them across a restart of the forwarder as long as the host is up.
+//
+// usage: mat-forwarder [--queue <queue path>] [socket path] [collector URL ...]
+
+#include "mat/config.h"
+
+#include "ILogConfiguration.hpp"
+#include "http/HttpClientFactory.hpp"
+#include "http/LocalAgentServer.hpp"
+#include "LogManagerProvider.hpp"
+
+#include <csignal>
+#include <cstdio>
+#include <cstring>
+#include <ctime>
+#include <string>
+#include <vector>
+
+#include <pthread.h>
+
+using namespace MAT;
+
+static const char* const DefaultSocketPath = "/run/mat-forwarder.sock";
+
+// How often the records of the shared queue are drained and uploaded
+static const time_t QueueUploadIntervalSec = 1;
+
+int main(int argc, char** argv)
+{
+    int arg = 1;
+    const char* queuePath = nullptr;
+    if (arg + 1 < argc && strcmp(argv[arg], "--queue") == 0)
+    {
+        queuePath = argv[arg + 1];
+        arg += 2;
+    }
+    const char* socketPath = (arg < argc) ? argv[arg++] : DefaultSocketPath;
+    std::vector<std::string> urls(argv + arg, argv + argc);
+    if (urls.empty())
+    {
+        urls.push_back(COLLECTOR_URL_PROD);
+    }
+    std::set<std::string> collectorUrls(urls.begin(), urls.end());
+
+    // Block the stop signals in every thread; the main thread waits for them below
+    sigset_t signals;
+    sigemptyset(&signals);
+    sigaddset(&signals, SIGINT);
+    sigaddset(&signals, SIGTERM);
+    pthread_sigmask(SIG_BLOCK, &signals, nullptr);
+    signal(SIGPIPE, SIG_IGN);
+
+    auto upstream = HttpClientFactory::Create();
+    LocalAgentServer server(socketPath, *upstream, collectorUrls);
+    if (!server.Start())
+    {
+        fprintf(stderr, "mat-forwarder: cannot listen on %s\n", socketPath);
+        return 1;
+    }
+    printf("mat-forwarder: listening on %s\n", socketPath);
+
+    ILogConfiguration config;
+    ILogManager* queueUploader = nullptr;
+    if (queuePath != nullptr)
+    {
+        config[CFG_STR_FACTORY_NAME] = "mat-forwarder";
+        config[CFG_STR_COLLECTOR_URL] = urls.front();
+        config[CFG_STR_SHARED_QUEUE_PATH] = queuePath;
+        config.AddModule(CFG_MODULE_HTTP_CLIENT, upstream);
+        status_t status = STATUS_SUCCESS;
+        queueUploader = LogManagerProvider::CreateLogManager(config, status);
+        if (queueUploader == nullptr || status != STATUS_SUCCESS)
+        {
+            fprintf(stderr, "mat-forwarder: cannot upload shared queue %s\n", queuePath);
+            server.Stop();
+            return 1;
+        }
+        printf("mat-forwarder: uploading shared queue %s to %s\n", queuePath, urls.front().c_str());
+    }
+    fflush(stdout);
+
+    if (queueUploader == nullptr)
+    {
+        int received = 0;
+        sigwait(&signals, &received);
+    }
+    else
+    {
+        // The processes only append to the queue; poll it until asked to stop
+        const timespec interval = { QueueUploadIntervalSec, 0 };
+        while (sigtimedwait(&signals, nullptr, &interval) < 0)
+        {
+            queueUploader->UploadNow();
+        }
+        LogManagerProvider::Release(config);
+    }
+
+    server.Stop();
+    printf("mat-forwarder: stopped after %llu requests\n", static_cast<unsigned long long>(server.GetForwardedCount()));
+    return 0;
+}